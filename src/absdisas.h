@@ -8,6 +8,7 @@
 #include "typedefs.h"
 #include <type_traits>
 #include <string>
+#include <array>
 
 
 static constexpr Byte PAGE2{0x10};
@@ -26,6 +27,16 @@ enum class InstFlg : uint8_t
     LabelAddr = (1U << 6U),    // return a label address
 };
 
+// Fixed size text buffers filled by the disassembler.
+// Each buffer is always zero terminated. Using it avoids any heap allocation
+// when disassembling on a per instruction basis, e.g. when logging.
+struct DisassemblyText
+{
+    std::array<char, 24> code{}; // address and instruction bytes
+    std::array<char, 8> mnemonic{};
+    std::array<char, 32> operands{};
+};
+
 class AbstractDisassembler
 {
 
@@ -38,6 +49,11 @@ public:
                   std::string &p_code,
                   std::string &p_mnemonic,
                   std::string &p_operands) = 0;
+    virtual InstFlg Disassemble(
+                  const Byte *p_memory,
+                  DWord p_pc,
+                  DWord &p_jumpaddr,
+                  DisassemblyText &p_text) = 0;
     virtual void set_use_undocumented(bool value) = 0;
     virtual unsigned getByteSize(const Byte *p_memory) = 0;
 }; // class AbstractDisassembler
@@ -79,6 +79,11 @@ void Acia1::writeOutput(Byte val)
 void Acia1::set_irq()
 {
     Mc6850::set_irq();
-    Notify(NotifyId::SetIrq);
+    irq.Pulse();
+}
+
+void Acia1::connect_interrupts(Mc6809 &cpu)
+{
+    irq.Connect(cpu, INT_IRQ);
 }
 
@@ -26,18 +26,20 @@
 #define ACIA1_INCLUDED
 
 #include "mc6850.h"
-#include "bobservd.h"
+#include "irqline.h"
 
 class TerminalIO;
 class Inout;
+class Mc6809;
 
-class Acia1 : public Mc6850, public BObserved
+class Acia1 final : public Mc6850
 {
 
 protected:
 
     TerminalIO &terminalIO;
     Inout &inout;
+    InterruptLine irq;
 
 public:
     // read data from serial line
@@ -53,6 +55,7 @@ public:
     void requestInput() override;
 
     void resetIo() override;
+    void connect_interrupts(Mc6809 &cpu);
 
     const char *getName() override
     {
@@ -64,7 +64,9 @@ ApplicationRunner::ApplicationRunner(struct sOptions &p_options) :
     drisel(fdc),
     command(inout, scheduler, fdc, options),
     gui(cpu, memory, scheduler, inout, vico1, vico2,
-        joystickIO, keyboardIO, terminalIO, pia1, p_options)
+        joystickIO, keyboardIO, terminalIO, pia1, p_options),
+    snapshot(cpu, memory, scheduler),
+    replayLog(cpu)
 {
     if (options.startup_command.size() > MAX_COMMAND)
     {
@@ -94,7 +96,7 @@ ApplicationRunner::ApplicationRunner(struct sOptions &p_options) :
 
     if (options.isRamExtension)
     {
-        ioDevices.insert({ mmu.getName(), mmu });
+        AddIoDevice(mmu);
     }
     else
     {
@@ -127,28 +129,34 @@ ApplicationRunner::ApplicationRunner(struct sOptions &p_options) :
         cpu.setLoggerConfig(loggerConfig);
     }
 
-    ioDevices.insert({ acia1.getName(), acia1 });
-    ioDevices.insert({ pia1.getName(), pia1 });
+    AddIoDevice(acia1);
+    AddIoDevice(pia1);
     if (options.isEurocom2V5)
     {
-        ioDevices.insert({ pia2v5.getName(), pia2v5 });
+        AddIoDevice(pia2v5);
     }
     else
     {
-        ioDevices.insert({ pia2.getName(), pia2 });
-        ioDevices.insert({ fdc.getName(), fdc });
-        ioDevices.insert({ drisel.getName(), drisel });
+        AddIoDevice(pia2);
+        AddIoDevice(fdc);
+        AddIoDevice(drisel);
         gui.SetFloppy(&fdc);
     }
-    ioDevices.insert({ command.getName(), command });
-    ioDevices.insert({ vico1.getName(), vico1 });
-    ioDevices.insert({ vico2.getName(), vico2 });
+    AddIoDevice(command);
+    AddIoDevice(vico1);
+    AddIoDevice(vico2);
     if (options.useRtc)
     {
-        ioDevices.insert({ rtc.getName(), rtc });
+        AddIoDevice(rtc);
         inout.set_rtc(&rtc);
     }
 
+    for (auto &iter : ioDevices)
+    {
+        snapshot.AddIoDevice(iter.second);
+    }
+    command.set_snapshot(&snapshot);
+
     scheduler.set_frequency(options.frequency);
 
     const auto path(flx::getFlexemuSystemConfigFile());
@@ -172,15 +180,15 @@ ApplicationRunner::ApplicationRunner(struct sOptions &p_options) :
     }
 
     pia1.Attach(inout);
-    pia1.Attach(cpu);
-    acia1.Attach(cpu);
-    terminalIO.Attach(cpu);
-    command.Attach(cpu);
+    pia1.connect_interrupts(cpu);
+    acia1.connect_interrupts(cpu);
+    terminalIO.connect_interrupts(cpu);
+    command.connect_interrupts(cpu);
     vico1.Attach(memory);
     vico2.Attach(memory);
     if (options.useRtc)
     {
-        rtc.Attach(cpu);
+        rtc.connect_interrupts(cpu);
     }
 }
 
@@ -209,6 +217,7 @@ void ApplicationRunner::AddIoDevicesToMemory()
         if (ioDevices.find(name) != ioDevices.end())
         {
             std::reference_wrapper<IoDevice> deviceRef = ioDevices.at(name);
+            auto dispatch = ioDispatches.at(name);
 
             if (deviceNames.find(name) != deviceNames.end())
             {
@@ -217,10 +226,11 @@ void ApplicationRunner::AddIoDevicesToMemory()
                 auto lastPos = debugLogDevices.size() - 1;
                 deviceRef =
                       dynamic_cast<IoDevice &>(debugLogDevices.at(lastPos));
+                dispatch = MakeIoDispatch<IoDeviceDebug>();
             }
 
-            memory.add_io_device(std::ref(deviceRef),
-                deviceParam.baseAddress, deviceParam.byteSize);
+            memory.add_io_device(deviceRef.get(), deviceParam.baseAddress,
+                                 deviceParam.byteSize, dispatch);
         }
     }
 
@@ -230,8 +240,10 @@ bool ApplicationRunner::LoadMonitorFileIntoRom()
 {
     std::string hexFilePath = options.hex_file;
     DWord startAddress = 0;
+    sHexFilePosition position;
 
-    int error = load_hexfile(options.hex_file, memory, startAddress);
+    int error = load_hexfile(options.hex_file, memory, startAddress,
+                             &position);
     if (error < 0)
     {
         if (!flx::isAbsolutePath(hexFilePath))
@@ -239,7 +251,10 @@ bool ApplicationRunner::LoadMonitorFileIntoRom()
             hexFilePath = options.disk_dir + PATHSEPARATORSTRING +
                           options.hex_file;
 
-            error = load_hexfile(hexFilePath, memory, startAddress);
+            // The position of the first attempt must not be reported.
+            position = sHexFilePosition{};
+            error = load_hexfile(hexFilePath, memory, startAddress,
+                                 &position);
         }
 
         if (error < 0)
@@ -247,7 +262,7 @@ bool ApplicationRunner::LoadMonitorFileIntoRom()
             std::stringstream pmsg;
 
             pmsg << "*** Error in \"" << hexFilePath << "\":\n    ";
-            print_hexfile_error(pmsg, error);
+            print_hexfile_error(pmsg, error, position);
             pmsg << '\n';
 #ifdef _WIN32
             MessageBox(
@@ -267,12 +282,17 @@ bool ApplicationRunner::LoadMonitorFileIntoRom()
 
 int ApplicationRunner::startup(QApplication &app)
 {
+    for (const auto &symbolFile : options.symbolFiles)
+    {
+        Da6809::AddSymbolFile(symbolFile);
+    }
     cpu.set_disassembler(&disassembler);
     cpu.set_use_undocumented(options.use_undocumented);
 
     if (options.isEurocom2V5)
     {
         pia2v5.disk_directory(options.disk_dir.c_str());
+        pia2v5.set_fast_load(options.isMdcrFastLoad);
         pia2v5.mount_all_drives(options.mdcrDrives);
     }
     else
@@ -299,17 +319,80 @@ int ApplicationRunner::startup(QApplication &app)
     memory.reset_io();
     cpu.reset();
 
+    if (!options.snapshotPath.empty() &&
+        !snapshot.RestoreFromFile(options.snapshotPath))
+    {
+        std::cerr << "*** Error: Could not restore snapshot '" <<
+                     options.snapshotPath << "'.\n";
+        return 1;
+    }
+
+    auto startupCommand = options.startup_command;
+    if (!StartReplayLog(startupCommand))
+    {
+        return 1;
+    }
+
     if (options.term_mode && terminalIO.is_terminal_supported())
     {
-        terminalIO.set_startup_command(options.startup_command.c_str());
+        terminalIO.set_startup_command(startupCommand.c_str());
     }
     else
     {
-        keyboardIO.set_startup_command(options.startup_command.c_str());
+        keyboardIO.set_startup_command(startupCommand.c_str());
+    }
+
+    // The fork server has to be started before any other thread.
+    if (!options.forkServerPath.empty())
+    {
+        if (!options.term_mode || options.isEurocom2V5)
+        {
+            std::cerr << "*** Warning: The fork server needs terminal mode "
+                         "and an Eurocom II/V7.\n";
+        }
+        else
+        {
+            forkServer = std::make_unique<ForkServer>(options.forkServerPath,
+                    scheduler, terminalIO, fdc);
+            if (!forkServer->Start())
+            {
+                std::cerr << "*** Warning: Could not start fork server on "
+                             "socket '" << options.forkServerPath << "'.\n";
+                forkServer.reset();
+            }
+        }
+    }
+
+    const bool isForkedChild = forkServer && forkServer->IsChild();
+
+    if (!options.counterSocketPath.empty() && !isForkedChild)
+    {
+        counterServer =
+            std::make_unique<HotCounterServer>(options.counterSocketPath);
+        if (!counterServer->Start())
+        {
+            std::cerr << "*** Warning: Could not serve hot path counters on "
+                         "socket '" << options.counterSocketPath << "'.\n";
+            counterServer.reset();
+        }
     }
 
     // start CPU thread
-    cpuThread = std::make_unique<std::thread>(&Scheduler::run, &scheduler);
+    cpuThread = std::make_unique<std::thread>([&, isForkedChild]()
+    {
+        scheduler.run();
+        if (isForkedChild)
+        {
+            // A forked child has no GUI thread to clean up.
+            ForkServer::ExitChild(EXIT_SUCCESS);
+        }
+    });
+
+    if (isForkedChild)
+    {
+        // The Qt event loop is not available in a forked child.
+        forkServer->RunTimer();
+    }
 
     QObject::connect(&gui, &QtGui::CloseApplication, &app,
                      &QCoreApplication::quit, Qt::QueuedConnection);
@@ -317,8 +400,54 @@ int ApplicationRunner::startup(QApplication &app)
     return 0;
 }
 
+// A recording starts with a snapshot of the machine. A replay restores
+// this snapshot and uses the recorded startup command. It runs with
+// maximum frequency.
+bool ApplicationRunner::StartReplayLog(std::string &startupCommand)
+{
+    if (options.replayRecordPath.empty() && options.replayPath.empty())
+    {
+        return true;
+    }
+
+    if (!options.term_mode || !terminalIO.is_terminal_supported())
+    {
+        std::cerr << "*** Warning: Recording or replaying inputs needs "
+                     "terminal mode.\n";
+        return true;
+    }
+
+    if (!options.replayPath.empty())
+    {
+        if (!replayLog.StartReplay(options.replayPath) ||
+            !snapshot.Restore(replayLog.GetSnapshot()))
+        {
+            std::cerr << "*** Error: Could not replay '" <<
+                         options.replayPath << "'.\n";
+            return false;
+        }
+        startupCommand = replayLog.GetStartupCommand();
+        scheduler.set_frequency(0.0F);
+    }
+    else if (!replayLog.StartRecording(options.replayRecordPath,
+                 snapshot.Save(), startupCommand))
+    {
+        std::cerr << "*** Error: Could not record inputs to '" <<
+                     options.replayRecordPath << "'.\n";
+        return false;
+    }
+
+    scheduler.set_replay_log(&replayLog);
+    terminalIO.set_replay_log(&replayLog);
+
+    return true;
+}
+
 void ApplicationRunner::cleanup()
 {
+    // No more child processes are forked.
+    forkServer.reset();
+
     if (cpuThread)
     {
         // Make sure that the CPU thread leaves the suspended state
@@ -326,6 +455,13 @@ void ApplicationRunner::cleanup()
         scheduler.request_new_state(CpuState::Exit);
         cpuThread->join(); // wait for termination of CPU thread
         cpuThread.reset();
+
+        if (options.isPrintCounters)
+        {
+            HotCounterRegistry::Instance().Dump(std::cout);
+        }
     }
+
+    counterServer.reset();
 }
 
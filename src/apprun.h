@@ -47,6 +47,10 @@
 #include "qtgui.h"
 #include "drisel.h"
 #include "iodevdbg.h"
+#include "hotcnt.h"
+#include "machsnap.h"
+#include "replay.h"
+#include "forksrv.h"
 #include <string>
 #include <map>
 #include <thread>
@@ -67,7 +71,14 @@ public:
 
 private:
     void AddIoDevicesToMemory();
+    template <class T>
+    void AddIoDevice(T &device)
+    {
+        ioDevices.insert({ device.getName(), device });
+        ioDispatches.insert({ device.getName(), MakeIoDispatch<T>() });
+    }
     bool LoadMonitorFileIntoRom();
+    bool StartReplayLog(std::string &startupCommand);
 
     struct sOptions &options;
     Memory memory;
@@ -90,9 +101,15 @@ private:
     VideoControl1 vico1;
     VideoControl2 vico2;
     QtGui gui;
+    MachineSnapshot snapshot;
+    ReplayLog replayLog;
     std::map<std::string, IoDevice &> ioDevices;
+    // I/O dispatch functions of each device, see MakeIoDispatch().
+    std::map<std::string, IoDispatch> ioDispatches;
     std::vector<IoDeviceDebug> debugLogDevices;
     std::unique_ptr<std::thread> cpuThread;
+    std::unique_ptr<HotCounterServer> counterServer;
+    std::unique_ptr<ForkServer> forkServer;
 };
 
 #endif
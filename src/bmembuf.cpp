@@ -28,34 +28,40 @@
 
 
 BMemoryBuffer::BMemoryBuffer(DWord size)
+    : bufferSize(size)
+    , pages((size + PAGE_BYTES - 1U) / PAGE_BYTES)
 {
-    buffer.resize(size, 0);
 }
 
 BMemoryBuffer::BMemoryBuffer(const BMemoryBuffer &src)
+    : bufferSize(src.bufferSize)
+    , pages(src.pages.size())
+    , addressRanges(src.addressRanges)
 {
-    buffer.clear();
-    std::copy(src.buffer.cbegin(), src.buffer.cend(),
-              std::back_inserter(buffer));
-    std::copy(src.addressRanges.cbegin(), src.addressRanges.cend(),
-              std::back_inserter(addressRanges));
+    for (size_t index = 0U; index < pages.size(); ++index)
+    {
+        if (src.pages[index])
+        {
+            pages[index] = std::make_unique<Page>(*src.pages[index]);
+        }
+    }
 }
 
 BMemoryBuffer::BMemoryBuffer(BMemoryBuffer &&src) noexcept
-    : buffer(std::move(src.buffer))
+    : bufferSize(src.bufferSize)
+    , pages(std::move(src.pages))
     , addressRanges(std::move(src.addressRanges))
 {
+    src.bufferSize = 0U;
 }
 
 BMemoryBuffer &BMemoryBuffer::operator= (const BMemoryBuffer &src)
 {
     if (this != &src)
     {
-        buffer.clear();
-        std::copy(src.buffer.cbegin(), src.buffer.cend(),
-                  std::back_inserter(buffer));
-        std::copy(src.addressRanges.cbegin(), src.addressRanges.cend(),
-                  std::back_inserter(addressRanges));
+        BMemoryBuffer tmp(src);
+
+        *this = std::move(tmp);
     }
 
     return *this;
@@ -63,8 +69,10 @@ BMemoryBuffer &BMemoryBuffer::operator= (const BMemoryBuffer &src)
 
 BMemoryBuffer &BMemoryBuffer::operator= (BMemoryBuffer &&src) noexcept
 {
-    buffer = std::move(src.buffer);
+    bufferSize = src.bufferSize;
+    pages = std::move(src.pages);
     addressRanges = std::move(src.addressRanges);
+    src.bufferSize = 0U;
 
     return *this;
 }
@@ -73,17 +81,36 @@ void BMemoryBuffer::CopyTo(Byte *target, DWord address, DWord size) const
 {
     auto secureSize = size;
 
-    if (address >= buffer.size())
+    if (address >= bufferSize)
     {
         throw std::out_of_range("address is out of valid range");
     }
 
-    if (address + secureSize >= buffer.size())
+    if (address + secureSize >= bufferSize)
+    {
+        secureSize -= address + size - bufferSize;
+    }
+
+    for (DWord offset = 0U; offset < secureSize;)
     {
-        secureSize -= static_cast<DWord>(address + size - buffer.size());
+        const auto pageIndex = (address + offset) / PAGE_BYTES;
+        const auto pageOffset = (address + offset) % PAGE_BYTES;
+        const auto count = std::min(secureSize - offset,
+                                    PAGE_BYTES - pageOffset);
+
+        if (pages[pageIndex])
+        {
+            std::memcpy(target + offset, pages[pageIndex]->data() + pageOffset,
+                        count);
+        }
+        else
+        {
+            // Unwritten pages are not allocated, they read as 0.
+            std::memset(target + offset, 0, count);
+        }
+        offset += count;
     }
 
-    std::memcpy(target, buffer.data() + address, secureSize);
     if (secureSize < size)
     {
         // Fill up buffer not represented in BMemoryBuffer by 0.
@@ -95,37 +122,87 @@ void BMemoryBuffer::CopyFrom(const Byte *source, DWord address, DWord size)
 {
     auto secureSize = size;
 
-    if (address >= buffer.size())
+    if (address >= bufferSize)
     {
         throw std::out_of_range("address is out of valid range");
     }
 
-    if (address + secureSize >= buffer.size())
+    if (address + secureSize >= bufferSize)
+    {
+        secureSize -= address + size - bufferSize;
+    }
+
+    if (secureSize == 0U)
+    {
+        return;
+    }
+
+    for (DWord offset = 0U; offset < secureSize;)
     {
-        secureSize -= static_cast<DWord>(address + size - buffer.size());
+        const auto pageIndex = (address + offset) / PAGE_BYTES;
+        const auto pageOffset = (address + offset) % PAGE_BYTES;
+        const auto count = std::min(secureSize - offset,
+                                    PAGE_BYTES - pageOffset);
+        auto &page = pages[pageIndex];
+
+        if (!page)
+        {
+            page = std::make_unique<Page>();
+        }
+        std::memcpy(page->data() + pageOffset, source + offset, count);
+        offset += count;
     }
 
-    std::memcpy(buffer.data() + address, source, secureSize);
+    AddAddressRange(address, address + secureSize - 1U);
+}
+
+// Insert an address range, keeping the address ranges sorted by their
+// lower address and joining it with all overlapping or adjoining ones.
+void BMemoryBuffer::AddAddressRange(DWord lower, DWord upper)
+{
+    auto iter = std::lower_bound(addressRanges.begin(), addressRanges.end(),
+            lower, [](const AddressRange &addressRange, DWord address)
+    {
+        return addressRange.upper() + 1U < address;
+    });
+    const auto first = iter;
 
-    DWord endAddress = address + secureSize - 1;
-    addressRanges.emplace_back(address, endAddress);
-    join(addressRanges);
+    while (iter != addressRanges.end() && iter->lower() <= upper + 1U)
+    {
+        lower = std::min(lower, iter->lower());
+        upper = std::max(upper, iter->upper());
+        ++iter;
+    }
+
+    iter = addressRanges.erase(first, iter);
+    addressRanges.emplace(iter, lower, upper);
 }
 
 bool BMemoryBuffer::CopyTo(std::vector<Byte> &targetBuffer,
            const MemorySource<DWord>::AddressRange &addressRange) const
 {
-    auto startIter = buffer.cbegin() + addressRange.lower();
-    auto endIter = buffer.cbegin() + addressRange.upper() + 1;
+    const auto offset = targetBuffer.size();
 
-    std::copy(startIter, endIter, std::back_inserter(targetBuffer));
+    targetBuffer.resize(offset + width(addressRange) + 1U);
+    CopyTo(targetBuffer.data() + offset, addressRange.lower(),
+           width(addressRange) + 1U);
 
     return true;
 }
 
 void BMemoryBuffer::Reset()
 {
-    std::memset(buffer.data(), 0, buffer.size());
+    // Only pages within the address ranges have been allocated.
+    for (const auto &addressRange : addressRanges)
+    {
+        const auto lastIndex = addressRange.upper() / PAGE_BYTES;
+
+        for (auto index = addressRange.lower() / PAGE_BYTES;
+             index <= lastIndex; ++index)
+        {
+            pages[index].reset();
+        }
+    }
     addressRanges.clear();
 }
 
@@ -26,9 +26,14 @@
 #include "typedefs.h"
 #include "memsrc.h"
 #include "memtgt.h"
+#include <array>
+#include <memory>
 #include <vector>
 
 
+// A memory buffer of a given size which only allocates memory for pages
+// which have been written to. Reading from an unwritten page returns 0.
+// The address ranges written to are kept sorted and joined.
 class BMemoryBuffer : public MemorySource<DWord>, public MemoryTarget<DWord>
 {
 public:
@@ -43,7 +48,7 @@ public:
 
     inline DWord GetSize() const
     {
-        return static_cast<DWord>(buffer.size());
+        return bufferSize;
     };
 
     // MemorySource interface
@@ -59,7 +64,13 @@ public:
     void Reset();
 
 private:
-    std::vector<Byte> buffer;
+    static constexpr DWord PAGE_BYTES{256U};
+    using Page = std::array<Byte, PAGE_BYTES>;
+
+    void AddAddressRange(DWord lower, DWord upper);
+
+    DWord bufferSize{};
+    std::vector<std::unique_ptr<Page> > pages;
     MemorySource<DWord>::AddressRanges addressRanges;
 };
 
@@ -0,0 +1,118 @@
+/*
+    bwrkpool.cpp
+
+
+    FLEXplorer, An explorer for FLEX disk image files and directory disks.
+    Copyright (C) 2003-2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "bwrkpool.h"
+#include <algorithm>
+
+
+BWorkerPool::BWorkerPool(unsigned threadCount)
+{
+    if (threadCount == 0U)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    threads.reserve(threadCount);
+    for (unsigned i = 0U; i < threadCount; ++i)
+    {
+        threads.emplace_back(&BWorkerPool::Run, this);
+    }
+}
+
+BWorkerPool::~BWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        isFinished = true;
+    }
+    condition.notify_all();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void BWorkerPool::Post(const std::string &key, Task task)
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        tasks.push_back(sTask{ key, std::move(task) });
+    }
+    condition.notify_one();
+}
+
+void BWorkerPool::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true)
+    {
+        auto iter = tasks.end();
+
+        // Wait for the first task which is not blocked by an active task
+        // with the same key.
+        condition.wait(lock, [&](){
+            iter = std::find_if(tasks.begin(), tasks.end(),
+                    [&](const sTask &task){
+                return task.key.empty() ||
+                       activeKeys.find(task.key) == activeKeys.end();
+            });
+            return iter != tasks.end() || (isFinished && tasks.empty());
+        });
+
+        if (iter == tasks.end())
+        {
+            return;
+        }
+
+        auto task = std::move(*iter);
+        tasks.erase(iter);
+        if (!task.key.empty())
+        {
+            activeKeys.insert(task.key);
+        }
+
+        lock.unlock();
+        try
+        {
+            task.task();
+        }
+        catch (...)
+        {
+            // A task has to handle its exceptions itself,
+            // see PostWithResult().
+        }
+        lock.lock();
+
+        if (!task.key.empty())
+        {
+            activeKeys.erase(task.key);
+        }
+        // Tasks with the same key or the destructor may be waiting.
+        if (!task.key.empty() || isFinished)
+        {
+            condition.notify_all();
+        }
+    }
+}
+
@@ -0,0 +1,98 @@
+/*
+    bwrkpool.h
+
+
+    FLEXplorer, An explorer for FLEX disk image files and directory disks.
+    Copyright (C) 2003-2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef BWRKPOOL_INCLUDED
+#define BWRKPOOL_INCLUDED
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// A pool of worker threads executing tasks in the background.
+// Tasks posted with the same key, e.g. the path of a FLEX disk image, are
+// executed one after the other in the order they have been posted. This
+// serializes all accesses to a resource which is not thread safe.
+// Tasks with different keys or without a key are executed in parallel.
+class BWorkerPool
+{
+public:
+    using Task = std::function<void()>;
+
+    // A thread count of 0 uses one thread per hardware thread.
+    explicit BWorkerPool(unsigned threadCount = 0U);
+    // All tasks already posted are executed before returning.
+    ~BWorkerPool();
+    BWorkerPool(const BWorkerPool &src) = delete;
+    BWorkerPool(BWorkerPool &&src) = delete;
+    BWorkerPool &operator=(const BWorkerPool &src) = delete;
+    BWorkerPool &operator=(BWorkerPool &&src) = delete;
+
+    void Post(const std::string &key, Task task);
+
+    // The future returns the result of the function or rethrows its
+    // exception.
+    template <typename T>
+    std::future<T> PostWithResult(const std::string &key,
+                                  std::function<T()> function)
+    {
+        auto task =
+            std::make_shared<std::packaged_task<T()> >(std::move(function));
+        auto future = task->get_future();
+
+        Post(key, [task](){ (*task)(); });
+
+        return future;
+    }
+
+    unsigned GetThreadCount() const
+    {
+        return static_cast<unsigned>(threads.size());
+    }
+
+private:
+    struct sTask
+    {
+        std::string key;
+        Task task;
+    };
+
+    void Run();
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<sTask> tasks;
+    // Keys of all tasks currently executed.
+    std::set<std::string> activeKeys;
+    std::vector<std::thread> threads;
+    bool isFinished{};
+};
+
+#endif // BWRKPOOL_INCLUDED
+
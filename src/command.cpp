@@ -33,6 +33,7 @@
 #include "inout.h"
 #include "schedule.h"
 #include "filfschk.h"
+#include "csnapsht.h"
 #include <sstream>
 #include <iomanip>
 #include <iostream>
@@ -50,6 +51,18 @@ Command::Command(
 {
 }
 
+void Command::set_snapshot(MachineSnapshot *p_snapshot)
+{
+    snapshot = p_snapshot;
+}
+
+void Command::connect_interrupts(Mc6809 &cpu)
+{
+    irq.Connect(cpu, INT_IRQ);
+    firq.Connect(cpu, INT_FIRQ);
+    nmi.Connect(cpu, INT_NMI);
+}
+
 void Command::resetIo()
 {
     command_index = 0;
@@ -146,19 +159,19 @@ void Command::writeIo(Word /*offset*/, Byte val)
 
                 if (arg1.compare("irq") == 0)
                 {
-                    Notify(NotifyId::SetIrq);
+                    irq.Pulse();
                     return;
                 }
 
                 if (arg1.compare("firq") == 0)
                 {
-                    Notify(NotifyId::SetFirq);
+                    firq.Pulse();
                     return;
                 }
 
                 if (arg1.compare("nmi") == 0)
                 {
-                    Notify(NotifyId::SetNmi);
+                    nmi.Pulse();
                     return;
                 }
 
@@ -234,6 +247,32 @@ void Command::writeIo(Word /*offset*/, Byte val)
                     return;
                 }
 
+                if (arg1.compare("savestate") == 0 ||
+                    arg1.compare("loadstate") == 0)
+                {
+                    if (snapshot == nullptr)
+                    {
+                        answer_stream << "EMU error: "
+                                         "Snapshots are not supported.";
+                        answer = answer_stream.str();
+                        return;
+                    }
+
+                    // Execute it after the current instruction.
+                    if (arg1.compare("savestate") == 0)
+                    {
+                        scheduler.sync_exec(BCommandPtr(
+                                    new CSaveSnapshot(*snapshot, arg2)));
+                    }
+                    else
+                    {
+                        scheduler.sync_exec(BCommandPtr(
+                                    new CRestoreSnapshot(*snapshot, arg2)));
+                    }
+
+                    return;
+                }
+
                 {
                     std::stringstream stream(arg2);
 
@@ -417,6 +456,54 @@ void Command::writeIo(Word /*offset*/, Byte val)
                     return;
                 }
 
+                if (arg1.compare("scratch") == 0)
+                {
+                    int trk;
+                    int sec;
+                    std::stringstream stream(arg2);
+
+                    if ((stream >> number).fail() || number > 3)
+                    {
+                        answer_stream << "EMU parameter error: " << arg2 <<
+                                         " is not a valid drive number.";
+                        answer = answer_stream.str();
+                        return;
+                    }
+
+                    std::stringstream tstream{arg3};
+                    if ((tstream >> trk).fail() || trk < 2 || trk > 255)
+                    {
+                        answer_stream << "EMU parameter error: " << arg3 <<
+                                         " is not a valid track count.";
+                        answer = answer_stream.str();
+                        return;
+                    }
+
+                    std::stringstream sstream{arg4};
+                    if ((sstream >> sec).fail() || sec < 6 || sec > 255)
+                    {
+                        answer_stream << "EMU parameter error: " << arg4 <<
+                                         " is not a valid sector count.";
+                        answer = answer_stream.str();
+                        return;
+                    }
+
+                    // A scratch disk only exists in memory.
+                    const auto name = "scratch" + std::to_string(number);
+                    if (!fdc.format_disk(
+                        static_cast<SWord>(trk),
+                        static_cast<SWord>(sec),
+                        name, TYPE_DSK_DISKFILE | TYPE_RAM_DISKFILE, number))
+                    {
+                        answer_stream << "EMU error: Unable to create "
+                                         "scratch disk in drive #" <<
+                                         number << ".";
+                        answer = answer_stream.str();
+                    }
+
+                    return;
+                }
+
                 break;
         }
         answer_stream << "Unknown command: " << command.data() << ".";
@@ -26,7 +26,7 @@
 
 #include "misc1.h"
 #include "iodevice.h"
-#include "bobservd.h"
+#include "irqline.h"
 #include "asciictl.h"
 #include "soptions.h"
 #include <string>
@@ -43,10 +43,12 @@ INVALID_DRIVE = 4, /* Identifier for an invalid drive */
 class Inout;
 class E2floppy;
 class Scheduler;
+class MachineSnapshot;
+class Mc6809;
 
 using command_t = std::array<char, MAX_COMMAND>;
 
-class Command : public IoDevice, public BObserved
+class Command final : public IoDevice
 {
 
     // Internal registers
@@ -55,6 +57,10 @@ protected:
     Inout &inout;
     Scheduler &scheduler;
     E2floppy &fdc;
+    MachineSnapshot *snapshot{nullptr};
+    InterruptLine irq;
+    InterruptLine firq;
+    InterruptLine nmi;
     command_t command{};
     Word command_index{0};
     Word answer_index{0};
@@ -87,6 +93,8 @@ public:
             E2floppy &p_fdc,
             const sOptions &p_options);
     ~Command() override = default;
+    void set_snapshot(MachineSnapshot *p_snapshot);
+    void connect_interrupts(Mc6809 &cpu);
     Command(const Command &src) = delete;
     Command(Command &&src) = delete;
     Command &operator=(const Command &src) = delete;
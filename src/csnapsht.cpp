@@ -0,0 +1,55 @@
+/*
+    csnapsht.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+
+#include "csnapsht.h"
+#include "machsnap.h"
+#include <iostream>
+
+
+CSaveSnapshot::CSaveSnapshot(MachineSnapshot &p_snapshot, std::string p_path)
+    : snapshot(p_snapshot), path(std::move(p_path))
+{
+}
+
+void CSaveSnapshot::Execute()
+{
+    if (!snapshot.SaveToFile(path))
+    {
+        std::cerr << "*** Error: Could not save snapshot '" << path << "'.\n";
+    }
+}
+
+CRestoreSnapshot::CRestoreSnapshot(MachineSnapshot &p_snapshot,
+                                   std::string p_path)
+    : snapshot(p_snapshot), path(std::move(p_path))
+{
+}
+
+void CRestoreSnapshot::Execute()
+{
+    if (!snapshot.RestoreFromFile(path))
+    {
+        std::cerr << "*** Error: Could not restore snapshot '" << path <<
+                     "'.\n";
+    }
+}
@@ -0,0 +1,69 @@
+/*
+    csnapsht.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef CSNAPSHT_INCLUDED
+#define CSNAPSHT_INCLUDED
+
+#include "bcommand.h"
+#include <string>
+
+class MachineSnapshot;
+
+// Save a machine snapshot into a file. Executed by the scheduler
+// between two CPU instructions.
+class CSaveSnapshot : public BCommand
+{
+
+public:
+    CSaveSnapshot(MachineSnapshot &p_snapshot, std::string p_path);
+    ~CSaveSnapshot() override = default;
+    CSaveSnapshot(const CSaveSnapshot &src) = delete;
+    CSaveSnapshot(CSaveSnapshot &&src) = delete;
+    CSaveSnapshot &operator=(const CSaveSnapshot &src) = delete;
+    CSaveSnapshot &operator=(CSaveSnapshot &&src) = delete;
+    void Execute() override;
+
+protected:
+    MachineSnapshot &snapshot;
+    std::string path;
+};
+
+// Restore a machine snapshot from a file. Executed by the scheduler
+// between two CPU instructions.
+class CRestoreSnapshot : public BCommand
+{
+
+public:
+    CRestoreSnapshot(MachineSnapshot &p_snapshot, std::string p_path);
+    ~CRestoreSnapshot() override = default;
+    CRestoreSnapshot(const CRestoreSnapshot &src) = delete;
+    CRestoreSnapshot(CRestoreSnapshot &&src) = delete;
+    CRestoreSnapshot &operator=(const CRestoreSnapshot &src) = delete;
+    CRestoreSnapshot &operator=(CRestoreSnapshot &&src) = delete;
+    void Execute() override;
+
+protected:
+    MachineSnapshot &snapshot;
+    std::string path;
+};
+
+#endif
@@ -19,14 +19,43 @@
 
 #include "misc1.h"
 #include <array>
-#include <map>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include "da6809.h"
 #include "flblfile.h"
 #include <fmt/format.h>
 
 const char *Da6809::flexLabelFile = nullptr;
+std::vector<std::string> Da6809::symbolFiles;
+LabelIndex Da6809::labelIndex;
+std::atomic<bool> Da6809::isLabelIndexValid{false};
+std::mutex Da6809::labelIndexMutex;
+
+// Format into a fixed size buffer. The result is truncated if it does not
+// fit into the buffer. It is always zero terminated.
+template<size_t N, typename... T>
+static void FormatTo(std::array<char, N> &buffer,
+        fmt::format_string<T...> format, T &&...args)
+{
+    const auto result = fmt::format_to_n(buffer.data(), N - 1U, format,
+            std::forward<T>(args)...);
+    *result.out = '\0';
+}
+
+// Append a string to a fixed size buffer. The result is truncated if it
+// does not fit into the buffer. It is always zero terminated.
+template<size_t N>
+static void AppendTo(std::array<char, N> &buffer, const char *str)
+{
+    auto length = std::strlen(buffer.data());
+
+    while (*str != '\0' && length < N - 1U)
+    {
+        buffer[length++] = *(str++);
+    }
+    buffer[length] = '\0';
+}
 
 void Da6809::set_use_undocumented(bool value)
 {
@@ -35,30 +64,77 @@ void Da6809::set_use_undocumented(bool value)
 
 void Da6809::SetFlexLabelFile(const char *path)
 {
+    std::lock_guard<std::mutex> guard(labelIndexMutex);
+
     flexLabelFile = path;
+    isLabelIndexValid = false;
 }
 
-const char *Da6809::FlexLabel(Word addr)
+// Add an assembler symbol or listing file as additional label source.
+// Labels of symbol files take precedence over labels of flexlabl.conf.
+void Da6809::AddSymbolFile(const std::string &path)
 {
-#ifdef FLEX_LABEL
-    static std::map<unsigned, std::string> label_for_address;
+    std::lock_guard<std::mutex> guard(labelIndexMutex);
+
+    symbolFiles.push_back(path);
+    isLabelIndexValid = false;
+}
+
+void Da6809::ClearSymbolFiles()
+{
+    std::lock_guard<std::mutex> guard(labelIndexMutex);
 
-    if (label_for_address.empty())
+    symbolFiles.clear();
+    isLabelIndexValid = false;
+}
+
+// The label index is shared by all Da6809 instances. It is lazily
+// (re)built by the first thread which needs it. Other threads wait until
+// it is complete.
+const LabelIndex &Da6809::GetLabelIndex()
+{
+    if (isLabelIndexValid)
     {
-        const auto path =
-            flexLabelFile == nullptr ? flx::getFlexLabelFile() : flexLabelFile;
-        label_for_address = FlexLabelFile::ReadFile(std::cerr, path, "LABELS");
+        return labelIndex;
     }
 
-    const auto iter = label_for_address.find(addr);
+    std::lock_guard<std::mutex> guard(labelIndexMutex);
 
-    if (iter != label_for_address.end())
+    if (!isLabelIndexValid)
     {
-        return iter->second.c_str();
+        const auto path =
+            flexLabelFile == nullptr ? flx::getFlexLabelFile() : flexLabelFile;
+
+        labelIndex.Clear();
+        labelIndex.Add(FlexLabelFile::ReadFile(std::cerr, path, "LABELS"));
+        for (const auto &symbolFile : symbolFiles)
+        {
+            labelIndex.Add(FlexLabelFile::ReadSymbolFile(symbolFile));
+        }
+        isLabelIndexValid = true;
     }
+
+    return labelIndex;
+}
+
+// Build the label index in advance, e.g. before starting worker threads
+// which disassemble in parallel.
+void Da6809::LoadLabelIndex()
+{
+#ifdef FLEX_LABEL
+    std::ignore = GetLabelIndex();
 #endif // #ifdef FLEX_LABEL
+}
+
+const char *Da6809::FlexLabel(Word addr)
+{
+#ifdef FLEX_LABEL
+    return GetLabelIndex().Find(addr);
+#else
+    (void)addr;
 
     return nullptr;
+#endif // #ifdef FLEX_LABEL
 }
 
 const char *Da6809::IndexRegister(Byte which)
@@ -94,82 +170,96 @@ const char *Da6809::StackRegister(Byte which, const char *not_stack)
 }
 
 
-inline InstFlg Da6809::D_Illegal(const char *mnemo, Byte bytes,
-        std::string &p_code, std::string &p_mnemonic, std::string &p_operands)
+inline InstFlg Da6809::D_Illegal(const char *mnemo, Byte bytes)
 {
-    p_code = PrintCode(bytes);
-    p_mnemonic = mnemo;
-    p_operands = "?????";
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
+    FormatTo(text->operands, "?????");
 
     return InstFlg::Illegal;
 }
 
 
-inline void Da6809::D_Direct(const char *mnemo, Byte bytes, std::string &p_code,
-                             std::string &p_mnemonic, std::string &p_operands)
+inline void Da6809::D_Direct(const char *mnemo, Byte bytes)
 {
     const auto offset = *(memory + bytes - 1);
 
-    p_code = PrintCode(bytes);
-    p_mnemonic = mnemo;
-    p_operands = fmt::format("${:02X}", offset);
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
+    FormatTo(text->operands, "${:02X}", offset);
 }
 
 
-inline void Da6809::D_Immediate8(const char *mnemo, Byte bytes,
-        std::string &p_code, std::string &p_mnemonic, std::string &p_operands)
+inline void Da6809::D_Immediate8(const char *mnemo, Byte bytes)
 {
     const auto offset = *(memory + bytes - 1);
 
-    p_code = PrintCode(bytes);
-    p_mnemonic = mnemo;
-    p_operands = fmt::format("#${:02X}", offset);
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
+    FormatTo(text->operands, "#${:02X}", offset);
 }
 
 
-inline void Da6809::D_Immediate16(const char *mnemo, Byte bytes,
-        std::string &p_code, std::string &p_mnemonic,
-        std::string &p_operands)
+inline void Da6809::D_Immediate16(const char *mnemo, Byte bytes)
 {
     const auto offset = flx::getValueBigEndian<Word>(&memory[bytes - 2]);
 
-    p_code = PrintCode(bytes);
-    const auto *label = FlexLabel(offset);
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
+    D_AddressOperand("#", offset);
+}
+
+// Print an address operand, either as label or as hex value.
+inline void Da6809::D_AddressOperand(const char *prefix, Word address)
+{
+    const auto *label = FlexLabel(address);
 
-    p_mnemonic = mnemo;
     if (label == nullptr)
     {
-        p_operands = fmt::format("#${:04X}", offset);
+        FormatTo(text->operands, "{}${:04X}", prefix, address);
     }
     else
     {
-        p_operands = "#";
-        p_operands += label;
+        FormatTo(text->operands, "{}{}", prefix, label);
     }
 }
 
-inline std::string Da6809::PrintCode(int bytes)
+inline void Da6809::PrintCode(int bytes)
 {
-    std::string result = fmt::format("{:04X}:", pc);
+    static constexpr std::array<char, 16> hex_digits{
+        '0', '1', '2', '3', '4', '5', '6', '7',
+        '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+    };
+    auto *out = text->code.data();
 
+    *(out++) = hex_digits[(pc >> 12U) & 0x0FU];
+    *(out++) = hex_digits[(pc >> 8U) & 0x0FU];
+    *(out++) = hex_digits[(pc >> 4U) & 0x0FU];
+    *(out++) = hex_digits[pc & 0x0FU];
+    *(out++) = ':';
     for (int i = 0; i < bytes; ++i)
     {
-        result += fmt::format(" {:02X}", memory[i]);
+        *(out++) = ' ';
+        *(out++) = hex_digits[(memory[i] >> 4U) & 0x0FU];
+        *(out++) = hex_digits[memory[i] & 0x0FU];
     }
+    *out = '\0';
+}
 
-    return result;
+inline void Da6809::PrintMnemonic(const char *mnemo)
+{
+    text->mnemonic[0] = '\0';
+    AppendTo(text->mnemonic, mnemo);
 }
 
-inline void Da6809::D_Inherent(const char *mnemo, Byte bytes,
-        std::string &p_code, std::string &p_mnemonic)
+inline void Da6809::D_Inherent(const char *mnemo, Byte bytes)
 {
-    p_code = PrintCode(bytes);
-    p_mnemonic = mnemo;
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
 }
 
 
-void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
-        std::string &p_mnemonic, std::string &p_operands)
+void Da6809::D_Indexed(const char *mnemo, Byte bytes)
 {
     Byte disp;
     Word offset;
@@ -181,7 +271,7 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
     const char *addr_mode = "<"; // addressing mode, "<" for direct, ">" for
                                  // extended addressing.
 
-    p_mnemonic = mnemo;
+    PrintMnemonic(mnemo);
     if ((postbyte & 0x80U) == 0x00U)
     {
         // ,R + 5 Bit Offset
@@ -193,8 +283,8 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
             disp = 0x20 - disp;
         }
 
-        p_code = PrintCode(bytes);
-        p_operands = fmt::format("{}${:02X},{}", sign, disp,
+        PrintCode(bytes);
+        FormatTo(text->operands, "{}${:02X},{}", sign, disp,
                  IndexRegister(postbyte >> 5U));
     }
     else
@@ -202,8 +292,9 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
         switch (postbyte & 0x1FU)
         {
             case 0x00 : // ,R+
-                p_code = PrintCode(bytes);
-                p_operands = fmt::format(",{}+", IndexRegister(postbyte >> 5U));
+                PrintCode(bytes);
+                FormatTo(text->operands, ",{}+",
+                        IndexRegister(postbyte >> 5U));
                 break;
 
             case 0x11 : // [,R++]
@@ -212,14 +303,15 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
                 FALLTHROUGH;
 
             case 0x01 : // ,R++
-                p_code = PrintCode(bytes);
-                p_operands = fmt::format("{},{}++{}",
+                PrintCode(bytes);
+                FormatTo(text->operands, "{},{}++{}",
                         br1, IndexRegister(postbyte >> 5U), br2);
                 break;
 
             case 0x02 : // ,-R
-                p_code = PrintCode(bytes);
-                p_operands = fmt::format(",-{}", IndexRegister(postbyte >> 5U));
+                PrintCode(bytes);
+                FormatTo(text->operands, ",-{}",
+                        IndexRegister(postbyte >> 5U));
                 break;
 
             case 0x13 : // [,R--]
@@ -228,8 +320,8 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
                 FALLTHROUGH;
 
             case 0x03 : // ,--R
-                p_code = PrintCode(bytes);
-                p_operands = fmt::format("{},--{}{}",
+                PrintCode(bytes);
+                FormatTo(text->operands, "{},--{}{}",
                         br1, IndexRegister(postbyte >> 5U), br2);
                 break;
 
@@ -239,8 +331,8 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
                 FALLTHROUGH;
 
             case 0x04 : // ,R
-                p_code = PrintCode(bytes);
-                p_operands = fmt::format("{},{}{}",
+                PrintCode(bytes);
+                FormatTo(text->operands, "{},{}{}",
                         br1, IndexRegister(postbyte >> 5U), br2);
                 break;
 
@@ -250,8 +342,8 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
                 FALLTHROUGH;
 
             case 0x05 : // B,R
-                p_code = PrintCode(bytes);
-                p_operands = fmt::format("{}B,{}{}",
+                PrintCode(bytes);
+                FormatTo(text->operands, "{}B,{}{}",
                         br1, IndexRegister(postbyte >> 5U), br2);
                 break;
 
@@ -261,8 +353,8 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
                 FALLTHROUGH;
 
             case 0x06 : // A,R
-                p_code = PrintCode(bytes);
-                p_operands = fmt::format("{}A,{}{}",
+                PrintCode(bytes);
+                FormatTo(text->operands, "{}A,{}{}",
                         br1, IndexRegister(postbyte >> 5U), br2);
                 break;
 
@@ -280,8 +372,8 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
                     offset = 0x0100 - offset;
                 }
                 extrabytes = 1;
-                p_code = PrintCode(bytes + extrabytes);
-                p_operands = fmt::format("{}{}${:02X},{}{}",
+                PrintCode(bytes + extrabytes);
+                FormatTo(text->operands, "{}{}${:02X},{}{}",
                          br1, sign, offset, IndexRegister(postbyte >> 5U), br2);
                 break;
 
@@ -292,14 +384,14 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
 
             case 0x09 : // ,R + 16 Bit Offset
                 extrabytes = 2;
-                p_code = PrintCode(bytes + extrabytes);
+                PrintCode(bytes + extrabytes);
                 offset = flx::getValueBigEndian<Word>(&memory[2]);
                 if (offset >= 32768)
                 {
                     sign = "-";
                     offset = 0xFFFF - offset + 1;
                 }
-                p_operands = fmt::format("{}{}${:04X},{}{}",
+                FormatTo(text->operands, "{}{}${:04X},{}{}",
                          br1, sign, offset, IndexRegister(postbyte >> 5U), br2);
                 break;
 
@@ -309,8 +401,8 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
                 FALLTHROUGH;
 
             case 0x0b : // D,R
-                p_code = PrintCode(bytes);
-                p_operands = fmt::format("{}D,{}{}",
+                PrintCode(bytes);
+                FormatTo(text->operands, "{}D,{}{}",
                         br1, IndexRegister(postbyte >> 5U), br2);
                 break;
 
@@ -322,8 +414,8 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
             case 0x0c : // ,PC + 8 Bit Offset
                 offset = (EXTEND8(*(memory + 2)) + pc + 3U) & 0xFFFFU;
                 extrabytes = 1;
-                p_code = PrintCode(bytes + extrabytes);
-                p_operands = fmt::format("{}{}${:02X},PCR{}",
+                PrintCode(bytes + extrabytes);
+                FormatTo(text->operands, "{}{}${:02X},PCR{}",
                          br1, addr_mode, offset, br2);
                 break;
 
@@ -337,8 +429,8 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
                          & 0xFFFFU;
                 addr_mode = ">";
                 extrabytes = 2;
-                p_code = PrintCode(bytes + extrabytes);
-                p_operands = fmt::format("{}{}${:04X},PCR{}",
+                PrintCode(bytes + extrabytes);
+                FormatTo(text->operands, "{}{}${:04X},PCR{}",
                          br1, addr_mode, offset, br2);
                 break;
 
@@ -349,42 +441,31 @@ void Da6809::D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
                     br2 = "]";
                     offset = flx::getValueBigEndian<Word>(&memory[2]);
                     extrabytes = 2;
-                    p_code = PrintCode(bytes + extrabytes);
-                    p_operands = fmt::format("{}${:04X}{}", br1, offset, br2);
+                    PrintCode(bytes + extrabytes);
+                    FormatTo(text->operands, "{}${:04X}{}", br1, offset, br2);
                     break;
                 }
                 FALLTHROUGH;
 
             default:
-                p_code = PrintCode(bytes);
-                p_operands = "????";
+                PrintCode(bytes);
+                FormatTo(text->operands, "????");
         }
     }
 }
 
 
-inline void Da6809::D_Extended(const char *mnemo, Byte bytes,
-        std::string &p_code, std::string &p_mnemonic, std::string &p_operands)
+inline void Da6809::D_Extended(const char *mnemo, Byte bytes)
 {
     const auto offset = flx::getValueBigEndian<Word>(&memory[bytes - 2]);
 
-    p_code = PrintCode(bytes);
-    const auto *label = FlexLabel(offset);
-    p_mnemonic = mnemo;
-
-    if (label == nullptr)
-    {
-        p_operands = fmt::format("${:04X}", offset);
-    }
-    else
-    {
-        p_operands = label;
-    }
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
+    D_AddressOperand("", offset);
 }
 
 inline void Da6809::D_Relative8(const char *mnemo, Byte bytes,
-        DWord &p_jumpaddr, std::string &p_code, std::string &p_mnemonic,
-        std::string &p_operands)
+        DWord &p_jumpaddr)
 {
     Word disp{};
     const auto offset = *(memory + bytes - 1);
@@ -399,23 +480,13 @@ inline void Da6809::D_Relative8(const char *mnemo, Byte bytes,
     }
     p_jumpaddr = disp;
 
-    p_code = PrintCode(bytes);
-    const auto *label = FlexLabel(disp);
-    p_mnemonic = mnemo;
-
-    if (label == nullptr)
-    {
-        p_operands = fmt::format("${:04X}", disp);
-    }
-    else
-    {
-        p_operands = label;
-    }
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
+    D_AddressOperand("", disp);
 }
 
 inline void Da6809::D_Relative16(const char *mnemo, Byte bytes,
-        DWord &p_jumpaddr, std::string &p_code, std::string &p_mnemonic,
-        std::string &p_operands)
+        DWord &p_jumpaddr)
 {
     const auto offset = flx::getValueBigEndian<Word>(&memory[bytes - 2]);
 
@@ -428,65 +499,52 @@ inline void Da6809::D_Relative16(const char *mnemo, Byte bytes,
         p_jumpaddr = pc + bytes - (65536 - offset);
     }
 
-    p_code = PrintCode(bytes);
-    const auto address = static_cast<Word>(p_jumpaddr);
-    const auto *label = FlexLabel(address);
-    p_mnemonic = mnemo;
-
-    if (label == nullptr)
-    {
-        p_operands = fmt::format("${:04X}", address);
-    }
-    else
-    {
-        p_operands = label;
-    }
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
+    D_AddressOperand("", static_cast<Word>(p_jumpaddr));
 }
 
-inline void Da6809::D_RegisterRegister(const char *mnemo, Byte bytes,
-        std::string &p_code, std::string &p_mnemonic, std::string &p_operands)
+inline void Da6809::D_RegisterRegister(const char *mnemo, Byte bytes)
 {
     const auto postbyte = *(memory + 1);
 
-    p_code = PrintCode(bytes);
-    p_mnemonic = mnemo;
-    p_operands = fmt::format("{},{}",
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
+    FormatTo(text->operands, "{},{}",
              InterRegister(postbyte >> 4U),
              InterRegister(postbyte & 0x0FU));
 }
 
 inline void Da6809::D_RegisterList(const char *mnemo, const char *ns_reg,
-        Byte bytes, std::string &p_code, std::string &p_mnemonic,
-        std::string &p_operands)
+        Byte bytes)
 {
     const auto postbyte = *(memory + 1);
 
-    p_code = PrintCode(bytes);
-    p_mnemonic = mnemo;
+    PrintCode(bytes);
+    PrintMnemonic(mnemo);
 
     if (postbyte == 0)
     {
-        p_operands = "??";
+        FormatTo(text->operands, "??");
     }
     else
     {
         bool withComma = false;
 
-        p_operands = "";
+        text->operands[0] = '\0';
         for (Byte i = 0; i < 8; i++)
         {
             if (postbyte & (1U << i))
             {
-                p_operands.append(withComma ? "," : "");
-                p_operands.append(StackRegister(i, ns_reg));
+                AppendTo(text->operands, withComma ? "," : "");
+                AppendTo(text->operands, StackRegister(i, ns_reg));
                 withComma = true;
             }
         }
     }
 }
 
-inline InstFlg Da6809::D_Page2(InstFlg p_flags, DWord &p_jumpaddr,
-        std::string &p_code, std::string &p_mnemonic, std::string &p_operands)
+inline InstFlg Da6809::D_Page2(InstFlg p_flags, DWord &p_jumpaddr)
 {
     const auto code = *(memory + 1);
 
@@ -494,192 +552,191 @@ inline InstFlg Da6809::D_Page2(InstFlg p_flags, DWord &p_jumpaddr,
     {
         case 0x21:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBRN", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBRN", 4, p_jumpaddr);
             break;
 
         case 0x22:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBHI", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBHI", 4, p_jumpaddr);
             break;
 
         case 0x23:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBLS", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBLS", 4, p_jumpaddr);
             break;
 
         case 0x24:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBCC", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBCC", 4, p_jumpaddr);
             break;
 
         case 0x25:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBCS", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBCS", 4, p_jumpaddr);
             break;
 
         case 0x26:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBNE", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBNE", 4, p_jumpaddr);
             break;
 
         case 0x27:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBEQ", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBEQ", 4, p_jumpaddr);
             break;
 
         case 0x28:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBVC", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBVC", 4, p_jumpaddr);
             break;
 
         case 0x29:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBVS", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBVS", 4, p_jumpaddr);
             break;
 
         case 0x2a:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBPL", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBPL", 4, p_jumpaddr);
             break;
 
         case 0x2b:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBMI", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBMI", 4, p_jumpaddr);
             break;
 
         case 0x2c:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBGE", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBGE", 4, p_jumpaddr);
             break;
 
         case 0x2d:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBLT", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBLT", 4, p_jumpaddr);
             break;
 
         case 0x2e:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBGT", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBGT", 4, p_jumpaddr);
             break;
 
         case 0x2f:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative16("LBLE", 4, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBLE", 4, p_jumpaddr);
             break;
 
         case 0x3f:
             p_flags |= InstFlg::Sub;
-            D_Inherent("SWI2", 2, p_code, p_mnemonic);
+            D_Inherent("SWI2", 2);
             break;
 
         case 0x83:
             p_flags |= InstFlg::LabelAddr;
-            D_Immediate16("CMPD", 4, p_code, p_mnemonic, p_operands);
+            D_Immediate16("CMPD", 4);
             break;
 
         case 0x8c:
             p_flags |= InstFlg::LabelAddr;
-            D_Immediate16("CMPY", 4, p_code, p_mnemonic, p_operands);
+            D_Immediate16("CMPY", 4);
             break;
 
         case 0x8e:
             p_flags |= InstFlg::LabelAddr;
-            D_Immediate16("LDY", 4, p_code, p_mnemonic, p_operands);
+            D_Immediate16("LDY", 4);
             break;
 
         case 0x93:
-            D_Direct("CMPD", 3, p_code, p_mnemonic, p_operands);
+            D_Direct("CMPD", 3);
             break;
 
         case 0x9c:
-            D_Direct("CMPY", 3, p_code, p_mnemonic, p_operands);
+            D_Direct("CMPY", 3);
             break;
 
         case 0x9e:
-            D_Direct("LDY", 3, p_code, p_mnemonic, p_operands);
+            D_Direct("LDY", 3);
             break;
 
         case 0x9f:
-            D_Direct("STY", 3, p_code, p_mnemonic, p_operands);
+            D_Direct("STY", 3);
             break;
 
         case 0xa3:
-            D_Indexed("CMPD", 3, p_code, p_mnemonic, p_operands);
+            D_Indexed("CMPD", 3);
             break;
 
         case 0xac:
-            D_Indexed("CMPY", 3, p_code, p_mnemonic, p_operands);
+            D_Indexed("CMPY", 3);
             break;
 
         case 0xae:
-            D_Indexed("LDY", 3, p_code, p_mnemonic, p_operands);
+            D_Indexed("LDY", 3);
             break;
 
         case 0xaf:
-            D_Indexed("STY", 3, p_code, p_mnemonic, p_operands);
+            D_Indexed("STY", 3);
             break;
 
         case 0xb3:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("CMPD", 4, p_code, p_mnemonic, p_operands);
+            D_Extended("CMPD", 4);
             break;
 
         case 0xbc:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("CMPY", 4, p_code, p_mnemonic, p_operands);
+            D_Extended("CMPY", 4);
             break;
 
         case 0xbe:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("LDY", 4, p_code, p_mnemonic, p_operands);
+            D_Extended("LDY", 4);
             break;
 
         case 0xbf:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("STY", 4, p_code, p_mnemonic, p_operands);
+            D_Extended("STY", 4);
             break;
 
         case 0xce:
             p_flags |= InstFlg::LabelAddr;
-            D_Immediate16("LDS", 4, p_code, p_mnemonic, p_operands);
+            D_Immediate16("LDS", 4);
             break;
 
         case 0xde:
-            D_Direct("LDS", 3, p_code, p_mnemonic, p_operands);
+            D_Direct("LDS", 3);
             break;
 
         case 0xdf:
-            D_Direct("STS", 3, p_code, p_mnemonic, p_operands);
+            D_Direct("STS", 3);
             break;
 
         case 0xee:
-            D_Indexed("LDS", 3, p_code, p_mnemonic, p_operands);
+            D_Indexed("LDS", 3);
             break;
 
         case 0xef:
-            D_Indexed("STS", 3, p_code, p_mnemonic, p_operands);
+            D_Indexed("STS", 3);
             break;
 
         case 0xfe:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("LDS", 4, p_code, p_mnemonic, p_operands);
+            D_Extended("LDS", 4);
             break;
 
         case 0xff:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("STS", 4, p_code, p_mnemonic, p_operands);
+            D_Extended("STS", 4);
             break;
 
         default:
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
     }
 
     return p_flags;
 }
 
 
-inline InstFlg Da6809::D_Page3(InstFlg p_flags, std::string &p_code,
-        std::string &p_mnemonic, std::string &p_operands)
+inline InstFlg Da6809::D_Page3(InstFlg p_flags)
 {
     const auto code = *(memory + 1);
 
@@ -687,45 +744,45 @@ inline InstFlg Da6809::D_Page3(InstFlg p_flags, std::string &p_code,
     {
         case 0x3f:
             p_flags |= InstFlg::Sub;
-            D_Inherent("SWI3", 2, p_code, p_mnemonic);
+            D_Inherent("SWI3", 2);
             break;
 
         case 0x83:
             p_flags |= InstFlg::LabelAddr;
-            D_Immediate16("CMPU", 4, p_code, p_mnemonic, p_operands);
+            D_Immediate16("CMPU", 4);
             break;
 
         case 0x8c:
             p_flags |= InstFlg::LabelAddr;
-            D_Immediate16("CMPS", 4, p_code, p_mnemonic, p_operands);
+            D_Immediate16("CMPS", 4);
             break;
 
         case 0x93:
-            D_Direct("CMPU", 3, p_code, p_mnemonic, p_operands);
+            D_Direct("CMPU", 3);
             break;
 
         case 0x9c:
-            D_Direct("CMPS", 3, p_code, p_mnemonic, p_operands);
+            D_Direct("CMPS", 3);
             break;
 
         case 0xa3:
-            D_Indexed("CMPU", 3, p_code, p_mnemonic, p_operands);
+            D_Indexed("CMPU", 3);
             break;
 
         case 0xac:
-            D_Indexed("CMPS", 3, p_code, p_mnemonic, p_operands);
+            D_Indexed("CMPS", 3);
             break;
 
         case 0xb3:
-            D_Extended("CMPU", 4, p_code, p_mnemonic, p_operands);
+            D_Extended("CMPU", 4);
             break;
 
         case 0xbc:
-            D_Extended("CMPS", 4, p_code, p_mnemonic, p_operands);
+            D_Extended("CMPS", 4);
             break;
 
         default:
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
     }
     return p_flags;
 }
@@ -737,1197 +794,1216 @@ InstFlg Da6809::Disassemble(
         std::string &p_code,
         std::string &p_mnemonic,
         std::string &p_operands)
+{
+    DisassemblyText p_text;
+
+    const auto p_flags = Disassemble(p_memory, p_pc, p_jumpaddr, p_text);
+    p_code = p_text.code.data();
+    p_mnemonic = p_text.mnemonic.data();
+    p_operands = p_text.operands.data();
+
+    return p_flags;
+}
+
+InstFlg Da6809::Disassemble(
+        const Byte *p_memory,
+        DWord p_pc,
+        DWord &p_jumpaddr,
+        DisassemblyText &p_text)
 {
     pc = static_cast<Word>(p_pc);
     memory = p_memory;
+    text = &p_text;
     auto p_flags = InstFlg::NONE;
     const auto opcode = *memory;
-    p_operands.clear();
+    text->code[0] = '\0';
+    text->mnemonic[0] = '\0';
+    text->operands[0] = '\0';
 
     switch (opcode)
     {
         case 0x01:
             if (use_undocumented)
             {
-                D_Direct("neg", 2, p_code, p_mnemonic, p_operands);
+                D_Direct("neg", 2);
                 break;
             }
 
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
 
         case 0x00:
-            D_Direct("NEG", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("NEG", 2);
             break;
 
         case 0x02:
             if (use_undocumented)
             {
-                D_Direct("negcom", 2, p_code, p_mnemonic, p_operands);
+                D_Direct("negcom", 2);
                 break;
             }
 
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
 
         case 0x03:
-            D_Direct("COM", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("COM", 2);
             break;
 
         case 0x04:
-            D_Direct("LSR", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("LSR", 2);
             break;
 
         case 0x05:
             if (use_undocumented)
             {
-                D_Direct("lsr", 2, p_code, p_mnemonic, p_operands);
+                D_Direct("lsr", 2);
                 break;
             }
 
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
 
         case 0x06:
-            D_Direct("ROR", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ROR", 2);
             break;
 
         case 0x07:
-            D_Direct("ASR", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ASR", 2);
             break;
 
         case 0x08:
-            D_Direct("LSL", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("LSL", 2);
             break;
 
         case 0x09:
-            D_Direct("ROL", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ROL", 2);
             break;
 
         case 0x0a:
-            D_Direct("DEC", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("DEC", 2);
             break;
 
         case 0x0b:
             if (use_undocumented)
             {
-                D_Direct("dec", 2, p_code, p_mnemonic, p_operands);
+                D_Direct("dec", 2);
                 break;
             }
 
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
 
         case 0x0c:
-            D_Direct("INC", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("INC", 2);
             break;
 
         case 0x0d:
-            D_Direct("TST", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("TST", 2);
             break;
 
         case 0x0e:
             p_flags |= InstFlg::Jump;
-            D_Direct("JMP", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("JMP", 2);
             break;
 
         case 0x0f:
-            D_Direct("CLR", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("CLR", 2);
             break;
 
         case PAGE2:
-            return D_Page2(p_flags, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            return D_Page2(p_flags, p_jumpaddr);
 
         case PAGE3:
-            return D_Page3(p_flags, p_code, p_mnemonic, p_operands);
+            return D_Page3(p_flags);
 
         case 0x12:
             p_flags |= InstFlg::Noop;
-            D_Inherent("NOP", 1, p_code, p_mnemonic);
+            D_Inherent("NOP", 1);
             break;
 
         case 0x13:
             p_flags |= InstFlg::Jump;
-            D_Inherent("SYNC", 1, p_code, p_mnemonic);
+            D_Inherent("SYNC", 1);
             break;
 
         // 0x14, 0x15 is illegal
         case 0x16:
             p_flags |= InstFlg::Jump | InstFlg::JumpAddr;
-            D_Relative16("LBRA", 3, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBRA", 3, p_jumpaddr);
             break;
 
         case 0x17:
             p_flags |= InstFlg::Sub | InstFlg::LabelAddr;
-            D_Relative16("LBSR", 3, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative16("LBSR", 3, p_jumpaddr);
             break;
 
         case 0x19:
-            D_Inherent("DAA", 1, p_code, p_mnemonic);
+            D_Inherent("DAA", 1);
             break;
 
         case 0x1a:
-            D_Immediate8("ORCC", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ORCC", 2);
             break;
 
         case 0x1c:
-            D_Immediate8("ANDCC", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ANDCC", 2);
             break;
 
         case 0x1d:
-            D_Inherent("SEX", 1, p_code, p_mnemonic);
+            D_Inherent("SEX", 1);
             break;
 
         case 0x1e:
-            D_RegisterRegister("EXG", 2, p_code, p_mnemonic, p_operands);
+            D_RegisterRegister("EXG", 2);
             break;
 
         case 0x1f:
-            D_RegisterRegister("TFR", 2, p_code, p_mnemonic, p_operands);
+            D_RegisterRegister("TFR", 2);
             break;
 
         case 0x20:
             p_flags |= InstFlg::Jump | InstFlg::JumpAddr;
-            D_Relative8("BRA", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BRA", 2, p_jumpaddr);
             break;
 
         case 0x21:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BRN", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BRN", 2, p_jumpaddr);
             break;
 
         case 0x22:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BHI", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BHI", 2, p_jumpaddr);
             break;
 
         case 0x23:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BLS", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BLS", 2, p_jumpaddr);
             break;
 
         case 0x24:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BCC", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BCC", 2, p_jumpaddr);
             break;
 
         case 0x25:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BCS", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BCS", 2, p_jumpaddr);
             break;
 
         case 0x26:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BNE", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BNE", 2, p_jumpaddr);
             break;
 
         case 0x27:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BEQ", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BEQ", 2, p_jumpaddr);
             break;
 
         case 0x28:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BVC", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BVC", 2, p_jumpaddr);
             break;
 
         case 0x29:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BVS", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BVS", 2, p_jumpaddr);
             break;
 
         case 0x2a:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BPL", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BPL", 2, p_jumpaddr);
             break;
 
         case 0x2b:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BMI", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BMI", 2, p_jumpaddr);
             break;
 
         case 0x2c:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BGE", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BGE", 2, p_jumpaddr);
             break;
 
         case 0x2d:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BLT", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BLT", 2, p_jumpaddr);
             break;
 
         case 0x2e:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BGT", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BGT", 2, p_jumpaddr);
             break;
 
         case 0x2f:
             p_flags |= InstFlg::JumpAddr;
-            D_Relative8("BLE", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BLE", 2, p_jumpaddr);
             break;
 
         case 0x30:
-            D_Indexed("LEAX", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LEAX", 2);
             break;
 
         case 0x31:
-            D_Indexed("LEAY", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LEAY", 2);
             break;
 
         case 0x32:
-            D_Indexed("LEAS", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LEAS", 2);
             break;
 
         case 0x33:
-            D_Indexed("LEAU", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LEAU", 2);
             break;
 
         case 0x34:
-            D_RegisterList("PSHS", "U", 2, p_code, p_mnemonic, p_operands);
+            D_RegisterList("PSHS", "U", 2);
             break;
 
         case 0x35:
-            D_RegisterList("PULS", "U", 2, p_code, p_mnemonic, p_operands);
+            D_RegisterList("PULS", "U", 2);
             break;
 
         case 0x36:
-            D_RegisterList("PSHU", "S", 2, p_code, p_mnemonic, p_operands);
+            D_RegisterList("PSHU", "S", 2);
             break;
 
         case 0x37:
-            D_RegisterList("PULU", "S", 2, p_code, p_mnemonic, p_operands);
+            D_RegisterList("PULU", "S", 2);
             break;
 
         // 0x38 is illegal
         case 0x39:
             p_flags |= InstFlg::Jump;
-            D_Inherent("RTS", 1, p_code, p_mnemonic);
+            D_Inherent("RTS", 1);
             break;
 
         case 0x3a:
-            D_Inherent("ABX", 1, p_code, p_mnemonic);
+            D_Inherent("ABX", 1);
             break;
 
         case 0x3b:
             p_flags |= InstFlg::Jump;
-            D_Inherent("RTI", 1, p_code, p_mnemonic);
+            D_Inherent("RTI", 1);
             break;
 
         case 0x3c:
             p_flags |= InstFlg::Jump;
-            D_Immediate8("CWAI", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("CWAI", 2);
             break;
 
         case 0x3d:
-            D_Inherent("MUL", 1, p_code, p_mnemonic);
+            D_Inherent("MUL", 1);
             break;
 
         case 0x3e:
             if (use_undocumented)
             {
-                D_Inherent("reset", 1, p_code, p_mnemonic);
+                D_Inherent("reset", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x3f:
             p_flags |= InstFlg::Sub;
-            D_Inherent("SWI", 1, p_code, p_mnemonic);
+            D_Inherent("SWI", 1);
             break;
 
         case 0x40:
-            D_Inherent("NEGA", 1, p_code, p_mnemonic);
+            D_Inherent("NEGA", 1);
             break;
 
         case 0x41:
             if (use_undocumented)
             {
-                D_Inherent("nega", 1, p_code, p_mnemonic);
+                D_Inherent("nega", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x42:
             if (use_undocumented)
             {
-                D_Inherent("negcoma", 1, p_code, p_mnemonic);
+                D_Inherent("negcoma", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x43:
-            D_Inherent("COMA", 1, p_code, p_mnemonic);
+            D_Inherent("COMA", 1);
             break;
 
         case 0x44:
-            D_Inherent("LSRA", 1, p_code, p_mnemonic);
+            D_Inherent("LSRA", 1);
             break;
 
         case 0x45:
             if (use_undocumented)
             {
-                D_Inherent("lsra", 1, p_code, p_mnemonic);
+                D_Inherent("lsra", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x46:
-            D_Inherent("RORA", 1, p_code, p_mnemonic);
+            D_Inherent("RORA", 1);
             break;
 
         case 0x47:
-            D_Inherent("ASRA", 1, p_code, p_mnemonic);
+            D_Inherent("ASRA", 1);
             break;
 
         case 0x48:
-            D_Inherent("LSLA", 1, p_code, p_mnemonic);
+            D_Inherent("LSLA", 1);
             break;
 
         case 0x49:
-            D_Inherent("ROLA", 1, p_code, p_mnemonic);
+            D_Inherent("ROLA", 1);
             break;
 
         case 0x4a:
-            D_Inherent("DECA", 1, p_code, p_mnemonic);
+            D_Inherent("DECA", 1);
             break;
 
         case 0x4b:
             if (use_undocumented)
             {
-                D_Inherent("deca", 1, p_code, p_mnemonic);
+                D_Inherent("deca", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x4c:
-            D_Inherent("INCA", 1, p_code, p_mnemonic);
+            D_Inherent("INCA", 1);
             break;
 
         case 0x4d:
-            D_Inherent("TSTA", 1, p_code, p_mnemonic);
+            D_Inherent("TSTA", 1);
             break;
 
         case 0x4e:
             if (use_undocumented)
             {
-                D_Inherent("clra", 1, p_code, p_mnemonic);
+                D_Inherent("clra", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x4f:
-            D_Inherent("CLRA", 1, p_code, p_mnemonic);
+            D_Inherent("CLRA", 1);
             break;
 
         case 0x50:
-            D_Inherent("NEGB", 1, p_code, p_mnemonic);
+            D_Inherent("NEGB", 1);
             break;
 
         case 0x51:
             if (use_undocumented)
             {
-                D_Inherent("negb", 1, p_code, p_mnemonic);
+                D_Inherent("negb", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x52:
             if (use_undocumented)
             {
-                D_Inherent("negcomb", 1, p_code, p_mnemonic);
+                D_Inherent("negcomb", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x53:
-            D_Inherent("COMB", 1, p_code, p_mnemonic);
+            D_Inherent("COMB", 1);
             break;
 
         case 0x54:
-            D_Inherent("LSRB", 1, p_code, p_mnemonic);
+            D_Inherent("LSRB", 1);
             break;
 
         case 0x55:
             if (use_undocumented)
             {
-                D_Inherent("lsrb", 1, p_code, p_mnemonic);
+                D_Inherent("lsrb", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x56:
-            D_Inherent("RORB", 1, p_code, p_mnemonic);
+            D_Inherent("RORB", 1);
             break;
 
         case 0x57:
-            D_Inherent("ASRB", 1, p_code, p_mnemonic);
+            D_Inherent("ASRB", 1);
             break;
 
         case 0x58:
-            D_Inherent("LSLB", 1, p_code, p_mnemonic);
+            D_Inherent("LSLB", 1);
             break;
 
         case 0x59:
-            D_Inherent("ROLB", 1, p_code, p_mnemonic);
+            D_Inherent("ROLB", 1);
             break;
 
         case 0x5a:
-            D_Inherent("DECB", 1, p_code, p_mnemonic);
+            D_Inherent("DECB", 1);
             break;
 
         case 0x5b:
             if (use_undocumented)
             {
-                D_Inherent("decb", 1, p_code, p_mnemonic);
+                D_Inherent("decb", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x5c:
-            D_Inherent("INCB", 1, p_code, p_mnemonic);
+            D_Inherent("INCB", 1);
             break;
 
         case 0x5d:
-            D_Inherent("TSTB", 1, p_code, p_mnemonic);
+            D_Inherent("TSTB", 1);
             break;
 
         case 0x5e:
             if (use_undocumented)
             {
-                D_Inherent("clrb", 1, p_code, p_mnemonic);
+                D_Inherent("clrb", 1);
                 break;
             }
 
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
 
         case 0x5f:
-            D_Inherent("CLRB", 1, p_code, p_mnemonic);
+            D_Inherent("CLRB", 1);
             break;
 
         case 0x60:
-            D_Indexed("NEG", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("NEG", 2);
             break;
 
         case 0x61:
             if (use_undocumented)
             {
-                D_Indexed("neg", 2, p_code, p_mnemonic, p_operands);
+                D_Indexed("neg", 2);
                 break;
             }
 
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
 
         case 0x62:
             if (use_undocumented)
             {
-                D_Indexed("negcom", 2, p_code, p_mnemonic, p_operands);
+                D_Indexed("negcom", 2);
                 break;
             }
 
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
 
         case 0x63:
-            D_Indexed("COM", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("COM", 2);
             break;
 
         case 0x64:
-            D_Indexed("LSR", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LSR", 2);
             break;
 
         case 0x65:
             if (use_undocumented)
             {
-                D_Indexed("lsr", 2, p_code, p_mnemonic, p_operands);
+                D_Indexed("lsr", 2);
                 break;
             }
 
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
 
         case 0x66:
-            D_Indexed("ROR", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ROR", 2);
             break;
 
         case 0x67:
-            D_Indexed("ASR", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ASR", 2);
             break;
 
         case 0x68:
-            D_Indexed("LSL", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LSL", 2);
             break;
 
         case 0x69:
-            D_Indexed("ROL", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ROL", 2);
             break;
 
         case 0x6a:
-            D_Indexed("DEC", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("DEC", 2);
             break;
 
         case 0x6b:
             if (use_undocumented)
             {
-                D_Indexed("dec", 2, p_code, p_mnemonic, p_operands);
+                D_Indexed("dec", 2);
                 break;
             }
 
-            return D_Illegal("", 2, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 2);
 
         case 0x6c:
-            D_Indexed("INC", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("INC", 2);
             break;
 
         case 0x6d:
-            D_Indexed("TST", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("TST", 2);
             break;
 
         case 0x6e:
             p_flags |= InstFlg::Jump | InstFlg::ComputedGoto;
-            D_Indexed("JMP", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("JMP", 2);
             break;
 
         case 0x6f:
-            D_Indexed("CLR", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("CLR", 2);
             break;
 
         case 0x70:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("NEG", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("NEG", 3);
             break;
 
         case 0x71:
             if (use_undocumented)
             {
                 p_flags |= InstFlg::LabelAddr;
-                D_Extended("neg", 3, p_code, p_mnemonic, p_operands);
+                D_Extended("neg", 3);
                 break;
             };
 
-            return D_Illegal("", 3, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 3);
 
         case 0x72:
             if (use_undocumented)
             {
                 p_flags |= InstFlg::LabelAddr;
-                D_Extended("negcom", 3, p_code, p_mnemonic, p_operands);
+                D_Extended("negcom", 3);
                 break;
             };
 
-            return D_Illegal("", 3, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 3);
 
         case 0x73:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("COM", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("COM", 3);
             break;
 
         case 0x74:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("LSR", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("LSR", 3);
             break;
 
         case 0x75:
             if (use_undocumented)
             {
                 p_flags |= InstFlg::LabelAddr;
-                D_Extended("lsr", 3, p_code, p_mnemonic, p_operands);
+                D_Extended("lsr", 3);
                 break;
             };
 
-            return D_Illegal("", 3, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 3);
 
         case 0x76:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ROR", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ROR", 3);
             break;
 
         case 0x77:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ASR", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ASR", 3);
             break;
 
         case 0x78:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("LSL", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("LSL", 3);
             break;
 
         case 0x79:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ROL", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ROL", 3);
             break;
 
         case 0x7a:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("DEC", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("DEC", 3);
             break;
 
         case 0x7b:
             if (use_undocumented)
             {
                 p_flags |= InstFlg::LabelAddr;
-                D_Extended("dec", 3, p_code, p_mnemonic, p_operands);
+                D_Extended("dec", 3);
                 break;
             };
 
-            return D_Illegal("", 3, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 3);
 
         case 0x7c:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("INC", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("INC", 3);
             break;
 
         case 0x7d:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("TST", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("TST", 3);
             break;
 
         case 0x7e:
             p_flags |= InstFlg::Jump;
-            D_Extended("JMP", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("JMP", 3);
             break;
 
         case 0x7f:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("CLR", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("CLR", 3);
             break;
 
         case 0x80:
-            D_Immediate8("SUBA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("SUBA", 2);
             break;
 
         case 0x81:
-            D_Immediate8("CMPA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("CMPA", 2);
             break;
 
         case 0x82:
-            D_Immediate8("SBCA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("SBCA", 2);
             break;
 
         case 0x83:
-            D_Immediate16("SUBD", 3, p_code, p_mnemonic, p_operands);
+            D_Immediate16("SUBD", 3);
             break;
 
         case 0x84:
-            D_Immediate8("ANDA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ANDA", 2);
             break;
 
         case 0x85:
-            D_Immediate8("BITA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("BITA", 2);
             break;
 
         case 0x86:
-            D_Immediate8("LDA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("LDA", 2);
             break;
 
         // 0x87 is illegal
         case 0x88:
-            D_Immediate8("EORA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("EORA", 2);
             break;
 
         case 0x89:
-            D_Immediate8("ADCA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ADCA", 2);
             break;
 
         case 0x8a:
-            D_Immediate8("ORA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ORA", 2);
             break;
 
         case 0x8b:
-            D_Immediate8("ADDA", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ADDA", 2);
             break;
 
         case 0x8c:
-            D_Immediate16("CMPX", 3, p_code, p_mnemonic, p_operands);
+            D_Immediate16("CMPX", 3);
             break;
 
         case 0x8d:
             p_flags |= InstFlg::Sub;
-            D_Relative8("BSR", 2, p_jumpaddr, p_code, p_mnemonic, p_operands);
+            D_Relative8("BSR", 2, p_jumpaddr);
             break;
 
         case 0x8e:
-            D_Immediate16("LDX", 3, p_code, p_mnemonic, p_operands);
+            D_Immediate16("LDX", 3);
             break;
 
         case 0x90:
-            D_Direct("SUBA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("SUBA", 2);
             break;
 
         case 0x91:
-            D_Direct("CMPA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("CMPA", 2);
             break;
 
         case 0x92:
-            D_Direct("SBCA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("SBCA", 2);
             break;
 
         case 0x93:
-            D_Direct("SUBD", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("SUBD", 2);
             break;
 
         case 0x94:
-            D_Direct("ANDA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ANDA", 2);
             break;
 
         case 0x95:
-            D_Direct("BITA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("BITA", 2);
             break;
 
         case 0x96:
-            D_Direct("LDA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("LDA", 2);
             break;
 
         case 0x97:
-            D_Direct("STA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("STA", 2);
             break;
 
         case 0x98:
-            D_Direct("EORA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("EORA", 2);
             break;
 
         case 0x99:
-            D_Direct("ADCA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ADCA", 2);
             break;
 
         case 0x9a:
-            D_Direct("ORA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ORA", 2);
             break;
 
         case 0x9b:
-            D_Direct("ADDA", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ADDA", 2);
             break;
 
         case 0x9c:
-            D_Direct("CMPX", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("CMPX", 2);
             break;
 
         case 0x9d:
             p_flags |= InstFlg::Sub;
-            D_Direct("JSR", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("JSR", 2);
             break;
 
         case 0x9e:
-            D_Direct("LDX", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("LDX", 2);
             break;
 
         case 0x9f:
-            D_Direct("STX", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("STX", 2);
             break;
 
         case 0xa0:
-            D_Indexed("SUBA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("SUBA", 2);
             break;
 
         case 0xa1:
-            D_Indexed("CMPA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("CMPA", 2);
             break;
 
         case 0xa2:
-            D_Indexed("SBCA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("SBCA", 2);
             break;
 
         case 0xa3:
-            D_Indexed("SUBD", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("SUBD", 2);
             break;
 
         case 0xa4:
-            D_Indexed("ANDA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ANDA", 2);
             break;
 
         case 0xa5:
-            D_Indexed("BITA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("BITA", 2);
             break;
 
         case 0xa6:
-            D_Indexed("LDA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LDA", 2);
             break;
 
         case 0xa7:
-            D_Indexed("STA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("STA", 2);
             break;
 
         case 0xa8:
-            D_Indexed("EORA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("EORA", 2);
             break;
 
         case 0xa9:
-            D_Indexed("ADCA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ADCA", 2);
             break;
 
         case 0xaa:
-            D_Indexed("ORA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ORA", 2);
             break;
 
         case 0xab:
-            D_Indexed("ADDA", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ADDA", 2);
             break;
 
         case 0xac:
-            D_Indexed("CMPX", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("CMPX", 2);
             break;
 
         case 0xad:
             p_flags |= InstFlg::Sub | InstFlg::ComputedGoto;
-            D_Indexed("JSR", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("JSR", 2);
             break;
 
         case 0xae:
-            D_Indexed("LDX", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LDX", 2);
             break;
 
         case 0xaf:
-            D_Indexed("STX", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("STX", 2);
             break;
 
         case 0xb0:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("SUBA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("SUBA", 3);
             break;
 
         case 0xb1:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("CMPA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("CMPA", 3);
             break;
 
         case 0xb2:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("SBCA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("SBCA", 3);
             break;
 
         case 0xb3:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("SUBD", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("SUBD", 3);
             break;
 
         case 0xb4:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ANDA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ANDA", 3);
             break;
 
         case 0xb5:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("BITA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("BITA", 3);
             break;
 
         case 0xb6:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("LDA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("LDA", 3);
             break;
 
         case 0xb7:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("STA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("STA", 3);
             break;
 
         case 0xb8:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("EORA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("EORA", 3);
             break;
 
         case 0xb9:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ADCA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ADCA", 3);
             break;
 
         case 0xba:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ORA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ORA", 3);
             break;
 
         case 0xbb:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ADDA", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ADDA", 3);
             break;
 
         case 0xbc:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("CMPX", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("CMPX", 3);
             break;
 
         case 0xbd:
             p_flags |= InstFlg::Sub | InstFlg::JumpAddr;
-            D_Extended("JSR", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("JSR", 3);
             break;
 
         case 0xbe:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("LDX", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("LDX", 3);
             break;
 
         case 0xbf:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("STX", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("STX", 3);
             break;
 
         case 0xc0:
-            D_Immediate8("SUBB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("SUBB", 2);
             break;
 
         case 0xc1:
-            D_Immediate8("CMPB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("CMPB", 2);
             break;
 
         case 0xc2:
-            D_Immediate8("SBCB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("SBCB", 2);
             break;
 
         case 0xc3:
             p_flags |= InstFlg::LabelAddr;
-            D_Immediate16("ADDD", 3, p_code, p_mnemonic, p_operands);
+            D_Immediate16("ADDD", 3);
             break;
 
         case 0xc4:
-            D_Immediate8("ANDB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ANDB", 2);
             break;
 
         case 0xc5:
-            D_Immediate8("BITB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("BITB", 2);
             break;
 
         case 0xc6:
-            D_Immediate8("LDB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("LDB", 2);
             break;
 
         case 0xc8:
-            D_Immediate8("EORB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("EORB", 2);
             break;
 
         case 0xc9:
-            D_Immediate8("ADCB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ADCB", 2);
             break;
 
         case 0xca:
-            D_Immediate8("ORB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ORB", 2);
             break;
 
         case 0xcb:
-            D_Immediate8("ADDB", 2, p_code, p_mnemonic, p_operands);
+            D_Immediate8("ADDB", 2);
             break;
 
         case 0xcc:
             p_flags |= InstFlg::LabelAddr;
-            D_Immediate16("LDD", 3, p_code, p_mnemonic, p_operands);
+            D_Immediate16("LDD", 3);
             break;
 
         case 0xce:
             p_flags |= InstFlg::LabelAddr;
-            D_Immediate16("LDU", 3, p_code, p_mnemonic, p_operands);
+            D_Immediate16("LDU", 3);
             break;
 
         case 0xd0:
-            D_Direct("SUBB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("SUBB", 2);
             break;
 
         case 0xd1:
-            D_Direct("CMPB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("CMPB", 2);
             break;
 
         case 0xd2:
-            D_Direct("SBCB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("SBCB", 2);
             break;
 
         case 0xd3:
-            D_Direct("ADDD", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ADDD", 2);
             break;
 
         case 0xd4:
-            D_Direct("ANDB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ANDB", 2);
             break;
 
         case 0xd5:
-            D_Direct("BITB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("BITB", 2);
             break;
 
         case 0xd6:
-            D_Direct("LDB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("LDB", 2);
             break;
 
         case 0xd7:
-            D_Direct("STB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("STB", 2);
             break;
 
         case 0xd8:
-            D_Direct("EORB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("EORB", 2);
             break;
 
         case 0xd9:
-            D_Direct("ADCB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ADCB", 2);
             break;
 
         case 0xda:
-            D_Direct("ORB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ORB", 2);
             break;
 
         case 0xdb:
-            D_Direct("ADDB", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("ADDB", 2);
             break;
 
         case 0xdc:
-            D_Direct("LDD", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("LDD", 2);
             break;
 
         case 0xdd:
-            D_Direct("STD", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("STD", 2);
             break;
 
         case 0xde:
-            D_Direct("LDU", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("LDU", 2);
             break;
 
         case 0xdf:
-            D_Direct("STU", 2, p_code, p_mnemonic, p_operands);
+            D_Direct("STU", 2);
             break;
 
         case 0xe0:
-            D_Indexed("SUBB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("SUBB", 2);
             break;
 
         case 0xe1:
-            D_Indexed("CMPB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("CMPB", 2);
             break;
 
         case 0xe2:
-            D_Indexed("SBCB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("SBCB", 2);
             break;
 
         case 0xe3:
-            D_Indexed("ADDD", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ADDD", 2);
             break;
 
         case 0xe4:
-            D_Indexed("ANDB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ANDB", 2);
             break;
 
         case 0xe5:
-            D_Indexed("BITB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("BITB", 2);
             break;
 
         case 0xe6:
-            D_Indexed("LDB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LDB", 2);
             break;
 
         case 0xe7:
-            D_Indexed("STB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("STB", 2);
             break;
 
         case 0xe8:
-            D_Indexed("EORB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("EORB", 2);
             break;
 
         case 0xe9:
-            D_Indexed("ADCB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ADCB", 2);
             break;
 
         case 0xea:
-            D_Indexed("ORB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ORB", 2);
             break;
 
         case 0xeb:
-            D_Indexed("ADDB", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("ADDB", 2);
             break;
 
         case 0xec:
-            D_Indexed("LDD", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LDD", 2);
             break;
 
         case 0xed:
-            D_Indexed("STD", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("STD", 2);
             break;
 
         case 0xee:
-            D_Indexed("LDU", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("LDU", 2);
             break;
 
         case 0xef:
-            D_Indexed("STU", 2, p_code, p_mnemonic, p_operands);
+            D_Indexed("STU", 2);
             break;
 
         case 0xf0:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("SUBB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("SUBB", 3);
             break;
 
         case 0xf1:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("CMPB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("CMPB", 3);
             break;
 
         case 0xf2:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("SBCB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("SBCB", 3);
             break;
 
         case 0xf3:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ADDD", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ADDD", 3);
             break;
 
         case 0xf4:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ANDB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ANDB", 3);
             break;
 
         case 0xf5:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("BITB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("BITB", 3);
             break;
 
         case 0xf6:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("LDB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("LDB", 3);
             break;
 
         case 0xf7:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("STB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("STB", 3);
             break;
 
         case 0xf8:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("EORB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("EORB", 3);
             break;
 
         case 0xf9:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ADCB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ADCB", 3);
             break;
 
         case 0xfa:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ORB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ORB", 3);
             break;
 
         case 0xfb:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("ADDB", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("ADDB", 3);
             break;
 
         case 0xfc:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("LDD", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("LDD", 3);
             break;
 
         case 0xfd:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("STD", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("STD", 3);
             break;
 
         case 0xfe:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("LDU", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("LDU", 3);
             break;
 
         case 0xff:
             p_flags |= InstFlg::LabelAddr;
-            D_Extended("STU", 3, p_code, p_mnemonic, p_operands);
+            D_Extended("STU", 3);
             break;
 
         default:
-            return D_Illegal("", 1, p_code, p_mnemonic, p_operands);
+            return D_Illegal("", 1);
     }
 
     return p_flags;
@@ -6,6 +6,11 @@
 #define DA6809_INCLUDED
 
 #include "absdisas.h"
+#include "lblindex.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
 
 
 class Da6809 : public AbstractDisassembler
@@ -15,6 +20,7 @@ protected:
 
     Word pc{};
     const Byte *memory{};
+    DisassemblyText *text{};
     bool use_undocumented{false};
 
 public:
@@ -28,52 +34,50 @@ public:
             std::string &p_code,
             std::string &p_mnemonic,
             std::string &p_operands) override;
+    InstFlg Disassemble(
+            const Byte *p_memory,
+            DWord p_pc,
+            DWord &p_jumpaddr,
+            DisassemblyText &p_text) override;
     void set_use_undocumented(bool value) override;
     unsigned getByteSize(const Byte *p_memory) override;
 
     static void SetFlexLabelFile(const char *path);
+    static void AddSymbolFile(const std::string &path);
+    static void ClearSymbolFiles();
+    static void LoadLabelIndex();
 
 private:
 
-    inline InstFlg D_Page2(InstFlg p_flags, DWord &p_jumpaddr,
-            std::string &p_code, std::string &p_mnemonic,
-            std::string &p_operands);
-    inline InstFlg D_Page3(InstFlg p_flags, std::string &p_code,
-            std::string &p_mnemonic, std::string &p_operands);
-    inline InstFlg D_Illegal(const char *mnemo, Byte bytes, std::string &p_code,
-            std::string &p_mnemonic, std::string &p_operands);
-    inline void D_Direct(const char *mnemo, Byte bytes, std::string &p_code,
-            std::string &p_mnemonic, std::string &p_operands);
-    inline void D_Immediate8(const char *mnemo, Byte bytes, std::string &p_code,
-            std::string &p_mnemonic, std::string &p_operands);
-    inline void D_Immediate16(const char *mnemo, Byte bytes,
-            std::string &p_code, std::string &p_mnemonic,
-            std::string &p_operands);
-    inline void D_Inherent(const char *mnemo, Byte bytes, std::string &p_code,
-            std::string &p_mnemonic);
-    void D_Indexed(const char *mnemo, Byte bytes, std::string &p_code,
-            std::string &p_mnemonic, std::string &p_operands);
-    inline void D_Extended(const char *mnemo, Byte bytes, std::string &p_code,
-            std::string &p_mnemonic, std::string &p_operands);
-    inline void D_Relative8(const char *mnemo, Byte bytes, DWord &p_jumpaddr,
-            std::string &p_code, std::string &p_mnemonic,
-            std::string &p_operands);
-    inline void D_Relative16(const char *mnemo, Byte bytes, DWord &p_jumpaddr,
-            std::string &p_code, std::string &p_mnemonic,
-            std::string &p_operands);
-    inline void D_RegisterRegister(const char *mnemo, Byte bytes,
-            std::string &p_code, std::string &p_mnemonic,
-            std::string &p_operands);
+    inline InstFlg D_Page2(InstFlg p_flags, DWord &p_jumpaddr);
+    inline InstFlg D_Page3(InstFlg p_flags);
+    inline InstFlg D_Illegal(const char *mnemo, Byte bytes);
+    inline void D_Direct(const char *mnemo, Byte bytes);
+    inline void D_Immediate8(const char *mnemo, Byte bytes);
+    inline void D_Immediate16(const char *mnemo, Byte bytes);
+    inline void D_Inherent(const char *mnemo, Byte bytes);
+    void D_Indexed(const char *mnemo, Byte bytes);
+    inline void D_Extended(const char *mnemo, Byte bytes);
+    inline void D_Relative8(const char *mnemo, Byte bytes, DWord &p_jumpaddr);
+    inline void D_Relative16(const char *mnemo, Byte bytes,
+            DWord &p_jumpaddr);
+    inline void D_RegisterRegister(const char *mnemo, Byte bytes);
     inline void D_RegisterList(const char *mnemo, const char *ns_reg,
-            Byte bytes, std::string &p_code, std::string &p_mnemonic,
-            std::string &p_operands);
+            Byte bytes);
+    inline void D_AddressOperand(const char *prefix, Word address);
 
-    std::string PrintCode(int bytes);
+    void PrintCode(int bytes);
+    void PrintMnemonic(const char *mnemo);
     static const char *IndexRegister(Byte which);
     static const char *InterRegister(Byte which);
     static const char *StackRegister(Byte which, const char *not_stack);
     static const char *FlexLabel(Word addr);
+    static const LabelIndex &GetLabelIndex();
     static const char *flexLabelFile;
+    static std::vector<std::string> symbolFiles;
+    static LabelIndex labelIndex;
+    static std::atomic<bool> isLabelIndexValid;
+    static std::mutex labelIndexMutex;
 };
 
 #endif // DA6809_INCLUDED
@@ -44,7 +44,7 @@ class E2floppy;
 //   Bit 3: Drive 3 selected
 //   Bit 4: Side 2 selected (Side 1 if low)
 //
-class DriveSelect : public ByteRegister
+class DriveSelect final : public ByteRegister
 {
 private:
     // Bits when reading register
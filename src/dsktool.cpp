@@ -26,9 +26,14 @@
 #include <iomanip>
 #include <fstream>
 #include <vector>
+#include <algorithm>
 #include <tuple>
+#include <utility>
 #include <string>
 #include <regex>
+#include <sstream>
+#include <future>
+#include <memory>
 #include "bdir.h"
 #include "benv.h"
 #include "flexerr.h"
@@ -42,11 +47,15 @@
 #include "filfschk.h"
 #include "ffilebuf.h"
 #include "filecnts.h"
+#include "fdedupst.h"
+#include "fdedupdk.h"
+#include "bwrkpool.h"
+#include "rgxlist.h"
 #include <fmt/format.h>
 
 
 static std::vector<std::string> GetMatchingFilenames(FlexDisk &container,
-        const std::vector<std::regex> &regexs)
+        const RegexList &regexs)
 {
     FlexDiskIterator iter;
     std::vector<std::string> allFilenames;
@@ -56,30 +65,12 @@ static std::vector<std::string> GetMatchingFilenames(FlexDisk &container,
         allFilenames.emplace_back((*iter).GetTotalFileName());
     }
 
-    if (regexs.empty())
+    if (regexs.IsEmpty())
     {
         return allFilenames;
     }
 
-    std::vector<std::string> result;
-    std::set<size_t> fileIndices; // To make entries in result unique
-
-    for (const auto &regex : regexs)
-    {
-        size_t index = 0U;
-        for (const std::string &filename : allFilenames)
-        {
-            if (std::regex_search(filename, regex) &&
-                fileIndices.find(index) == fileIndices.end())
-            {
-                result.emplace_back(filename);
-                fileIndices.emplace(index);
-            }
-            ++index;
-        }
-    }
-
-    return result;
+    return regexs.Select(allFilenames);
 }
 
 static int FormatFlexDiskFile(const std::string &dsk_file, int disk_format,
@@ -145,7 +136,7 @@ static int FormatFlexDiskFile(const std::string &dsk_file, int disk_format,
 
 static int ExtractDskFile(const std::string &target_dir, bool verbose,
         bool convert_text, char default_answer, const std::string &dsk_file,
-        const std::vector<std::regex> &regexs, FileTimeAccess fileTimeAccess)
+        const RegexList &regexs, FileTimeAccess fileTimeAccess)
 {
     if (verbose)
     {
@@ -248,7 +239,7 @@ static int ExtractDskFile(const std::string &target_dir, bool verbose,
 static int ExtractDskFiles(std::string target_dir, bool verbose,
         bool convert_text, char default_answer,
         const std::vector<std::string> &dsk_files,
-        const std::vector<std::regex> &regexs, FileTimeAccess fileTimeAccess)
+        const RegexList &regexs, FileTimeAccess fileTimeAccess)
 {
     if (target_dir.empty())
     {
@@ -293,7 +284,7 @@ static int ExtractDskFiles(std::string target_dir, bool verbose,
 }
 
 static int ListDirectoryOfDskFile(const std::string &dsk_file,
-        const std::vector<std::regex> &regexs, FileTimeAccess fileTimeAccess)
+        const RegexList &regexs, FileTimeAccess fileTimeAccess)
 {
     const auto mode = std::ios::in | std::ios::binary;
     FlexRamDisk src{dsk_file, mode, fileTimeAccess};
@@ -384,7 +375,7 @@ static int ListDirectoryOfDskFile(const std::string &dsk_file,
 }
 
 static int ListDirectoryOfDskFiles(const std::vector<std::string> &dsk_files,
-        const std::vector<std::regex> &regexs, FileTimeAccess fileTimeAccess)
+        const RegexList &regexs, FileTimeAccess fileTimeAccess)
 {
     for (const auto &dsk_file : dsk_files)
     {
@@ -498,6 +489,8 @@ static int SummaryOfDskFiles(const std::vector<std::string> &dsk_files,
     return 0;
 }
 
+// All files are injected within one transaction. If not all of them fit
+// on the disk none of them is injected.
 static int InjectToDskFile(const std::string &dsk_file, bool verbose,
         const std::vector<std::string> &files, char default_answer,
         bool isConvertText, FileTimeAccess fileTimeAccess)
@@ -505,6 +498,9 @@ static int InjectToDskFile(const std::string &dsk_file, bool verbose,
     FlexCopyManager::autoTextConversion = isConvertText;
     const auto mode = std::ios::in | std::ios::out | std::ios::binary;
     FlexRamDisk dst{dsk_file, mode, fileTimeAccess};
+    std::vector<FlexFileBuffer> fileBuffers;
+    std::vector<std::string> messages;
+    std::vector<std::string> filesToDelete;
 
     if (!dst.IsFlexFormat())
     {
@@ -513,7 +509,6 @@ static int InjectToDskFile(const std::string &dsk_file, bool verbose,
 
     for (const auto &file : files)
     {
-        bool isSuccess = true;
         bool isText = false;
         FlexFileBuffer fileBuffer;
 
@@ -530,45 +525,71 @@ static int InjectToDskFile(const std::string &dsk_file, bool verbose,
             isText = true;
         }
 
-        try
+        FlexDirEntry dir_entry;
+        const auto filename = flx::tolower(fileBuffer.GetFilename());
+        const auto iter = std::find_if(fileBuffers.cbegin(),
+                fileBuffers.cend(), [&](const FlexFileBuffer &buffer){
+            return flx::tolower(buffer.GetFilename()) == filename;
+        });
+        const bool isInjected = (iter != fileBuffers.cend());
+
+        if (isInjected || dst.FindFile(fileBuffer.GetFilename(), dir_entry))
         {
-            FlexDirEntry dir_entry;
+            std::string question(fileBuffer.GetFilename());
 
-            if (dst.FindFile(fileBuffer.GetFilename(), dir_entry))
+            question += " already exists. Overwrite?";
+            if (flx::askForInput(question, "yn", default_answer))
             {
-                std::string question(fileBuffer.GetFilename());
-
-                question += " already exists. Overwrite?";
-                if (flx::askForInput(question, "yn", default_answer))
+                if (isInjected)
                 {
-                    dst.DeleteFile(dir_entry.GetTotalFileName());
+                    const auto index = iter - fileBuffers.cbegin();
+                    fileBuffers.erase(iter);
+                    messages.erase(messages.cbegin() + index);
                 }
                 else
                 {
-                    if (default_answer != '?')
-                    {
-                        std::cout << fileBuffer.GetFilename() <<
-                            " already exists. Skipped.\n";
-                    }
-                    continue;
+                    filesToDelete.push_back(dir_entry.GetTotalFileName());
                 }
             }
-
-            dst.WriteFromBuffer(fileBuffer);
+            else
+            {
+                if (default_answer != '?')
+                {
+                    std::cout << fileBuffer.GetFilename() <<
+                        " already exists. Skipped.\n";
+                }
+                continue;
+            }
         }
-        catch (FlexException &ex)
+
+        std::string fileType = isText ? "text file" : "binary file";
+
+        fileBuffers.push_back(std::move(fileBuffer));
+        messages.push_back("Injecting " + fileType + " " + file + " ... Ok\n");
+    }
+
+    try
+    {
+        for (const auto &filename : filesToDelete)
         {
-            std::cerr <<
-                "   *** Error: " << ex.what() << ".\n" <<
-                "       Injecting of " << file << " aborted.\n";
-            isSuccess = false;
+            dst.DeleteFile(filename);
         }
 
-        if (isSuccess && verbose)
-        {
-            std::string fileType = isText ? "text file" : "binary file";
+        dst.WriteFromBuffers(fileBuffers);
+    }
+    catch (FlexException &ex)
+    {
+        std::cerr <<
+            "   *** Error: " << ex.what() << ".\n" <<
+            "       Injecting of all files aborted.\n";
+        return 1;
+    }
 
-            std::cout << "Injecting " << fileType << " " << file << " ... Ok\n";
+    if (verbose)
+    {
+        for (const auto &message : messages)
+        {
+            std::cout << message;
         }
     }
 
@@ -576,7 +597,7 @@ static int InjectToDskFile(const std::string &dsk_file, bool verbose,
 }
 
 static int DeleteFromDskFile(const std::string &dsk_file, bool verbose,
-        const std::vector<std::regex> &regexs, char default_answer)
+        const RegexList &regexs, char default_answer)
 {
     auto fileTimeAccess = FileTimeAccess::NONE;
     const auto mode = std::ios::in | std::ios::out | std::ios::binary;
@@ -587,7 +608,7 @@ static int DeleteFromDskFile(const std::string &dsk_file, bool verbose,
         throw FlexException(FERR_CONTAINER_UNFORMATTED, src.GetPath());
     }
 
-    if (regexs.empty())
+    if (regexs.IsEmpty())
     {
         return 0;
     }
@@ -644,60 +665,102 @@ static int DeleteFromDskFile(const std::string &dsk_file, bool verbose,
 }
 
 static int CheckConsistencyOfDskFile(const std::string &dsk_file,
-        bool verbose, bool debug_output, FileTimeAccess fileTimeAccess)
+        bool verbose, bool debug_output, FileTimeAccess fileTimeAccess,
+        std::ostream &out, std::ostream &err)
 {
     const auto mode = std::ios::in | std::ios::binary;
-    FlexRamDisk src{dsk_file, mode, fileTimeAccess};
+    const auto store_dir = flx::getParentPath(dsk_file);
+    std::unique_ptr<IFlexDiskBySector> src;
+    struct stat sbuf{};
 
-    if (!src.IsFlexFormat())
+    // If there is no such file <store-dir>/<image-name> refers to a disk
+    // image in a deduplicating store.
+    if (stat(dsk_file.c_str(), &sbuf) != 0 && !store_dir.empty() &&
+        FlexDedupStore::IsStore(store_dir))
     {
-        throw FlexException(FERR_CONTAINER_UNFORMATTED, src.GetPath());
+        src = std::make_unique<FlexDedupDisk>(
+                std::make_shared<const FlexDedupStore>(store_dir),
+                flx::getFileName(dsk_file));
+    }
+    else
+    {
+        src = std::make_unique<FlexRamDisk>(dsk_file, mode, fileTimeAccess);
+    }
+
+    if (!src->IsFlexFormat())
+    {
+        throw FlexException(FERR_CONTAINER_UNFORMATTED, src->GetPath());
     }
 
-    FlexDiskCheck check(src, fileTimeAccess);
+    FlexDiskCheck check(*src, fileTimeAccess);
 
-    std::cout << "Check " << dsk_file << " ...";
+    out << "Check " << dsk_file << " ...";
     if (check.CheckFileSystem())
     {
-        std::cout << " Ok\n";
+        out << " Ok\n";
     }
     else
     {
-        std::cout << " " << check.GetStatisticsString() << "\n";
+        out << " " << check.GetStatisticsString() << "\n";
 
         if (verbose)
         {
             for (const auto &result : check.GetResult())
             {
-                std::cout << "  " << result << '\n';
+                out << "  " << result << '\n';
             }
         }
     }
 
     if (debug_output)
     {
-        check.DebugDump(std::cerr);
+        check.DebugDump(err);
     }
 
     return 0;
 }
 
+// Check all disk image files with up to jobs worker threads. The output
+// is printed in the order of the disk image files.
 static int CheckConsistencyOfDskFiles(const std::vector<std::string> &dsk_files,
-        bool verbose, bool debug_output, FileTimeAccess fileTimeAccess)
+        bool verbose, bool debug_output, FileTimeAccess fileTimeAccess,
+        unsigned jobs)
 {
+    using Output_t = std::pair<std::string, std::string>;
+    BWorkerPool workerPool(std::max(1U, std::min(jobs,
+                    static_cast<unsigned>(dsk_files.size()))));
+    std::vector<std::future<Output_t> > futures;
+
+    futures.reserve(dsk_files.size());
     for (const auto &dsk_file : dsk_files)
     {
-        try
-        {
-            CheckConsistencyOfDskFile(dsk_file, verbose, debug_output,
-                    fileTimeAccess);
-        }
-        catch (FlexException &ex)
-        {
-            std::cerr <<
-                "   *** Error: " << ex.what() << ".\n" <<
-                "       Check consistency of '" << dsk_file << "' aborted.\n";
-        }
+        futures.push_back(workerPool.PostWithResult<Output_t>("", [&](){
+            std::stringstream out;
+            std::stringstream err;
+
+            try
+            {
+                CheckConsistencyOfDskFile(dsk_file, verbose, debug_output,
+                        fileTimeAccess, out, err);
+            }
+            catch (FlexException &ex)
+            {
+                err <<
+                    "   *** Error: " << ex.what() << ".\n" <<
+                    "       Check consistency of '" << dsk_file <<
+                    "' aborted.\n";
+            }
+
+            return Output_t(out.str(), err.str());
+        }));
+    }
+
+    for (auto &future : futures)
+    {
+        const auto output = future.get();
+
+        std::cout << output.first << std::flush;
+        std::cerr << output.second;
     }
 
     return 0;
@@ -705,7 +768,7 @@ static int CheckConsistencyOfDskFiles(const std::vector<std::string> &dsk_files,
 
 static int CopyFromToDskFile(const std::string &src_dsk_file,
         const std::string &dst_dsk_file, bool verbose,
-        const std::vector<std::regex> &regexs, char default_answer,
+        const RegexList &regexs, char default_answer,
         FileTimeAccess fileTimeAccess)
 {
     auto mode = std::ios::in | std::ios::binary;
@@ -722,85 +785,229 @@ static int CopyFromToDskFile(const std::string &src_dsk_file,
         throw FlexException(FERR_CONTAINER_UNFORMATTED, dst.GetPath());
     }
 
-    size_t count = 0;
     size_t random_count = 0;
     size_t byte_size = 0;
-    size_t errors = 0;
+    // First: source file name, second: destination file name.
+    std::vector<std::pair<std::string, std::string> > fileNames;
+    std::vector<std::string> filesToDelete;
 
     auto matchedFilenames = GetMatchingFilenames(src, regexs);
 
     for (auto &filename : matchedFilenames)
     {
-        bool isSuccess = true;
+        FlexDirEntry dir_entry;
 
-        try
+        if (dst.FindFile(filename, dir_entry))
         {
-            FlexDirEntry dir_entry;
+            std::string question(filename);
 
-            if (dst.FindFile(filename, dir_entry))
+            question += " already exists. Overwrite?";
+            if (flx::askForInput(question, "yn", default_answer))
             {
-                std::string question(filename);
-
-                question += " already exists. Overwrite?";
-                if (flx::askForInput(question, "yn", default_answer))
-                {
-                    dst.DeleteFile(filename);
-                }
-                else
+                filesToDelete.push_back(dir_entry.GetTotalFileName());
+            }
+            else
+            {
+                if (default_answer != '?')
                 {
-                    if (default_answer != '?')
-                    {
-                        std::cout << filename << " already exists. Skipped.\n";
-                    }
-                    continue;
+                    std::cout << filename << " already exists. Skipped.\n";
                 }
+                continue;
             }
+        }
+
+        fileNames.emplace_back(filename, filename);
+        if (src.FindFile(filename, dir_entry))
+        {
+            byte_size += dir_entry.GetFileSize();
+            random_count += dir_entry.IsRandom() ? 1 : 0;
+        }
+    }
 
-            src.FileCopy(filename, filename, dst);
+    // All files are copied sector by sector within one transaction.
+    // Only the used sectors of the source disk are read.
+    // The destination is a RAM disk, its changes are only written to the
+    // disk image file when it is closed. If the copy fails the changes
+    // are discarded, so files to be overwritten are not lost.
+    try
+    {
+        for (const auto &filename : filesToDelete)
+        {
+            dst.DeleteFile(filename);
+        }
 
-            ++count;
-            if (src.FindFile(filename, dir_entry))
+        dst.CopyFilesFrom(src, fileNames);
+    }
+    catch (FlexException &ex)
+    {
+        dst.Detach();
+        std::cerr <<
+            "*** Error: " << ex.what() << ".\n" <<
+            "    Copying of all files aborted. " << dst_dsk_file <<
+            " is unchanged.\n";
+        return 1;
+    }
+
+    if (verbose)
+    {
+        for (const auto &fileName : fileNames)
+        {
+            std::cout << "Copying " << fileName.first << " ... Ok\n";
+        }
+        std::cout <<
+            fileNames.size() << " file(s), " << random_count <<
+            " random file(s), ";
+        auto kbyte_size = byte_size / 1024;
+        std::cout << "total size: " << kbyte_size << " KByte.\n";
+    }
+
+    return 0;
+}
+
+static int AddToDedupStore(const std::string &store_dir,
+        const std::vector<std::string> &dsk_files, bool verbose,
+        char default_answer)
+{
+    FlexDedupStore store{store_dir};
+    int result = 0;
+
+    for (const auto &dsk_file : dsk_files)
+    {
+        const auto name = flx::getFileName(dsk_file);
+
+        if (store.HasImage(name))
+        {
+            std::string question(name);
+
+            question += " already exists. Overwrite?";
+            if (!flx::askForInput(question, "yn", default_answer))
             {
-                byte_size += dir_entry.GetFileSize();
-                random_count += dir_entry.IsRandom() ? 1 : 0;
+                if (default_answer != '?')
+                {
+                    std::cout << name << " already exists. Skipped.\n";
+                }
+                continue;
             }
         }
-        catch (FlexException &ex)
+
+        try
         {
-            isSuccess = false;
-            ++errors;
-            std::cerr << "*** Error: " << ex.what() << ".\n";
-            if (ex.GetErrorCode() == FERR_DISK_FULL_WRITING)
+            if (verbose)
             {
-                std::cerr << "    Copying aborted.\n";
-                break;
+                std::cout << "Adding " << dsk_file << " ... ";
             }
 
-            std::cerr << "    Copying of " << filename << " aborted.\n";
-        }
+            const auto count = store.Import(dsk_file, name);
 
-        if (isSuccess && verbose)
+            if (verbose)
+            {
+                std::cout << "Ok, " << count << " new sector(s)\n";
+            }
+        }
+        catch (FlexException &ex)
         {
-            std::cout << "Copying " << filename << " ... Ok\n";
+            if (verbose)
+            {
+                std::cout << " failed.\n";
+            }
+            std::cerr <<
+                "   *** Error: " << ex.what() << ".\n" <<
+                "       Adding of '" << dsk_file << "' aborted.\n";
+            result = 1;
         }
     }
 
     if (verbose)
     {
+        const auto count = store.GetSectorCount();
+
         std::cout <<
-            count << " file(s), " << random_count << " random file(s), ";
-        if (errors != 0)
+            store.GetImageNames().size() << " disk image(s), " << count <<
+            " unique sector(s), total size: " <<
+            (count * SECTOR_SIZE) / 1024 << " KByte.\n";
+    }
+
+    return result;
+}
+
+static int ExtractFromDedupStore(const std::string &store_dir,
+        std::string target_dir, std::vector<std::string> names,
+        bool verbose, char default_answer)
+{
+    if (target_dir.empty())
+    {
+        target_dir = ".";
+    }
+
+    if (!BDirectory::Exists(store_dir) || !BDirectory::Exists(target_dir))
+    {
+        const auto &dir = BDirectory::Exists(store_dir) ?
+            target_dir : store_dir;
+
+        std::cerr <<
+            "*** Error: '" << dir << "' does not exist or is"
+            " no directory.\n" <<
+            "    Extraction aborted.\n";
+        return 1;
+    }
+
+    const FlexDedupStore store{store_dir};
+    int result = 0;
+
+    if (names.empty())
+    {
+        names = store.GetImageNames();
+    }
+
+    for (const auto &name : names)
+    {
+        const auto path = target_dir + PATHSEPARATORSTRING + name;
+
+        if (BDirectory::Exists(path) || std::ifstream(path).is_open())
         {
-            std::cout << errors << " errors, ";
+            std::string question(path);
+
+            question += " already exists. Overwrite?";
+            if (!flx::askForInput(question, "yn", default_answer))
+            {
+                if (default_answer != '?')
+                {
+                    std::cout << path << " already exists. Skipped.\n";
+                }
+                continue;
+            }
+        }
+
+        try
+        {
+            if (verbose)
+            {
+                std::cout << "Extracting " << name << " ... ";
+            }
+
+            store.Export(name, path);
+
+            if (verbose)
+            {
+                std::cout << "Ok\n";
+            }
+        }
+        catch (FlexException &ex)
+        {
+            if (verbose)
+            {
+                std::cout << " failed.\n";
+            }
+            std::cerr <<
+                "   *** Error: " << ex.what() << ".\n" <<
+                "       Extraction of '" << name << "' aborted.\n";
+            result = 1;
         }
-        auto kbyte_size = byte_size / 1024;
-        std::cout << "total size: " << kbyte_size << " KByte.\n";
     }
 
-    return 0;
+    return result;
 }
 
-
 static void helpOnDiskSize()
 {
     std::cout <<
@@ -829,10 +1036,13 @@ static void version()
 static void usage()
 {
     std::cout <<
-        "Usage: dsktool -c <dsk-file> [-v][-D] [<dsk-file>...]\n"
+        "Usage: dsktool -a <store-dir> [-v][-y|-n] <dsk-file> [<dsk-file>...]\n"
+        "Usage: dsktool -c <dsk-file> [-v][-D][-j<jobs>] [<dsk-file>...]\n"
         "Usage: dsktool -C <dsk-file> -T<tgt-dsk-file> [-v][-z][-y|-n][-m]"
         "[-R<file>...]\n"
         "                  [<regex>...]\n"
+        "Usage: dsktool -e <store-dir> [-d<directory>][-v][-y|-n] "
+        "[<image-name>...]\n"
         "Usage: dsktool -f <dsk-file> [-v][-F(dsk|flx)][-y|-n] -S<size>\n"
         "                  -B<boot-sector-file>\n"
         "Usage: dsktool -h\n"
@@ -850,9 +1060,15 @@ static void usage()
         "Usage: dsktool -X <dsk-file> [-d<directory>][-t][-v][-z] "
         "[-y|-n][<dsk-file>...]\n\n"
         "Commands:\n"
+        "  -a: Add FLEX disk image file(s) to a deduplicating store.\n"
+        "      Identical sectors of all disk images are stored only once.\n"
         "  -c: Check consistency of FLEX disk image file.\n"
+        "      <store-dir>/<image-name> checks an image in a deduplicating\n"
+        "      store.\n"
         "  -C: Copy files from a FLEX disk image file into another one.\n"
         "      If no regex is specified, all files are copied.\n"
+        "  -e: Extract disk image file(s) from a deduplicating store.\n"
+        "      If no image name is specified, all images are extracted.\n"
         "  -f: Create a new FLEX disk image file.\n"
         "  -h: Print this help.\n"
         "  -i: Inject FLEX-files to a FLEX disk image file.\n"
@@ -874,6 +1090,8 @@ static void usage()
         "                *.wta extension is handled as *.dsk format.\n"
         "                If not set it is determined from the file extension\n"
         "                or finally the default is *.dsk\n"
+        "  -j<jobs>      Check up to <jobs> disk image files in parallel.\n"
+        "                0 uses the number of CPU cores. Default: 1.\n"
         "  -m            Regex is case sensitive (case has meaning).\n"
         "  -n            Answer no to all questions.\n"
         "  -t            Automatic detection and conversion of text files.\n"
@@ -892,6 +1110,10 @@ static void usage()
         "format.\n"
         "                *.wta extension is handled as *.dsk format.\n"
         "  <FLEX-file>   A FLEX text or binary file.\n"
+        "  <image-name>  File name of a disk image file in a deduplicating\n"
+        "                store.\n"
+        "  <store-dir>   Directory of a deduplicating store. It is created\n"
+        "                if it does not exist.\n"
         "  <file>        A text file or FLEX text or binary file.\n"
         "  <regex>       A regular expression specifying FLEX file(s).\n"
         "                Extended POSIX regular expression grammar is\n"
@@ -1048,7 +1270,8 @@ static char checkCommand(char oldCommand, int result)
         return static_cast<char>(result);
     }
 
-    std::cerr << "*** Error: Only one command -X, -l, -s, -c, -C, -i or -r allowed."                 "\n";
+    std::cerr << "*** Error: Only one command -X, -l, -s, -c, -C, -i, -r, "
+                 "-a or -e allowed.\n";
     usage();
     return 0;
 }
@@ -1105,21 +1328,15 @@ static std::tuple<bool, std::vector<std::string> >
 }
 
 static bool addToRegexList(const std::vector<std::string> &regexLines,
-        std::vector<std::regex> &regexs, bool isCaseSensitive)
+        RegexList &regexs, bool isCaseSensitive)
 {
     bool result = true;
 
-    auto flags = std::regex_constants::extended;
-    if (!isCaseSensitive)
-    {
-        flags |= std::regex_constants::icase;
-    }
-
     for (const auto &regex : regexLines)
     {
         try
         {
-            regexs.emplace_back(regex, flags);
+            regexs.Add(regex, isCaseSensitive);
         }
         catch(const std::regex_error &ex)
         {
@@ -1135,18 +1352,19 @@ static bool addToRegexList(const std::vector<std::string> &regexLines,
 
 int main(int argc, char *argv[])
 {
-    std::string optstr("f:X:x:L:l:s:c:C:i:r:R:T:d:o:S:F:B:DhmntvVyz");
+    std::string optstr("a:e:f:X:x:L:l:s:c:C:i:r:R:T:d:o:S:F:B:j:DhmntvVyz");
     std::string target_dir;
     std::vector<std::string> dsk_files;
     std::vector<std::string> files;
     std::vector<std::string> regexFiles;
-    std::vector<std::regex> regexs;
+    RegexList regexs;
     std::string dsk_file;
     std::string dst_dsk_file;
     const char *bsFile = nullptr;
     int disk_format = 0;
     int tracks = 0;
     int sectors = 0;
+    unsigned jobs = 1U;
     bool verbose = false;
     bool debug_output = false;
     bool convert_text = false;
@@ -1176,6 +1394,8 @@ int main(int argc, char *argv[])
                       }
                       break;
 
+            case 'a':
+            case 'e':
             case 'x':
             case 'f':
             case 'i':
@@ -1197,10 +1417,7 @@ int main(int argc, char *argv[])
                       break;
 
             case 'R': has_regex_file = true;
-                      if (command == 'C' || command == 'x')
-                      {
-                          regexFiles.emplace_back(optarg);
-                      }
+                      regexFiles.emplace_back(optarg);
                       break;
 
             case 'T': dst_dsk_file = optarg;
@@ -1252,6 +1469,19 @@ int main(int argc, char *argv[])
             case 't': convert_text = true;
                       break;
 
+            case 'j':
+                      {
+                          if (!flx::getJobCount(optarg, jobs))
+                          {
+                              std::cerr << "*** Error: Invalid number of "
+                                           "jobs '" << optarg << "'. Valid "
+                                           "range is 0 to " << flx::MAX_JOBS <<
+                                           ".\n";
+                              return 1;
+                          }
+                      }
+                      break;
+
             case 'v': verbose = true;
                       break;
 
@@ -1300,7 +1530,8 @@ int main(int argc, char *argv[])
         }
     }
     else if (command == 'c' || command == 'l' ||
-             command == 's' || command == 'X')
+             command == 's' || command == 'X' ||
+             command == 'a' || command == 'e')
     {
         for (index = optind; index < argc; index++)
         {
@@ -1333,15 +1564,18 @@ int main(int argc, char *argv[])
     if ((tolower(command == 'l') && verbose) ||
         (command == 'i' && files.empty()) ||
         (command == 'C' && dst_dsk_file.empty()) ||
-        (command != 'X' && command != 'x' && !target_dir.empty()) ||
+        (command == 'a' && dsk_files.empty()) ||
+        (std::string("eXx").find_first_of(command) == std::string::npos &&
+         !target_dir.empty()) ||
         (command != 'C' && !dst_dsk_file.empty()) ||
         (!isRegexCommand && regexCaseSense) ||
         (!isRegexCommand && has_regex_file) ||
-        (!isRegexCommand && !regexs.empty()) ||
-        (std::string("firCxX").find_first_of(command) == std::string::npos &&
+        (!isRegexCommand && !regexs.IsEmpty()) ||
+        (std::string("aefirCxX").find_first_of(command) == std::string::npos &&
          (default_answer != '?')) ||
         (command != 'i' && command != 'X' && command != 'x' && convert_text) ||
         (command != 'c' && debug_output) ||
+        (command != 'c' && jobs != 1U) ||
         (std::string("cCilLxX").find_first_of(command) == std::string::npos &&
             (fileTimeAccess != FileTimeAccess::NONE)) ||
         (command != 'f' && bsFile != nullptr))
@@ -1370,7 +1604,7 @@ int main(int argc, char *argv[])
             case 'c':
                 return CheckConsistencyOfDskFiles(dsk_files, verbose,
                                                   debug_output,
-                                                  fileTimeAccess);
+                                                  fileTimeAccess, jobs);
 
             case 'f':
                 return FormatFlexDiskFile(dsk_file, disk_format, tracks,
@@ -1410,6 +1644,14 @@ int main(int argc, char *argv[])
                 return CopyFromToDskFile(dsk_file, dst_dsk_file, verbose,
                                          regexs, default_answer,
                                          fileTimeAccess);
+
+            case 'a':
+                return AddToDedupStore(dsk_file, dsk_files, verbose,
+                                       default_answer);
+
+            case 'e':
+                return ExtractFromDedupStore(dsk_file, target_dir, dsk_files,
+                                             verbose, default_answer);
         }
     }
     catch (FlexException &ex)
@@ -33,10 +33,20 @@
 #include "bdir.h"
 #include "crc.h"
 #include "soptions.h"
+#include "hotcnt.h"
+#include "snapshot.h"
 #include <cassert>
 #include <array>
+#include <memory>
 
 
+static bool isScratchDisk(const IFlexDiskBySector *pfloppy)
+{
+    const auto *ramDisk = dynamic_cast<const FlexRamDisk *>(pfloppy);
+
+    return ramDisk != nullptr && ramDisk->IsScratch();
+}
+
 E2floppy::E2floppy(const struct sOptions &p_options)
     : options(p_options)
 {
@@ -110,9 +120,34 @@ bool E2floppy::mount_drive(const std::string &path,
 
     track[drive_nr] = 1; // position to a track != 0 !!!
 
+    auto pfloppy = open_drive(path, drive_nr, option);
+
+    std::lock_guard<std::mutex> guard(status_mutex);
+    floppy[drive_nr] = std::move(pfloppy);
+
+    if (floppy[drive_nr].get() != nullptr)
+    {
+        drive_status[drive_nr] = DiskStatus::ACTIVE;
+        return true;
+    }
+
+    return false;
+}
+
+// Open the disk to be mounted to drive drive_nr. On error an empty
+// pointer is returned.
+IFlexDiskBySectorPtr E2floppy::open_drive(const std::string &path,
+                                          Word drive_nr,
+                                          tMountOption option) const
+{
+    if (is_overlay)
+    {
+        option = MOUNT_RAM;
+    }
+
     // Intentionally use value argument, it may be changed on Windows.
     // NOLINTNEXTLINE(performance-unnecessary-value-param)
-    auto TryMount = [&](std::string containerPath) -> bool
+    auto TryOpen = [&](std::string containerPath) -> IFlexDiskBySectorPtr
     {
         IFlexDiskBySectorPtr pfloppy;
 
@@ -131,7 +166,7 @@ bool E2floppy::mount_drive(const std::string &path,
 #endif
         if (BDirectory::Exists(containerPath))
         {
-            if (options.isDirectoryDiskActive)
+            if (options.isDirectoryDiskActive && !is_overlay)
             {
                 try
                 {
@@ -159,12 +194,17 @@ bool E2floppy::mount_drive(const std::string &path,
                 (!fileExists ||
                 (fileExists && S_ISREG(sbuf.st_mode) && sbuf.st_size == 0)))
             {
-                return false;
+                return {};
             }
             // A file which does not exist or has file size zero
             // is marked as unformatted.
             bool is_formatted = !stat(containerPath.c_str(), &sbuf) &&
                                 (S_ISREG(sbuf.st_mode) && sbuf.st_size);
+
+            if (is_overlay && !is_formatted)
+            {
+                return {};
+            }
             auto mode = std::ios::in | std::ios::out | std::ios::binary;
 
             if (is_formatted && option == MOUNT_RAM)
@@ -222,27 +262,21 @@ bool E2floppy::mount_drive(const std::string &path,
             }
         }
 
-        std::lock_guard<std::mutex> guard(status_mutex);
-        floppy[drive_nr] = std::move(pfloppy);
-
-        if (floppy[drive_nr].get() != nullptr)
+        auto *ramDisk = dynamic_cast<FlexRamDisk *>(pfloppy.get());
+        if (is_overlay && ramDisk != nullptr)
         {
-            drive_status[drive_nr] = DiskStatus::ACTIVE;
-            return true;
+            // Changes of an overlay disk are never written to file.
+            ramDisk->Detach();
         }
 
-        return false;
+        return pfloppy;
     };
 
     // first try with given path
-    if (TryMount(path))
+    auto pfloppy = TryOpen(path);
+    if (pfloppy || flx::isAbsolutePath(path))
     {
-        return true;
-    }
-
-    if (flx::isAbsolutePath(path))
-    {
-        return false;
+        return pfloppy;
     }
 
     // If path is relative, second try with full path in disk_dir directory
@@ -254,7 +288,7 @@ bool E2floppy::mount_drive(const std::string &path,
     }
     fullPath += path;
 
-    return TryMount(fullPath);
+    return TryOpen(fullPath);
 }
 
 void E2floppy::disk_directory(const std::string &p_disk_dir)
@@ -291,6 +325,48 @@ bool E2floppy::umount_all_drives()
     return result;
 }
 
+// Replace all mounted disks by RAM disks without an open file. Changes to
+// them are never written back (overlay disks). It is used in a forked
+// process, the disks inherited from the parent process have to be
+// synchronized before forking. A directory disk can not be used as overlay
+// disk, it is unmounted.
+// From now on any mounted disk is an overlay disk.
+bool E2floppy::overlay_all_drives()
+{
+    // The emulated floppy drives keep their head positions.
+    const auto saved_track = track;
+    bool result = true;
+
+    is_overlay = true;
+    for (Word drive_nr = 0U; drive_nr < MAX_DRIVES; ++drive_nr)
+    {
+        if (floppy[drive_nr].get() == nullptr)
+        {
+            continue;
+        }
+
+        if (isScratchDisk(floppy[drive_nr].get()))
+        {
+            // A scratch disk has no file, it is already an overlay disk.
+            continue;
+        }
+
+        const auto path = floppy[drive_nr]->GetPath();
+        const auto type = floppy[drive_nr]->GetFlexDiskType();
+
+        umount_drive(drive_nr);
+        if ((type & TYPE_DIRECTORY) || !mount_drive(path, drive_nr))
+        {
+            result = false;
+        }
+    }
+
+    track = saved_track;
+    pfs = floppy[selected].get();
+
+    return result;
+}
+
 std::string E2floppy::drive_attributes_string(Word drive_nr)
 {
     auto diskAttributes = drive_attributes(drive_nr);
@@ -414,6 +490,17 @@ bool E2floppy::sync_drive(Word drive_nr, tMountOption option)
         result = umount_drive(drive_nr);
         result &= mount_drive(path, drive_nr, option);
     }
+    else if (!is_overlay)
+    {
+        // Only the changed sectors of a RAM disk are written to file.
+        auto *ramDisk = dynamic_cast<FlexRamDisk *>(floppy[drive_nr].get());
+
+        if (ramDisk != nullptr)
+        {
+            std::lock_guard<std::mutex> guard(status_mutex);
+            result = ramDisk->Flush();
+        }
+    }
 
     return result;
 }
@@ -423,6 +510,104 @@ void E2floppy::resetIo()
     Wd1793::resetIo();
 }
 
+// Besides the controller registers the snapshot contains the paths of
+// all mounted disks. The disk contents is not part of the snapshot, saving
+// a snapshot does not change any disk.
+void E2floppy::saveState(SnapshotWriter &writer)
+{
+    Wd1793::saveState(writer);
+    writer.Write(selected);
+    writer.Write(track.data(), static_cast<DWord>(track.size()));
+    writer.Write(sector_buffer.data(),
+                 static_cast<DWord>(sector_buffer.size()));
+    writer.Write(static_cast<Byte>(writeTrackState));
+    writer.Write(offset);
+    writer.Write(idAddressMark.data(),
+                 static_cast<DWord>(idAddressMark.size()));
+    // The contents of a scratch disk is not part of the snapshot.
+    for (Word drive_nr = 0U; drive_nr < MAX_DRIVES; ++drive_nr)
+    {
+        const auto *pfloppy = floppy[drive_nr].get();
+
+        writer.Write((pfloppy != nullptr && !isScratchDisk(pfloppy)) ?
+                     pfloppy->GetPath() : std::string());
+    }
+}
+
+// A drive is remounted if a different disk is currently mounted.
+// A drive which was empty when saving the snapshot keeps its disk.
+// The disks to be remounted are already opened when reading the state,
+// so applying it can not fail.
+RestoreStateFct E2floppy::restoreState(SnapshotReader &reader)
+{
+    Byte new_selected;
+    Byte state;
+    Word new_offset;
+    auto new_track = track;
+    auto new_sector_buffer = std::make_shared<std::array<Byte, 1024> >();
+    auto new_idAddressMark = idAddressMark;
+    std::array<std::string, MAX_DRIVES> paths;
+
+    const auto applyWd1793 = Wd1793::restoreState(reader);
+    reader.Read(new_selected);
+    reader.Read(new_track.data(), static_cast<DWord>(new_track.size()));
+    reader.Read(new_sector_buffer->data(),
+                static_cast<DWord>(new_sector_buffer->size()));
+    reader.Read(state);
+    reader.Read(new_offset);
+    reader.Read(new_idAddressMark.data(),
+                static_cast<DWord>(new_idAddressMark.size()));
+    for (auto &path : paths)
+    {
+        reader.Read(path);
+    }
+
+    if (!applyWd1793 || !reader.IsValid())
+    {
+        return {};
+    }
+
+    auto disks = std::make_shared<std::array<IFlexDiskBySectorPtr,
+                                             MAX_DRIVES> >();
+    for (Word drive_nr = 0U; drive_nr < MAX_DRIVES; ++drive_nr)
+    {
+        const auto &path = paths[drive_nr];
+
+        if (!path.empty() &&
+            (!floppy[drive_nr] || floppy[drive_nr]->GetPath() != path))
+        {
+            (*disks)[drive_nr] = open_drive(path, drive_nr);
+            if (!(*disks)[drive_nr])
+            {
+                return {};
+            }
+        }
+    }
+
+    return [this, applyWd1793, new_selected, new_track, new_sector_buffer,
+            state, new_offset, new_idAddressMark, disks](){
+        applyWd1793();
+        selected = std::min(new_selected, MAX_DRIVES);
+        track = new_track;
+        sector_buffer = *new_sector_buffer;
+        writeTrackState = static_cast<WriteTrackState>(state);
+        offset = new_offset;
+        idAddressMark = new_idAddressMark;
+
+        for (Word drive_nr = 0U; drive_nr < MAX_DRIVES; ++drive_nr)
+        {
+            if ((*disks)[drive_nr])
+            {
+                umount_drive(drive_nr);
+                std::lock_guard<std::mutex> guard(status_mutex);
+                floppy[drive_nr] = std::move((*disks)[drive_nr]);
+                drive_status[drive_nr] = DiskStatus::ACTIVE;
+            }
+        }
+        pfs = floppy[selected].get();
+    };
+}
+
 void E2floppy::select_drive(Byte new_selected)
 {
     new_selected = std::min(new_selected, MAX_DRIVES);
@@ -465,6 +650,7 @@ Byte E2floppy::readByteInSector(Word index)
     {
         drive_status[selected] = DiskStatus::ACTIVE;
 
+        HOT_COUNT(SectorRead);
         if (!pfs->ReadSector(sector_buffer.data(), getTrack(), getSector(),
                              getSide() ? 1 : 0))
         {
@@ -622,6 +808,7 @@ void E2floppy::writeByteInSector(Word index)
     {
         drive_status[selected] = DiskStatus::ACTIVE;
 
+        HOT_COUNT(SectorWrite);
         if (!pfs->WriteSector(sector_buffer.data(), getTrack(), getSector(),
                               getSide() ? 1 : 0))
         {
@@ -683,10 +870,45 @@ void E2floppy::get_drive_status(std::array<DiskStatus, MAX_DRIVES> &stat)
 
 bool E2floppy::format_disk(SWord trk, SWord sec,
                            const std::string &name,
-                           int fmt)
+                           int fmt,
+                           Word drive_nr /* = MAX_DRIVES */)
 {
     IFlexDiskBySectorPtr pfloppy;
     FileTimeAccess fileTimeAccess = FileTimeAccess::NONE;
+
+    if (fmt & TYPE_RAM_DISKFILE)
+    {
+        // A scratch disk never creates or changes a file.
+        if (drive_nr >= MAX_DRIVES || floppy[drive_nr].get() != nullptr)
+        {
+            return false;
+        }
+
+        try
+        {
+            pfloppy = IFlexDiskBySectorPtr(
+                new FlexRamDisk(name, options.fileTimeAccess, trk, sec,
+                                fmt & ~static_cast<int>(TYPE_RAM_DISKFILE)));
+        }
+        catch (FlexException &)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> guard(status_mutex);
+        track[drive_nr] = 1; // position to a track != 0 !!!
+        floppy[drive_nr] = std::move(pfloppy);
+        drive_status[drive_nr] = DiskStatus::ACTIVE;
+
+        return true;
+    }
+
+    if (is_overlay)
+    {
+        // An overlay disk never creates or changes a file.
+        return false;
+    }
+
     auto path = disk_dir;
     if (!flx::endsWithPathSeparator(path))
     {
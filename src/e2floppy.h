@@ -46,7 +46,7 @@
 
 struct sOptions;
 
-class E2floppy : public Wd1793
+class E2floppy final : public Wd1793
 {
 private:
 
@@ -93,6 +93,7 @@ private:
     std::array<Byte, 1024>sector_buffer{};
     std::string disk_dir;
     mutable std::mutex status_mutex;
+    bool is_overlay{}; // All disks are RAM disks, changes are discarded
     // data for CMD_WRITETRACK
     WriteTrackState writeTrackState{WriteTrackState::Inactive};
     Word offset{}; // offset when reading or writing a track
@@ -114,6 +115,8 @@ public:
     {
         return "fdc";
     };
+    void saveState(SnapshotWriter &writer) override;
+    RestoreStateFct restoreState(SnapshotReader &reader) override;
 
     virtual void get_drive_status(std::array<DiskStatus, MAX_DRIVES> &stat);
     virtual void disk_directory(const std::string &p_disk_dir);
@@ -121,10 +124,14 @@ public:
             const std::array<std::string, MAX_DRIVES> &drives);
     virtual bool sync_all_drives(tMountOption option = MOUNT_DEFAULT);
     virtual bool umount_all_drives();
+    virtual bool overlay_all_drives();
     virtual bool mount_drive(const std::string &path, Word drive_nr,
                              tMountOption option = MOUNT_DEFAULT);
+    // If fmt contains TYPE_RAM_DISKFILE a scratch disk without backing
+    // file is formatted in memory and mounted to drive drive_nr.
     virtual bool format_disk(SWord trk, SWord sec,
-                             const std::string &name, int fmt);
+                             const std::string &name, int fmt,
+                             Word drive_nr = MAX_DRIVES);
     virtual bool sync_drive(Word drive_nr,
                             tMountOption option = MOUNT_DEFAULT);
     virtual bool umount_drive(Word drive_nr);
@@ -149,6 +156,8 @@ private:
     bool isSeekError(Byte new_track) const override;
     Word getBytesPerSector() const override;
     Byte getSizeCode() const;
+    IFlexDiskBySectorPtr open_drive(const std::string &path, Word drive_nr,
+                                    tMountOption option = MOUNT_DEFAULT) const;
 };
 
 #endif /* #ifndef __fromflex__ */
@@ -43,6 +43,11 @@ std::string FlexDiskAttributes::GetTypeString() const
         {
             str = "Disk image file";
         }
+
+        if (type & TYPE_DEDUP_DISKFILE)
+        {
+            str += ", deduplicated";
+        }
     }
     else if (type & TYPE_DIRECTORY)
     {
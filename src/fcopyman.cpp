@@ -27,6 +27,7 @@
 #include "flexerr.h"
 #include "fcinfo.h"
 #include "ffilebuf.h"
+#include "ffilecnt.h"
 
 bool FlexCopyManager::autoTextConversion = false;
 
@@ -52,25 +53,41 @@ bool FlexCopyManager::FileCopy(const std::string &sourcName,
                             diskAttributes.GetPath());
     }
 
-    auto fileBuffer = src.ReadToBuffer(sourcName);
+    auto *srcDisk = dynamic_cast<FlexDisk *>(&src);
+    auto *dstDisk = dynamic_cast<FlexDisk *>(&dst);
+    bool isSuccess;
 
-    if ((src.GetFlexDiskType() & TYPE_DISKFILE) &&
-        (dst.GetFlexDiskType() & TYPE_DIRECTORY) &&
-        fileBuffer.IsFlexTextFile() && autoTextConversion)
+    if (srcDisk != nullptr && dstDisk != nullptr)
     {
-        fileBuffer.ConvertToTextFile();
-        isTextFile = true;
+        // Between FLEX disk image files the sectors are copied directly
+        // without reading the whole file into a buffer.
+        isSuccess =
+            dstDisk->CopyFilesFrom(*srcDisk, {{ sourcName, destName }});
     }
-
-    if ((src.GetFlexDiskType() & TYPE_DIRECTORY) &&
-        (dst.GetFlexDiskType() & TYPE_DISKFILE) &&
-        fileBuffer.IsTextFile() && autoTextConversion)
+    else
     {
-        fileBuffer.ConvertToFlexTextFile();
-        isTextFile = true;
+        auto fileBuffer = src.ReadToBuffer(sourcName);
+
+        if ((src.GetFlexDiskType() & TYPE_DISKFILE) &&
+            (dst.GetFlexDiskType() & TYPE_DIRECTORY) &&
+            fileBuffer.IsFlexTextFile() && autoTextConversion)
+        {
+            fileBuffer.ConvertToTextFile();
+            isTextFile = true;
+        }
+
+        if ((src.GetFlexDiskType() & TYPE_DIRECTORY) &&
+            (dst.GetFlexDiskType() & TYPE_DISKFILE) &&
+            fileBuffer.IsTextFile() && autoTextConversion)
+        {
+            fileBuffer.ConvertToFlexTextFile();
+            isTextFile = true;
+        }
+
+        isSuccess = dst.WriteFromBuffer(fileBuffer, destName.c_str());
     }
 
-    if (!dst.WriteFromBuffer(fileBuffer, destName.c_str()))
+    if (!isSuccess)
     {
         FlexDiskAttributes diskAttributes;
 
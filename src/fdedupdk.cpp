@@ -0,0 +1,232 @@
+/*
+    fdedupdk.cpp
+
+
+    FLEXplorer, An explorer for FLEX disk image files and directory disks.
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "misc1.h"
+#include "fdedupdk.h"
+#include "ffilecnt.h"
+#include "fcinfo.h"
+#include "fattrib.h"
+#include "flexerr.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+
+FlexDedupDisk::FlexDedupDisk(std::shared_ptr<const FlexDedupStore> p_store,
+                             const std::string &p_name)
+    : store(std::move(p_store))
+    , name(p_name)
+{
+    if (!store)
+    {
+        throw FlexException(FERR_INVALID_NULL_POINTER, "store");
+    }
+
+    manifest = store->ReadManifest(name);
+
+    const auto &header = manifest.header;
+    s_flex_header flx_header{};
+
+    if (header.size() == sizeof(flx_header))
+    {
+        std::memcpy(&flx_header, header.data(), sizeof(flx_header));
+    }
+
+    if (flx::fromBigEndian(flx_header.magic_number) == MAGIC_NUMBER)
+    {
+        type = TYPE_DISKFILE | TYPE_FLX_DISKFILE | TYPE_DEDUP_DISKFILE;
+        tracks = flx_header.tracks;
+        sectors = flx_header.sectors * flx_header.sides;
+        sectors0 = flx_header.sectors0 * flx_header.sides0;
+        track0_sectors = sectors0;
+        is_flex_format = (tracks != 0 && sectors != 0 && sectors0 != 0 &&
+                          getBytesPerSector(flx_header.sizecode) ==
+                          SECTOR_SIZE);
+        return;
+    }
+
+    type = TYPE_DISKFILE | TYPE_DSK_DISKFILE | TYPE_DEDUP_DISKFILE;
+    if (!header.empty())
+    {
+        type |= TYPE_JVC_HEADER;
+    }
+
+    // For DSK format the geometry is read from the system info sector.
+    // Track 0 always has the same sector count as all other tracks.
+    const auto sisIndex = static_cast<size_t>(sis_trk_sec.sec - 1);
+    if (manifest.indices.size() > sisIndex)
+    {
+        s_sys_info_sector sis{};
+
+        if (!store->ReadSector(manifest.indices[sisIndex],
+                               reinterpret_cast<Byte *>(&sis)))
+        {
+            return;
+        }
+        tracks = sis.sir.last.trk + 1;
+        sectors = sis.sir.last.sec;
+        track0_sectors = sectors;
+        is_flex_format = (sectors != 0);
+        EvaluateTrack0SectorCount();
+    }
+}
+
+// Same evaluation as in FlexDisk::EvaluateTrack0SectorCount().
+void FlexDedupDisk::EvaluateTrack0SectorCount()
+{
+    int i;
+
+    if (!FlexDisk::onTrack0OnlyDirSectors)
+    {
+        sectors0 = sectors;
+        return;
+    }
+
+    for (i = first_dir_trk_sec.sec - 1; i < sectors; ++i)
+    {
+        if (static_cast<size_t>(i) >= manifest.indices.size())
+        {
+            break;
+        }
+
+        std::array<Byte, SECTOR_SIZE> sector{};
+
+        if (!store->ReadSector(manifest.indices[i], sector.data()))
+        {
+            break;
+        }
+        const st_t link{sector[0], sector[1]};
+
+        if (link == st_t{0, 0} || link.trk != 0)
+        {
+            break;
+        }
+    }
+
+    sectors0 = std::min(sectors, i + 1);
+}
+
+DWord FlexDedupDisk::GetSectorIndex(int track, int sector) const
+{
+    if (track == 0)
+    {
+        return static_cast<DWord>(sector - 1);
+    }
+
+    return static_cast<DWord>(track0_sectors + (track - 1) * sectors +
+                              sector - 1);
+}
+
+bool FlexDedupDisk::IsWriteProtected() const
+{
+    return true;
+}
+
+bool FlexDedupDisk::GetDiskAttributes(
+        FlexDiskAttributes &diskAttributes) const
+{
+    s_sys_info_sector sis{};
+
+    if (is_flex_format &&
+        ReadSector(reinterpret_cast<Byte *>(&sis), sis_trk_sec.trk,
+                   sis_trk_sec.sec))
+    {
+        FlexDisk::SetDiskAttributesFrom(sis, SECTOR_SIZE, diskAttributes);
+    }
+
+    diskAttributes.SetTrackSector(tracks, sectors);
+    diskAttributes.SetIsFlexFormat(is_flex_format);
+    diskAttributes.SetPath(GetPath());
+    diskAttributes.SetType(static_cast<int>(type));
+    diskAttributes.SetAttributes(static_cast<Byte>(WRITE_PROTECT));
+    diskAttributes.SetIsWriteProtected(true);
+    if (type & TYPE_JVC_HEADER)
+    {
+        diskAttributes.SetJvcFileHeader(manifest.header);
+    }
+
+    return true;
+}
+
+unsigned FlexDedupDisk::GetFlexDiskType() const
+{
+    return type;
+}
+
+std::string FlexDedupDisk::GetPath() const
+{
+    return store->GetDirectory() + PATHSEPARATORSTRING + name;
+}
+
+bool FlexDedupDisk::ReadSector(Byte *buffer, int trk, int sec,
+                               int /* side = -1 */) const
+{
+    if (!IsTrackValid(trk) || !IsSectorValid(trk, sec))
+    {
+        return false;
+    }
+
+    const auto index = manifest.indices[GetSectorIndex(trk, sec)];
+
+    return store->ReadSector(index, buffer);
+}
+
+bool FlexDedupDisk::WriteSector(const Byte * /* buffer */, int /* trk */,
+                                int /* sec */, int /* side = -1 */)
+{
+    return false;
+}
+
+bool FlexDedupDisk::FormatSector(const Byte * /* buffer */, int /* trk */,
+                                 int /* sec */, int /* side */,
+                                 unsigned /* sizecode */)
+{
+    return false;
+}
+
+bool FlexDedupDisk::IsFlexFormat() const
+{
+    return is_flex_format;
+}
+
+bool FlexDedupDisk::IsTrackValid(int track) const
+{
+    return is_flex_format && track >= 0 && track < tracks;
+}
+
+bool FlexDedupDisk::IsSectorValid(int track, int sector) const
+{
+    if (!is_flex_format || sector <= 0 ||
+        sector > ((track == 0) ? sectors0 : sectors))
+    {
+        return false;
+    }
+
+    return GetSectorIndex(track, sector) < manifest.indices.size();
+}
+
+unsigned FlexDedupDisk::GetBytesPerSector() const
+{
+    return SECTOR_SIZE;
+}
+
@@ -0,0 +1,83 @@
+/*
+    fdedupdk.h
+
+
+    FLEXplorer, An explorer for FLEX disk image files and directory disks.
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef FDEDUPDK_INCLUDED
+#define FDEDUPDK_INCLUDED
+
+#include "filecnts.h"
+#include "fdedupst.h"
+#include <string>
+#include <memory>
+
+// class FlexDedupDisk implements a read-only sector oriented access to
+// a FLEX disk image in a deduplicating store (see FlexDedupStore).
+// The geometry is evaluated from the FLX header or from the system
+// info sector of the disk image. All disk images of the same store share
+// the store, which reads the sectors on demand.
+class FlexDedupDisk : public IFlexDiskBySector
+{
+public:
+    FlexDedupDisk() = delete;
+    FlexDedupDisk(const FlexDedupDisk &src) = delete;
+    FlexDedupDisk(FlexDedupDisk &&src) = delete;
+    FlexDedupDisk(std::shared_ptr<const FlexDedupStore> p_store,
+                  const std::string &p_name);
+    ~FlexDedupDisk() override = default;
+
+    FlexDedupDisk &operator= (const FlexDedupDisk &src) = delete;
+    FlexDedupDisk &operator= (FlexDedupDisk &&src) = delete;
+
+    // IFlexDiskBase interface declaration.
+    bool IsWriteProtected() const override;
+    bool GetDiskAttributes(FlexDiskAttributes &diskAttributes) const override;
+    unsigned GetFlexDiskType() const override;
+    std::string GetPath() const override;
+
+    // IFlexDiskBySector interface declaration.
+    bool ReadSector(Byte *buffer, int trk, int sec,
+                    int side = -1) const override;
+    bool WriteSector(const Byte *buffer, int trk, int sec,
+                     int side = -1) override;
+    bool FormatSector(const Byte *buffer, int trk, int sec, int side,
+                      unsigned sizecode) override;
+    bool IsFlexFormat() const override;
+    bool IsTrackValid(int track) const override;
+    bool IsSectorValid(int track, int sector) const override;
+    unsigned GetBytesPerSector() const override;
+
+private:
+    void EvaluateTrack0SectorCount();
+    DWord GetSectorIndex(int track, int sector) const;
+
+    std::shared_ptr<const FlexDedupStore> store;
+    std::string name;
+    s_dedup_manifest manifest;
+    unsigned type{};
+    bool is_flex_format{false};
+    int tracks{};
+    int sectors{}; // Sectors per track (all sides) for track != 0.
+    int sectors0{}; // Accessible sectors on track 0.
+    int track0_sectors{}; // Sectors of track 0 stored in the image file.
+};
+
+#endif // FDEDUPDK_INCLUDED
+
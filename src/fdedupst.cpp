@@ -0,0 +1,573 @@
+/*
+    fdedupst.cpp
+
+
+    FLEXplorer, An explorer for FLEX disk image files and directory disks.
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "misc1.h"
+#include "fdedupst.h"
+#include "ffilecnt.h"
+#include "flexerr.h"
+#include "bdir.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <iterator>
+#include <sstream>
+#include <cerrno>
+#include <cstdio>
+
+
+static const std::string sectorsFileName{"sectors.dat"};
+static const std::string indexFileName{"sectors.idx"};
+static const std::string lockFileName{"sectors.lck"};
+static const std::string manifestExtension{".fsm"};
+static const DWord CRC32_POLYNOMIAL = 0x04C11DB7U;
+
+// Size of the fixed part of a manifest file:
+// magic number, file size, header size and sector count.
+static const size_t manifestHeaderSize = 3U * sizeof(DWord) + sizeof(Word);
+
+// The lock file is created exclusively while sectors are appended to the
+// store. If it already exists another process is appending or a previous
+// one has been aborted.
+class StoreLock
+{
+public:
+    StoreLock() = delete;
+    StoreLock(const StoreLock &src) = delete;
+    StoreLock(StoreLock &&src) = delete;
+    StoreLock(const std::string &p_directory, std::string p_path)
+        : path(std::move(p_path))
+    {
+        auto *file = std::fopen(path.c_str(), "wbx");
+
+        if (file == nullptr)
+        {
+            if (errno == EEXIST)
+            {
+                throw FlexException(FERR_STORE_LOCKED, p_directory, path);
+            }
+            throw FlexException(FERR_UNABLE_TO_CREATE, path);
+        }
+        std::fclose(file);
+    }
+    ~StoreLock()
+    {
+        std::remove(path.c_str());
+    }
+
+    StoreLock &operator= (const StoreLock &src) = delete;
+    StoreLock &operator= (StoreLock &&src) = delete;
+
+private:
+    std::string path;
+};
+
+FlexDedupStore::FlexDedupStore(const std::string &p_directory)
+    : directory(p_directory)
+    , crc(CRC32_POLYNOMIAL)
+{
+    if (!BDirectory::Exists(directory) && !BDirectory::Create(directory))
+    {
+        throw FlexException(FERR_UNABLE_TO_CREATE, directory);
+    }
+
+    UpdateIndex();
+}
+
+// Add the hashes of all sectors which have been appended to sectors.dat
+// since the last update, e.g. by another process. The hashes are read
+// from sectors.idx. Only for sectors missing in there the sector is read
+// to calculate its hash and sectors.idx is updated.
+// A trailing partial sector is ignored. It is left over by a failed
+// append or is currently appended by another process.
+void FlexDedupStore::UpdateIndex()
+{
+    const auto path = GetPath(sectorsFileName);
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+
+    if (!ifs.is_open())
+    {
+        // It is a new empty store.
+        return;
+    }
+
+    ifs.seekg(0, std::ios::end);
+    const auto size = static_cast<size_t>(ifs.tellg());
+    if (ifs.fail())
+    {
+        throw FlexException(FERR_READING_FROM, path);
+    }
+
+    const auto count = static_cast<DWord>(size / SECTOR_SIZE);
+    const auto first = GetSectorCount();
+    if (count <= first)
+    {
+        return;
+    }
+
+    std::ifstream idx(GetPath(indexFileName), std::ios::in | std::ios::binary);
+    std::array<Byte, sizeof(DWord)> value{};
+    bool isIndexValid = false;
+
+    hashes.reserve(count);
+    indices.reserve(count);
+    if (idx.is_open() &&
+        idx.read(reinterpret_cast<char *>(value.data()), value.size()) &&
+        flx::getValueBigEndian<DWord>(value.data()) ==
+            DEDUP_INDEX_MAGIC_NUMBER)
+    {
+        isIndexValid = true;
+        idx.seekg(static_cast<std::streamoff>((first + 1U) * sizeof(DWord)));
+        while (GetSectorCount() < count &&
+               idx.read(reinterpret_cast<char *>(value.data()), value.size()))
+        {
+            const auto hash = flx::getValueBigEndian<DWord>(value.data());
+
+            indices.emplace(hash, GetSectorCount());
+            hashes.push_back(hash);
+        }
+    }
+
+    const auto indexed = GetSectorCount();
+    if (indexed < count)
+    {
+        std::array<Byte, SECTOR_SIZE> sector{};
+
+        ifs.seekg(static_cast<std::streamoff>(indexed) * SECTOR_SIZE);
+        while (GetSectorCount() < count)
+        {
+            if (!ifs.read(reinterpret_cast<char *>(sector.data()),
+                          sector.size()))
+            {
+                throw FlexException(FERR_READING_FROM, path);
+            }
+            const auto hash = GetHash(sector.data());
+
+            indices.emplace(hash, GetSectorCount());
+            hashes.push_back(hash);
+        }
+        WriteIndexFile(isIndexValid ? indexed : 0U);
+    }
+}
+
+// Write the hashes from sector index first on into sectors.idx. Writing
+// the index file is optional. If it fails, e.g. because the store is
+// write protected, the missing hashes are calculated on each open.
+void FlexDedupStore::WriteIndexFile(DWord first) const
+{
+    const auto path = GetPath(indexFileName);
+    std::vector<Byte> data;
+    auto mode = std::ios::out | std::ios::binary;
+    std::array<Byte, sizeof(DWord)> value{};
+
+    if (first == 0U)
+    {
+        mode |= std::ios::trunc;
+        flx::setValueBigEndian<DWord>(value.data(), DEDUP_INDEX_MAGIC_NUMBER);
+        data.insert(data.end(), value.cbegin(), value.cend());
+    }
+    else
+    {
+        mode |= std::ios::in;
+    }
+
+    data.reserve(data.size() + (hashes.size() - first) * sizeof(DWord));
+    for (auto iter = hashes.cbegin() + first; iter != hashes.cend(); ++iter)
+    {
+        flx::setValueBigEndian<DWord>(value.data(), *iter);
+        data.insert(data.end(), value.cbegin(), value.cend());
+    }
+
+    std::fstream ofs(path, mode);
+    if (first != 0U)
+    {
+        ofs.seekp(static_cast<std::streamoff>((first + 1U) * sizeof(DWord)));
+    }
+    ofs.write(reinterpret_cast<const char *>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+}
+
+// Remove any data behind the first count sectors of sectors.dat, e.g.
+// sectors partially appended by a failed Import(). Only call it while
+// holding the store lock. A failure is ignored, UpdateIndex() ignores a
+// trailing partial sector.
+void FlexDedupStore::TruncateSectorsFile(DWord count) const
+{
+    namespace fs = std::filesystem;
+    const fs::path path(GetPath(sectorsFileName));
+    const auto size = static_cast<std::uintmax_t>(count) * SECTOR_SIZE;
+    std::error_code error;
+
+    if (fs::exists(path, error) && fs::file_size(path, error) > size)
+    {
+        fs::resize_file(path, size, error);
+    }
+}
+
+// Remove the hashes of all sectors from sector index first on.
+void FlexDedupStore::RemoveSectors(DWord first)
+{
+    for (auto index = first; index < GetSectorCount(); ++index)
+    {
+        const auto range = indices.equal_range(hashes[index]);
+
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second == index)
+            {
+                indices.erase(iter);
+                break;
+            }
+        }
+    }
+    hashes.resize(first);
+}
+
+DWord FlexDedupStore::Import(const std::string &imagePath,
+                             const std::string &name)
+{
+    const auto fileTimeAccess = FileTimeAccess::NONE;
+
+    {
+        // Only FLEX compatible disk image files are supported.
+        FlexDisk disk(imagePath, std::ios::in | std::ios::binary,
+                      fileTimeAccess);
+
+        if (!disk.IsFlexFormat())
+        {
+            throw FlexException(FERR_CONTAINER_UNFORMATTED, imagePath);
+        }
+    }
+
+    std::ifstream ifs(imagePath, std::ios::in | std::ios::binary);
+    std::vector<Byte> image;
+
+    if (!ifs.is_open())
+    {
+        throw FlexException(FERR_UNABLE_TO_OPEN, imagePath);
+    }
+    image.assign(std::istreambuf_iterator<char>(ifs),
+                 std::istreambuf_iterator<char>());
+    if (ifs.bad())
+    {
+        throw FlexException(FERR_READING_FROM, imagePath);
+    }
+
+    // Only one process at a time can append sectors. Sectors appended by
+    // another process since this store has been opened are also used.
+    const StoreLock lock(directory, GetPath(lockFileName));
+    UpdateIndex();
+    // New sectors have to be appended after the last complete sector.
+    TruncateSectorsFile(GetSectorCount());
+
+    // All supported disk image file formats consist of a file header
+    // (of size 0 for a DSK file without JVC header) followed by sectors.
+    s_dedup_manifest manifest;
+    const auto headerSize = image.size() % SECTOR_SIZE;
+    const auto oldCount = GetSectorCount();
+    std::vector<Byte> newSectors;
+
+    manifest.fileSize = static_cast<DWord>(image.size());
+    manifest.header.assign(image.cbegin(), image.cbegin() + headerSize);
+    manifest.indices.reserve(image.size() / SECTOR_SIZE);
+    try
+    {
+        for (auto offset = headerSize; offset < image.size();
+             offset += SECTOR_SIZE)
+        {
+            manifest.indices.push_back(AddSector(&image[offset], newSectors));
+        }
+
+        // First append the new sectors, then write the manifest referring
+        // to them.
+        if (!newSectors.empty())
+        {
+            const auto path = GetPath(sectorsFileName);
+            std::ofstream ofs(path, std::ios::out | std::ios::binary |
+                                    std::ios::app);
+
+            ofs.write(reinterpret_cast<const char *>(newSectors.data()),
+                      static_cast<std::streamsize>(newSectors.size()));
+            if (!ofs.is_open() || ofs.fail())
+            {
+                throw FlexException(FERR_WRITING_TO, path);
+            }
+        }
+    }
+    catch (FlexException &)
+    {
+        RemoveSectors(oldCount);
+        TruncateSectorsFile(oldCount);
+        throw;
+    }
+    WriteIndexFile(oldCount);
+
+    std::vector<Byte> data(manifestHeaderSize);
+    Byte *p = data.data();
+
+    flx::setValueBigEndian<DWord>(p, DEDUP_MAGIC_NUMBER);
+    flx::setValueBigEndian<DWord>(p + 4, manifest.fileSize);
+    flx::setValueBigEndian<DWord>(p + 8,
+            static_cast<DWord>(manifest.indices.size()));
+    flx::setValueBigEndian<Word>(p + 12,
+            static_cast<Word>(manifest.header.size()));
+    data.insert(data.end(), manifest.header.cbegin(), manifest.header.cend());
+    for (auto index : manifest.indices)
+    {
+        std::array<Byte, sizeof(DWord)> value{};
+
+        flx::setValueBigEndian<DWord>(value.data(), index);
+        data.insert(data.end(), value.cbegin(), value.cend());
+    }
+
+    const auto path = GetManifestPath(name);
+    std::ofstream ofs(path, std::ios::out | std::ios::binary |
+                            std::ios::trunc);
+
+    ofs.write(reinterpret_cast<const char *>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+    if (!ofs.is_open() || ofs.fail())
+    {
+        throw FlexException(FERR_WRITING_TO, path);
+    }
+
+    return GetSectorCount() - oldCount;
+}
+
+void FlexDedupStore::Export(const std::string &name,
+                            const std::string &imagePath) const
+{
+    const auto manifest = ReadManifest(name);
+    std::ofstream ofs(imagePath, std::ios::out | std::ios::binary |
+                                 std::ios::trunc);
+
+    if (!ofs.is_open())
+    {
+        throw FlexException(FERR_UNABLE_TO_CREATE, imagePath);
+    }
+
+    ofs.write(reinterpret_cast<const char *>(manifest.header.data()),
+              static_cast<std::streamsize>(manifest.header.size()));
+    for (auto index : manifest.indices)
+    {
+        std::array<Byte, SECTOR_SIZE> sector{};
+
+        if (!ReadSector(index, sector.data()))
+        {
+            throw FlexException(FERR_READING_FROM, GetPath(sectorsFileName));
+        }
+        ofs.write(reinterpret_cast<const char *>(sector.data()),
+                  SECTOR_SIZE);
+    }
+
+    if (ofs.fail())
+    {
+        throw FlexException(FERR_WRITING_TO, imagePath);
+    }
+}
+
+bool FlexDedupStore::IsStore(const std::string &p_directory)
+{
+    std::ifstream ifs(p_directory + PATHSEPARATORSTRING + sectorsFileName);
+
+    return ifs.is_open();
+}
+
+bool FlexDedupStore::HasImage(const std::string &name) const
+{
+    std::ifstream ifs(GetManifestPath(name));
+
+    return ifs.is_open();
+}
+
+std::vector<std::string> FlexDedupStore::GetImageNames() const
+{
+    std::vector<std::string> names;
+
+    for (const auto &file : BDirectory::GetFiles(directory))
+    {
+        if (file.size() > manifestExtension.size() &&
+            file.compare(file.size() - manifestExtension.size(),
+                         manifestExtension.size(), manifestExtension) == 0)
+        {
+            names.push_back(
+                file.substr(0U, file.size() - manifestExtension.size()));
+        }
+    }
+    std::sort(names.begin(), names.end());
+
+    return names;
+}
+
+s_dedup_manifest FlexDedupStore::ReadManifest(const std::string &name) const
+{
+    const auto path = GetManifestPath(name);
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+    std::vector<Byte> data;
+    s_dedup_manifest manifest;
+
+    if (!ifs.is_open())
+    {
+        throw FlexException(FERR_UNABLE_TO_OPEN, path);
+    }
+    data.assign(std::istreambuf_iterator<char>(ifs),
+                std::istreambuf_iterator<char>());
+    if (ifs.bad() || data.size() < manifestHeaderSize)
+    {
+        throw FlexException(FERR_READING_FROM, path);
+    }
+
+    const Byte *p = data.data();
+    const auto magicNumber = flx::getValueBigEndian<DWord>(p);
+    if (magicNumber != DEDUP_MAGIC_NUMBER)
+    {
+        std::stringstream stream;
+
+        stream << std::hex << magicNumber;
+        throw FlexException(FERR_INVALID_MAGIC_NUMBER, stream.str());
+    }
+
+    manifest.fileSize = flx::getValueBigEndian<DWord>(p + 4);
+    const auto count = flx::getValueBigEndian<DWord>(p + 8);
+    const auto headerSize = flx::getValueBigEndian<Word>(p + 12);
+    if (data.size() != manifestHeaderSize + headerSize +
+                       count * sizeof(DWord) ||
+        manifest.fileSize != headerSize + count * SECTOR_SIZE)
+    {
+        throw FlexException(FERR_READING_FROM, path);
+    }
+
+    p += manifestHeaderSize;
+    manifest.header.assign(p, p + headerSize);
+    p += headerSize;
+    manifest.indices.reserve(count);
+    for (DWord i = 0U; i < count; ++i, p += sizeof(DWord))
+    {
+        const auto index = flx::getValueBigEndian<DWord>(p);
+
+        if (index >= GetSectorCount())
+        {
+            throw FlexException(FERR_READING_FROM, path);
+        }
+        manifest.indices.push_back(index);
+    }
+
+    return manifest;
+}
+
+// Read a sector from sectors.dat. It can be called concurrently by all
+// disk images of this store.
+bool FlexDedupStore::ReadSector(DWord index, Byte *buffer) const
+{
+    std::lock_guard<std::mutex> guard(sectorsMutex);
+
+    if (index >= GetSectorCount())
+    {
+        return false;
+    }
+
+    if (!sectorsStream.is_open())
+    {
+        sectorsStream.open(GetPath(sectorsFileName),
+                           std::ios::in | std::ios::binary);
+    }
+
+    sectorsStream.seekg(static_cast<std::streamoff>(index) * SECTOR_SIZE);
+    sectorsStream.read(reinterpret_cast<char *>(buffer), SECTOR_SIZE);
+    if (sectorsStream.fail())
+    {
+        sectorsStream.clear();
+        return false;
+    }
+
+    return true;
+}
+
+DWord FlexDedupStore::GetSectorCount() const
+{
+    return static_cast<DWord>(hashes.size());
+}
+
+const std::string &FlexDedupStore::GetDirectory() const
+{
+    return directory;
+}
+
+// Return the index of a sector with the given contents. If it does not
+// exist yet it is added to the store. Sectors not yet written to
+// sectors.dat are collected in newSectors.
+// The contents of a sector with the same hash is read from sectors.dat
+// to compare it, so hash collisions are no problem.
+DWord FlexDedupStore::AddSector(const Byte *sector,
+                                std::vector<Byte> &newSectors)
+{
+    const auto hash = GetHash(sector);
+    const auto range = indices.equal_range(hash);
+    const auto firstNew =
+        GetSectorCount() - static_cast<DWord>(newSectors.size() / SECTOR_SIZE);
+    std::array<Byte, SECTOR_SIZE> buffer{};
+
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        const Byte *other = buffer.data();
+
+        if (iter->second >= firstNew)
+        {
+            other = &newSectors[static_cast<size_t>(iter->second - firstNew) *
+                                SECTOR_SIZE];
+        }
+        else if (!ReadSector(iter->second, buffer.data()))
+        {
+            throw FlexException(FERR_READING_FROM, GetPath(sectorsFileName));
+        }
+
+        if (std::memcmp(other, sector, SECTOR_SIZE) == 0)
+        {
+            return iter->second;
+        }
+    }
+
+    const auto index = GetSectorCount();
+    newSectors.insert(newSectors.end(), sector, sector + SECTOR_SIZE);
+    indices.emplace(hash, index);
+    hashes.push_back(hash);
+
+    return index;
+}
+
+std::string FlexDedupStore::GetPath(const std::string &fileName) const
+{
+    return directory + PATHSEPARATORSTRING + fileName;
+}
+
+std::string FlexDedupStore::GetManifestPath(const std::string &name) const
+{
+    return GetPath(name + manifestExtension);
+}
+
+DWord FlexDedupStore::GetHash(const Byte *sector)
+{
+    return crc.GetResult(sector, sector + SECTOR_SIZE);
+}
+
@@ -0,0 +1,113 @@
+/*
+    fdedupst.h
+
+
+    FLEXplorer, An explorer for FLEX disk image files and directory disks.
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef FDEDUPST_INCLUDED
+#define FDEDUPST_INCLUDED
+
+#include "misc1.h"
+#include "crc.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+
+// Magic number of a disk image manifest in a deduplicating store.
+// It is stored in big endian format.
+const DWord DEDUP_MAGIC_NUMBER = 0x46534d31; // "FSM1"
+// Magic number of the sector hash index of a deduplicating store.
+const DWord DEDUP_INDEX_MAGIC_NUMBER = 0x46534931; // "FSI1"
+
+// The manifest of a disk image in a deduplicating store.
+// A disk image file is split into an optional file header and
+// 256 Byte sectors. The file header (e.g. a FLX or JVC header) is
+// stored in the manifest. Each sector is stored only once in the store,
+// the manifest contains the index of each sector.
+struct s_dedup_manifest
+{
+    DWord fileSize{}; // Size of the disk image file in byte.
+    std::vector<Byte> header; // File header of the disk image file.
+    std::vector<DWord> indices; // Sector index of each sector in the store.
+};
+
+// class FlexDedupStore is a content addressed store for FLEX disk image
+// files. It is located in a host directory containing:
+// - sectors.dat: All unique sectors of all disk images.
+// - sectors.idx: The CRC32 hash of each sector in sectors.dat.
+// - sectors.lck: Only exists while a process appends to the store.
+// - <name>.fsm: One manifest for each disk image file with this name.
+// Identical sectors of any disk image (e.g. identical files or free
+// sectors) are stored only once. New sectors are only appended to
+// sectors.dat, so existing manifests stay valid.
+// Only the hash index is kept in memory. Sectors are read from
+// sectors.dat when needed. A store can be shared by all disk images of
+// the same store, see FlexDedupDisk.
+class FlexDedupStore
+{
+public:
+    FlexDedupStore() = delete;
+    FlexDedupStore(const FlexDedupStore &src) = delete;
+    FlexDedupStore(FlexDedupStore &&src) = delete;
+    explicit FlexDedupStore(const std::string &p_directory);
+    ~FlexDedupStore() = default;
+
+    FlexDedupStore &operator= (const FlexDedupStore &src) = delete;
+    FlexDedupStore &operator= (FlexDedupStore &&src) = delete;
+
+    // Add a FLEX disk image file to the store with the given name. An
+    // existing image with the same name is overwritten.
+    // Return the number of sectors which had to be newly stored.
+    DWord Import(const std::string &imagePath, const std::string &name);
+    // Write the disk image with the given name into a file. The file is
+    // identical to the imported one.
+    void Export(const std::string &name, const std::string &imagePath) const;
+    bool HasImage(const std::string &name) const;
+    std::vector<std::string> GetImageNames() const;
+    s_dedup_manifest ReadManifest(const std::string &name) const;
+    bool ReadSector(DWord index, Byte *buffer) const;
+    DWord GetSectorCount() const;
+    const std::string &GetDirectory() const;
+    // Return true if the directory contains a deduplicating store.
+    static bool IsStore(const std::string &p_directory);
+
+private:
+    void UpdateIndex();
+    void WriteIndexFile(DWord first) const;
+    void RemoveSectors(DWord first);
+    void TruncateSectorsFile(DWord count) const;
+    DWord AddSector(const Byte *sector, std::vector<Byte> &newSectors);
+    std::string GetPath(const std::string &fileName) const;
+    std::string GetManifestPath(const std::string &name) const;
+    DWord GetHash(const Byte *sector);
+
+    std::string directory;
+    Crc<DWord> crc;
+    std::vector<DWord> hashes; // Hash of each sector in sectors.dat.
+    // Key: hash of sector contents, value: sector index.
+    std::unordered_multimap<DWord, DWord> indices;
+    mutable std::ifstream sectorsStream;
+    mutable std::mutex sectorsMutex;
+};
+
+#endif // FDEDUPST_INCLUDED
+
@@ -26,6 +26,7 @@
 #include <ctime>
 #include "bdate.h"
 #include "ffilebuf.h"
+#include "ftxtconv.h"
 #include "flexerr.h"
 #include "fdirent.h"
 #include "filecntb.h"
@@ -134,78 +135,6 @@ void FlexFileBuffer::Realloc(DWord newSize,
     fileHeader.fileSize = newSize;
 }
 
-// Traverse through a given FLEX text file and call a function for each
-// converted character for converting to a host operating system text file.
-void FlexFileBuffer::TraverseForTextFileConversion(
-        const std::function<void(Byte c)>& fct) const
-{
-    for (DWord index = 0; index < fileHeader.fileSize; index++)
-    {
-        Byte c = buffer[index];
-
-        if (c >= ' ')
-        {
-            fct(c);
-        }
-        else if (c == 0x0d)
-        {
-            // Convert ASCII CR, the FLEX text file end of line character
-            // into a new line (depending on the operating system).
-#ifdef _WIN32
-            fct(0x0d);
-#endif
-            fct(0x0a);
-        }
-        else if (c == 0x09)
-        {
-            Byte spaces = 0;
-
-            // Expand space compression.
-            if (index < fileHeader.fileSize - 1)
-            {
-                spaces = buffer[++index];
-            }
-            else
-            {
-                spaces = 1;
-            }
-
-            while (spaces--)
-            {
-                fct(' ');
-            }
-        }
-        else if (c == 0x1a)
-        {
-            break; // ASCII SUB is end of file marker
-        }
-
-        // Other control characters than ASCII TAB, ASCII CR, ASCII SUB
-        // are ignored.
-    }
-}
-
-// Estimate the needed buffer size after converting
-// a given FLEX text file into a text file on the host operating
-// system.
-// Returns the estimated file size in byte.
-DWord FlexFileBuffer::SizeOfConvertedTextFile() const
-{
-    DWord count = 0;
-
-    if (buffer.empty())
-    {
-        return count;
-    }
-
-    TraverseForTextFileConversion([&count](Byte)
-        {
-            count++;
-        });
-
-    return count;
-}
-
 // Convert a FLEX text file into a text file on the host operating
 // system.
 // Replace the buffer contents by the converted file contents.
@@ -216,83 +145,16 @@ void FlexFileBuffer::ConvertToTextFile()
         return;
     }
 
-    DWord new_size = SizeOfConvertedTextFile();
-    std::vector<Byte> new_buffer(new_size);
-    DWord new_index = 0;
+    FlexTextToHostConverter converter;
+    std::vector<Byte> new_buffer;
 
-    TraverseForTextFileConversion([&new_buffer, &new_index](Byte c)
-        {
-            new_buffer[new_index++] = c;
-        });
+    // Expanded space compression usually needs more space.
+    new_buffer.reserve(fileHeader.fileSize + fileHeader.fileSize / 4U);
+    converter.Convert(buffer.data(), fileHeader.fileSize, new_buffer);
+    converter.Finish(new_buffer);
 
+    fileHeader.fileSize = static_cast<DWord>(new_buffer.size());
     buffer = std::move(new_buffer);
-    fileHeader.fileSize = new_size;
-}
-
-// Traverse through a given host operating system text file and call a function
-// for each converted character for converting to a FLEX text file.
-void FlexFileBuffer::TraverseForFlexTextFileConversion(
-        const std::function<void(Byte c)>& fct) const
-{
-    Byte spaces = 0;
-    auto process_spaces = [&](){
-        if (spaces)
-        {
-            if (spaces == 1)
-            {
-                fct(' ');
-            }
-            else
-            {
-                // Do space compression.
-                fct(0x09);
-                fct(spaces);
-            }
-            spaces = 0;
-        }
-    };
-
-    for (DWord index = 0; index < fileHeader.fileSize; index++)
-    {
-        Byte c = buffer[index];
-
-        if (c == ' ')
-        {
-            if (++spaces == 127)
-            {
-                // Do space compression for a maximum of 127 characters.
-                process_spaces();
-            }
-        }
-        else
-        {
-            process_spaces();
-            if (c > ' ')
-            {
-                fct(c);
-            }
-            else if (c == 0x0a)
-            {
-                // For ASCII LF write ASCII CR indicating end of line
-                // in a FLEX text file.
-                // If ASCII CR is ignored this works for both Unix/Linux
-                // and DOS/Windows text files.
-                fct(0x0d);
-            }
-            else if (c == 0x09)
-            {
-                // ASCII TAB is converted to 8 spaces.
-                fct(0x09);
-                fct(8);
-            }
-
-            // Other control characters than ASCII TAB or ASCII CR will be
-            // ignored.
-        }
-    }
-
-    // Process remaining spaces if file does not end with new line.
-    process_spaces();
 }
 
 // Convert a host operating system text file into a FLEX test file.
@@ -304,86 +166,29 @@ void FlexFileBuffer::ConvertToFlexTextFile()
         return;
     }
 
-    DWord new_size = SizeOfConvertedFlexTextFile();
-    std::vector<Byte> new_buffer(new_size);
-    DWord new_index = 0;
+    HostTextToFlexConverter converter;
+    std::vector<Byte> new_buffer;
 
-    TraverseForFlexTextFileConversion([&new_buffer, &new_index](Byte c)
-        {
-            new_buffer[new_index++] = c;
-        });
+    new_buffer.reserve(fileHeader.fileSize);
+    converter.Convert(buffer.data(), fileHeader.fileSize, new_buffer);
+    converter.Finish(new_buffer);
 
+    fileHeader.fileSize = static_cast<DWord>(new_buffer.size());
     buffer = std::move(new_buffer);
-    fileHeader.fileSize = new_size;
-}
-
-// Estimate the needed buffer size after converting
-// a given text file on the host operating system into a FLEX text file.
-// Returns the estimated file size in byte.
-DWord FlexFileBuffer::SizeOfConvertedFlexTextFile() const
-{
-    DWord count = 0;
-
-    if (buffer.empty())
-    {
-        return count;
-    }
-
-    TraverseForFlexTextFileConversion([&count](Byte)
-        {
-            count++;
-        });
-
-    return count;
 }
 
 // Evaluate if the given file is a text file on the host operating system.
 bool FlexFileBuffer::IsTextFile() const
 {
-    for (DWord i = 0; i < fileHeader.fileSize; i++)
-    {
-        Byte c = buffer[i];
-
-        // Allowed characters of a host operating system text file are:
-        // ASCII LF, ASCII CR, ASCII TAB and any character >= ASCII Space
-        if (c >= ' ' || c == 0x0a || c == 0x0d || c == 0x09)
-        {
-            continue;
-        }
-
-        return false;
-    }
-
-    return true;
+    return HostTextToFlexConverter::IsHostText(buffer.data(),
+                                               fileHeader.fileSize);
 }
 
 // Evaluate if the given file is a FLEX text file.
 bool FlexFileBuffer::IsFlexTextFile() const
 {
-    for (DWord i = 0; i < fileHeader.fileSize; i++)
-    {
-        Byte c = buffer[i];
-
-        // Allowed characters of a FLEX text file are:
-        // ASCII LF, ASCII CR, ASCII NUL, ASCII CANCEL, ASCII FF, ASCII SUB and
-        // any character >= ASCII Space.
-        if (c >= ' ' || c == 0x0a || c == 0x0d || c == 0x00 || c == 0x18 ||
-            c == 0x0c || c == 0x1a)
-        {
-            continue;
-        }
-
-        if (c == 0x09)
-        {
-            // ASCII TAB is followed by one space count byte.
-            i++;
-            continue;
-        }
-
-        return false;
-    }
-
-    return true;
+    return FlexTextToHostConverter::IsFlexText(buffer.data(),
+                                               fileHeader.fileSize);
 }
 
 // Traverse through a given file and call a function
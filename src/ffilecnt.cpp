@@ -27,6 +27,8 @@
 #include <sstream>
 #include <array>
 #include <vector>
+#include <unordered_set>
+#include <algorithm>
 #include <cctype>
 #include <ctime>
 #include <cassert>
@@ -223,6 +225,17 @@ FlexDisk::FlexDisk(
     throw FlexException(FERR_IS_NO_FILECONTAINER, path);
 }
 
+// Constructor for a disk image without a backing file.
+// It is initialized as an unformatted disk.
+FlexDisk::FlexDisk(
+        const std::string &p_path,
+        const FileTimeAccess &fileTimeAccess)
+    : path(p_path)
+    , ft_access(fileTimeAccess)
+{
+    Initialize_unformatted_disk();
+}
+
 /****************************************/
 /* Public interface                     */
 /****************************************/
@@ -313,28 +326,13 @@ bool FlexDisk::FindFile(const std::string &wildcard, FlexDirEntry &entry)
     {
         if (wildcard.find_first_of("*?[]") == std::string::npos)
         {
-            if (!is_filenames_initialized)
-            {
-                InitializeFilenames();
-            }
-
-            const auto iter = filenames.find(flx::tolower(wildcard));
-            if (iter != filenames.end())
+            if (FindInFilenames(wildcard))
             {
-                s_dir_sector sectorBuffer{};
-                const auto &dir_pos = iter->second;
-
-                if (!ReadSector(reinterpret_cast<Byte *>(&sectorBuffer),
-                                    dir_pos.trk_sec.trk, dir_pos.trk_sec.sec))
-                {
-                    std::stringstream stream;
+                st_t dirTrkSec;
+                const auto index = filenames.at(flx::tolower(wildcard));
+                const auto *dir_entry = GetCachedDirEntry(index, dirTrkSec);
 
-                    stream << dir_pos.trk_sec;
-                    throw FlexException(FERR_READING_TRKSEC,
-                                      stream.str(), GetPath());
-                }
-                auto &dir_entry = sectorBuffer.dir_entries[dir_pos.idx];
-                entry = CreateDirEntryFrom(dir_entry, wildcard);
+                entry = CreateDirEntryFrom(*dir_entry, wildcard);
                 return true;
             }
 
@@ -449,12 +447,58 @@ bool FlexDisk::FileCopy(const std::string &sourceName,
     return FlexCopyManager::FileCopy(sourceName, destName, *this, destination);
 }
 
+void FlexDisk::SetDiskAttributesFrom(const s_sys_info_sector &sis,
+                                     unsigned bytesPerSector,
+                                     FlexDiskAttributes &diskAttributes)
+{
+    int year;
+
+    if (sis.sir.year < 75)
+    {
+        year = sis.sir.year + 2000;
+    }
+    else
+    {
+        year = sis.sir.year + 1900;
+    }
+
+    auto size = 0U;
+    while (size < sizeof(sis.sir.disk_name) && sis.sir.disk_name[size])
+    {
+        ++size;
+    }
+    std::string disk_name(sis.sir.disk_name, size);
+    bool is_valid = true;
+    size = 0U;
+    while (size < sizeof(sis.sir.disk_ext) && sis.sir.disk_ext[size])
+    {
+        if (sis.sir.disk_ext[size] < ' ' || sis.sir.disk_ext[size] > '~')
+        {
+            is_valid = false;
+            break;
+        }
+        ++size;
+    }
+    if (size > 0U && is_valid)
+    {
+        disk_name.append(".");
+        disk_name.append(sis.sir.disk_ext, size);
+    }
+    diskAttributes.SetDate(BDate(sis.sir.day, sis.sir.month, year));
+    diskAttributes.SetFree(flx::getValueBigEndian<Word>(&sis.sir.free[0]) *
+                           bytesPerSector);
+    diskAttributes.SetTotalSize((sis.sir.last.sec * (sis.sir.last.trk + 1)) *
+                                bytesPerSector);
+    diskAttributes.SetName(disk_name);
+    diskAttributes.SetNumber(
+            flx::getValueBigEndian<Word>(&sis.sir.disk_number[0]));
+}
+
 bool FlexDisk::GetDiskAttributes(FlexDiskAttributes &diskAttributes) const
 {
     if (is_flex_format)
     {
         s_sys_info_sector sis{};
-        int year;
 
         if (!ReadSector(reinterpret_cast<Byte *>(&sis), sis_trk_sec.trk,
                         sis_trk_sec.sec))
@@ -465,49 +509,7 @@ bool FlexDisk::GetDiskAttributes(FlexDiskAttributes &diskAttributes) const
             throw FlexException(FERR_READING_TRKSEC, stream.str(), path);
         }
 
-        if (sis.sir.year < 75)
-        {
-            year = sis.sir.year + 2000;
-        }
-        else
-        {
-            year = sis.sir.year + 1900;
-        }
-
-        auto size = 0U;
-        while (size < sizeof(sis.sir.disk_name) && sis.sir.disk_name[size])
-        {
-            ++size;
-        }
-        std::string disk_name(sis.sir.disk_name, size);
-        disk_name.append("");
-        bool is_valid = true;
-        size = 0U;
-        while (size < sizeof(sis.sir.disk_ext) && sis.sir.disk_ext[size])
-        {
-            if (sis.sir.disk_ext[size] < ' ' || sis.sir.disk_ext[size] > '~')
-            {
-                is_valid = false;
-                break;
-            }
-            ++size;
-        }
-        if (size > 0U && is_valid)
-        {
-            std::string disk_ext(sis.sir.disk_ext, size);
-            disk_ext.append("");
-            disk_name.append(".");
-            disk_name.append(disk_ext);
-        }
-        diskAttributes.SetDate(BDate(sis.sir.day, sis.sir.month, year));
-        diskAttributes.SetFree(flx::getValueBigEndian<Word>(&sis.sir.free[0]) *
-                               param.byte_p_sector);
-        diskAttributes.SetTotalSize((sis.sir.last.sec *
-                                    (sis.sir.last.trk + 1)) *
-                                    param.byte_p_sector);
-        diskAttributes.SetName(disk_name);
-        diskAttributes.SetNumber(
-                flx::getValueBigEndian<Word>(&sis.sir.disk_number[0]));
+        SetDiskAttributesFrom(sis, param.byte_p_sector, diskAttributes);
     }
 
     diskAttributes.SetTrackSector(
@@ -549,36 +551,161 @@ IFlexDiskIteratorImpPtr FlexDisk::IteratorFactory()
 bool FlexDisk::WriteFromBuffer(const FlexFileBuffer &buffer,
                                const char *p_fileName /* = nullptr */)
 {
-    if (!is_flex_format)
+    const std::string fileName =
+        (p_fileName == nullptr) ? buffer.GetFilename() : p_fileName;
+
+    return WriteFiles({ s_file_to_write{ &buffer, fileName, nullptr, {} } });
+}
+
+bool FlexDisk::WriteFromBuffers(const std::vector<FlexFileBuffer> &buffers)
+{
+    std::vector<s_file_to_write> files;
+
+    files.reserve(buffers.size());
+    for (const auto &buffer : buffers)
     {
-        return false;
+        files.push_back(s_file_to_write{ &buffer, buffer.GetFilename(),
+                                         nullptr, {} });
     }
 
-    Byte trk = 0;
-    Byte sec = 0;
-    st_t start;
-    st_t next;
-    Word recordNr = 0; // Current record number. For random files
-                       // the two sector map sectors are counted too.
-    int count;
-    s_sys_info_sector sis{};
-    std::string fileName;
-    // sectorBuffer[2] and [1] are used for the Sector Map of random files.
-    std::array<SectorBuffer_t, 3> sectorBuffer{};
+    return WriteFiles(files);
+}
+
+bool FlexDisk::CopyFilesFrom(FlexDisk &src,
+        const std::vector<std::pair<std::string, std::string> > &fileNames)
+{
+    if (!src.is_flex_format)
+    {
+        throw FlexException(FERR_CONTAINER_UNFORMATTED, src.path);
+    }
+
+    std::vector<s_file_to_write> files;
+
+    files.reserve(fileNames.size());
+    for (const auto &fileName : fileNames)
+    {
+        s_file_to_write file{ nullptr, fileName.second, &src, {} };
+
+        if (fileName.first.find_first_of("*?[]") != std::string::npos)
+        {
+            throw FlexException(FERR_WILDCARD_NOT_SUPPORTED, fileName.first);
+        }
+
+        if (!src.FindFile(fileName.first, file.srcDirEntry))
+        {
+            throw FlexException(FERR_UNABLE_TO_OPEN, fileName.first);
+        }
+
+        if ((src.ft_access & FileTimeAccess::Get) != FileTimeAccess::Get)
+        {
+            file.srcDirEntry.SetTime(BTime());
+        }
+
+        files.push_back(std::move(file));
+    }
+
+    return WriteFiles(files);
+}
+
+// Number of sectors used by a file. For random files this includes the
+// two sectors of the sector map at the begin of the file.
+DWord FlexDisk::GetSectorCount(const s_file_to_write &file)
+{
+    if (file.buffer == nullptr)
+    {
+        return file.srcDirEntry.GetFileSize() / SECTOR_SIZE;
+    }
+
+    return (file.buffer->GetFileSize() + SECTOR_SIZE - 5U) /
+           (SECTOR_SIZE - 4U);
+}
+
+// Copy the contents of sector index of a file into sector. The link and
+// record number (bytes 0 to 3) have to be set by the caller.
+// If the file is read from another disk srcNext is the track/sector of
+// the source sector. It is updated to the next sector of the chain.
+// For random files the sector map sectors are not copied.
+bool FlexDisk::CopyFileSector(const s_file_to_write &file, DWord index,
+                              st_t &srcNext, SectorBuffer_t &sector)
+{
+    const bool isRandom = (file.buffer != nullptr) ?
+        file.buffer->IsRandom() : file.srcDirEntry.IsRandom();
+
+    if (file.buffer != nullptr)
+    {
+        return (isRandom && index < 2U) ||
+               file.buffer->CopyTo(&sector[4], SECTOR_SIZE - 4,
+                                   index * (SECTOR_SIZE - 4), 0x00);
+    }
+
+    if (srcNext == st_t{})
+    {
+        // The sector chain is shorter than the file size. As for
+        // ReadToBuffer() the missing sectors are filled with zeros.
+        return true;
+    }
+
+    if (!file.srcDisk->ReadSector(sector.data(), srcNext.trk, srcNext.sec))
+    {
+        std::stringstream stream;
+
+        stream << srcNext;
+        throw FlexException(FERR_READING_TRKSEC, stream.str(),
+                            file.srcDirEntry.GetTotalFileName());
+    }
+
+    srcNext.trk = sector[0];
+    srcNext.sec = sector[1];
+    if (isRandom && index < 2U)
+    {
+        sector.fill(0U);
+    }
 
-    fileName = (p_fileName == nullptr) ? buffer.GetFilename() : p_fileName;
+    return true;
+}
 
-    if (FindInFilenames(fileName))
+// All files are written within one transaction:
+// 1. Check all files and walk the free chain once to allocate the sectors
+//    of all files. The free chain also has to contain the sectors needed
+//    to extend the directory. If anything does not fit on the disk an
+//    exception is thrown before any sector is written.
+// 2. Create all file sectors in memory and write them in track-sector
+//    order. All sectors are staged, so reading a source sector can fail
+//    before anything is written. The sector map of a random file is only
+//    complete after all its sectors are created.
+// 3. Update the system info sector and the directory once.
+bool FlexDisk::WriteFiles(const std::vector<s_file_to_write> &files)
+{
+    if (!is_flex_format)
     {
-        throw FlexException(FERR_FILE_ALREADY_EXISTS, fileName);
+        return false;
     }
 
-    if (buffer.GetFileSize() == 0U)
+    std::unordered_set<std::string> newFileNames;
+    DWord sectorCount = 0U;
+
+    for (const auto &file : files)
     {
-        throw FlexException(FERR_COPY_EMPTY_FILE, fileName);
+        if (FindInFilenames(file.fileName) ||
+            !newFileNames.insert(flx::tolower(file.fileName)).second)
+        {
+            throw FlexException(FERR_FILE_ALREADY_EXISTS, file.fileName);
+        }
+
+        // A random file also needs at least one sector after the sector map.
+        const auto count = GetSectorCount(file);
+        const auto &dirEntry = (file.buffer != nullptr) ?
+            file.buffer->GetDirEntry() : file.srcDirEntry;
+        if (count == 0U || (dirEntry.IsRandom() && count <= 2U))
+        {
+            throw FlexException(FERR_COPY_EMPTY_FILE, file.fileName);
+        }
+
+        sectorCount += count;
     }
 
     // read sys info sector
+    s_sys_info_sector sis{};
     if (!ReadSector(reinterpret_cast<Byte *>(&sis), sis_trk_sec.trk,
                     sis_trk_sec.sec))
     {
@@ -588,155 +715,205 @@ bool FlexDisk::WriteFromBuffer(const FlexFileBuffer &buffer,
         throw FlexException(FERR_READING_TRKSEC, stream.str(), path);
     }
 
-    next = start = sis.sir.fc_start;
-
-    // write each sector to buffer
-    Byte repeat = 0;
-    DWord smSector = 2; // Index of current sector map sector (2..1)
-    DWord smIndex = 1; // Byte index within current sector map sector
-    Word nextTrk = 0; // Contains next subsequent track
-    Word nextSec = 0; // Contains next subsequent sector
+    SectorBuffer_t sectorBuffer{};
+    std::vector<st_t> sectors;
+    st_t next = sis.sir.fc_start;
 
-    // at the begin of a random file reserve two sectors for the sector map
-    if (recordNr == 0U && buffer.IsRandom())
+    const auto followFreeChain = [&]()
     {
-        repeat = 2;
-    }
+        if (!ReadSector(sectorBuffer.data(), next.trk, next.sec))
+        {
+            std::stringstream stream;
 
-    while (static_cast<DWord>(recordNr * (SECTOR_SIZE - 4)) <
-            buffer.GetFileSize())
+            stream << next;
+            throw FlexException(FERR_READING_TRKSEC, stream.str(), path);
+        }
+        next.trk = sectorBuffer[0];
+        next.sec = sectorBuffer[1];
+    };
+
+    sectors.reserve(sectorCount);
+    for (const auto &file : files)
     {
-        for (count = repeat; count >= 0; count--)
+        for (auto count = GetSectorCount(file); count > 0U; --count)
         {
-            trk = next.trk;
-            sec = next.sec;
-
-            if (trk == 0 && sec == 0)
+            if (next == st_t{})
             {
-                throw FlexException(FERR_DISK_FULL_WRITING, path, fileName);
+                throw FlexException(FERR_DISK_FULL_WRITING, path,
+                                    file.fileName);
             }
 
-            if (!ReadSector(sectorBuffer[count].data(), trk, sec))
-            {
-                std::stringstream stream;
+            sectors.push_back(next);
+            followFreeChain();
+        }
+    }
 
-                stream << next;
-                throw FlexException(FERR_READING_TRKSEC, stream.str(), path);
-            }
+    const auto newFreeChainStart = next;
+    const auto freeDirEntries = CountFreeDirEntries();
+    if (files.size() > freeDirEntries)
+    {
+        auto dirSectors = (files.size() - freeDirEntries + DIRENTRIES - 1U) /
+                          DIRENTRIES;
 
-            if (count)
+        for (; dirSectors > 0U; --dirSectors)
+        {
+            if (next == st_t{})
             {
-                // For random files the two sector map sectors are
-                // skipped. They are newly generated in sectorBuffer[2]
-                // and sectorBuffer[1].
-                // Here the buffer is initialized to zero.
-                std::memset(&sectorBuffer[count][2], 0, SECTOR_SIZE - 2);
-                ++recordNr;
+                throw FlexException(FERR_DIRECTORY_FULL);
             }
 
-            next.trk = sectorBuffer[count][0];
-            next.sec = sectorBuffer[count][1];
+            followFreeChain();
         }
-        repeat = 0; // Finished preparing random file sector map.
+    }
 
-        if (!buffer.CopyTo(&sectorBuffer[0][4], SECTOR_SIZE - 4,
-                           recordNr * (SECTOR_SIZE - 4), 0x00))
+    // Each file sector links to the next allocated sector. The first two
+    // sectors of a random file contain the sector map.
+    std::vector<std::pair<st_t, SectorBuffer_t> > fileSectors;
+    std::vector<FlexDirEntry> dirEntries;
+    const auto sectorsPerTrack = param.byte_p_track / param.byte_p_sector;
+    size_t index = 0U;
+
+    fileSectors.reserve(sectors.size());
+    dirEntries.reserve(files.size());
+    for (const auto &file : files)
+    {
+        auto dirEntry = (file.buffer != nullptr) ?
+            file.buffer->GetDirEntry() : file.srcDirEntry;
+        const auto count = GetSectorCount(file);
+        const auto first = fileSectors.size();
+        const DWord mapSectors = dirEntry.IsRandom() ? 2U : 0U;
+        size_t smSector = first; // Index of current sector map sector
+        DWord smIndex = 1U; // Byte index within current sector map sector
+        Word nextTrk = 0U; // Contains next subsequent track
+        Word nextSec = 0U; // Contains next subsequent sector
+        st_t srcNext{}; // Next sector to read from source disk
+
+        if (file.srcDisk != nullptr)
         {
-            std::stringstream stream;
+            int srcTrk;
+            int srcSec;
 
-            stream << next;
-            throw FlexException(FERR_WRITING_TRKSEC, stream.str(), path);
+            file.srcDirEntry.GetStartTrkSec(srcTrk, srcSec);
+            srcNext.trk = static_cast<Byte>(srcTrk);
+            srcNext.sec = static_cast<Byte>(srcSec);
         }
 
-        recordNr++;
-
-        if (buffer.IsRandom())
+        for (DWord i = 0U; i < count; ++i)
         {
-            // For random files update the sector map.
-            // For each non continuous sector or if sector count is 255
-            // a new entry in sector map is created.
-            if (trk != nextTrk || sec != nextSec ||
-                sectorBuffer[smSector][smIndex + 2U] == 255U)
+            const auto trk_sec = sectors[index + i];
+            const auto link = (i + 1U < count) ?
+                sectors[index + i + 1U] : st_t{};
+
+            fileSectors.emplace_back(trk_sec, SectorBuffer_t{});
+            auto &sector = fileSectors.back().second;
+            if (!CopyFileSector(file, i, srcNext, sector))
+            {
+                std::stringstream stream;
+
+                stream << trk_sec;
+                throw FlexException(FERR_WRITING_TRKSEC, stream.str(), path);
+            }
+            sector[0] = link.trk;
+            sector[1] = link.sec;
+            if (i < mapSectors)
             {
-                smIndex += 3U;
+                continue;
+            }
 
-                if (smIndex >= SECTOR_SIZE)
+            const auto recordNr = i - mapSectors;
+            flx::setValueBigEndian<Word>(&sector[2],
+                                         static_cast<Word>(recordNr + 1U));
+
+            if (mapSectors != 0U)
+            {
+                // For random files update the sector map.
+                // For each non continuous sector or if sector count is 255
+                // a new entry in sector map is created.
+                if (trk_sec.trk != nextTrk || trk_sec.sec != nextSec ||
+                    fileSectors[smSector].second[smIndex + 2U] == 255U)
                 {
-                    if (--smSector == 0U)
+                    smIndex += 3U;
+
+                    if (smIndex >= SECTOR_SIZE)
                     {
-                        throw FlexException(FERR_RECORDMAP_FULL,
-                                            fileName, path);
+                        if (++smSector == first + mapSectors)
+                        {
+                            throw FlexException(FERR_RECORDMAP_FULL,
+                                                file.fileName, path);
+                        }
+                        smIndex = 4U;
                     }
-                    smIndex = 4U;
-                }
 
-                sectorBuffer[smSector][smIndex] = trk;
-                sectorBuffer[smSector][smIndex + 1U] = sec;
-            }
+                    fileSectors[smSector].second[smIndex] = trk_sec.trk;
+                    fileSectors[smSector].second[smIndex + 1U] = trk_sec.sec;
+                }
 
-            ++sectorBuffer[smSector][smIndex + 2U];
+                ++fileSectors[smSector].second[smIndex + 2U];
 
-            // Calculate the next subsequent track/sector for given trk/sec.
-            nextTrk = trk;
-            nextSec = sec + 1;
-            if (nextSec > (param.byte_p_track / param.byte_p_sector))
-            {
-                ++nextTrk;
-                nextSec = 1;
+                // Calculate the next subsequent track/sector for given
+                // trk/sec.
+                nextTrk = trk_sec.trk;
+                nextSec = trk_sec.sec + 1U;
+                if (nextSec > sectorsPerTrack)
+                {
+                    ++nextTrk;
+                    nextSec = 1U;
+                }
             }
         }
 
-        // Set record number. If last sector of file set link to 0.
-        // Write the sector to disk.
-        flx::setValueBigEndian<Word>(&sectorBuffer[0][2],
-                                recordNr - (buffer.IsRandom() ? 2U : 0U));
+        if (file.srcDisk != nullptr && srcNext != st_t{})
+        {
+            // As for ReadToBuffer() the sector chain must not contain more
+            // sectors than the file size.
+            throw FlexException(FERR_FILE_UNEXPECTED_SEC,
+                                file.srcDirEntry.GetTotalFileName(),
+                                std::to_string(count + 1U));
+        }
 
-        if (static_cast<DWord>(recordNr * (SECTOR_SIZE - 4)) >=
-                buffer.GetFileSize())
+        // Create a new directory entry.
+        const auto &start = sectors[index];
+        const auto &end = sectors[index + count - 1U];
+        dirEntry.SetTotalFileName(file.fileName);
+        if ((ft_access & FileTimeAccess::Set) != FileTimeAccess::Set)
         {
-            sectorBuffer[0][0] = sectorBuffer[0][1] = 0;
+            dirEntry.SetTime(BTime());
         }
+        dirEntry.SetStartTrkSec(start.trk, start.sec);
+        dirEntry.SetEndTrkSec(end.trk, end.sec);
+        dirEntries.push_back(dirEntry);
+
+        index += count;
+    }
+
+    std::sort(fileSectors.begin(), fileSectors.end(),
+              [](const auto &lhs, const auto &rhs){
+        return lhs.first < rhs.first;
+    });
+    for (const auto &fileSector : fileSectors)
+    {
+        const auto &trk_sec = fileSector.first;
 
-        if (!WriteSector(sectorBuffer[0].data(), trk, sec))
+        if (!WriteSector(fileSector.second.data(), trk_sec.trk, trk_sec.sec))
         {
             std::stringstream stream;
 
-            stream << next;
+            stream << trk_sec;
             throw FlexException(FERR_WRITING_TRKSEC, stream.str(), path);
         }
     }
 
-    sis.sir.fc_start = next;
+    // Update the system info sector.
+    sis.sir.fc_start = newFreeChainStart;
 
     // if free chain full, set end trk/sec of free chain also to 0
-    if (!next.sec && !next.trk)
-    {
-        sis.sir.fc_end = next;
-    }
-
-    // if random file, write the sector map buffers back
-    next = start;
-
-    if (buffer.IsRandom())
+    if (newFreeChainStart == st_t{})
     {
-        for (count = 2; count >= 1; count--)
-        {
-            if (!WriteSector(sectorBuffer[count].data(), next.trk, next.sec))
-            {
-                std::stringstream stream;
-
-                stream << next;
-                throw FlexException(FERR_WRITING_TRKSEC, stream.str(), path);
-            }
-
-            next.trk = sectorBuffer[count][0];
-            next.sec = sectorBuffer[count][1];
-        }
+        sis.sir.fc_end = newFreeChainStart;
     }
 
-    // Update the system info sector.
     auto free = flx::getValueBigEndian<Word>(&sis.sir.free[0]);
-    free -= recordNr;
+    free -= static_cast<Word>(sectorCount);
     flx::setValueBigEndian<Word>(&sis.sir.free[0], free);
 
     if (!WriteSector(reinterpret_cast<const Byte *>(&sis), sis_trk_sec.trk,
@@ -748,16 +925,7 @@ bool FlexDisk::WriteFromBuffer(const FlexFileBuffer &buffer,
         throw FlexException(FERR_WRITING_TRKSEC, stream.str(), path);
     }
 
-    // Create a new directory entry.
-    auto dirEntry = buffer.GetDirEntry();
-    dirEntry.SetTotalFileName(fileName);
-    if ((ft_access & FileTimeAccess::Set) != FileTimeAccess::Set)
-    {
-        dirEntry.SetTime(BTime());
-    }
-    dirEntry.SetStartTrkSec(start.trk, start.sec);
-    dirEntry.SetEndTrkSec(trk, sec);
-    CreateDirEntry(dirEntry);
+    CreateDirEntries(dirEntries);
 
     return true;
 }
@@ -866,7 +1034,10 @@ bool FlexDisk::SetAttributes(const std::string &wildcard,
     return true;
 }
 
-bool FlexDisk::CreateDirEntry(FlexDirEntry &entry)
+// Create the directory entries in the free directory slots starting at the
+// directory sector used for the last new file. Each directory sector
+// is written once.
+bool FlexDisk::CreateDirEntries(const std::vector<FlexDirEntry> &entries)
 {
     if (!is_flex_format)
     {
@@ -876,10 +1047,16 @@ bool FlexDisk::CreateDirEntry(FlexDirEntry &entry)
     s_dir_sector dir_sector{};
     s_dir_entry *pde;
     st_t next(next_dir_trk_sec);
+    auto iter = entries.cbegin();
     int tmp1;
     int tmp2;
     BDate date;
 
+    if (iter == entries.cend())
+    {
+        return true;
+    }
+
     if (next == st_t())
     {
         next = first_dir_trk_sec;
@@ -888,6 +1065,8 @@ bool FlexDisk::CreateDirEntry(FlexDirEntry &entry)
     // loop until all directory sectors read
     while (next.sec != 0 || next.trk != 0)
     {
+        bool isModified = false;
+
         // read next directory sector
         if (!ReadSector(reinterpret_cast<Byte *>(&dir_sector), next.trk,
                         next.sec))
@@ -898,13 +1077,14 @@ bool FlexDisk::CreateDirEntry(FlexDirEntry &entry)
             throw FlexException(FERR_READING_TRKSEC, stream.str(), path);
         }
 
-        for (Byte idx = 0U; idx < DIRENTRIES; ++idx)
+        for (Byte idx = 0U; idx < DIRENTRIES && iter != entries.cend(); ++idx)
         {
             // look for the next free directory entry
             pde = &dir_sector.dir_entries[idx];
 
             if (pde->filename[0] == DE_EMPTY || pde->filename[0] == DE_DELETED)
             {
+                const auto &entry = *iter;
                 BTime time;
 
                 if ((ft_access & FileTimeAccess::Set) == FileTimeAccess::Set)
@@ -935,21 +1115,29 @@ bool FlexDisk::CreateDirEntry(FlexDirEntry &entry)
                 pde->month = static_cast<Byte>(date.GetMonth());
                 pde->year = static_cast<Byte>(date.GetYear() % 100);
 
-                if (!WriteSector(reinterpret_cast<const Byte *>(&dir_sector),
-                                 next.trk, next.sec))
-                {
-                    std::stringstream stream;
-
-                    stream << next;
-                    throw FlexException(FERR_WRITING_TRKSEC,
-                                        stream.str(), path);
-                }
+                isModified = true;
+                ++iter;
+            }
+        }
 
-                SetNextDirectoryPosition(next);
-                AddToFilenames(entry.GetTotalFileName(), s_dir_pos{next, idx});
+        if (isModified)
+        {
+            if (!WriteSector(reinterpret_cast<const Byte *>(&dir_sector),
+                             next.trk, next.sec))
+            {
+                std::stringstream stream;
 
-                return true;
+                stream << next;
+                throw FlexException(FERR_WRITING_TRKSEC,
+                                    stream.str(), path);
             }
+
+            SetNextDirectoryPosition(next);
+        }
+
+        if (iter == entries.cend())
+        {
+            return true;
         }
 
         next = (dir_sector.next == st_t{}) ?
@@ -959,6 +1147,45 @@ bool FlexDisk::CreateDirEntry(FlexDirEntry &entry)
     throw FlexException(FERR_DIRECTORY_FULL);
 }
 
+// Count the free directory entries starting at the directory sector used
+// for the last new file.
+size_t FlexDisk::CountFreeDirEntries() const
+{
+    s_dir_sector dir_sector{};
+    st_t next(next_dir_trk_sec);
+    size_t count = 0U;
+
+    if (next == st_t())
+    {
+        next = first_dir_trk_sec;
+    }
+
+    while (next.sec != 0 || next.trk != 0)
+    {
+        if (!ReadSector(reinterpret_cast<Byte *>(&dir_sector), next.trk,
+                        next.sec))
+        {
+            std::stringstream stream;
+
+            stream << next;
+            throw FlexException(FERR_READING_TRKSEC, stream.str(), path);
+        }
+
+        for (const auto &dir_entry : dir_sector.dir_entries)
+        {
+            if (dir_entry.filename[0] == DE_EMPTY ||
+                dir_entry.filename[0] == DE_DELETED)
+            {
+                ++count;
+            }
+        }
+
+        next = dir_sector.next;
+    }
+
+    return count;
+}
+
 // Evaluate the sector count on track 0.
 // Follow the directory chain until end of chain reached or link is
 // pointing to a directory extend on a track != 0.
@@ -1117,6 +1344,8 @@ bool FlexDisk::WriteSector(const Byte *pbuffer, int trk, int sec,
         return false;
     }
 
+    UpdateDirectoryCache(pbuffer, trk, sec);
+
     if (!is_flex_format &&
         trk == 0 && sec == 3 && IsFlexFileFormat(TYPE_FLX_DISKFILE))
     {
@@ -1362,7 +1591,7 @@ void FlexDisk::Create_sys_info_sector(s_sys_info_sector &sis,
 }
 
 // on success return true
-bool FlexDisk::Write_dir_sectors(std::fstream &ofs, struct s_formats &format)
+bool FlexDisk::Write_dir_sectors(std::ostream &ofs, struct s_formats &format)
 {
     SectorBuffer_t sectorBuffer{};
     int i;
@@ -1391,7 +1620,7 @@ bool FlexDisk::Write_dir_sectors(std::fstream &ofs, struct s_formats &format)
 }
 
 // on success return true
-bool FlexDisk::Write_sectors(std::fstream &ofs, struct s_formats &format)
+bool FlexDisk::Write_sectors(std::ostream &ofs, struct s_formats &format)
 {
     SectorBuffer_t sectorBuffer{};
     int i;
@@ -1471,92 +1700,82 @@ void FlexDisk::Format_disk(
     int fmt /* = TYPE_DSK_DISKFILE */,
     const char *bsFile /* = nullptr */)
 {
-    struct s_formats format{};
-    int err = 0;
-
     if (path.empty() ||
         tracks < 2 || sectors < 6 || tracks > 256 || sectors > 255)
     {
         throw FlexException(FERR_WRONG_PARAMETER);
     }
 
-    Create_format_table(fmt, tracks, sectors, format);
-
     std::fstream fstream(path, std::ios::out | std::ios::binary |
                          std::ios::trunc);
 
-    if (fstream.is_open())
+    if (!fstream.is_open() ||
+        !Format_disk(fstream, flx::getFileName(path), tracks, sectors, fmt,
+                     bsFile))
     {
-        if (fmt == TYPE_FLX_DISKFILE)
-        {
-            int sides = getSides(format.tracks, format.sectors);
-            struct s_flex_header header{};
+        throw FlexException(FERR_UNABLE_TO_FORMAT, path);
+    }
+}
 
-            header.initialize(SECTOR_SIZE, format.tracks, format.sectors0,
-                              format.sectors, sides, sides);
+// Write a formatted disk image to a stream, e.g. to format a disk image
+// in memory. name is used as disk name. On success return true.
+bool FlexDisk::Format_disk(
+    std::ostream &os,
+    const std::string &name,
+    int tracks,
+    int sectors,
+    int fmt /* = TYPE_DSK_DISKFILE */,
+    const char *bsFile /* = nullptr */)
+{
+    struct s_formats format{};
 
-            fstream.write(reinterpret_cast<const char *>(&header),
-                          sizeof(header));
-            if (fstream.fail())
-            {
-                err = 1;
-            }
-        }
+    if (tracks < 2 || sectors < 6 || tracks > 256 || sectors > 255)
+    {
+        throw FlexException(FERR_WRONG_PARAMETER);
+    }
 
-        {
-            BootSectorBuffer_t bootSectors{};
+    Create_format_table(fmt, tracks, sectors, format);
 
-            Create_boot_sectors(bootSectors, bsFile);
+    if (fmt == TYPE_FLX_DISKFILE)
+    {
+        int sides = getSides(format.tracks, format.sectors);
+        struct s_flex_header header{};
 
-            fstream.write(reinterpret_cast<const char *>(bootSectors.data()),
-                          bootSectors.size());
-            if (fstream.fail())
-            {
-                err = 1;
-            }
-        }
+        header.initialize(SECTOR_SIZE, format.tracks, format.sectors0,
+                          format.sectors, sides, sides);
 
-        s_sys_info_sector sis{};
-        Create_sys_info_sector(sis, flx::getFileName(path), format);
+        os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
 
-        fstream.write(reinterpret_cast<const char *>(&sis), sizeof(sis));
-        if (fstream.fail())
-        {
-            err = 1;
-        }
+    {
+        BootSectorBuffer_t bootSectors{};
 
-        {
-            SectorBuffer_t sectorBuffer{};
+        Create_boot_sectors(bootSectors, bsFile);
 
-            // Sector 00-04 seems to be unused. Format with all zeros.
-            std::memset(sectorBuffer.data(), '\0', sectorBuffer.size());
-            fstream.write(reinterpret_cast<const char *>(sectorBuffer.data()),
-                          sectorBuffer.size());
-            if (fstream.fail())
-            {
-                err = 1;
-            }
-        }
+        os.write(reinterpret_cast<const char *>(bootSectors.data()),
+                 bootSectors.size());
+    }
 
-        if (!Write_dir_sectors(fstream, format))
-        {
-            err = 1;
-        }
+    s_sys_info_sector sis{};
+    Create_sys_info_sector(sis, name, format);
+
+    os.write(reinterpret_cast<const char *>(&sis), sizeof(sis));
 
-        if (!Write_sectors(fstream, format))
-        {
-            err = 1;
-        }
-    }
-    else
     {
-        err = 1;
+        SectorBuffer_t sectorBuffer{};
+
+        // Sector 00-04 seems to be unused. Format with all zeros.
+        std::memset(sectorBuffer.data(), '\0', sectorBuffer.size());
+        os.write(reinterpret_cast<const char *>(sectorBuffer.data()),
+                 sectorBuffer.size());
     }
 
-    if (err)
+    if (os.fail())
     {
-        throw FlexException(FERR_UNABLE_TO_FORMAT, path);
+        return false;
     }
+
+    return Write_dir_sectors(os, format) && Write_sectors(os, format);
 }
 
 // Read the number of tracks and sectors for a FLEX file container.
@@ -1839,90 +2058,295 @@ FlexDirEntry FlexDisk::CreateDirEntryFrom(const s_dir_entry &dir_entry,
     return dirEntry;
 }
 
-void FlexDisk::InitializeFilenames()
+void FlexDisk::SetNextDirectoryPosition(const st_t &dirTS)
+{
+    next_dir_trk_sec = dirTS;
+}
+
+bool FlexDisk::FindInFilenames(const std::string &filename)
 {
-    if (!is_filenames_initialized)
+    if (!is_dir_index_valid)
     {
-        s_dir_sector sectorBuffer{};
-        auto trk_sec = first_dir_trk_sec;
+        BuildDirectoryIndices();
+    }
 
-        while (trk_sec != st_t{})
-        {
-            Byte idx = 0U;
+    if (is_dir_read_error)
+    {
+        std::stringstream stream;
 
-            if (!ReadSector(reinterpret_cast<Byte *>(&sectorBuffer),
-                        trk_sec.trk, trk_sec.sec))
-            {
-                std::stringstream stream;
+        stream << dir_read_error_trk_sec;
+        throw FlexException(FERR_READING_TRKSEC, stream.str(), GetPath());
+    }
 
-                stream << trk_sec;
-                throw FlexException(FERR_READING_TRKSEC, stream.str(),
-                        GetPath());
-            }
+    return filenames.find(flx::tolower(filename)) != filenames.end();
+}
 
-            for (const auto &dirEntry : sectorBuffer.dir_entries)
-            {
-                if (dirEntry.filename[0] == DE_EMPTY)
-                {
-                    break;
-                }
+// Read the directory chain into memory. Reading stops at the end of the
+// chain, at a sector which already has been read (cyclic chain) or at a
+// sector which can not be read. In the last case an exception is only
+// thrown if a directory entry behind the first empty one is needed.
+void FlexDisk::LoadDirectoryCache()
+{
+    InvalidateDirectoryCache();
 
-                if (dirEntry.filename[0] != DE_DELETED)
-                {
-                    auto filename(flx::getstr<>(dirEntry.filename));
-                    auto fileExtension(flx::getstr<>(dirEntry.file_ext));
+    s_dir_sector sectorBuffer{};
+    auto trk_sec = first_dir_trk_sec;
 
-                    filenames.emplace(
-                                flx::tolower(filename += '.' + fileExtension),
-                                s_dir_pos{trk_sec, idx});
-                }
+    while (trk_sec != st_t{})
+    {
+        const auto key = static_cast<Word>(trk_sec.trk * 256U + trk_sec.sec);
 
-                ++idx;
-            }
+        if (dir_sector_indices.find(key) != dir_sector_indices.end())
+        {
+            break;
+        }
 
-            trk_sec = sectorBuffer.next;
+        if (!ReadSector(reinterpret_cast<Byte *>(&sectorBuffer),
+                    trk_sec.trk, trk_sec.sec))
+        {
+            is_dir_read_error = true;
+            dir_read_error_trk_sec = trk_sec;
+            break;
         }
 
-        is_filenames_initialized = true;
+        dir_sector_indices.emplace(key, static_cast<DWord>(dir_sectors.size()));
+        dir_trk_secs.push_back(trk_sec);
+        dir_sectors.push_back(sectorBuffer);
+        trk_sec = sectorBuffer.next;
     }
+
+    is_dir_cache_loaded = true;
 }
 
-void FlexDisk::SetNextDirectoryPosition(const st_t &dirTS)
+void FlexDisk::InvalidateDirectoryCache()
 {
-    next_dir_trk_sec = dirTS;
+    is_dir_cache_loaded = false;
+    is_dir_index_valid = false;
+    is_dir_read_error = false;
+    dir_trk_secs.clear();
+    dir_sectors.clear();
+    dir_sector_indices.clear();
 }
 
-void FlexDisk::DeleteFromFilenames(const std::string &filename)
+// Has to be called for each sector successfully written. If it is a
+// directory sector the cached copy is updated. If the link to the next
+// directory sector has changed the whole cache is reloaded on next use.
+void FlexDisk::UpdateDirectoryCache(const Byte *buffer, int trk, int sec)
 {
-    if (!is_filenames_initialized)
+    if (!is_dir_cache_loaded)
+    {
+        return;
+    }
+
+    const auto key = static_cast<Word>(trk * 256 + sec);
+    const auto iter = dir_sector_indices.find(key);
+
+    if (iter == dir_sector_indices.end())
     {
-        InitializeFilenames();
+        return;
     }
 
-    auto iter = filenames.find(flx::tolower(filename));
-    if (iter != filenames.end())
+    auto &dir_sector = dir_sectors[iter->second];
+    const auto *new_dir_sector = reinterpret_cast<const s_dir_sector *>(buffer);
+
+    if (new_dir_sector->next != dir_sector.next)
     {
-        filenames.erase(iter->first);
+        InvalidateDirectoryCache();
+        return;
     }
+
+    std::memcpy(&dir_sector, buffer, sizeof(dir_sector));
+    is_dir_index_valid = false;
 }
 
-void FlexDisk::AddToFilenames(const std::string &filename,
-        const s_dir_pos &dir_pos)
+void FlexDisk::BuildDirectoryIndices()
 {
-    if (!is_filenames_initialized)
+    if (!is_dir_cache_loaded)
     {
-        InitializeFilenames();
+        LoadDirectoryCache();
     }
 
-    filenames.insert(std::make_pair(flx::tolower(filename), dir_pos));
+    filenames.clear();
+    sorted_filenames.clear();
+    sorted_extensions.clear();
+    dir_end_index = static_cast<DWord>(dir_sectors.size() * DIRENTRIES);
+
+    DWord index = 0U;
+    for (const auto &dir_sector : dir_sectors)
+    {
+        bool isSectorEnd = false;
+
+        for (const auto &dir_entry : dir_sector.dir_entries)
+        {
+            if (dir_entry.filename[0] == DE_EMPTY)
+            {
+                isSectorEnd = true;
+                dir_end_index = std::min(dir_end_index, index);
+            }
+            else if (dir_entry.filename[0] != DE_DELETED)
+            {
+                auto filename = flx::tolower(flx::getstr<>(dir_entry.filename));
+                auto fileExtension =
+                    flx::tolower(flx::getstr<>(dir_entry.file_ext));
+
+                filename += '.' + fileExtension;
+                // Same as the directory scan of FLEX: Entries behind an
+                // empty entry within the same sector are ignored.
+                if (!isSectorEnd)
+                {
+                    filenames.emplace(filename, index);
+                }
+                if (index < dir_end_index)
+                {
+                    sorted_filenames.push_back({ filename, index });
+                    const auto pos = filename.rfind('.');
+                    sorted_extensions.push_back(
+                            { filename.substr(pos + 1U), index });
+                }
+            }
+            ++index;
+        }
+    }
+
+    const auto less = [](const s_dir_key &lhs, const s_dir_key &rhs)
+    {
+        return lhs.key < rhs.key;
+    };
+    std::stable_sort(sorted_filenames.begin(), sorted_filenames.end(), less);
+    std::stable_sort(sorted_extensions.begin(), sorted_extensions.end(),
+                     less);
+    is_dir_index_valid = true;
 }
 
-bool FlexDisk::FindInFilenames(const std::string &filename)
+void FlexDisk::AddKeyRange(std::vector<DWord> &indices,
+                           const std::vector<s_dir_key> &sortedKeys,
+                           const std::string &prefix)
 {
-    if (!is_filenames_initialized)
+    auto iter = std::lower_bound(sortedKeys.cbegin(), sortedKeys.cend(),
+            prefix, [](const s_dir_key &lhs, const std::string &rhs)
+            {
+                return lhs.key < rhs;
+            });
+
+    for (; iter != sortedKeys.cend() &&
+           iter->key.compare(0U, prefix.size(), prefix) == 0; ++iter)
     {
-        InitializeFilenames();
+        indices.push_back(iter->index);
     }
+}
 
-    return filenames.find(flx::tolower(filename)) != filenames.end();
+// Return the ascending indices of all directory entries matching
+// the wildcard. Entries behind the first empty entry are ignored.
+// For each wildcard either the literal file name prefix or the literal
+// file extension prefix is looked up in the sorted indices, whichever
+// gives less candidates. Only if both are empty all entries are scanned.
+std::vector<DWord> FlexDisk::FindDirEntryIndices(const std::string &wildcard)
+{
+    static const char *wildcardChars = "*?[]";
+    std::vector<DWord> candidates;
+    bool isFullScan = false;
+
+    if (!is_dir_index_valid)
+    {
+        BuildDirectoryIndices();
+    }
+
+    for (const auto &pattern : flx::split(wildcard, ';', true))
+    {
+        const auto lcPattern = flx::tolower(pattern);
+        const auto prefix =
+            lcPattern.substr(0U, lcPattern.find_first_of(wildcardChars));
+        const auto pos = lcPattern.rfind('.');
+        std::string extension;
+
+        // The extension literal is only used if it is not preceded
+        // by a wildcard character, e.g. "*.txt".
+        if (pos != std::string::npos &&
+            lcPattern.find_first_of(wildcardChars, pos) == std::string::npos)
+        {
+            extension = lcPattern.substr(pos + 1U);
+        }
+
+        if (prefix.empty() && extension.empty())
+        {
+            isFullScan = true;
+            break;
+        }
+
+        std::vector<DWord> prefixIndices;
+        std::vector<DWord> extensionIndices;
+
+        if (!prefix.empty())
+        {
+            AddKeyRange(prefixIndices, sorted_filenames, prefix);
+        }
+        if (!extension.empty())
+        {
+            AddKeyRange(extensionIndices, sorted_extensions, extension);
+        }
+
+        const auto &indices =
+            (prefix.empty() || (!extension.empty() &&
+             extensionIndices.size() < prefixIndices.size())) ?
+            extensionIndices : prefixIndices;
+        candidates.insert(candidates.end(), indices.cbegin(), indices.cend());
+    }
+
+    if (isFullScan)
+    {
+        candidates.clear();
+        for (const auto &dirKey : sorted_filenames)
+        {
+            candidates.push_back(dirKey.index);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    if (is_dir_read_error && dir_end_index == dir_sectors.size() * DIRENTRIES)
+    {
+        std::stringstream stream;
+
+        stream << dir_read_error_trk_sec;
+        throw FlexException(FERR_READING_TRKSEC, stream.str(), GetPath());
+    }
+
+    std::vector<DWord> result;
+    st_t dirTrkSec;
+
+    for (auto index : candidates)
+    {
+        const auto *dir_entry = GetCachedDirEntry(index, dirTrkSec);
+        std::string fileName(flx::getstr<>(dir_entry->filename));
+
+        fileName += '.' + flx::getstr<>(dir_entry->file_ext);
+        if (flx::multimatches(fileName, wildcard, ';', true))
+        {
+            result.push_back(index);
+        }
+    }
+
+    return result;
+}
+
+// Return the cached directory entry with the given index and the
+// track/sector of its directory sector or nullptr if there is none.
+const s_dir_entry *FlexDisk::GetCachedDirEntry(DWord index, st_t &dirTrkSec)
+{
+    if (!is_dir_cache_loaded)
+    {
+        LoadDirectoryCache();
+    }
+
+    const auto sectorIndex = index / DIRENTRIES;
+
+    if (sectorIndex >= dir_sectors.size())
+    {
+        return nullptr;
+    }
+
+    dirTrkSec = dir_trk_secs[sectorIndex];
+    return &dir_sectors[sectorIndex].dir_entries[index % DIRENTRIES];
 }
@@ -31,6 +31,7 @@
 #include <vector>
 #include <array>
 #include <unordered_map>
+#include <utility>
 #include <fstream>
 
 class FlexDiskAttributes;
@@ -58,12 +59,23 @@ class FlexDisk : public IFlexDiskBySector, public IFlexDiskByFile
 {
     friend class FlexDiskIteratorImp; // corresponding iterator class
 
-    // Struct defining the directory sector's track/sector and directory index
-    // within this sector referencing a file.
-    struct s_dir_pos
+    // Struct defining a directory entry and its lower case key
+    // (file name or file extension) used in a sorted index.
+    struct s_dir_key
     {
-        st_t trk_sec; // track/sector of the directory sector.
-        Byte idx; // index within the directory sector.
+        std::string key;
+        DWord index; // directory sector index * DIRENTRIES + entry index.
+    };
+
+    // Struct defining a file to be written and its file name on disk.
+    // The file contents is either taken from buffer or, if buffer is
+    // nullptr, read sector by sector from a file on srcDisk.
+    struct s_file_to_write
+    {
+        const FlexFileBuffer *buffer;
+        std::string fileName;
+        FlexDisk *srcDisk{};
+        FlexDirEntry srcDirEntry; // Directory entry of the source file.
     };
 
 protected:
@@ -75,14 +87,31 @@ protected:
 
     // Variables only used for FLX format when formatting a disk
     bool is_flex_format{false}; // true when this is a FLEX compatible format.
-    bool is_filenames_initialized{false}; // Used to lazy init. filenames.
     int sectors0_side0_max{}; // Max. sector number on side0 for track 0
     int sectors_side0_max{}; // Max. sector number on side0 for track != 0
     st_t next_dir_trk_sec{}; // Next directory track/sector to be used for
                              // new created files. May be 00-00.
     s_flex_header flx_header{};
-    // All filenames available and their position in the directory.
-    std::unordered_map<std::string, s_dir_pos> filenames;
+
+    // In-memory copy of the directory. It is loaded on first use and
+    // updated on each directory sector written by WriteSector().
+    // A directory entry is identified by its index which is
+    // directory sector index * DIRENTRIES + entry index.
+    bool is_dir_cache_loaded{false};
+    bool is_dir_index_valid{false};
+    bool is_dir_read_error{false}; // true if directory chain is unreadable.
+    st_t dir_read_error_trk_sec{}; // track/sector which could not be read.
+    DWord dir_end_index{}; // Index of the first empty directory entry.
+    std::vector<st_t> dir_trk_secs; // track/sector of each directory sector.
+    std::vector<s_dir_sector> dir_sectors;
+    std::unordered_map<Word, DWord> dir_sector_indices; // Key: trk * 256 + sec
+    // Indices on the directory cache, all keys are lower case.
+    // All filenames available and their directory entry index.
+    std::unordered_map<std::string, DWord> filenames;
+    // Sorted file names and file extensions to look up a literal
+    // prefix of a wildcard.
+    std::vector<s_dir_key> sorted_filenames;
+    std::vector<s_dir_key> sorted_extensions;
 
 private:
     Byte attributes{};
@@ -107,6 +136,10 @@ public:
     static void SetBootSectorFile(const std::string &p_bootSectorFile);
     static std::string &GetBootSectorFile();
     static void InitializeClass();
+    // Set the disk attributes stored in a system info sector.
+    static void SetDiskAttributesFrom(const s_sys_info_sector &sis,
+                                      unsigned bytesPerSector,
+                                      FlexDiskAttributes &diskAttributes);
 
     // IFlexDiskBase interface declaration
     bool IsWriteProtected() const override;
@@ -148,10 +181,32 @@ public:
                   IFlexDiskByFile &destination) override;
     std::string GetSupportedAttributes() const override;
 
+    // Write all files within one transaction. The free chain is walked
+    // once and nothing is written if not all files fit on the disk.
+    // The system info sector and the directory are only updated once.
+    bool WriteFromBuffers(const std::vector<FlexFileBuffer> &buffers);
+
+    // Copy files from another FLEX disk within one transaction.
+    // First: source file name, second: destination file name.
+    // No FlexFileBuffer is used, but all sectors of all files are staged
+    // in memory before the first one is written. So the memory needed
+    // is the size of all copied files (at most the size of the disk).
+    // A read error on the source disk leaves the destination unchanged.
+    // The sector map of random files is newly created.
+    bool CopyFilesFrom(FlexDisk &src,
+        const std::vector<std::pair<std::string, std::string> > &fileNames);
+
 protected:
+    FlexDisk(const std::string &p_path, const FileTimeAccess &fileTimeAccess);
+
     int ByteOffset(int trk, int sec, int side) const;
     void EvaluateTrack0SectorCount();
-    bool CreateDirEntry(FlexDirEntry &entry);
+    bool CreateDirEntries(const std::vector<FlexDirEntry> &entries);
+    size_t CountFreeDirEntries() const;
+    bool WriteFiles(const std::vector<s_file_to_write> &files);
+    static DWord GetSectorCount(const s_file_to_write &file);
+    static bool CopyFileSector(const s_file_to_write &file, DWord index,
+                               st_t &srcNext, SectorBuffer_t &sector);
 
     void Initialize_for_flx_format(const s_flex_header &header);
     void Initialize_for_dsk_format(const s_formats &format);
@@ -167,8 +222,8 @@ protected:
         s_sys_info_sector &sis,
         const std::string &name,
         struct s_formats &format);
-    static bool Write_dir_sectors(std::fstream &fs, struct s_formats &format);
-    static bool Write_sectors(std::fstream &fs, struct s_formats &format);
+    static bool Write_dir_sectors(std::ostream &os, struct s_formats &format);
+    static bool Write_sectors(std::ostream &os, struct s_formats &format);
     static void Create_format_table(
         int type,
         int trk,
@@ -180,15 +235,28 @@ protected:
         int sectors,
         int fmt = TYPE_DSK_DISKFILE,
         const char *bsFile = nullptr);
+    static bool Format_disk(
+        std::ostream &os,
+        const std::string &name,
+        int tracks,
+        int sectors,
+        int fmt = TYPE_DSK_DISKFILE,
+        const char *bsFile = nullptr);
     static FlexDirEntry CreateDirEntryFrom(const s_dir_entry &dir_entry,
             const std::string &filename);
 
     // IFlexDiskByFile interface performance functions.
-    void InitializeFilenames();
     void SetNextDirectoryPosition(const st_t &dirTS);
-    void DeleteFromFilenames(const std::string &filename);
-    void AddToFilenames(const std::string &filename, const s_dir_pos &dir_pos);
     bool FindInFilenames(const std::string &filename);
+    void LoadDirectoryCache();
+    void InvalidateDirectoryCache();
+    void UpdateDirectoryCache(const Byte *buffer, int trk, int sec);
+    void BuildDirectoryIndices();
+    std::vector<DWord> FindDirEntryIndices(const std::string &wildcard);
+    const s_dir_entry *GetCachedDirEntry(DWord index, st_t &dirTrkSec);
+    static void AddKeyRange(std::vector<DWord> &indices,
+                            const std::vector<s_dir_key> &sortedKeys,
+                            const std::string &prefix);
 
 private:
     IFlexDiskIteratorImpPtr IteratorFactory() override;
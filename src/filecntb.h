@@ -40,6 +40,8 @@ const unsigned TYPE_RAM_DISKFILE =
     0x80U; /* subtype: filecontainer loaded in RAM */
 const unsigned TYPE_JVC_HEADER =
     0x100U; /* subtype: DSK filecontainer with JVC header */
+const unsigned TYPE_DEDUP_DISKFILE =
+    0x200U; /* subtype: filecontainer in a deduplicating store */
 
 // This macro defines the name of a file. It contains the boot sector.
 // It is used in directory containers to be able to boot from them.
@@ -42,245 +42,288 @@ static Word read_word(std::istream &istream)
     return result;
 }
 
-static bool read_hex_byte(std::istream &istream, Byte &value, Byte &checksum)
+// Value of a hexadecimal digit or 0xFF if the character is no hex digit.
+static constexpr std::array<Byte, 256> hexDigitValue = []()
 {
-    char byte = '\0';
+    std::array<Byte, 256> table{};
 
-    value = 0U;
-    for (int i = 0; i < 2; ++i)
+    for (auto &value : table)
     {
-        if (istream.eof())
+        value = 0xFFU;
+    }
+    for (Byte index = 0U; index < 10U; ++index)
+    {
+        table['0' + index] = index;
+    }
+    for (Byte index = 0U; index < 6U; ++index)
+    {
+        table['A' + index] = static_cast<Byte>(10U + index);
+        table['a' + index] = static_cast<Byte>(10U + index);
+    }
+
+    return table;
+}();
+
+// The contents of a hex file is read into memory at once and parsed
+// from there. The line and the start of the line is kept to be able
+// to report the position of an error.
+struct sHexFileInput
+{
+    const Byte *current;
+    const Byte *end;
+    const Byte *lineStart;
+    DWord line;
+};
+
+// Contiguous data records are collected and copied to the memory
+// target at once.
+class DataRecordCollector
+{
+public:
+    explicit DataRecordCollector(MemoryTarget<DWord> &p_memtgt)
+        : memtgt(p_memtgt)
+    {
+        data.reserve(65536U);
+    }
+
+    void Add(const Byte *source, DWord address, DWord size)
+    {
+        if (size == 0U)
         {
-            return false;
+            return;
         }
-
-        istream.get(byte);
-        byte = static_cast<char>(toupper(byte));
-        if (byte >= '0' && byte <= '9')
+        if (!data.empty() && address != startAddress + data.size())
         {
-            value <<= 4U;
-            value |= static_cast<Byte>(byte - '0');
+            Flush();
         }
-        else if (byte >= 'A' && byte <= 'F')
+        if (data.empty())
         {
-            value <<= 4U;
-            value |= static_cast<Byte>(byte - 'A' + 10);
+            startAddress = address;
         }
-        else
+        data.insert(data.end(), source, source + size);
+    }
+
+    void Flush()
+    {
+        if (!data.empty())
         {
-            return false;
+            memtgt.CopyFrom(data.data(), startAddress,
+                            static_cast<DWord>(data.size()));
+            data.clear();
         }
     }
 
+private:
+    MemoryTarget<DWord> &memtgt;
+    std::vector<Byte> data;
+    DWord startAddress{};
+};
+
+static bool read_hex_byte(sHexFileInput &input, Byte &value, Byte &checksum)
+{
+    if (input.end - input.current < 2)
+    {
+        input.current = input.end;
+        return false;
+    }
+
+    const auto high = hexDigitValue[input.current[0]];
+    const auto low = hexDigitValue[input.current[1]];
+    if ((high | low) & 0xF0U)
+    {
+        // Let current point to the invalid character.
+        input.current += (high & 0xF0U) ? 0 : 1;
+        return false;
+    }
+
+    value = static_cast<Byte>((high << 4U) | low);
     checksum += value;
+    input.current += 2;
 
     return true;
 }
 
-static bool read_hex_word(std::istream &istream, Word &value, Byte &checksum)
+static bool read_hex_word(sHexFileInput &input, Word &value, Byte &checksum)
 {
-    Byte byte;
+    Byte high;
+    Byte low;
+
+    if (!read_hex_byte(input, high, checksum) ||
+        !read_hex_byte(input, low, checksum))
+    {
+        return false;
+    }
+    value = static_cast<Word>((high << 8U) | low);
+
+    return true;
+}
 
-    value = 0U;
-    for (int i = 0; i < 2; ++i)
+static bool read_hex_bytes(sHexFileInput &input, Byte *buffer, DWord count,
+                           Byte &checksum)
+{
+    for (DWord index = 0U; index < count; ++index)
     {
-        auto ok = read_hex_byte(istream, byte, checksum);
-        if (!ok)
+        if (!read_hex_byte(input, buffer[index], checksum))
         {
             return false;
         }
-        value <<= 8U;
-        value |= byte;
     }
 
     return true;
 }
 
-static int load_intel_hex(std::istream &istream, MemoryTarget<DWord> &memtgt,
-                          DWord &startAddress)
+// Read the checksum and the end of line of a record.
+// A missing line end is only accepted for the last record.
+static int read_end_of_record(sHexFileInput &input, Byte checksum, bool isLast)
 {
-    bool done = false;
-    std::istream::int_type value;
-    Byte type;
-    Byte checksum;
     Byte expected_checksum;
-    Byte dummy;
-    Byte index;
-    Byte count;
-    Word address;
+    Byte dummy = 0U;
+
+    // Parameter names are concously chosen.
+    // NOLINTNEXTLINE(readability-suspicious-call-argument)
+    if (!read_hex_byte(input, expected_checksum, dummy))
+    {
+        return -3; // format error
+    }
+    if (checksum != expected_checksum)
+    {
+        input.current -= 2;
+        return -4; // checksum error
+    }
+
+    if (input.current != input.end && *input.current == '\r')
+    {
+        ++input.current;
+    }
+    if (input.current == input.end)
+    {
+        return isLast ? 0 : -2; // read error
+    }
+    if (*input.current != '\n')
+    {
+        return -3; // format error
+    }
+    ++input.current;
+    ++input.line;
+    input.lineStart = input.current;
+
+    return 0;
+}
+
+static int load_intel_hex(sHexFileInput &input, MemoryTarget<DWord> &memtgt,
+                          DWord &startAddress)
+{
+    DataRecordCollector collector(memtgt);
     std::array<Byte, 255> buffer{};
-    // MSVC does not allow auto *ibuffer.
-    // NOLINTNEXTLINE(readability-qualified-auto).
-    auto ibuffer = buffer.begin();
+    bool done = false;
 
     while (!done)
     {
-        checksum = 0;
-        value = istream.get();
-        if (value != ':')
+        Byte checksum = 0U;
+        Byte count;
+        Word address;
+        Byte type;
+
+        if (input.current == input.end || *input.current != ':')
         {
             return -3; // format error
         }
-        auto ok = read_hex_byte(istream, count, checksum);
-        ok &= read_hex_word(istream, address, checksum);
-        ok &= read_hex_byte(istream, type, checksum);
-        if (!ok)
+        ++input.current;
+        if (!read_hex_byte(input, count, checksum) ||
+            !read_hex_word(input, address, checksum) ||
+            !read_hex_byte(input, type, checksum))
         {
             return -3;
         }
 
-        if (type == 0x00) // Data
+        switch (type)
         {
-            // Read a maximum of 255 hex-byte per line.
-            for (index = 0; index < count; ++index)
-            {
-                if (address + index <= std::numeric_limits<Word>::max())
+            case 0x00: // Data
+                if (!read_hex_bytes(input, buffer.data(), count, checksum))
                 {
-                    Byte bval;
-                    ok = read_hex_byte(istream, bval, checksum);
-                    if (!ok)
-                    {
-                        return -3;
-                    }
-                    *(ibuffer++) = bval;
+                    return -3;
                 }
-            }
-            memtgt.CopyFrom(buffer.data(), address, count);
-            ibuffer = buffer.begin();
-            if (count == 0)
-            {
+                collector.Add(buffer.data(), address, count);
+                done = (count == 0U);
+                break;
+
+            case 0x01: // End of file
                 done = true;
-            }
-        }
-        else if (type == 0x01) // End of file
-        {
-            done = true;
-        }
-        else if (type == 0x05) // Start linear address
-        {
-            if (count != 4)
-            {
-                return -3; // Start address has 4 byte.
-            }
-            startAddress = 0U;
-            for (index = 0; index < count; ++index)
-            {
-                Byte bval;
-                ok = read_hex_byte(istream, bval, checksum);
-                if (!ok)
+                break;
+
+            case 0x05: // Start linear address
+                if (count != 4U || // Start address has 4 byte.
+                    !read_hex_bytes(input, buffer.data(), count, checksum))
                 {
                     return -3;
                 }
-                startAddress = (startAddress << 8U) | bval;
-            }
-        }
-        else
-        {
-            return -3; // format error
-        }
-
-        checksum = ~checksum + 1;
-        // Parameter names are concously chosen.
-        // NOLINTNEXTLINE(readability-suspicious-call-argument)
-        ok = read_hex_byte(istream, expected_checksum, dummy);
-        if (!ok)
-        {
-            return -3;
-        }
-        if (checksum != expected_checksum)
-        {
-            return -4; // checksum error
-        }
+                startAddress = flx::getValueBigEndian<DWord>(buffer.data());
+                break;
 
-        if (istream.get() == '\r')
-        {
-            (void)istream.get();
+            default:
+                return -3; // format error
         }
 
-        if (istream.fail())
+        checksum = ~checksum + 1;
+        auto result = read_end_of_record(input, checksum, done);
+        if (result < 0)
         {
-            return -2; // read error
+            return result;
         }
     }
 
+    collector.Flush();
+
     return 0;
 }
 
-static int load_motorola_srecord(std::istream &istream,
+static int load_motorola_srecord(sHexFileInput &input,
                                  MemoryTarget<DWord> &memtgt,
                                  DWord &startAddress)
 {
-    bool done = false;
-    std::istream::int_type value;
-    Byte type;
-    Byte checksum;
-    Byte expected_checksum;
-    Byte dummy;
-    DWord index;
-    Byte count;
-    Word address;
+    DataRecordCollector collector(memtgt);
     std::array<Byte, 255> buffer{};
-    // MSVC does not allow auto *ibuffer.
-    // NOLINTNEXTLINE(readability-qualified-auto).
-    auto ibuffer = buffer.begin();
+    bool done = false;
 
     while (!done)
     {
-        checksum = 0;
-        value = istream.get(); /* read 'S' */
-        if (tolower(value) != 's')
+        Byte checksum = 0U;
+        Byte count;
+        Word address;
+
+        if (input.current == input.end || (*input.current | 0x20U) != 's')
         {
             return -3; // format error
         }
-
-        if (istream.eof())
+        if (++input.current == input.end)
         {
             break;
         }
 
-        type = static_cast<char>(istream.get()); /* read type of line */
-        auto ok = read_hex_byte(istream, count, checksum);
-        ok &= read_hex_word(istream, address, checksum);
-        if (!ok)
+        const auto *typePosition = input.current++;
+        const auto type = *typePosition;
+        if (!read_hex_byte(input, count, checksum) ||
+            !read_hex_word(input, address, checksum) || count < 3U)
         {
             return -3;
         }
+        count -= 3U;
 
         switch (type)
         {
             case '0': // Header
-                count -= 3;
-
-                for (index = 0; index < count; ++index)
+                if (!read_hex_bytes(input, buffer.data(), count, checksum))
                 {
-                    read_hex_byte(istream, dummy, checksum);
+                    return -3;
                 }
                 break;
 
             case '1': // Data
-                count -= 3;
-
-                // Read a maximum of 252 hex-byte per line.
-                for (index = 0; index < count; ++index)
-                {
-                    if (address + index <= std::numeric_limits<Word>::max())
-                    {
-                        Byte bval;
-                        ok = read_hex_byte(istream, bval, checksum);
-                        if (!ok)
-                        {
-                            return -3;
-                        }
-                        *(ibuffer++) = bval;
-                    }
-                }
-                if (!ok)
+                if (!read_hex_bytes(input, buffer.data(), count, checksum))
                 {
                     return -3;
                 }
-                memtgt.CopyFrom(buffer.data(), address, count);
-                ibuffer = buffer.begin();
-
+                collector.Add(buffer.data(), address, count);
                 break;
 
             case '9': // End of file / start address
@@ -292,33 +335,20 @@ static int load_motorola_srecord(std::istream &istream,
                 break;
 
             default:
+                input.current = typePosition;
                 return -3; // format error
         }
 
         checksum = ~checksum;
-        // Parameter names are concously chosen.
-        // NOLINTNEXTLINE(readability-suspicious-call-argument)
-        ok = read_hex_byte(istream, expected_checksum, dummy);
-        if (!ok)
+        auto result = read_end_of_record(input, checksum, done);
+        if (result < 0)
         {
-            return -3;
-        }
-        if (checksum != expected_checksum)
-        {
-            return -4; // checksum error
-        }
-
-        if (istream.get() == '\r')
-        {
-            (void)istream.get();
-        }
-
-        if (istream.fail())
-        {
-            return -2; // read error
+            return result;
         }
     }
 
+    collector.Flush();
+
     return 0;
 }
 
@@ -391,9 +421,8 @@ static int load_flex_binary(std::istream &istream, MemoryTarget<DWord> &memtgt,
 }
 
 int load_hexfile(const std::string &filename, MemoryTarget<DWord> &memtgt,
-                 DWord &startAddress)
+                 DWord &startAddress, sHexFilePosition *position)
 {
-    Word ch;
     std::ifstream istream(filename, std::ios_base::in | std::ios_base::binary);
 
     if (!istream.is_open())
@@ -401,35 +430,47 @@ int load_hexfile(const std::string &filename, MemoryTarget<DWord> &memtgt,
         return -1; // Could not open file for reading
     }
 
-    ch = static_cast<Word>(istream.get());
-    istream.unget();
+    const auto ch = istream.peek();
 
-    if (ch != 0x02)
+    if (ch == 0x02)
     {
-        istream.close();
-        istream.open(filename, std::ios_base::in);
-        if (!istream.is_open())
-        {
-            return -1; // Could not open file for reading
-        }
+        return load_flex_binary(istream, memtgt, startAddress);
     }
 
-    if (ch == ':')
+    if (ch != ':' && toupper(ch) != 'S')
     {
-        return load_intel_hex(istream, memtgt, startAddress);
+        return -3; // Unknown or invalid file format
     }
 
-    if (toupper(ch) == 'S')
+    // Intel hex and Motorola S-record files are read at once.
+    istream.seekg(0, std::ios_base::end);
+    const auto size = static_cast<std::streamsize>(istream.tellg());
+    istream.seekg(0, std::ios_base::beg);
+    if (size <= 0)
     {
-        return load_motorola_srecord(istream, memtgt, startAddress);
+        return -2; // read error
     }
 
-    if (ch == 0x02)
+    std::vector<Byte> data(static_cast<size_t>(size));
+    if (!istream.read(reinterpret_cast<char *>(data.data()), size))
     {
-        return load_flex_binary(istream, memtgt, startAddress);
+        return -2; // read error
     }
 
-    return -3; // Unknown or invalid file format
+    sHexFileInput input{ data.data(), data.data() + data.size(), data.data(),
+                         1U };
+    const auto result = (ch == ':') ?
+        load_intel_hex(input, memtgt, startAddress) :
+        load_motorola_srecord(input, memtgt, startAddress);
+
+    if (result < 0 && position != nullptr)
+    {
+        position->line = input.line;
+        position->column =
+            static_cast<DWord>(input.current - input.lineStart) + 1U;
+    }
+
+    return result;
 }
 
 int load_flex_binary(const std::string &filename, MemoryTarget<DWord> &memtgt,
@@ -608,10 +649,9 @@ static int write_buffer_motorola_srec(WBType wbType, std::ostream &ostream,
 
 static int write_buffer_raw_binary(WBType wbType, std::ostream &ostream,
                                    const Byte *buffer,
-                                   DWord address, DWord size)
+                                   DWord address, DWord size,
+                                   DWord &previous_address)
 {
-    static DWord previous_address = std::numeric_limits<DWord>::max();
-
     switch (wbType)
     {
         case WBType::Header:
@@ -662,13 +702,15 @@ static int write_hexfile(
                          std::ios_base::binary :
                          std::ios_base::out |
                          std::ios_base::trunc;
-    std::ofstream ostream(filename, mode);
+    std::ofstream ofstream(filename, mode);
 
-    if (!ostream.is_open())
+    if (!ofstream.is_open())
     {
         return -6; // Could not open file for writing
     }
 
+    // The file contents is created in memory and written at once.
+    std::ostringstream ostream;
     std::vector<Byte> buffer;
     const auto& addressRanges = memsrc.GetAddressRanges();
     const std::array<Byte, 22> header{"Created with flex2hex"};
@@ -724,7 +766,11 @@ static int write_hexfile(
         return result;
     }
 
-    return result;
+    const auto contents = ostream.str();
+    ofstream.write(contents.data(),
+                   static_cast<std::streamsize>(contents.size()));
+
+    return ofstream.good() ? 0 : -5; // write error
 }
 
 int write_intel_hex(const std::string &filename,
@@ -747,8 +793,17 @@ int write_raw_binary(const std::string &filename,
                      const MemorySource<DWord> &memsrc,
                      DWord startAddress)
 {
-    return write_hexfile(filename, memsrc, write_buffer_raw_binary, 32,
-                         startAddress, true);
+    DWord previous_address = std::numeric_limits<DWord>::max();
+    const auto write_buffer = [&previous_address](WBType wbType,
+            std::ostream &ostream, const Byte *buffer, DWord address,
+            DWord size)
+    {
+        return write_buffer_raw_binary(wbType, ostream, buffer, address, size,
+                                       previous_address);
+    };
+
+    return write_hexfile(filename, memsrc, write_buffer, 32, startAddress,
+                         true);
 }
 
 int write_flex_binary(const std::string &filename,
@@ -790,3 +845,14 @@ void print_hexfile_error(std::ostream &ostream, int error_id)
     }
 }
 
+void print_hexfile_error(std::ostream &ostream, int error_id,
+                         const sHexFilePosition &position)
+{
+    print_hexfile_error(ostream, error_id);
+    if (error_id < 0 && position.line != 0U)
+    {
+        ostream << " Line " << position.line << ", column " <<
+                   position.column << ".";
+    }
+}
+
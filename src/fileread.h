@@ -30,9 +30,18 @@
 #include "memsrc.h"
 #include "memtgt.h"
 
+// Position of an error in an Intel hex or Motorola S-record file.
+// Line and column start with 1.
+struct sHexFilePosition
+{
+    DWord line{};
+    DWord column{};
+};
+
 extern int load_hexfile(const std::string &filename,
                         MemoryTarget<DWord> &memtgt,
-                        DWord &startAddress);
+                        DWord &startAddress,
+                        sHexFilePosition *position = nullptr);
 extern int load_flex_binary(const std::string &filename,
                             MemoryTarget<DWord> &memtgt,
                             DWord &startAddress);
@@ -53,6 +62,8 @@ extern int write_raw_binary(const std::string &filename,
                             DWord startAddress =
                                 std::numeric_limits<DWord>::max());
 extern void print_hexfile_error(std::ostream &ostream, int error_id);
+extern void print_hexfile_error(std::ostream &ostream, int error_id,
+                                const sHexFilePosition &position);
 
 #endif // FILREAD_INCLUDED
 
@@ -22,10 +22,11 @@
 #include "misc1.h"
 #include "filfschk.h"
 #include "flexerr.h"
-#include <set>
 #include <string>
 #include <sstream>
 #include <array>
+#include <algorithm>
+#include <stdexcept>
 #include <fmt/format.h>
 
 
@@ -40,6 +41,122 @@ FlexDiskCheck::FlexDiskCheck(
 FlexDiskCheck::~FlexDiskCheck()
 = default;
 
+// Insert link if there is no link for its track-sector yet.
+// Return the link of the track-sector.
+FlexDiskCheck::link_t &FlexDiskCheck::EmplaceLink(const link_t &link)
+{
+    const auto trk = static_cast<int>(link.trk_sec.trk);
+    const auto sec = static_cast<int>(link.trk_sec.sec);
+
+    if (trk >= trackCount || sec > sectorCount)
+    {
+        auto &outsideLink = outsideLinks.emplace(link.trk_sec, link)
+                            .first->second;
+        outsideLink.is_used = true;
+
+        return outsideLink;
+    }
+
+    auto &insideLink =
+        links[static_cast<size_t>(trk * (sectorCount + 1) + sec)];
+    if (!insideLink.is_used)
+    {
+        insideLink = link;
+        insideLink.is_used = true;
+    }
+
+    return insideLink;
+}
+
+const FlexDiskCheck::link_t *FlexDiskCheck::FindLink(st_t trk_sec) const
+{
+    const auto trk = static_cast<int>(trk_sec.trk);
+    const auto sec = static_cast<int>(trk_sec.sec);
+
+    if (trk >= trackCount || sec > sectorCount)
+    {
+        const auto iter = outsideLinks.find(trk_sec);
+
+        return (iter != outsideLinks.end()) ? &iter->second : nullptr;
+    }
+
+    const auto &link =
+        links[static_cast<size_t>(trk * (sectorCount + 1) + sec)];
+
+    return link.is_used ? &link : nullptr;
+}
+
+FlexDiskCheck::link_t *FlexDiskCheck::FindLink(st_t trk_sec)
+{
+    return const_cast<link_t *>(
+            static_cast<const FlexDiskCheck *>(this)->FindLink(trk_sec));
+}
+
+const FlexDiskCheck::link_t &FlexDiskCheck::GetLink(st_t trk_sec) const
+{
+    const auto *link = FindLink(trk_sec);
+
+    if (link == nullptr)
+    {
+        throw std::out_of_range("FlexDiskCheck: No link for track-sector");
+    }
+
+    return *link;
+}
+
+FlexDiskCheck::link_t &FlexDiskCheck::GetLink(st_t trk_sec)
+{
+    return const_cast<link_t &>(
+            static_cast<const FlexDiskCheck *>(this)->GetLink(trk_sec));
+}
+
+size_t FlexDiskCheck::GetLinkCount() const
+{
+    return static_cast<size_t>(
+            std::count_if(links.cbegin(), links.cend(),
+                          [](const link_t &link){ return link.is_used; })) +
+           outsideLinks.size();
+}
+
+// Call function for each link in ascending order of its track-sector.
+template <typename F>
+void FlexDiskCheck::ForEachLink(F function) const
+{
+    auto outsideIter = outsideLinks.cbegin();
+
+    for (const auto &link : links)
+    {
+        if (!link.is_used)
+        {
+            continue;
+        }
+
+        while (outsideIter != outsideLinks.cend() &&
+               outsideIter->first < link.trk_sec)
+        {
+            function(outsideIter->second);
+            ++outsideIter;
+        }
+        function(link);
+    }
+
+    for (; outsideIter != outsideLinks.cend(); ++outsideIter)
+    {
+        function(outsideIter->second);
+    }
+}
+
+void FlexDiskCheck::AddFrom(link_t &link, st_t from)
+{
+    const auto iter = std::lower_bound(link.from.begin(), link.from.end(),
+                                       from);
+
+    if (iter == link.from.end() || *iter != from)
+    {
+        link.from.insert(iter, from);
+    }
+}
+
 std::string FlexDiskCheck::GetItemName(const item_t &item)
 {
     std::string name;
@@ -120,15 +237,12 @@ void FlexDiskCheck::CheckDisk()
 
 void FlexDiskCheck::CheckLinks()
 {
-    for (auto &iter : links)
-    {
-        const auto &link = iter.second;
-
+    ForEachLink([&](const link_t &link){
         if (link.is_bad)
         {
             for (const auto &previous : link.from)
             {
-                auto &previous_link = links.at(previous);
+                const auto &previous_link = GetLink(previous);
                 auto name = GetItemName(previous_link.item_index);
                 auto *result = new BadLink;
 
@@ -138,7 +252,7 @@ void FlexDiskCheck::CheckLinks()
                     FlexDiskCheckResultItem::Type::Warning :
                     FlexDiskCheckResultItem::Type::Error;
                 result->name = name;
-                result->bad = iter.first;
+                result->bad = link.trk_sec;
                 result->current = previous;
                 results.emplace_back(result);
             }
@@ -151,7 +265,7 @@ void FlexDiskCheck::CheckLinks()
 
             result->type = FlexDiskCheckResultItem::Type::Error;
             result->name = name;
-            result->current = iter.first;
+            result->current = link.trk_sec;
             std::copy(link.from.cbegin(), link.from.cend(),
                       std::back_inserter(result->inputs));
             results.emplace_back(result);
@@ -163,7 +277,7 @@ void FlexDiskCheck::CheckLinks()
 
             result->type = FlexDiskCheckResultItem::Type::Error;
             result->name = GetItemName(link.item_index);
-            result->from = iter.first;
+            result->from = link.trk_sec;
             result->back_to = link.to;
             results.emplace_back(result);
         }
@@ -176,12 +290,12 @@ void FlexDiskCheck::CheckLinks()
 
             result->type = FlexDiskCheckResultItem::Type::Warning;
             result->name = name;
-            result->current = iter.first;
+            result->current = link.trk_sec;
             result->record_nr = link.record_nr;
             result->expected_record_nr = link.expected_record_nr;
             results.emplace_back(result);
         }
-    }
+    });
 }
 
 void FlexDiskCheck::CheckItems()
@@ -241,11 +355,11 @@ void FlexDiskCheck::CheckItems()
 
         if (IsTrackSectorValid(item.start))
         {
-            auto &link = links.at(item.start);
+            const auto &link = GetLink(item.start);
 
             if (!link.from.empty())
             {
-                const auto &inputLink = links.at(*link.from.cbegin());
+                const auto &inputLink = GetLink(*link.from.cbegin());
                 auto inputName = GetItemName(inputLink.item_index);
                 auto *result = new LinkAndFileInput;
 
@@ -272,7 +386,7 @@ void FlexDiskCheck::CheckItems()
 
         if (IsTrackSectorValid(item.end))
         {
-             auto &link = links.at(item.end);
+             const auto &link = GetLink(item.end);
              if (link.to != st_t{0, 0})
              {
                 auto *result = new LinkAfterEnd;
@@ -404,6 +518,11 @@ void FlexDiskCheck::InitializeLinks()
     }
 
     diskAttributes.GetTrackSector(tracks, sectors);
+    trackCount = tracks;
+    sectorCount = sectors;
+    links.clear();
+    links.resize(static_cast<size_t>(tracks * (sectors + 1)));
+    outsideLinks.clear();
 
     for (int track = 0; track < tracks; ++track)
     {
@@ -412,31 +531,28 @@ void FlexDiskCheck::InitializeLinks()
             SectorBuffer_t sectorBuffer{};
             st_t current{static_cast<Byte>(track), static_cast<Byte>(sector)};
 
-            if (!IsTrackSectorValid(current) &&
-                links.find(current) == links.end())
+            if (!IsTrackSectorValid(current) && FindLink(current) == nullptr)
             {
-                links.emplace(current, link_t{current});
-                links.at(current).is_bad = true;
+                auto &link = EmplaceLink(link_t{current});
+                link.is_bad = true;
                 if (track == 0 && sector < first_dir_trk_sec.sec)
                 {
-                    links.emplace(current, link_t{current});
-                    links.at(current).type = SectorType::System;
+                    link.type = SectorType::System;
                 }
                 continue;
             }
 
             if (!flexDisk.ReadSector(sectorBuffer.data(), track, sector) &&
-                links.find(current) == links.end())
+                FindLink(current) == nullptr)
             {
-                links.emplace(current, link_t{current});
-                links.at(current).is_bad = true;
+                EmplaceLink(link_t{current}).is_bad = true;
                 continue;
             }
 
             st_t next{sectorBuffer[0], sectorBuffer[1]};
             auto record_nr = flx::getValueBigEndian<Word>(&sectorBuffer[2]);
 
-            links.emplace(current, link_t{current, next, record_nr});
+            EmplaceLink(link_t{current, next, record_nr});
         }
     }
 }
@@ -449,7 +565,6 @@ void FlexDiskCheck::AddItem(const std::string &name, SectorType type,
 {
     auto current = start;
     st_t previous = {0, 0};
-    std::set<st_t> visited;
     auto item_index = static_cast<SDWord>(items.size());
     items.emplace_back(type, start, end, name);
     auto &item = items.at(item_index);
@@ -461,12 +576,12 @@ void FlexDiskCheck::AddItem(const std::string &name, SectorType type,
     while (current != st_t{0, 0})
     {
         bool is_bad = !IsTrackSectorValid(current);
-        if (is_bad && links.find(current) == links.end())
+        if (is_bad && FindLink(current) == nullptr)
         {
             // Add invalid link if not found.
-            links.emplace(current, link_t{current});
+            EmplaceLink(link_t{current});
         }
-        auto &current_link = links.at(current);
+        auto &current_link = GetLink(current);
         current_link.is_bad = is_bad;
 
         // Lost sectors: Only follow sector chain if it has not
@@ -505,10 +620,11 @@ void FlexDiskCheck::AddItem(const std::string &name, SectorType type,
 
         if (previous != st_t{0, 0})
         {
-            current_link.from.emplace(previous);
-            if (visited.find(current) != visited.end())
+            AddFrom(current_link, previous);
+            // A link already visited by this item closes a cycle.
+            if (current_link.visited_by == item_index)
             {
-                auto &previous_link = links.at(previous);
+                auto &previous_link = GetLink(previous);
                 previous_link.has_cycle = true;
                 current = st_t{0, 0};
                 break;
@@ -516,7 +632,7 @@ void FlexDiskCheck::AddItem(const std::string &name, SectorType type,
         }
 
         ++item.sectors;
-        visited.emplace(current);
+        current_link.visited_by = item_index;
 
         if (has_end && current == end)
         {
@@ -614,8 +730,7 @@ void FlexDiskCheck::InitializeFileSectors()
                                  current.trk, current.sec))
         {
             // Directory sector not readable, abort while loop.
-            links.emplace(current, link_t{current});
-            links.at(current).is_bad = true;
+            EmplaceLink(link_t{current}).is_bad = true;
             break;
         }
 
@@ -658,27 +773,29 @@ void FlexDiskCheck::InitializeLostSectors()
 {
     std::vector<st_t> not_assigned;
 
-    for (auto &iter : links)
-    {
-        const auto &link = iter.second;
-
+    ForEachLink([&](const link_t &link){
         if (link.trk_sec.trk != 0 &&
             link.type == SectorType::NotAssigned &&
             !link.is_bad)
         {
             not_assigned.push_back(link.trk_sec);
-            if (IsTrackSectorValid(link.to))
-            {
-                auto &to_link = links.at(link.to);
-                to_link.from.emplace(link.trk_sec);
-            }
+        }
+    });
+
+    for (const auto &current : not_assigned)
+    {
+        const auto &link = GetLink(current);
+
+        if (IsTrackSectorValid(link.to))
+        {
+            AddFrom(GetLink(link.to), link.trk_sec);
         }
     }
 
     int index = 1;
     for (auto &current : not_assigned)
     {
-        auto &link = links.at(current);
+        const auto &link = GetLink(current);
         if (link.from.empty())
         {
             std::string name = "Lost" + std::to_string(index);
@@ -711,7 +828,7 @@ void FlexDiskCheck::DumpItemChains(std::ostream &os) const
         new_line = true;
         while (current != st_t{0, 0})
         {
-            const auto &link = links.at(current);
+            const auto &link = GetLink(current);
             if (new_line)
             {
                 os << "  ";
@@ -753,11 +870,10 @@ std::ostream &FlexDiskCheck::DebugDump(std::ostream &os) const
     }
 
     os << "********  L I N K S  ********\n";
-    os << "count=" << links.size() << "\n";
-    for (const auto &iter : links)
-    {
-        os << " " << iter.second << "\n";
-    }
+    os << "count=" << GetLinkCount() << "\n";
+    ForEachLink([&os](const link_t &link){
+        os << " " << link << "\n";
+    });
 
     os << "********  I T E M   C H A I N S  ********\n";
     DumpItemChains(os);
@@ -20,7 +20,6 @@
 */
 
 #include <vector>
-#include <set>
 #include <map>
 #include <string>
 #include <iostream>
@@ -68,14 +67,18 @@ class FlexDiskCheck
         SectorType type{SectorType::NotAssigned};
         st_t trk_sec{}; // track-sector of this sector.
         st_t to{}; // track-sector to next linked sector or 00-00.
-        std::set<st_t> from; // track-sector from previous linked sector(s)
+        std::vector<st_t> from; // track-sector from previous linked
+                                // sector(s), sorted ascending.
         SDWord item_index{-1}; // index of according item
+        SDWord visited_by{-1}; // index of item which visited this link
+                               // last (used for cycle detection).
         Word record_nr{0}; // record number
         Word expected_record_nr{0}; // expected record number (only valid if
                                     // type == SectorType::File)
         bool is_bad{false}; // flag if trk_sec is a bad track-sector
                             // (not usable as link).
         bool has_cycle{false}; // flag if this link has a cycle
+        bool is_used{false}; // flag if this link is part of the link table.
 
         s_link() = default;
 
@@ -146,6 +149,15 @@ private:
     static bool CheckTime(Byte hour, Byte minute);
     void DumpItemChains(std::ostream &os) const;
 
+    link_t &EmplaceLink(const link_t &link);
+    link_t *FindLink(st_t trk_sec);
+    const link_t *FindLink(st_t trk_sec) const;
+    link_t &GetLink(st_t trk_sec);
+    const link_t &GetLink(st_t trk_sec) const;
+    size_t GetLinkCount() const;
+    template <typename F> void ForEachLink(F function) const;
+    static void AddFrom(link_t &link, st_t from);
+
     void AddItem(const std::string &name, SectorType type,
                  const st_t &start,
                  const st_t &end = st_t{0, 0},
@@ -166,7 +178,13 @@ private:
 
     const IFlexDiskBySector &flexDisk;
     FlexDiskAttributes diskAttributes;
-    std::map<st_t, link_t> links;
+    // Links of all track-sectors within the disk geometry, indexed by
+    // track * (sectors + 1) + sector. Links of track-sectors outside of the
+    // disk geometry, only referenced as bad link, are kept in outsideLinks.
+    std::vector<link_t> links;
+    std::map<st_t, link_t> outsideLinks;
+    int trackCount{};
+    int sectorCount{};
     std::vector<item_t> items;
     FlexDiskCheckResultItems results;
     Byte disk_month{0};
@@ -24,6 +24,7 @@
 #include "flblfile.h"
 #include "binifile.h"
 #include <ostream>
+#include <fstream>
 #include <sstream>
 #include <regex>
 
@@ -72,3 +73,47 @@ std::map<unsigned, std::string> FlexLabelFile::ReadFile(
 
     return result;
 }
+
+// Read labels from an assembler symbol table or listing file.
+// Supported are lines starting in the first column of the form:
+//   LABEL EQU $CD03
+//   LABEL = $CD03
+//   LABEL $CD03
+// Any other line, e.g. source lines of a listing, is silently ignored.
+std::map<unsigned, std::string> FlexLabelFile::ReadSymbolFile(
+        const std::string &path)
+{
+    static std::regex regexLine(
+        "^([A-Z_.][A-Z0-9_.$]*):?\\s+(?:(?:EQU|SET)\\s+|=\\s*)?"
+        "\\$([0-9A-F]{1,4})\\s*(;.*)?$", std::regex_constants::icase);
+    std::map<unsigned, std::string> result;
+    std::ifstream ifs(path);
+    std::string line;
+
+    if (!ifs.is_open())
+    {
+        return {};
+    }
+
+    while (std::getline(ifs, line))
+    {
+        std::smatch match;
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (std::regex_match(line, match, regexLine) && match.size() >= 3)
+        {
+            std::stringstream stream(match[2]);
+            unsigned addr{};
+
+            stream >> std::hex >> addr;
+
+            result[addr] = match[1];
+        }
+    }
+
+    return result;
+}
@@ -36,6 +36,8 @@ public:
             std::ostream &os,
             const std::string &path,
             const std::string &section);
+    static std::map<unsigned, std::string> ReadSymbolFile(
+            const std::string &path);
 };
 
 #endif
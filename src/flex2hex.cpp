@@ -26,12 +26,18 @@
 #include "bmembuf.h"
 #include "fileread.h"
 #include "flexerr.h"
+#include "da6809.h"
+#include "flowdis.h"
 #include <cctype>
 #include <limits>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <map>
+#include <vector>
+#include <sstream>
+#include <atomic>
+#include <thread>
 #include <sys/stat.h>
 #ifdef HAVE_UNISTD_H
     #include <sys/types.h>
@@ -45,6 +51,7 @@ enum class FileType : uint8_t
     IntelHex,
     MotorolaSRec,
     RawBinary,
+    Listing,
 };
 
 static void version()
@@ -54,13 +61,28 @@ static void version()
         "flex2hex " << COPYRIGHT_MESSAGE;
 }
 
+// One conversion of an input file to an output file. Messages are
+// collected per conversion to print them in order of the input files.
+struct sConversion
+{
+    std::string ifile;
+    std::string ofile;
+    std::ostringstream messages;
+    int result{};
+};
+
 static void syntax()
 {
     std::cout <<
         "flex2hex syntax:\n"
         " Convert FLEX binary file(s) to Intel Hex or Motorola S-Record File:\n"
         "   flex2hex [-i|-m|-b][-y][-v] -o <hex_file> <flex_bin_file>\n"
-        "   flex2hex [-i|-m|-b][-y][-v] <flex_bin_file> [<flex_bin_file>...]\n"
+        "   flex2hex [-i|-m|-b][-j <jobs>][-y][-v] <flex_bin_file> "
+        "[<flex_bin_file>...]\n"
+        " Create a disassembly listing of FLEX binary, Intel Hex or Motorola\n"
+        " S-Record file(s):\n"
+        "   flex2hex -d [-e <address>...][-n][-j <jobs>][-y][-v] <file> "
+        "[<file>...]\n"
         "   flex2hex -h\n\n"
         "   <flex_bin_file>: A input file in FLEX binary format.\n"
         "   -o <hex_file>:   A output file.\n"
@@ -68,24 +90,75 @@ static void syntax()
         "   -m:              hex_file has Motorola S-Record format (*.s19).\n"
         "   -b:              hex_file has raw binary format (*.bin).\n"
         "                    Address range gaps are filled up with 0.\n"
+        "   -d:              Output is a disassembly listing (*.lst).\n"
+        "                    Code is detected by following all code paths\n"
+        "                    starting at the transfer address, the MC6809\n"
+        "                    vectors and the FLEX entry points.\n"
+        "   -e <address>:    Additional hex entry point for -d.\n"
+        "                    Can be used multiple times.\n"
+        "   -n:              No FLEX entry points for -d, e.g. for a ROM.\n"
+        "   -j <jobs>:       Convert up to <jobs> files in parallel.\n"
+        "                    0 uses one job per CPU core. Default: 1.\n"
         "   -y:              Overwrite existing file(s) without confirmation.\n"
         "   -v:              Verbose output.\n"
         "   -V:              Print version number and exit.\n"
         "   -h:              Print this help and exit.\n";
 }
 
-static int ConvertFlexToHex(const std::string &ifile, const std::string &ofile,
-        FileType ofiletype, int verbose)
+static int write_listing(const std::string &filename,
+        const MemorySource<DWord> &memsrc, DWord startAddress,
+        const std::vector<Word> &entryPoints, bool withFlexEntryPoints)
+{
+    std::ofstream ostream(filename, std::ios_base::out | std::ios_base::trunc);
+
+    if (!ostream.is_open())
+    {
+        return -6; // Could not open file for writing
+    }
+
+    Da6809 disassembler;
+    FlowDisassembler flowDisassembler(disassembler);
+
+    flowDisassembler.SetMemory(memsrc);
+    if (startAddress <= 0xFFFFU)
+    {
+        flowDisassembler.AddEntryPoint(static_cast<Word>(startAddress));
+    }
+    for (const auto entryPoint : entryPoints)
+    {
+        flowDisassembler.AddEntryPoint(entryPoint);
+    }
+    flowDisassembler.AddVectorEntryPoints();
+    if (withFlexEntryPoints)
+    {
+        flowDisassembler.AddFlexEntryPoints();
+    }
+    flowDisassembler.Analyze();
+    flowDisassembler.WriteListing(ostream);
+
+    return ostream.good() ? 0 : -5;
+}
+
+// The memory buffer is reused for each conversion. Only the address ranges
+// loaded by the previous conversion have to be cleared.
+static int ConvertFlexToHex(BMemoryBuffer &memory, const std::string &ifile,
+        const std::string &ofile, FileType ofiletype,
+        const std::vector<Word> &entryPoints, bool withFlexEntryPoints,
+        int verbose, std::ostream &messages)
 {
-    BMemoryBuffer memory(65536);
+    memory.Reset();
     DWord startAddress = std::numeric_limits<DWord>::max();
+    sHexFilePosition position;
 
-    auto result = load_flex_binary(ifile, memory, startAddress);
+    // For a disassembly listing any supported input file format is accepted.
+    auto result = (ofiletype == FileType::Listing) ?
+        load_hexfile(ifile, memory, startAddress, &position) :
+        load_flex_binary(ifile, memory, startAddress);
     if (result < 0)
     {
-        std::cerr << "*** Error in \"" << ifile << "\":\n    ";
-        print_hexfile_error(std::cerr, result);
-        std::cerr << '\n';
+        messages << "*** Error in \"" << ifile << "\":\n    ";
+        print_hexfile_error(messages, result, position);
+        messages << '\n';
         return 1;
     }
 
@@ -103,39 +176,105 @@ static int ConvertFlexToHex(const std::string &ifile, const std::string &ofile,
                   result = write_raw_binary(ofile, memory, startAddress);
                   break;
 
+        case FileType::Listing:
+                  result = write_listing(ofile, memory, startAddress,
+                          entryPoints, withFlexEntryPoints);
+                  break;
+
         case FileType::Unknown:
-                  std::cerr << "*** No file format specified\n";
+                  messages << "*** No file format specified\n";
                   return 1;
     }
 
     if (result < 0)
     {
-        std::cerr << "*** Error in \"" << ofile << "\":\n    ";
-        print_hexfile_error(std::cerr, result);
-        std::cerr << '\n';
+        messages << "*** Error in \"" << ofile << "\":\n    ";
+        print_hexfile_error(messages, result);
+        messages << '\n';
         return 1;
     }
 
     if (verbose > 0)
     {
-        std::cout << " " << ifile << " converted to " << ofile << ".\n";
+        messages << " " << ifile << " converted to " << ofile << ".\n";
     }
 
     return 0;
 }
 
+// Convert all files with up to jobs worker threads. Each worker thread
+// reuses its memory buffer for all its conversions.
+static int ConvertFlexToHex(std::vector<sConversion> &conversions,
+        FileType ofiletype, const std::vector<Word> &entryPoints,
+        bool withFlexEntryPoints, int verbose, unsigned jobs)
+{
+    std::atomic<size_t> nextIndex{0U};
+
+    if (ofiletype == FileType::Listing && jobs > 1U)
+    {
+        // Load the label index shared by all disassemblers before the
+        // worker threads start.
+        Da6809::LoadLabelIndex();
+    }
+    const auto convert = [&]()
+    {
+        BMemoryBuffer memory(65536);
+
+        for (auto index = nextIndex++; index < conversions.size();
+             index = nextIndex++)
+        {
+            auto &conversion = conversions[index];
+
+            conversion.result = ConvertFlexToHex(memory, conversion.ifile,
+                    conversion.ofile, ofiletype, entryPoints,
+                    withFlexEntryPoints, verbose, conversion.messages);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    jobs = std::min(jobs, static_cast<unsigned>(conversions.size()));
+    for (unsigned i = 1U; i < jobs; ++i)
+    {
+        threads.emplace_back(convert);
+    }
+    convert();
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    int result = 0;
+    for (const auto &conversion : conversions)
+    {
+        auto &ostream = (conversion.result == 0) ? std::cout : std::cerr;
+
+        ostream << conversion.messages.str();
+        if (conversion.result != 0)
+        {
+            result = conversion.result;
+        }
+    }
+
+    return result;
+}
+
 int main(int argc, char *argv[])
 {
     static const std::map<int, FileType> fileTypes{
         { 'm', FileType::MotorolaSRec },
         { 'i', FileType::IntelHex },
         { 'b', FileType::RawBinary },
+        { 'd', FileType::Listing },
     };
-    std::string optstr("himbo:vVy");
+    std::string optstr("himbde:nj:o:vVy");
     std::vector<std::string> ifiles;
+    std::vector<sConversion> conversions;
+    std::vector<Word> entryPoints;
     std::string ofilePrefered;
     FileType ofiletype = FileType::Unknown;
     bool isOverwriteAlways = false;
+    bool withFlexEntryPoints = true;
+    unsigned jobs = 1U;
     int verbose = 0;
     int result;
 
@@ -150,17 +289,50 @@ int main(int argc, char *argv[])
             case 'i':
             case 'm':
             case 'b':
+            case 'd':
                       if (ofiletype != FileType::Unknown &&
                           ofiletype != fileTypes.at(result))
                       {
-                          std::cerr << "*** Error: Only one of -m or -i can "
-                                       "be used at a time.\n";
+                          std::cerr << "*** Error: Only one of -m, -i, -b "
+                                       "or -d can be used at a time.\n";
                           syntax();
                           return 1;
                       }
                       ofiletype = fileTypes.at(result);
                       break;
 
+            case 'e':
+                      {
+                          std::stringstream stream(optarg);
+                          DWord address{};
+
+                          if (!(stream >> std::hex >> address) ||
+                              address > 0xFFFFU)
+                          {
+                              std::cerr << "*** Error: Invalid entry point '" <<
+                                           optarg << "'.\n";
+                              return 1;
+                          }
+                          entryPoints.push_back(static_cast<Word>(address));
+                      }
+                      break;
+
+            case 'n': withFlexEntryPoints = false;
+                      break;
+
+            case 'j':
+                      {
+                          if (!flx::getJobCount(optarg, jobs))
+                          {
+                              std::cerr << "*** Error: Invalid number of "
+                                           "jobs '" << optarg << "'. Valid "
+                                           "range is 0 to " << flx::MAX_JOBS <<
+                                           ".\n";
+                              return 1;
+                          }
+                      }
+                      break;
+
             case 'V': version();
                       return 0;
 
@@ -174,7 +346,8 @@ int main(int argc, char *argv[])
                       break;
 
             case '?':
-                      if (optopt != 'o' && !isprint(optopt))
+                      if (optopt != 'o' && optopt != 'e' && optopt != 'j' &&
+                          !isprint(optopt))
                       {
                           std::cerr << "*** Unknown option character '\\x" <<
                                        std::hex << optopt << "'.\n";
@@ -212,8 +385,6 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    result = 0;
-
     for (const auto &ifile : ifiles)
     {
         struct stat status{};
@@ -236,6 +407,10 @@ int main(int argc, char *argv[])
                     ofile += ".bin";
                     break;
 
+                case FileType::Listing:
+                    ofile += ".lst";
+                    break;
+
                 case FileType::Unknown:
                     std::cerr << "*** No file format specified. "
                                  "Conversion skipped\n";
@@ -243,6 +418,20 @@ int main(int argc, char *argv[])
             }
         }
 
+        // Parallel conversions must not write the same output file.
+        const auto absOfile = flx::toAbsolutePath(ofile);
+        for (const auto &conversion : conversions)
+        {
+            if (flx::isPathsEqual(flx::toAbsolutePath(conversion.ofile),
+                                  absOfile))
+            {
+                std::cerr << "*** Error: " << conversion.ifile << " and " <<
+                             ifile << " are both converted to " << ofile <<
+                             ".\n";
+                return 1;
+            }
+        }
+
         if (!stat(ofile.c_str(), &status))
         {
             if (!S_ISREG(status.st_mode))
@@ -279,9 +468,12 @@ int main(int argc, char *argv[])
             }
         }
 
-        result = ConvertFlexToHex(ifile, ofile, ofiletype, verbose);
+        auto &conversion = conversions.emplace_back();
+        conversion.ifile = ifile;
+        conversion.ofile = ofile;
     }
 
-    return result;
+    return ConvertFlexToHex(conversions, ofiletype, entryPoints,
+                            withFlexEntryPoints, verbose, jobs);
 }
 
@@ -78,6 +78,7 @@ FERR_ERROR_IN_SYSTEM_CALL = 44,
 FERR_INVALID_JVC_HEADER = 45,
 FERR_BAD_OPTIONAL_ACCESS = 46,
 FERR_WILDCARD_NOT_SUPPORTED = 47,
+FERR_STORE_LOCKED = 48,
 };
 
 
@@ -87,7 +88,7 @@ protected:
 
     int errorCode;
     std::string errorString;
-    static std::array<const char *, 48> errString;
+    static std::array<const char *, 49> errString;
 
 public:
 
@@ -0,0 +1,456 @@
+/*
+    flowdis.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "misc1.h"
+#include "flowdis.h"
+#include <array>
+#include <algorithm>
+#include <fmt/format.h>
+
+
+// Size of the 64 KByte address space.
+static constexpr DWord ADDRESS_SPACE_SIZE{0x10000U};
+// Maximum byte size of a MC6809 instruction. Used as padding at the end of
+// the memory image.
+static constexpr DWord MAX_INSTRUCTION_SIZE{5U};
+// Number of bytes printed in one FCB line of the listing.
+static constexpr DWord BYTES_PER_DATA_LINE{4U};
+
+FlowDisassembler::FlowDisassembler(AbstractDisassembler &p_disassembler)
+    : disassembler(p_disassembler)
+    , memory(ADDRESS_SPACE_SIZE + MAX_INSTRUCTION_SIZE, 0U)
+    , byteTypes(ADDRESS_SPACE_SIZE, ByteType::NotLoaded)
+    , labels(ADDRESS_SPACE_SIZE, false)
+{
+}
+
+void FlowDisassembler::SetMemory(const MemorySource<DWord> &memsrc)
+{
+    std::fill(memory.begin(), memory.end(), Byte(0U));
+    std::fill(byteTypes.begin(), byteTypes.end(), ByteType::NotLoaded);
+    std::fill(labels.begin(), labels.end(), false);
+    references.clear();
+
+    for (const auto &addressRange : memsrc.GetAddressRanges())
+    {
+        if (addressRange.lower() >= ADDRESS_SPACE_SIZE)
+        {
+            continue;
+        }
+
+        const auto upper =
+            std::min(addressRange.upper(), ADDRESS_SPACE_SIZE - 1U);
+        const auto size = upper - addressRange.lower() + 1U;
+
+        memsrc.CopyTo(&memory[addressRange.lower()], addressRange.lower(),
+                size);
+        std::fill_n(byteTypes.begin() + addressRange.lower(), size,
+                ByteType::Data);
+    }
+}
+
+void FlowDisassembler::AddEntryPoint(Word address)
+{
+    if (std::find(entryPoints.cbegin(), entryPoints.cend(), address) ==
+            entryPoints.cend())
+    {
+        entryPoints.push_back(address);
+    }
+}
+
+// Add all MC6809 interrupt and reset vectors contained in the memory image
+// as entry points.
+void FlowDisassembler::AddVectorEntryPoints()
+{
+    // SWI3, SWI2, FIRQ, IRQ, SWI, NMI, RESET
+    for (DWord vector = 0xFFF2U; vector < ADDRESS_SPACE_SIZE; vector += 2U)
+    {
+        if (byteTypes[vector] != ByteType::NotLoaded &&
+            byteTypes[vector + 1U] != ByteType::NotLoaded)
+        {
+            AddEntryPoint(flx::getValueBigEndian<Word>(&memory[vector]));
+        }
+    }
+}
+
+// Add the FLEX DOS and FMS entry points contained in the memory image.
+void FlowDisassembler::AddFlexEntryPoints()
+{
+    static const std::array<Word, 30> flexEntryPoints{
+        0xCD00, 0xCD03, 0xCD06, 0xCD09, 0xCD0C, 0xCD0F, 0xCD12, 0xCD15,
+        0xCD18, 0xCD1B, 0xCD1E, 0xCD21, 0xCD24, 0xCD27, 0xCD2A, 0xCD2D,
+        0xCD30, 0xCD33, 0xCD36, 0xCD39, 0xCD3C, 0xCD3F, 0xCD42, 0xCD45,
+        0xCD48, 0xCD4B, 0xCD4E, 0xD400, 0xD403, 0xD406,
+    };
+
+    for (const auto address : flexEntryPoints)
+    {
+        if (byteTypes[address] != ByteType::NotLoaded)
+        {
+            AddEntryPoint(address);
+        }
+    }
+}
+
+void FlowDisassembler::Analyze()
+{
+    std::vector<Word> pending(entryPoints.crbegin(), entryPoints.crend());
+
+    for (const auto address : entryPoints)
+    {
+        labels[address] = true;
+    }
+
+    while (!pending.empty())
+    {
+        const auto address = pending.back();
+
+        pending.pop_back();
+        Trace(address, pending);
+    }
+
+    std::stable_sort(references.begin(), references.end(),
+        [](const Reference &lhs, const Reference &rhs){
+            return lhs.target < rhs.target;
+        });
+}
+
+// Follow one code path starting at address until it ends with an
+// unconditional jump or return, reaches already analyzed code or leaves
+// the memory image. Branch and call targets are added to pending.
+void FlowDisassembler::Trace(Word address, std::vector<Word> &pending)
+{
+    DisassemblyText text;
+
+    while (byteTypes[address] == ByteType::Data)
+    {
+        DWord jumpAddress = 0U;
+        const auto *instruction = &memory[address];
+        const auto flags =
+            disassembler.Disassemble(instruction, address, jumpAddress, text);
+        const auto size = disassembler.getByteSize(instruction);
+
+        if (size == 0U || (flags & InstFlg::Illegal) != InstFlg::NONE ||
+            address + size > ADDRESS_SPACE_SIZE)
+        {
+            return;
+        }
+
+        for (DWord offset = 1U; offset < size; ++offset)
+        {
+            if (byteTypes[address + offset] != ByteType::Data)
+            {
+                // Instruction would overlap with code or unloaded memory.
+                return;
+            }
+        }
+
+        byteTypes[address] = ByteType::Code;
+        std::fill_n(byteTypes.begin() + address + 1U, size - 1U,
+                ByteType::Operand);
+
+        const auto flow = DecodeFlow(instruction, address, size);
+
+        if (flow.hasTarget)
+        {
+            references.push_back({ flow.target, address, flow.type });
+            if (byteTypes[flow.target] != ByteType::NotLoaded)
+            {
+                labels[flow.target] = true;
+                if (flow.type != RefType::Data)
+                {
+                    pending.push_back(flow.target);
+                }
+            }
+        }
+
+        if (flow.isEnd || address + size == ADDRESS_SPACE_SIZE)
+        {
+            return;
+        }
+
+        address = static_cast<Word>(address + size);
+    }
+}
+
+// Decode the control flow or the extended address of an instruction.
+FlowDisassembler::Flow FlowDisassembler::DecodeFlow(const Byte *instruction,
+        Word pc, unsigned size)
+{
+    Flow flow;
+    const auto next = static_cast<Word>(pc + size);
+    const auto opcode = instruction[0];
+
+    auto setTarget = [&](Word target, RefType type)
+    {
+        flow.hasTarget = true;
+        flow.target = target;
+        flow.type = type;
+    };
+    auto relative8 = [&]()
+    {
+        return static_cast<Word>(next + EXTEND8(instruction[1]));
+    };
+    auto word_at = [&](unsigned index)
+    {
+        return flx::getValueBigEndian<Word>(&instruction[index]);
+    };
+
+    if (opcode == PAGE2 || opcode == PAGE3)
+    {
+        const auto code = instruction[1];
+
+        if (opcode == PAGE2 && code > 0x21U && code <= 0x2FU)
+        {
+            // LBcc
+            setTarget(static_cast<Word>(next + word_at(2U)), RefType::Jump);
+        }
+        else if ((code & 0xB0U) == 0xB0U)
+        {
+            // Extended addressing.
+            setTarget(word_at(2U), RefType::Data);
+        }
+
+        return flow;
+    }
+
+    switch (opcode)
+    {
+        case 0x20: // BRA
+            setTarget(relative8(), RefType::Jump);
+            flow.isEnd = true;
+            break;
+
+        case 0x21: // BRN
+            break;
+
+        case 0x22: case 0x23: case 0x24: case 0x25: case 0x26: case 0x27:
+        case 0x28: case 0x29: case 0x2A: case 0x2B: case 0x2C: case 0x2D:
+        case 0x2E: case 0x2F: // Bcc
+            setTarget(relative8(), RefType::Jump);
+            break;
+
+        case 0x8D: // BSR
+            setTarget(relative8(), RefType::Call);
+            break;
+
+        case 0x16: // LBRA
+            setTarget(static_cast<Word>(next + word_at(1U)), RefType::Jump);
+            flow.isEnd = true;
+            break;
+
+        case 0x17: // LBSR
+            setTarget(static_cast<Word>(next + word_at(1U)), RefType::Call);
+            break;
+
+        case 0x7E: // JMP extended
+            setTarget(word_at(1U), RefType::Jump);
+            flow.isEnd = true;
+            break;
+
+        case 0xBD: // JSR extended
+            setTarget(word_at(1U), RefType::Call);
+            break;
+
+        case 0x0E: // JMP direct
+        case 0x6E: // JMP indexed
+        case 0x39: // RTS
+        case 0x3B: // RTI
+        case 0x3E: // RESET (undocumented)
+            flow.isEnd = true;
+            break;
+
+        case 0x35: // PULS
+        case 0x37: // PULU
+            flow.isEnd = (instruction[1] & 0x80U) != 0U;
+            break;
+
+        case 0x1E: // EXG
+            flow.isEnd = (instruction[1] & 0x0FU) == 0x05U ||
+                         (instruction[1] & 0xF0U) == 0x50U;
+            break;
+
+        case 0x1F: // TFR
+            flow.isEnd = (instruction[1] & 0x0FU) == 0x05U;
+            break;
+
+        default:
+            if ((opcode & 0x70U) == 0x70U || (opcode & 0xB0U) == 0xB0U)
+            {
+                // Extended addressing.
+                setTarget(word_at(1U), RefType::Data);
+            }
+            break;
+    }
+
+    return flow;
+}
+
+void FlowDisassembler::WriteXrefs(std::ostream &os, Word address) const
+{
+    static const std::array<char, 3> typeChars{ 'J', 'C', 'D' };
+    const auto iter = std::lower_bound(references.cbegin(), references.cend(),
+            address, [](const Reference &reference, Word value){
+                return reference.target < value;
+            });
+    int count = 0;
+
+    for (auto it = iter; it != references.cend() && it->target == address;
+         ++it)
+    {
+        if (count % 8 == 0)
+        {
+            os << fmt::format("{}{:21}; XREF:", count == 0 ? "" : "\n", "");
+        }
+        os << fmt::format(" {:04X}{}", it->source,
+                typeChars[static_cast<unsigned>(it->type)]);
+        ++count;
+    }
+
+    if (count != 0)
+    {
+        os << '\n';
+    }
+}
+
+void FlowDisassembler::WriteListing(std::ostream &os) const
+{
+    DisassemblyText text;
+    DWord address = 0U;
+    bool isGap = true;
+    DWord codeBytes = 0U;
+    DWord dataBytes = 0U;
+
+    os << "; Entry points:";
+    for (const auto entryPoint : entryPoints)
+    {
+        os << fmt::format(" {:04X}", entryPoint);
+    }
+    os << "\n";
+
+    while (address < ADDRESS_SPACE_SIZE)
+    {
+        const auto type = byteTypes[address];
+
+        if (type == ByteType::NotLoaded)
+        {
+            isGap = true;
+            ++address;
+            continue;
+        }
+
+        if (isGap)
+        {
+            os << fmt::format("\n{:21}{:8}ORG   ${:04X}\n", "", "", address);
+            isGap = false;
+        }
+
+        const auto label = labels[address] ?
+            fmt::format("L{:04X}", address) : std::string();
+
+        if (labels[address])
+        {
+            WriteXrefs(os, static_cast<Word>(address));
+        }
+
+        if (type == ByteType::Code)
+        {
+            DWord jumpAddress = 0U;
+            const auto *instruction = &memory[address];
+
+            disassembler.Disassemble(instruction, address, jumpAddress, text);
+            const auto size = disassembler.getByteSize(instruction);
+
+            if (text.operands[0] == '\0')
+            {
+                os << fmt::format("{:<21}{:<8}{}\n", text.code.data(), label,
+                        text.mnemonic.data());
+            }
+            else
+            {
+                os << fmt::format("{:<21}{:<8}{:<5} {}\n", text.code.data(),
+                        label, text.mnemonic.data(), text.operands.data());
+            }
+            codeBytes += size;
+            address += size;
+            continue;
+        }
+
+        // Data bytes, printed as FCB. A line ends at the next label.
+        DWord count = 0U;
+        std::string code = fmt::format("{:04X}:", address);
+        std::string operands;
+
+        do
+        {
+            code += fmt::format(" {:02X}", memory[address + count]);
+            operands += fmt::format("{}${:02X}", count == 0U ? "" : ",",
+                    memory[address + count]);
+            ++count;
+        } while (count < BYTES_PER_DATA_LINE &&
+                 address + count < ADDRESS_SPACE_SIZE &&
+                 byteTypes[address + count] == ByteType::Data &&
+                 !labels[address + count]);
+
+        os << fmt::format("{:<21}{:<8}{:<5} {}\n", code, label, "FCB",
+                operands);
+        dataBytes += count;
+        address += count;
+    }
+
+    os << fmt::format("\n; {} code bytes, {} data bytes, {} references\n",
+            codeBytes, dataBytes, references.size());
+}
+
+FlowDisassembler::ByteType FlowDisassembler::GetByteType(Word address) const
+{
+    return byteTypes[address];
+}
+
+bool FlowDisassembler::HasLabel(Word address) const
+{
+    return labels[address];
+}
+
+std::vector<FlowDisassembler::Reference> FlowDisassembler::GetReferencesTo(
+        Word address) const
+{
+    std::vector<Reference> result;
+    const auto iter = std::lower_bound(references.cbegin(), references.cend(),
+            address, [](const Reference &reference, Word value){
+                return reference.target < value;
+            });
+
+    for (auto it = iter; it != references.cend() && it->target == address;
+         ++it)
+    {
+        result.push_back(*it);
+    }
+
+    return result;
+}
+
+const std::vector<FlowDisassembler::Reference> &
+FlowDisassembler::GetReferences() const
+{
+    return references;
+}
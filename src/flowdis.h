@@ -0,0 +1,105 @@
+/*
+    flowdis.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef FLOWDIS_INCLUDED
+#define FLOWDIS_INCLUDED
+
+#include "typedefs.h"
+#include "absdisas.h"
+#include "memsrc.h"
+#include <ostream>
+#include <vector>
+
+
+// Static disassembler for a whole 64 KByte memory image.
+// Starting from a set of entry points (e.g. the interrupt vectors, the FLEX
+// DOS entry points or a transfer address) it follows all branches, jumps
+// and subroutine calls (recursive descent). All reached bytes are marked as
+// code, all other loaded bytes are data. References to addresses are
+// collected as cross references.
+// Computed jumps (e.g. JMP [,X]) can not be followed. Additional entry
+// points can be added for them.
+// Each MMU bank can be analyzed separately by providing a 64 KByte view
+// of it as memory source.
+class FlowDisassembler
+{
+public:
+    enum class ByteType : uint8_t
+    {
+        NotLoaded, // Address not contained in memory image.
+        Data,      // Loaded byte, not reached by any code path.
+        Code,      // First byte of an instruction.
+        Operand,   // Subsequent byte of an instruction.
+    };
+
+    enum class RefType : uint8_t
+    {
+        Jump, // Branch or jump.
+        Call, // Subroutine call.
+        Data, // Memory access with extended addressing.
+    };
+
+    struct Reference
+    {
+        Word target;
+        Word source;
+        RefType type;
+    };
+
+    FlowDisassembler() = delete;
+    explicit FlowDisassembler(AbstractDisassembler &p_disassembler);
+
+    void SetMemory(const MemorySource<DWord> &memsrc);
+    void AddEntryPoint(Word address);
+    void AddVectorEntryPoints();
+    void AddFlexEntryPoints();
+    void Analyze();
+    void WriteListing(std::ostream &os) const;
+
+    ByteType GetByteType(Word address) const;
+    bool HasLabel(Word address) const;
+    std::vector<Reference> GetReferencesTo(Word address) const;
+    const std::vector<Reference> &GetReferences() const;
+
+private:
+    struct Flow
+    {
+        bool isEnd{};
+        bool hasTarget{};
+        Word target{};
+        RefType type{RefType::Jump};
+    };
+
+    void Trace(Word address, std::vector<Word> &pending);
+    static Flow DecodeFlow(const Byte *instruction, Word pc, unsigned size);
+    void WriteXrefs(std::ostream &os, Word address) const;
+
+    AbstractDisassembler &disassembler;
+    std::vector<Byte> memory;
+    std::vector<ByteType> byteTypes;
+    std::vector<bool> labels;
+    std::vector<Word> entryPoints;
+    std::vector<Reference> references;
+};
+
+#endif // FLOWDIS_INCLUDED
+
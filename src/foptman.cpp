@@ -111,6 +111,26 @@ void FlexemuOptions::PrintHelp(std::ostream &os)
           "  -L <file_path> Enable CPU instruction logging.\n"
           "     File extension: *.log or *.txt logs to a text file; "
           "*.csv logs to a csv file.\n"
+          "  -S <file_path> Use labels of an assembler symbol file in the "
+            "disassembler.\n"
+          "     Can be used multiple times.\n"
+#ifdef UNIX
+          "  -X <socket_path> Serve hot path counters on a Unix domain "
+            "socket.\n"
+#endif
+          "  -Z (print hot path counters on exit)\n"
+          "  -R <file_path> Restore a machine snapshot on startup.\n"
+#ifdef UNIX
+          "  -K <socket_path> Fork a copy of the booted emulator for each "
+            "connection\n"
+          "     on a Unix domain socket. Needs terminal mode (Linux only).\n"
+#endif
+          "  -M (Eurocom II/V5: fast loading from MDCR tapes)\n"
+          "  -W <file_path> Record all terminal inputs and timer ticks "
+            "to a replay log.\n"
+          "     Needs terminal mode.\n"
+          "  -P <file_path> Replay a replay log with maximum frequency.\n"
+          "     Needs terminal mode.\n"
           "  -h (display this)\n"
           "  -? (display this)\n"
           "  -V (print version number)\n";
@@ -175,7 +195,11 @@ void FlexemuOptions::GetCommandlineOptions(
     float f;
     optind = 1;
     opterr = 1;
-    std::string optstr("mup:f:0:1:2:3:j:F:C:O:L:");
+    std::string optstr("mup:f:0:1:2:3:j:F:C:O:L:S:ZR:MW:P:");
+#ifdef UNIX
+    optstr.append("K:"); // Unix domain socket of the fork server
+    optstr.append("X:"); // Unix domain socket of the hot path counters
+#endif
 #ifdef HAVE_TERMIOS_H
     optstr.append("tr:"); // terminal mode and reset key
 #endif
@@ -368,6 +392,38 @@ void FlexemuOptions::GetCommandlineOptions(
                 options.cpuLogPath = optarg;
                 break;
 
+            case 'S':
+                options.symbolFiles.emplace_back(optarg);
+                break;
+
+            case 'X':
+                options.counterSocketPath = optarg;
+                break;
+
+            case 'Z':
+                options.isPrintCounters = true;
+                break;
+
+            case 'R':
+                options.snapshotPath = optarg;
+                break;
+
+            case 'K':
+                options.forkServerPath = optarg;
+                break;
+
+            case 'M':
+                options.isMdcrFastLoad = true;
+                break;
+
+            case 'W':
+                options.replayRecordPath = optarg;
+                break;
+
+            case 'P':
+                options.replayPath = optarg;
+                break;
+
             case 'V':
                 std::cout <<
                     PROGRAMNAME " " PROGRAM_VERSION " (" OSTYPE ")\n" <<
@@ -0,0 +1,275 @@
+/*
+    forksrv.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "misc1.h"
+#include "forksrv.h"
+#include "schedule.h"
+#include "terminal.h"
+#include "e2floppy.h"
+#include "cpustate.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#ifdef UNIX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <csignal>
+#include <unistd.h>
+#endif
+
+
+#ifdef UNIX
+// Timeout in ms after which the server process checks if flexemu is still
+// running and for terminated child processes.
+static constexpr int POLL_TIMEOUT{200};
+
+// Return true if the process is known to be single threaded.
+// On Linux each thread has an entry in /proc/self/task. If the threads
+// can not be counted the process is not assumed to be single threaded.
+static bool IsSingleThreaded()
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    fs::directory_iterator iter("/proc/self/task", error);
+
+    if (error)
+    {
+        return false;
+    }
+
+    return std::distance(iter, fs::directory_iterator{}) == 1;
+}
+#endif
+
+ForkServer::ForkServer(std::string p_path, Scheduler &p_scheduler,
+                       TerminalIO &p_terminalIO, E2floppy &p_fdc)
+    : path(std::move(p_path))
+    , scheduler(p_scheduler)
+    , terminalIO(p_terminalIO)
+    , fdc(p_fdc)
+{
+}
+
+ForkServer::~ForkServer()
+{
+    Stop();
+}
+
+// Create the socket and fork the server process.
+// Return false if the process is not single threaded, the socket could not
+// be created or the server process could not be started.
+bool ForkServer::Start()
+{
+#ifdef UNIX
+    struct sockaddr_un address{};
+
+    // The path has to fit into sun_path including the terminating NUL.
+    // An existing file is only replaced if it is a socket.
+    if (serverPid >= 0 || path.empty() ||
+        path.size() >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+
+    if (!IsSingleThreaded())
+    {
+        std::cerr << "*** Error: The fork server needs a single threaded "
+                     "process.\n";
+        return false;
+    }
+
+    if (!flx::removeSocketFile(path))
+    {
+        return false;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1U);
+    if (bind(fd, reinterpret_cast<struct sockaddr *>(&address),
+             sizeof(address)) != 0 || listen(fd, 16) != 0)
+    {
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    // The disk contents of the server process has to be up to date.
+    fdc.sync_all_drives();
+    // Buffered output must not be written twice.
+    fflush(stdout);
+    fflush(stderr);
+
+    const auto pid = fork();
+
+    if (pid < 0)
+    {
+        close(fd);
+        fd = -1;
+        flx::removeSocketFile(path);
+        return false;
+    }
+
+    if (pid > 0)
+    {
+        // flexemu only keeps the path to remove the socket on Stop().
+        close(fd);
+        fd = -1;
+        serverPid = pid;
+        return true;
+    }
+
+    // Server process: Only the thread executing this function exists.
+    // Signals from the terminal are only meant for flexemu. Stop()
+    // terminates the server process with SIGTERM.
+    setpgid(0, 0);
+    signal(SIGTERM, SIG_DFL);
+    // The overlay disks are RAM disks without a file, all children inherit
+    // them copy-on-write.
+    if (!fdc.overlay_all_drives())
+    {
+        std::cerr << "*** Warning: Directory disks are not available in a "
+                     "forked child process.\n";
+    }
+
+    // Returns only in a child process.
+    Run();
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Stop the server process. Running child processes are not affected.
+void ForkServer::Stop()
+{
+#ifdef UNIX
+    if (serverPid >= 0)
+    {
+        kill(serverPid, SIGTERM);
+        waitpid(serverPid, nullptr, 0);
+        serverPid = -1;
+        flx::removeSocketFile(path);
+    }
+#endif
+}
+
+// Accept connections and fork a child process for each of them.
+// Only returns in a child process.
+void ForkServer::Run()
+{
+#ifdef UNIX
+    const auto parentPid = getppid();
+
+    while (true)
+    {
+        struct pollfd pfd{};
+
+        if (getppid() != parentPid)
+        {
+            // flexemu has terminated.
+            ExitChild(EXIT_SUCCESS);
+        }
+
+        ReapChildren();
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, POLL_TIMEOUT) <= 0 || (pfd.revents & POLLIN) == 0)
+        {
+            continue;
+        }
+
+        const auto connection = accept(fd, nullptr, nullptr);
+        if (connection < 0)
+        {
+            continue;
+        }
+
+        fflush(stdout);
+        fflush(stderr);
+        const auto pid = fork();
+
+        if (pid < 0)
+        {
+            std::cerr << "*** Error: Could not fork a child process.\n";
+        }
+
+        if (pid != 0)
+        {
+            close(connection);
+            continue;
+        }
+
+        // Child process: The server process is single threaded, so there
+        // is no mutex which could be locked by another thread.
+        isChild = true;
+        close(fd);
+        fd = -1;
+        if (!terminalIO.redirect_serial_io(connection))
+        {
+            ExitChild(EXIT_FAILURE);
+        }
+        close(connection);
+
+        return;
+    }
+#endif
+}
+
+// Collect the exit status of terminated child processes, otherwise they
+// remain as zombie processes.
+void ForkServer::ReapChildren()
+{
+#ifdef UNIX
+    while (waitpid(-1, nullptr, WNOHANG) > 0)
+    {
+    }
+#endif
+}
+
+void ForkServer::RunTimer()
+{
+    while (true)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(TIME_BASE));
+        scheduler.timer_elapsed();
+    }
+}
+
+void ForkServer::ExitChild(int status)
+{
+    fflush(stdout);
+    fflush(stderr);
+    std::_Exit(status);
+}
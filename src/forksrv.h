@@ -0,0 +1,95 @@
+/*
+    forksrv.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef FORKSRV_INCLUDED
+#define FORKSRV_INCLUDED
+
+#include <string>
+
+
+class Scheduler;
+class TerminalIO;
+class E2floppy;
+
+// The fork server waits for connections on a local (Unix domain) socket.
+// For each connection a child process is forked, which is a copy of the
+// emulator at startup, e.g. a booted FLEX restored from a snapshot.
+// All children share the emulated RAM copy-on-write.
+// The connection is the terminal of the child: Serial input is read from
+// and serial output is written to the connection. All disks of the child
+// are overlay disks, its changes are discarded. The child exits if the
+// connection is closed or the emulation exits,
+// e.g.: socat - UNIX-CONNECT:<path>
+//
+// fork() is only safe in a single threaded process, otherwise a child
+// could inherit a mutex locked by another thread. For this reason
+// Start() refuses to start if the process has more than one thread or if
+// the threads can not be counted (only supported on Linux). The Qt
+// platform plugin of a windowing system may start threads, so main() selects
+// the offscreen platform if the fork server is requested. Start() forks a
+// single threaded server process, which accepts the connections and forks
+// the children. In the server process all disks are replaced by overlay
+// disks, so the children do not share any disk file with flexemu.
+// A child only consists of the CPU thread and the main thread generating
+// the timer ticks, so the fork server needs terminal mode.
+class ForkServer
+{
+public:
+    ForkServer() = delete;
+    ForkServer(std::string p_path, Scheduler &p_scheduler,
+               TerminalIO &p_terminalIO, E2floppy &p_fdc);
+    ~ForkServer();
+    ForkServer(const ForkServer &src) = delete;
+    ForkServer(ForkServer &&src) = delete;
+    ForkServer &operator=(const ForkServer &src) = delete;
+    ForkServer &operator=(ForkServer &&src) = delete;
+
+    // Fails if any other thread has been started.
+    // Returns in flexemu and in each child process, see IsChild().
+    bool Start();
+    void Stop();
+    bool IsChild() const
+    {
+        return isChild;
+    }
+    // Generate the timer ticks of a child process. Never returns.
+    [[noreturn]] void RunTimer();
+    // Exit a child process without any cleanup. All objects besides the
+    // emulated machine are inherited from flexemu and must not be
+    // destroyed.
+    [[noreturn]] static void ExitChild(int status);
+
+private:
+    void Run();
+    static void ReapChildren();
+
+    std::string path;
+    Scheduler &scheduler;
+    TerminalIO &terminalIO;
+    E2floppy &fdc;
+    int fd{-1};
+    int serverPid{-1};
+    bool isChild{};
+};
+
+#endif // FORKSRV_INCLUDED
+
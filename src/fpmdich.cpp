@@ -45,6 +45,11 @@
 #include <QProgressDialog>
 #include "warnon.h"
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
 #include <string>
 #include <limits>
 #include <memory>
@@ -56,6 +61,50 @@
 #include "sfpopts.h"
 #include "fpcnvui.h"
 #include "qtfree.h"
+#include "rndcheck.h"
+#include "bwrkpool.h"
+
+// Worker pool shared by all MDI child windows. All tasks accessing a FLEX
+// disk use its path as key, so a disk is only accessed by one worker
+// thread at the same time.
+static BWorkerPool &GetWorkerPool()
+{
+    static BWorkerPool workerPool;
+
+    return workerPool;
+}
+
+// Wait for a task executed in the background while keeping the GUI
+// responsive. Returns false if the user has canceled the operation.
+template <typename T>
+static bool WaitFor(const std::future<T> &future, QProgressDialog &progress)
+{
+    while (future.wait_for(std::chrono::milliseconds(20)) !=
+           std::future_status::ready)
+    {
+        QApplication::processEvents();
+        if (progress.wasCanceled())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Wait until all tasks not yet finished have been executed. Their results
+// are ignored.
+template <typename T>
+static void WaitForAll(std::vector<std::future<T> > &futures)
+{
+    for (auto &future : futures)
+    {
+        if (future.valid())
+        {
+            future.wait();
+        }
+    }
+}
 
 const QString &FlexplorerMdiChild::GetMimeTypeFlexDiskImageFile()
 {
@@ -145,6 +194,7 @@ unsigned FlexplorerMdiChild::GetSelectedFilesByteSize() const
 
 void FlexplorerMdiChild::SelectAll()
 {
+    model->FetchAll();
     selectAll();
 }
 
@@ -215,22 +265,49 @@ QVector<int>::size_type FlexplorerMdiChild::InjectFiles(
     QProgressDialog progress(tr("Inject files ..."), tr("&Cancel"), 0,
                              cast_from_qsizetype(filePaths.size() - 1), this);
     QVector<int> rowIndices;
+    std::vector<FlexFileBuffer> buffers;
+    std::vector<std::future<FlexFileBuffer> > futures;
+    auto isCanceled = std::make_shared<std::atomic<bool> >(false);
+    const auto ft_access = options.ft_access;
     auto index = 0;
 
-    progress.show();
+    // All files are read in parallel in the background.
+    futures.reserve(static_cast<size_t>(filePaths.size()));
     for (const auto &path : filePaths)
+    {
+        const auto filePath = QDir::toNativeSeparators(path).toStdString();
+
+        futures.push_back(GetWorkerPool().PostWithResult<FlexFileBuffer>(
+                "", [filePath, ft_access, isCanceled](){
+            FlexFileBuffer buffer;
+
+            if (!*isCanceled && !buffer.ReadFromFile(filePath, ft_access))
+            {
+                throw FlexException(FERR_UNABLE_TO_OPEN, filePath);
+            }
+
+            return buffer;
+        }));
+    }
+
+    progress.setWindowModality(Qt::WindowModal);
+    progress.show();
+    for (auto &future : futures)
     {
         FlexFileBuffer buffer;
+        const auto filePath = QDir::toNativeSeparators(filePaths[index]);
 
-        QApplication::processEvents();
         progress.setValue(index++);
-        if (progress.wasCanceled())
+        if (!WaitFor(future, progress))
         {
             break;
         }
 
-        const auto filePath = QDir::toNativeSeparators(path);
-        if (!buffer.ReadFromFile(filePath.toStdString(), options.ft_access))
+        try
+        {
+            buffer = future.get();
+        }
+        catch (FlexException &)
         {
             auto msg = tr("Error reading from\n%1\nInjection aborted.");
             msg = msg.arg(filePath);
@@ -273,9 +350,14 @@ QVector<int>::size_type FlexplorerMdiChild::InjectFiles(
 
         try
         {
+            const auto filename = flx::tolower(buffer.GetFilename());
+            const auto iter = std::find_if(buffers.cbegin(), buffers.cend(),
+                    [&](const FlexFileBuffer &injectBuffer){
+                return flx::tolower(injectBuffer.GetFilename()) == filename;
+            });
             auto rowIndicesFound =
                 model->FindFiles(buffer.GetFilename().c_str());
-            if (!rowIndicesFound.isEmpty())
+            if (iter != buffers.cend() || !rowIndicesFound.isEmpty())
             {
                 auto msg = tr("%1\nalready exists. Overwrite?");
 
@@ -284,18 +366,23 @@ QVector<int>::size_type FlexplorerMdiChild::InjectFiles(
                               QMessageBox::Yes | QMessageBox::No,
                               QMessageBox::Yes);
 
-                if (answer == QMessageBox::Yes)
+                if (answer != QMessageBox::Yes)
                 {
-                    auto modelIndex = model->index(rowIndicesFound[0], 0);
-                    model->DeleteFile(modelIndex);
+                    continue;
+                }
+
+                if (iter != buffers.cend())
+                {
+                    buffers.erase(iter);
                 }
                 else
                 {
-                    continue;
+                    auto modelIndex = model->index(rowIndicesFound[0], 0);
+                    model->DeleteFile(modelIndex);
                 }
             }
 
-            rowIndices.append(model->AddFile(buffer).row());
+            buffers.push_back(std::move(buffer));
         }
         catch (FlexException &ex)
         {
@@ -314,6 +401,22 @@ QVector<int>::size_type FlexplorerMdiChild::InjectFiles(
         }
     }
 
+    *isCanceled = true;
+    WaitForAll(futures);
+
+    // All files are injected within one transaction.
+    try
+    {
+        rowIndices = model->AddFiles(buffers);
+    }
+    catch (FlexException &ex)
+    {
+        auto msg = tr("%1\nInjection aborted.");
+
+        msg = msg.arg(ex.what());
+        QMessageBox::critical(this, tr("FLEXPlorer Error"), msg);
+    }
+
     MultiSelect(rowIndices);
 
     return rowIndices.count();
@@ -325,22 +428,45 @@ QVector<int>::size_type FlexplorerMdiChild::ExtractSelected(
     auto selectedRows = selectionModel()->selectedRows();
     QProgressDialog progress(tr("Extract files ..."), tr("&Cancel"), 0,
                              cast_from_qsizetype(selectedRows.size() - 1), this);
+    std::vector<std::future<FlexFileBuffer> > readFutures;
+    std::vector<std::future<bool> > writeFutures;
+    // Target file name and FLEX file name if it is a random file.
+    std::vector<std::pair<QString, std::string> > writtenFiles;
+    auto isCanceled = std::make_shared<std::atomic<bool> >(false);
+    const auto key = GetPath().toStdString();
+    const auto ft_access = options.ft_access;
+    const auto *pModel = model.get();
     QVector<int>::size_type count = 0;
+    auto index = 0;
 
+    // The files are read from the disk one after the other in the
+    // background. The host files are written in parallel.
+    readFutures.reserve(static_cast<size_t>(selectedRows.size()));
+    for (const auto &rowIndex : selectedRows)
+    {
+        const auto filename = model->GetFilename(rowIndex).toStdString();
+
+        readFutures.push_back(GetWorkerPool().PostWithResult<FlexFileBuffer>(
+                key, [pModel, filename, isCanceled](){
+            return *isCanceled ? FlexFileBuffer() : pModel->CopyFile(filename);
+        }));
+    }
+
+    progress.setWindowModality(Qt::WindowModal);
     progress.show();
-    for (auto &index : selectedRows)
+    for (auto &future : readFutures)
     {
-        QApplication::processEvents();
-        progress.setValue(cast_from_qsizetype(count));
-        if (progress.wasCanceled())
+        const auto filename = model->GetFilename(selectedRows[index]);
+
+        progress.setValue(index++);
+        if (!WaitFor(future, progress))
         {
             break;
         }
 
         try
         {
-            QString filename = model->GetFilename(index);
-            auto buffer = model->CopyFile(index);
+            auto buffer = future.get();
 
             if (buffer.IsFlexTextFile())
             {
@@ -400,14 +526,15 @@ QVector<int>::size_type FlexplorerMdiChild::ExtractSelected(
                 }
             }
 
-            if (!buffer.WriteToFile(targetPath.toStdString(),
-                        options.ft_access, true))
-            {
-                throw FlexException(FERR_UNABLE_TO_CREATE,
-                                    targetFilename.toStdString());
-            }
-
-            ++count;
+            // The random file check updates one file per directory,
+            // so it is done once after all files have been written.
+            const auto path = targetPath.toStdString();
+            writeFutures.push_back(GetWorkerPool().PostWithResult<bool>(
+                    "", [buffer, path, ft_access](){
+                return buffer.WriteToFile(path, ft_access, false);
+            }));
+            writtenFiles.emplace_back(targetFilename,
+                    buffer.IsRandom() ? buffer.GetFilename() : std::string());
         }
         catch (FlexException &ex)
         {
@@ -426,6 +553,40 @@ QVector<int>::size_type FlexplorerMdiChild::ExtractSelected(
         }
     }
 
+    *isCanceled = true;
+    WaitForAll(readFutures);
+
+    std::vector<std::string> randomFilenames;
+    for (size_t i = 0U; i < writeFutures.size(); ++i)
+    {
+        const auto &writtenFile = writtenFiles[i];
+
+        if (!writeFutures[i].get())
+        {
+            FlexException ex(FERR_UNABLE_TO_CREATE,
+                             writtenFile.first.toStdString());
+            QMessageBox::critical(this, tr("FLEXPlorer Error"), ex.what());
+            continue;
+        }
+
+        if (!writtenFile.second.empty())
+        {
+            randomFilenames.push_back(writtenFile.second);
+        }
+        ++count;
+    }
+
+    if (count > 0)
+    {
+        RandomFileCheck randomFileCheck(targetDirectory.toStdString());
+
+        randomFileCheck.CheckAllFilesAttributeAndUpdate();
+        for (const auto &randomFilename : randomFilenames)
+        {
+            randomFileCheck.AddToRandomList(randomFilename);
+        }
+    }
+
     return count;
 }
 
@@ -686,6 +847,13 @@ void FlexplorerMdiChild::SetupView()
             this, &FlexplorerMdiChild::SelectionChanged);
     connect(this, &FlexplorerMdiChild::activated,
             this, &FlexplorerMdiChild::IsActivated);
+    // A model reset, e.g. when sorting a partially visible table,
+    // clears the selection without emitting selectionChanged.
+    connect(model.get(), &QAbstractItemModel::modelReset, this, [&](){
+        selectedFilesCount = 0;
+        selectedFilesByteSize = 0;
+        emit SelectionHasChanged();
+    });
     setSelectionMode(QAbstractItemView::ExtendedSelection);
 
     // QHeaderView::ResizeToContents would always optimize the column size
@@ -910,7 +1078,7 @@ int FlexplorerMdiChild::CopySelectedToClipboard()
 int FlexplorerMdiChild::PasteFrom(const QMimeData &mimeData)
 {
     int count = 0;
-    FlexDnDFiles files;
+    auto files = std::make_shared<FlexDnDFiles>();
 
     if (!mimeData.hasFormat(GetMimeTypeFlexDiskImageFile()))
     {
@@ -919,23 +1087,56 @@ int FlexplorerMdiChild::PasteFrom(const QMimeData &mimeData)
 
     QByteArray itemData = mimeData.data(GetMimeTypeFlexDiskImageFile());
 
-    files.ReadDataFrom(reinterpret_cast<Byte *>(itemData.data()));
+    files->ReadDataFrom(reinterpret_cast<Byte *>(itemData.data()));
 
-    if (flx::getHostName() == files.GetDnsHostName() &&
-            flx::isPathsEqual(GetPath().toStdString(), files.GetPath()))
+    if (flx::getHostName() == files->GetDnsHostName() &&
+            flx::isPathsEqual(GetPath().toStdString(), files->GetPath()))
     {
         return count;
     }
 
+    const auto fileCount = files->GetFileCount();
+    QProgressDialog progress(tr("Paste files ..."), tr("&Cancel"), 0,
+                             static_cast<int>(fileCount) - 1, this);
+    std::vector<std::future<bool> > futures;
+    auto isCanceled = std::make_shared<std::atomic<bool> >(false);
+    auto *pModel = model.get();
+    auto fileIndex = 0U;
+
+    // The files are written to the disk one after the other in the
+    // background. The rows are added as soon as a file has been written.
+    futures.reserve(fileCount);
+    for (auto i = 0U; i < fileCount; ++i)
+    {
+        futures.push_back(GetWorkerPool().PostWithResult<bool>(
+                GetPath().toStdString(), [pModel, files, i, isCanceled](){
+            if (*isCanceled)
+            {
+                return false;
+            }
+
+            pModel->WriteFile(files->GetBufferAt(i));
+
+            return true;
+        }));
+    }
+
     setSortingEnabled(false);
-    for (auto fileIndex = 0U; fileIndex < files.GetFileCount(); ++fileIndex)
+    progress.setWindowModality(Qt::WindowModal);
+    progress.show();
+    for (; fileIndex < fileCount; ++fileIndex)
     {
+        progress.setValue(static_cast<int>(fileIndex));
+        if (!WaitFor(futures[fileIndex], progress))
+        {
+            break;
+        }
+
         try
         {
-            const auto &buffer = files.GetBufferAt(fileIndex);
-            auto index = model->AddFile(buffer);
-            if (index.isValid())
+            if (futures[fileIndex].get())
             {
+                model->AddRow(files->GetBufferAt(fileIndex));
                 ++count;
             }
         }
@@ -946,15 +1147,31 @@ int FlexplorerMdiChild::PasteFrom(const QMimeData &mimeData)
             {
                 QMessageBox::critical(this, tr("FLEXPlorer Error"),
                                       ex.what(), QMessageBox::Ok);
-                setSortingEnabled(true);
-
-                return count;
+                ++fileIndex;
+                break;
             }
 
             QMessageBox::warning(this, tr("FLEXPlorer Error"),
                                  ex.what(), QMessageBox::Ok);
         }
     }
+
+    // Files already written when canceling are kept.
+    *isCanceled = true;
+    for (; fileIndex < fileCount; ++fileIndex)
+    {
+        try
+        {
+            if (futures[fileIndex].get())
+            {
+                model->AddRow(files->GetBufferAt(fileIndex));
+                ++count;
+            }
+        }
+        catch (FlexException &)
+        {
+        }
+    }
     setSortingEnabled(true);
 
     return count;
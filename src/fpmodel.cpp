@@ -40,6 +40,8 @@
 #include <QLocale>
 #include <QString>
 #include <QDate>
+#include <QDateTime>
+#include <QTime>
 #include <QVector>
 #include <QSet>
 #include <QModelIndex>
@@ -53,11 +55,36 @@
 #endif
 #include "warnon.h"
 #include "fpmodel.h"
-#include <unordered_map>
+#include <algorithm>
+#include <functional>
+#include <numeric>
 #include <utility>
 #include <memory>
 
 
+// Reorder values. order contains for each new position the old position.
+template <typename T>
+static void Reorder(std::vector<T> &values, const std::vector<size_t> &order)
+{
+    std::vector<T> result;
+
+    result.reserve(values.size());
+    for (auto oldIndex : order)
+    {
+        result.push_back(std::move(values[oldIndex]));
+    }
+    values = std::move(result);
+}
+
+template <typename T>
+static void Erase(std::vector<T> &values, int first, int count)
+{
+    const auto iter = values.begin() + first;
+
+    values.erase(iter, iter + count);
+}
+
+
 HeaderNames_t &FlexplorerTableModel::GetHeaderNames()
 {
     static HeaderNames_t headerNames =
@@ -139,53 +166,187 @@ void FlexplorerTableModel::CreateAttributesBitmasks(const QString &attributes,
     }
 }
 
-QModelIndex FlexplorerTableModel::SetRow(const FlexDirEntry &dirEntry, int row,
-                                         int role)
+void FlexplorerTableModel::AppendEntry(const FlexDirEntry &dirEntry)
 {
-    static const int ssm4 = SECTOR_SIZE - 4;
-    int column = 0;
-
-    setData(index(row, column++), row, role);
-    QString fileName(dirEntry.GetTotalFileName().c_str());
-    setData(index(row, column++), fileName, role);
-    auto fileType = GetFileType(dirEntry);
-    setData(index(row, column++), fileType, role);
-    QString random(dirEntry.IsRandom() ? "Yes" : "");
-    setData(index(row, column++), random, role);
-    auto filesize = dirEntry.GetFileSize();
-    if (options.fileSizeType == FileSizeType::DataSize)
-    {
-        filesize = filesize / SECTOR_SIZE * ssm4;
-    }
-    setData(index(row, column++), filesize, role);
     const auto &date = dirEntry.GetDate();
-    QDate qdate(date.GetYear(), date.GetMonth(), date.GetDay());
     const auto &time = dirEntry.GetTime();
+    QDate qdate(date.GetYear(), date.GetMonth(), date.GetDay());
     QTime qtime(time.GetHour(), time.GetMinute());
-    QDateTime qDateTime(qdate, qtime);
-    setData(index(row, column++), qDateTime, role);
-    QString attributes(dirEntry.GetAttributesString().c_str());
-    setData(index(row, column), attributes, role);
 
-    return index(row, 0);
+    entries.ids.push_back(nextId++);
+    entries.filenames.emplace_back(dirEntry.GetTotalFileName().c_str());
+    entries.fileTypes.push_back(GetFileType(dirEntry));
+    entries.isRandom.push_back(dirEntry.IsRandom());
+    entries.fileSizes.push_back(dirEntry.GetFileSize());
+    entries.dateTimes.push_back(GetDateTimeKey(QDateTime(qdate, qtime)));
+    entries.attributes.emplace_back(dirEntry.GetAttributesString().c_str());
+}
+
+// Append a row for a new directory entry. All rows have to be visible,
+// otherwise the new row would be placed behind the not yet visible rows.
+void FlexplorerTableModel::AppendRow(const FlexDirEntry &dirEntry)
+{
+    FetchAll();
+    beginInsertRows(QModelIndex(), fetchedRows, fetchedRows);
+    AppendEntry(dirEntry);
+    ++fetchedRows;
+    endInsertRows();
+}
+
+int FlexplorerTableModel::GetEntryCount() const
+{
+    return static_cast<int>(entries.ids.size());
+}
+
+QWord FlexplorerTableModel::GetDateTimeKey(const QDateTime &dateTime)
+{
+    if (!dateTime.isValid())
+    {
+        return 0U;
+    }
+
+    const auto date = dateTime.date();
+    const auto time = dateTime.time();
+    QWord key = static_cast<QWord>(date.year());
+
+    key = key * 100U + static_cast<QWord>(date.month());
+    key = key * 100U + static_cast<QWord>(date.day());
+    key = key * 100U + static_cast<QWord>(time.hour());
+    key = key * 100U + static_cast<QWord>(time.minute());
+
+    return key;
+}
+
+QDateTime FlexplorerTableModel::GetDateTime(QWord dateTimeKey)
+{
+    if (dateTimeKey == 0U)
+    {
+        return {};
+    }
+
+    const auto minute = static_cast<int>(dateTimeKey % 100U);
+    const auto hour = static_cast<int>(dateTimeKey / 100U % 100U);
+    const auto day = static_cast<int>(dateTimeKey / 10000U % 100U);
+    const auto month = static_cast<int>(dateTimeKey / 1000000U % 100U);
+    const auto year = static_cast<int>(dateTimeKey / 100000000U);
+
+    return QDateTime(QDate(year, month, day), QTime(hour, minute));
+}
+
+QVariant FlexplorerTableModel::GetValue(int row, int column) const
+{
+    static const DWord ssm4 = SECTOR_SIZE - 4;
+    const auto index = static_cast<size_t>(row);
+
+    switch (column)
+    {
+        case COL_ID:
+            return entries.ids[index];
+
+        case COL_FILENAME:
+            return entries.filenames[index];
+
+        case COL_FILETYPE:
+            return entries.fileTypes[index];
+
+        case COL_RANDOM:
+            return QString(entries.isRandom[index] ? "Yes" : "");
+
+        case COL_SIZE:
+        {
+            auto fileSize = entries.fileSizes[index];
+
+            if (options.fileSizeType == FileSizeType::DataSize)
+            {
+                fileSize = fileSize / SECTOR_SIZE * ssm4;
+            }
+
+            return fileSize;
+        }
+
+        case COL_DATE:
+            return GetDateTime(entries.dateTimes[index]);
+
+        case COL_ATTRIBUTES:
+            return entries.attributes[index];
+
+        default:
+            return {};
+    }
+}
+
+bool FlexplorerTableModel::SetValue(int row, int column, const QVariant &value)
+{
+    static const DWord ssm4 = SECTOR_SIZE - 4;
+    const auto index = static_cast<size_t>(row);
+
+    switch (column)
+    {
+        case COL_ID:
+            entries.ids[index] = value.toInt();
+            break;
+
+        case COL_FILENAME:
+            entries.filenames[index] = value.toString();
+            break;
+
+        case COL_FILETYPE:
+            entries.fileTypes[index] = value.toString();
+            break;
+
+        case COL_RANDOM:
+            entries.isRandom[index] = !value.toString().isEmpty();
+            break;
+
+        case COL_SIZE:
+        {
+            auto fileSize = value.toUInt();
+
+            if (options.fileSizeType == FileSizeType::DataSize)
+            {
+                fileSize = fileSize / ssm4 * SECTOR_SIZE;
+            }
+            entries.fileSizes[index] = fileSize;
+            break;
+        }
+
+        case COL_DATE:
+            entries.dateTimes[index] = GetDateTimeKey(value.toDateTime());
+            break;
+
+        case COL_ATTRIBUTES:
+            entries.attributes[index] = value.toString();
+            break;
+
+        default:
+            return false;
+    }
+
+    return true;
 }
 
 void FlexplorerTableModel::Initialize()
 {
     FlexDiskIterator iter;
-    int columnIndex = 0;
 
     for (iter = container->begin(); iter != container->end(); ++iter)
     {
-        ++columnIndex;
+        AppendEntry(*iter);
     }
 
-    insertRows(0, columnIndex);
-    columnIndex = 0;
-    for (iter = container->begin(); iter != container->end(); ++iter)
+    // Not yet connected to a view, rows can be made visible silently.
+    fetchedRows = std::min(GetEntryCount(), ROWS_PER_FETCH);
+}
+
+void FlexplorerTableModel::FetchAll()
+{
+    const auto count = GetEntryCount();
+
+    if (fetchedRows < count)
     {
-        SetRow(*iter, columnIndex, Qt::DisplayRole);
-        ++columnIndex;
+        beginInsertRows(QModelIndex(), fetchedRows, count - 1);
+        fetchedRows = count;
+        endInsertRows();
     }
 }
 
@@ -220,26 +381,14 @@ void FlexplorerTableModel::UpdateFileSizeHeaderName()
 
 void FlexplorerTableModel::UpdateFileSizeColumn()
 {
-    static const int column = COL_SIZE;
-    static const int ssm4 = SECTOR_SIZE - 4;
-
-    for (auto &row : rows)
+    // The file size is converted in data() depending on the file size type.
+    if (rowCount() > 0)
     {
-        auto value = row.at(column).toUInt();
-        if (options.fileSizeType == FileSizeType::FileSize)
-        {
-            value = value / ssm4 * SECTOR_SIZE;
-        }
-        else if (options.fileSizeType == FileSizeType::DataSize)
-        {
-            value = value / SECTOR_SIZE * ssm4;
-        }
-        QVariant variant(value);
-        row.at(column) = variant;
-    }
-    QVector<int> roles { Qt::DisplayRole };
+        QVector<int> roles { Qt::DisplayRole };
 
-    emit dataChanged(index(0, column), index(rowCount(), column), roles);
+        emit dataChanged(index(0, COL_SIZE), index(rowCount() - 1, COL_SIZE),
+                         roles);
+    }
 }
 
 unsigned FlexplorerTableModel::GetFlexDiskType() const
@@ -266,7 +415,8 @@ QStringList FlexplorerTableModel::GetFilenames(
     {
         if (index.isValid())
         {
-            filenames.append(rows[index.row()][COL_FILENAME].toString());
+            filenames.append(
+                entries.filenames[static_cast<size_t>(index.row())]);
         }
     }
 
@@ -277,9 +427,11 @@ QStringList FlexplorerTableModel::GetFilenames() const
 {
     QStringList filenames;
 
-    for (int row = 0; row < rowCount(); ++row)
+    // Also contains the file names of rows not yet visible.
+    filenames.reserve(GetEntryCount());
+    for (const auto &filename : entries.filenames)
     {
-        filenames.append(rows[row][COL_FILENAME].toString());
+        filenames.append(filename);
     }
 
     return filenames;
@@ -289,7 +441,7 @@ QString FlexplorerTableModel::GetFilename(const QModelIndex &index) const
 {
     if (index.row() >= 0 && index.row() < rowCount())
     {
-        return rows[index.row()][COL_FILENAME].toString();
+        return entries.filenames[static_cast<size_t>(index.row())];
     }
 
     return "";
@@ -363,7 +515,7 @@ bool FlexplorerTableModel::GetAttributes(const QModelIndex &index,
     return false;
 }
 
-QVector<int> FlexplorerTableModel::FindFiles(const QString &pattern) const
+QVector<int> FlexplorerTableModel::FindFiles(const QString &pattern)
 {
     QVector<int> rowIndices;
     int rowIndex = 0;
@@ -386,33 +538,84 @@ QVector<int> FlexplorerTableModel::FindFiles(const QString &pattern) const
     };
 #endif
 
-    rowIndices.reserve(rows.size() / 2);
-    for (const auto &row : rows)
+    rowIndices.reserve(GetEntryCount() / 2);
+    for (const auto &filename : entries.filenames)
     {
-        if (doesMatch(row[COL_FILENAME].toString()))
+        if (doesMatch(filename))
         {
             rowIndices.push_back(rowIndex);
         }
         ++rowIndex;
     }
 
+    // Make found rows visible.
+    if (!rowIndices.isEmpty() && rowIndices.back() >= fetchedRows)
+    {
+        FetchAll();
+    }
+
     return rowIndices;
 }
 
 QModelIndex FlexplorerTableModel::AddFile(const FlexFileBuffer &buffer)
+{
+    WriteFile(buffer);
+
+    return AddRow(buffer);
+}
+
+// Only write the file to the container. Can be called from a worker
+// thread if no other thread accesses the container at the same time.
+void FlexplorerTableModel::WriteFile(const FlexFileBuffer &buffer)
 {
     container->WriteFromBuffer(buffer);
+}
 
+// Only add a row for a file already written to the container.
+QModelIndex FlexplorerTableModel::AddRow(const FlexFileBuffer &buffer)
+{
     auto dirEntry = buffer.GetDirEntry();
     if (!dirEntry.IsEmpty())
     {
-        insertRows(rowCount(), 1);
-        return SetRow(dirEntry, rowCount() - 1, Qt::DisplayRole);
+        AppendRow(dirEntry);
+        return index(rowCount() - 1, 0);
     }
 
     return {};
 }
 
+// If supported by the container all files are written within one
+// transaction.
+QVector<int> FlexplorerTableModel::AddFiles(
+        const std::vector<FlexFileBuffer> &buffers)
+{
+    QVector<int> rowIndices;
+    auto *disk = dynamic_cast<FlexDisk *>(container.get());
+
+    if (disk == nullptr)
+    {
+        for (const auto &buffer : buffers)
+        {
+            rowIndices.append(AddFile(buffer).row());
+        }
+
+        return rowIndices;
+    }
+
+    disk->WriteFromBuffers(buffers);
+    for (const auto &buffer : buffers)
+    {
+        auto dirEntry = buffer.GetDirEntry();
+        if (!dirEntry.IsEmpty())
+        {
+            AppendRow(dirEntry);
+            rowIndices.append(rowCount() - 1);
+        }
+    }
+
+    return rowIndices;
+}
+
 void FlexplorerTableModel::DeleteFile(const QModelIndex &index)
 {
     if (index.isValid())
@@ -464,19 +667,27 @@ FlexFileBuffer FlexplorerTableModel::CopyFile(const QModelIndex &index) const
 {
     if (index.isValid())
     {
-        auto filename = GetFilename(index);
-        return container->ReadToBuffer(filename.toStdString());
+        return CopyFile(GetFilename(index).toStdString());
     }
 
     return {};
 }
 
+// Can be called from a worker thread if no other thread accesses the
+// container at the same time.
+FlexFileBuffer FlexplorerTableModel::CopyFile(
+        const std::string &filename) const
+{
+    return container->ReadToBuffer(filename);
+}
+
 void FlexplorerTableModel::SetAttributesString(const QModelIndex &index,
                                                const QString &attributes)
 {
     if (index.isValid())
     {
-        auto oldAttributes = rows[index.row()][COL_ATTRIBUTES].toString();
+        auto oldAttributes =
+            entries.attributes[static_cast<size_t>(index.row())];
         auto filename = GetFilename(index);
 
         if (oldAttributes != attributes)
@@ -507,8 +718,7 @@ void FlexplorerTableModel::SetAttributesString(const QModelIndex &index,
 
 int FlexplorerTableModel::rowCount(const QModelIndex & /*parent*/) const
 {
-    // This is an override method with a defined return type.
-    return cast_from_qsizetype(rows.size());
+    return fetchedRows;
 }
 
 int FlexplorerTableModel::columnCount(const QModelIndex & /*parent*/) const
@@ -521,9 +731,9 @@ QVariant FlexplorerTableModel::data(const QModelIndex &index, int role) const
     if (index.isValid() &&
         (role == Qt::DisplayRole || role == Qt::EditRole))
     {
-        if (index.row() < rows.size() && index.column() < COLUMNS)
+        if (index.row() < rowCount() && index.column() < COLUMNS)
         {
-            return rows.at(index.row()).at(index.column());
+            return GetValue(index.row(), index.column());
         }
     }
 
@@ -538,12 +748,12 @@ bool FlexplorerTableModel::setData(
     if (index.isValid() &&
         (role == Qt::DisplayRole || role == Qt::EditRole))
     {
-        if (index.row() < rows.size() && index.column() < COLUMNS)
+        if (index.row() < rowCount() && index.column() < COLUMNS)
         {
             QVector<int> roles { role };
-            if (rows.at(index.row()).at(index.column()) != value)
+            if (GetValue(index.row(), index.column()) != value &&
+                SetValue(index.row(), index.column(), value))
             {
-                rows[index.row()].at(index.column()) = value;
                 emit dataChanged(index, index, roles);
                 return true;
             }
@@ -626,17 +836,16 @@ bool FlexplorerTableModel::insertRows(
         int count,
         const QModelIndex & /*parent*/)
 {
-    if (count >= 0 && row == rows.size())
+    if (count >= 0 && row == rowCount() && fetchedRows == GetEntryCount())
     {
         if (count > 0)
         {
-            RowType newRow;
-            auto max = row + count;
-            beginInsertRows(QModelIndex(), row, max - 1);
-            for (auto i = row; i < max; ++i)
+            beginInsertRows(QModelIndex(), row, row + count - 1);
+            for (auto i = 0; i < count; ++i)
             {
-                rows.append(newRow);
+                AppendEntry(FlexDirEntry());
             }
+            fetchedRows += count;
             endInsertRows();
         }
 
@@ -651,15 +860,19 @@ bool FlexplorerTableModel::removeRows(
         int count,
         const QModelIndex & /*parent*/)
 {
-    if (count >= 0 && row + count <= rows.size())
+    if (count >= 0 && row >= 0 && row + count <= rowCount())
     {
         if (count > 0)
         {
             beginRemoveRows(QModelIndex(), row, row + count - 1);
-            // clang-tidy: auto *const iter is not compatible with Qt6.
-            // NOLINTNEXTLINE(readability-qualified-auto)
-            const auto iter = rows.begin() + row;
-            rows.erase(iter, iter + count);
+            Erase(entries.ids, row, count);
+            Erase(entries.filenames, row, count);
+            Erase(entries.fileTypes, row, count);
+            Erase(entries.isRandom, row, count);
+            Erase(entries.fileSizes, row, count);
+            Erase(entries.dateTimes, row, count);
+            Erase(entries.attributes, row, count);
+            fetchedRows -= count;
             endRemoveRows();
         }
 
@@ -669,193 +882,133 @@ bool FlexplorerTableModel::removeRows(
     return false;
 }
 
-FlexplorerTableModel::IdsType FlexplorerTableModel::GetIds() const
+// Sorting is done on the cached entries of all rows, visible or not.
+// If not all rows are visible the model is reset and only a first batch
+// of sorted rows is visible.
+void FlexplorerTableModel::sort(int column, Qt::SortOrder order)
 {
-    IdsType ids;
-
-    ids.reserve(rowCount());
-    for (const auto &row : rows)
+    if (column < 0 || column >= COLUMNS)
     {
-        ids.push_back(row[COL_ID].toInt());
+        return;
     }
 
-    return ids;
-}
+    std::function<bool(size_t lhs, size_t rhs)> isLess;
+    const auto byValues = [](const auto &values){
+        return [&values](size_t lhs, size_t rhs){
+            return values[lhs] < values[rhs];
+        };
+    };
 
-void FlexplorerTableModel::CalculateAndChangePersistentIndexList(
-        const IdsType &oldIds)
-{
-    auto newIds = GetIds();
-    QModelIndexList fromList;
-    QModelIndexList toList;
-    std::unordered_map<int, int> idToNewRow;
-    int newRow = 0;
+    switch (column)
+    {
+        case COL_ID:
+            isLess = byValues(entries.ids);
+            break;
+
+        case COL_FILENAME:
+            isLess = byValues(entries.filenames);
+            break;
+
+        case COL_FILETYPE:
+            isLess = byValues(entries.fileTypes);
+            break;
+
+        case COL_RANDOM:
+            isLess = byValues(entries.isRandom);
+            break;
+
+        case COL_SIZE:
+            isLess = byValues(entries.fileSizes);
+            break;
 
-    idToNewRow.reserve(oldIds.size());
-    for (int newId : newIds)
+        case COL_DATE:
+            isLess = byValues(entries.dateTimes);
+            break;
+
+        default:
+            isLess = byValues(entries.attributes);
+            break;
+    }
+
+    // For each new position the old position.
+    std::vector<size_t> newOrder(entries.ids.size());
+    std::iota(newOrder.begin(), newOrder.end(), 0U);
+    if (order == Qt::AscendingOrder)
+    {
+        std::stable_sort(newOrder.begin(), newOrder.end(), isLess);
+    }
+    else
     {
-        idToNewRow.emplace(std::pair<int, int>(newId, newRow));
-        ++newRow;
+        std::stable_sort(newOrder.begin(), newOrder.end(),
+                [&isLess](size_t lhs, size_t rhs){ return isLess(rhs, lhs); });
     }
 
-    fromList.reserve(oldIds.size() * COLUMNS);
-    toList.reserve(oldIds.size() * COLUMNS);
-    for (int oldRow = 0; oldRow < oldIds.size(); ++oldRow)
+    const auto reorderFct = [&](){
+        Reorder(entries.ids, newOrder);
+        Reorder(entries.filenames, newOrder);
+        Reorder(entries.fileTypes, newOrder);
+        Reorder(entries.isRandom, newOrder);
+        Reorder(entries.fileSizes, newOrder);
+        Reorder(entries.dateTimes, newOrder);
+        Reorder(entries.attributes, newOrder);
+    };
+
+    if (fetchedRows < GetEntryCount())
     {
-        if (oldIds[oldRow] != newIds[oldRow])
-        {
-            newRow = idToNewRow[oldIds[oldRow]];
+        beginResetModel();
+        reorderFct();
+        fetchedRows = std::min(GetEntryCount(), ROWS_PER_FETCH);
+        endResetModel();
 
-            for (int col = 0; col < COLUMNS; ++col)
-            {
-                fromList.push_back(index(oldRow, col));
-                toList.push_back(index(newRow, col));
-            }
-        }
+        return;
     }
 
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(),
+                                QAbstractItemModel::VerticalSortHint);
+
+    // For each old row the new row.
+    std::vector<int> newRows(newOrder.size());
+    for (size_t newRow = 0U; newRow < newOrder.size(); ++newRow)
+    {
+        newRows[newOrder[newRow]] = static_cast<int>(newRow);
+    }
+    reorderFct();
+
+    const auto fromList = persistentIndexList();
+    QModelIndexList toList;
+    toList.reserve(fromList.size());
+    for (const auto &fromIndex : fromList)
+    {
+        const auto newRow = newRows[static_cast<size_t>(fromIndex.row())];
+
+        toList.push_back(index(newRow, fromIndex.column()));
+    }
     changePersistentIndexList(fromList, toList);
+
+    emit layoutChanged(QList<QPersistentModelIndex>(),
+                       QAbstractItemModel::VerticalSortHint);
 }
 
-void FlexplorerTableModel::sort(int column, Qt::SortOrder order)
+bool FlexplorerTableModel::canFetchMore(const QModelIndex &parent) const
 {
-#if defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wswitch-enum"
-#endif
-    if (column < 0 || column >= rows.size())
+    return !parent.isValid() && fetchedRows < GetEntryCount();
+}
+
+void FlexplorerTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid())
     {
         return;
     }
 
-    auto oldIds = GetIds();
-    std::function<bool(const RowType &lhs, const RowType &rhs)> compare;
+    const auto count = std::min(GetEntryCount() - fetchedRows, ROWS_PER_FETCH);
 
-    switch (order)
+    if (count > 0)
     {
-        case Qt::AscendingOrder:
-            compare = [&column](const RowType &lhs, const RowType &rhs){
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-                switch (lhs[column].typeId())
-                {
-                    case QMetaType::QString:
-                        return lhs[column].toString() < rhs[column].toString();
-
-                    case QMetaType::QDateTime:
-                        return lhs[column].toDateTime() <
-                            rhs[column].toDateTime();
-
-                    case QMetaType::Int:
-                        return lhs[column].toInt() < rhs[column].toInt();
-
-                    case QMetaType::UInt:
-                        return lhs[column].toUInt() < rhs[column].toUInt();
-
-                    default:
-                    {
-                        auto msg = std::string(
-                            "FlexplorerTableModel::sort(): Unexpected type '");
-                        msg += std::string(lhs[column].typeName()) + "'";
-
-                        throw std::logic_error(msg);
-                    }
-                }
-#else
-                switch (lhs[column].type())
-                {
-                    case QVariant::String:
-                        return lhs[column].toString() < rhs[column].toString();
-
-                    case QVariant::DateTime:
-                        return lhs[column].toDateTime() <
-                            rhs[column].toDateTime();
-
-                    case QVariant::Int:
-                        return lhs[column].toInt() < rhs[column].toInt();
-
-                    case QVariant::UInt:
-                        return lhs[column].toUInt() < rhs[column].toUInt();
-
-                    default:
-                    {
-                        auto msg = std::string(
-                            "FlexplorerTableModel::sort(): Unexpected type '");
-                        msg += std::string(lhs[column].typeName()) + "'";
-
-                        throw std::logic_error(msg);
-                    }
-                }
-#endif
-            };
-            break;
-
-        case Qt::DescendingOrder:
-            compare = [&column](const RowType &lhs, const RowType &rhs){
-#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
-                switch (lhs[column].typeId())
-                {
-                    case QMetaType::QString:
-                        return lhs[column].toString() > rhs[column].toString();
-
-                    case QMetaType::QDateTime:
-                        return lhs[column].toDateTime() >
-                            rhs[column].toDateTime();
-
-                    case QMetaType::Int:
-                        return lhs[column].toInt() > rhs[column].toInt();
-
-                    case QMetaType::UInt:
-                        return lhs[column].toUInt() > rhs[column].toUInt();
-
-                    default:
-                    {
-                        auto msg = std::string(
-                            "FlexplorerTableModel::sort(): Unexpected type '");
-                        msg += std::string(lhs[column].typeName()) + "'";
-
-                        throw std::logic_error(msg);
-                    }
-                }
-#else
-                switch (lhs[column].type())
-                {
-                    case QVariant::String:
-                        return lhs[column].toString() > rhs[column].toString();
-
-                    case QVariant::DateTime:
-                        return lhs[column].toDateTime() >
-                            rhs[column].toDateTime();
-
-                    case QVariant::Int:
-                        return lhs[column].toInt() > rhs[column].toInt();
-
-                    case QVariant::UInt:
-                        return lhs[column].toUInt() > rhs[column].toUInt();
-
-                    default:
-                    {
-                        auto msg = std::string(
-                            "FlexplorerTableModel::sort(): Unexpected type '");
-                        msg += std::string(lhs[column].typeName()) + "'";
-
-                        throw std::logic_error(msg);
-                    }
-                }
-#endif
-            };
-            break;
+        beginInsertRows(QModelIndex(), fetchedRows, fetchedRows + count - 1);
+        fetchedRows += count;
+        endInsertRows();
     }
-
-    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(),
-                                QAbstractItemModel::VerticalSortHint);
-
-    std::stable_sort(rows.begin(), rows.end(), compare);
-    CalculateAndChangePersistentIndexList(oldIds);
-
-    emit layoutChanged();
-#if defined(__GNUC__) && !defined(__clang__)
-#pragma GCC diagnostic pop
-#endif
 }
 
 QString FlexplorerTableModel::VariantToString(const QVariant &variant) const
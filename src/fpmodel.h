@@ -37,10 +37,12 @@
 #include <QModelIndex>
 #include <QAbstractTableModel>
 #include <QStringList>
+#include <QDateTime>
 #include "warnon.h"
 #include <memory>
 #include <array>
 #include <string>
+#include <vector>
 
 
 class FlexDirEntry;
@@ -71,7 +73,11 @@ public:
     // right after object construction.
     // It has been separated to avoid virtual member function calls
     // in the object constructor.
+    // All directory entries are read at once but only a first batch of
+    // rows is visible. More rows are added on request of the view
+    // (see fetchMore()) or by FetchAll().
     void Initialize();
+    void FetchAll();
     QString GetPath() const;
     QString GetUserFriendlyPath() const;
     bool IsWriteProtected() const;
@@ -88,14 +94,18 @@ public:
                              const QString &attributes);
     static void CreateAttributesBitmasks(const QString &attributes,
                                          Byte &setMask, Byte &clearMask);
-    QVector<int> FindFiles(const QString &pattern) const;
+    QVector<int> FindFiles(const QString &pattern);
     QString AsText(const QModelIndexList &indexList,
                    const QString &mimeType) const;
     QString GetFilename(const QModelIndex &index) const;
     QModelIndex AddFile(const FlexFileBuffer &buffer);
+    void WriteFile(const FlexFileBuffer &buffer);
+    QModelIndex AddRow(const FlexFileBuffer &buffer);
+    QVector<int> AddFiles(const std::vector<FlexFileBuffer> &buffers);
     void DeleteFile(const QModelIndex &index);
     void RenameFile(const QModelIndex &index, const QString &newFilename);
     FlexFileBuffer CopyFile(const QModelIndex &index) const;
+    FlexFileBuffer CopyFile(const std::string &filename) const;
     std::string GetSupportedAttributes() const;
     QStringList GetColumnMaxStrings();
 
@@ -116,6 +126,8 @@ public:
     bool removeRows(int row, int count,
                     const QModelIndex &parent = QModelIndex()) override;
     void sort(int column, Qt::SortOrder order) override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
     static const QString &GetHeaderNameForFileSize(FileSizeType type);
 
     static const int COL_ID{0};
@@ -131,22 +143,42 @@ public slots:
     void UpdateFileSizeColumn();
 
 private:
-    using RowType = std::array<QVariant, COLUMNS>;
-    using IdsType = QVector<int>;
+    // Cache of all directory entries as a struct of arrays, one array
+    // per column. The date and time is stored as sort key YYYYMMDDhhmm,
+    // the file size is stored in bytes including the sector link.
+    struct sEntries
+    {
+        std::vector<int> ids;
+        std::vector<QString> filenames;
+        std::vector<QString> fileTypes;
+        std::vector<bool> isRandom;
+        std::vector<DWord> fileSizes;
+        std::vector<QWord> dateTimes;
+        std::vector<QString> attributes;
+    };
+
+    static constexpr int ROWS_PER_FETCH{256};
 
     void OpenFlexDisk(const char *path, const FileTimeAccess &fileTimeAccess);
-    QModelIndex SetRow(const FlexDirEntry &dirEntry, int row, int role);
-    IdsType GetIds() const;
-    void CalculateAndChangePersistentIndexList(const IdsType &oldIds);
+    void AppendEntry(const FlexDirEntry &dirEntry);
+    void AppendRow(const FlexDirEntry &dirEntry);
+    int GetEntryCount() const;
+    QVariant GetValue(int row, int column) const;
+    bool SetValue(int row, int column, const QVariant &value);
     QString AsHtml(const QModelIndexList &indexList) const;
     QString VariantToString(const QVariant &variant) const;
 
     static QString GetFileType(const FlexDirEntry &dirEntry);
+    static QWord GetDateTimeKey(const QDateTime &dateTime);
+    static QDateTime GetDateTime(QWord dateTimeKey);
     static const FileTypes_t &GetFileTypes();
     static HeaderNames_t &GetHeaderNames();
 
     std::unique_ptr<IFlexDiskByFile> container;
-    QVector<RowType> rows;
+    sEntries entries;
+    // Number of entries visible as rows.
+    int fetchedRows{};
+    int nextId{};
     QString path;
     struct sFPOptions &options;
     QStringList maxStrings;
@@ -0,0 +1,277 @@
+/*
+    ftxtconv.cpp
+
+
+    FLEXplorer, An explorer for FLEX disk image files and directory disks.
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "ftxtconv.h"
+#include <cstdint>
+#include <cstring>
+
+
+// Return the index of the first byte less than limit or size if there is
+// none. limit has to be <= 128.
+// Eight bytes are checked at once: A byte b < limit has the most
+// significant bit set in (b - limit) & ~b.
+static size_t FindFirstLess(const Byte *data, size_t size, Byte limit)
+{
+    static constexpr uint64_t ones{0x0101010101010101U};
+    static constexpr uint64_t highBits{0x8080808080808080U};
+    const uint64_t limits = ones * limit;
+    size_t index = 0U;
+
+    for (; index + sizeof(uint64_t) <= size; index += sizeof(uint64_t))
+    {
+        uint64_t word;
+
+        std::memcpy(&word, data + index, sizeof(word));
+        if (((word - limits) & ~word & highBits) != 0U)
+        {
+            break;
+        }
+    }
+
+    for (; index < size; ++index)
+    {
+        if (data[index] < limit)
+        {
+            return index;
+        }
+    }
+
+    return size;
+}
+
+void FlexTextToHostConverter::Convert(const Byte *data, size_t size,
+                                      std::vector<Byte> &out)
+{
+    size_t index = 0U;
+
+    if (isEndOfFile)
+    {
+        return;
+    }
+
+    if (isTabPending && size != 0U)
+    {
+        out.insert(out.end(), static_cast<size_t>(data[index++]),
+                   static_cast<Byte>(' '));
+        isTabPending = false;
+    }
+
+    while (index < size)
+    {
+        const auto pos =
+            index + FindFirstLess(data + index, size - index, ' ');
+
+        out.insert(out.end(), data + index, data + pos);
+        if (pos == size)
+        {
+            break;
+        }
+
+        index = pos + 1U;
+        switch (data[pos])
+        {
+            case 0x0d:
+                // Convert ASCII CR, the FLEX text file end of line character
+                // into a new line (depending on the operating system).
+#ifdef _WIN32
+                out.push_back(0x0d);
+#endif
+                out.push_back(0x0a);
+                break;
+
+            case 0x09:
+                // Expand space compression.
+                if (index < size)
+                {
+                    out.insert(out.end(), static_cast<size_t>(data[index++]),
+                               static_cast<Byte>(' '));
+                }
+                else
+                {
+                    isTabPending = true;
+                }
+                break;
+
+            case 0x1a:
+                // ASCII SUB is end of file marker
+                isEndOfFile = true;
+                return;
+
+            default:
+                // Other control characters than ASCII TAB, ASCII CR,
+                // ASCII SUB are ignored.
+                break;
+        }
+    }
+}
+
+void FlexTextToHostConverter::Finish(std::vector<Byte> &out)
+{
+    // ASCII TAB without count byte at end of file.
+    if (isTabPending)
+    {
+        out.push_back(' ');
+        isTabPending = false;
+    }
+}
+
+// Evaluate if the given data is a FLEX text file.
+bool FlexTextToHostConverter::IsFlexText(const Byte *data, size_t size)
+{
+    size_t index = 0U;
+
+    while (index < size)
+    {
+        index += FindFirstLess(data + index, size - index, ' ');
+        if (index == size)
+        {
+            break;
+        }
+
+        // Allowed characters of a FLEX text file are:
+        // ASCII LF, ASCII CR, ASCII NUL, ASCII CANCEL, ASCII FF, ASCII SUB and
+        // any character >= ASCII Space.
+        // ASCII TAB is followed by one space count byte.
+        switch (data[index])
+        {
+            case 0x0a:
+            case 0x0d:
+            case 0x00:
+            case 0x18:
+            case 0x0c:
+            case 0x1a:
+                ++index;
+                break;
+
+            case 0x09:
+                index += 2U;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void HostTextToFlexConverter::Convert(const Byte *data, size_t size,
+                                      std::vector<Byte> &out)
+{
+    size_t index = 0U;
+
+    while (index < size)
+    {
+        // Search for the next ASCII space or control character.
+        const auto pos = index + FindFirstLess(data + index, size - index,
+                                               ' ' + 1);
+
+        if (pos != index)
+        {
+            FlushSpaces(out);
+            out.insert(out.end(), data + index, data + pos);
+        }
+        if (pos == size)
+        {
+            break;
+        }
+
+        index = pos + 1U;
+        const auto ch = data[pos];
+        if (ch == ' ')
+        {
+            if (++spaces == 127U)
+            {
+                // Do space compression for a maximum of 127 characters.
+                FlushSpaces(out);
+            }
+            continue;
+        }
+
+        FlushSpaces(out);
+        if (ch == 0x0a)
+        {
+            // For ASCII LF write ASCII CR indicating end of line
+            // in a FLEX text file.
+            // If ASCII CR is ignored this works for both Unix/Linux
+            // and DOS/Windows text files.
+            out.push_back(0x0d);
+        }
+        else if (ch == 0x09)
+        {
+            // ASCII TAB is converted to 8 spaces.
+            out.push_back(0x09);
+            out.push_back(8U);
+        }
+
+        // Other control characters than ASCII TAB or ASCII CR will be
+        // ignored.
+    }
+}
+
+void HostTextToFlexConverter::Finish(std::vector<Byte> &out)
+{
+    // Process remaining spaces if file does not end with new line.
+    FlushSpaces(out);
+}
+
+void HostTextToFlexConverter::FlushSpaces(std::vector<Byte> &out)
+{
+    if (spaces == 1U)
+    {
+        out.push_back(' ');
+    }
+    else if (spaces > 1U)
+    {
+        // Do space compression.
+        out.push_back(0x09);
+        out.push_back(spaces);
+    }
+    spaces = 0U;
+}
+
+// Evaluate if the given data is a text file on the host operating system.
+bool HostTextToFlexConverter::IsHostText(const Byte *data, size_t size)
+{
+    size_t index = 0U;
+
+    while (index < size)
+    {
+        index += FindFirstLess(data + index, size - index, ' ');
+        if (index == size)
+        {
+            break;
+        }
+
+        // Allowed characters of a host operating system text file are:
+        // ASCII LF, ASCII CR, ASCII TAB and any character >= ASCII Space
+        const auto ch = data[index];
+        if (ch != 0x0a && ch != 0x0d && ch != 0x09)
+        {
+            return false;
+        }
+        ++index;
+    }
+
+    return true;
+}
+
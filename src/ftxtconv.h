@@ -0,0 +1,71 @@
+/*
+    ftxtconv.h
+
+
+    FLEXplorer, An explorer for FLEX disk image files and directory disks.
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef FTXTCONV_INCLUDED
+#define FTXTCONV_INCLUDED
+
+#include "typedefs.h"
+#include <cstddef>
+#include <vector>
+
+
+// Text file converters between FLEX text files and text files of the
+// host operating system.
+// The input can be converted in chunks of any size. The converted
+// characters of each chunk are appended to the output. After the last
+// chunk Finish() has to be called.
+// Sequences of characters which need no conversion are searched
+// for eight bytes at a time and are copied as a block.
+
+// Convert a FLEX text file into a text file of the host operating system.
+// A FLEX text file uses ASCII CR as end of line, ASCII TAB followed by a
+// count byte as space compression and ASCII SUB as end of file marker.
+class FlexTextToHostConverter
+{
+public:
+    void Convert(const Byte *data, size_t size, std::vector<Byte> &out);
+    void Finish(std::vector<Byte> &out);
+
+    static bool IsFlexText(const Byte *data, size_t size);
+
+private:
+    bool isTabPending{false}; // ASCII TAB was last byte of previous chunk.
+    bool isEndOfFile{false};
+};
+
+// Convert a text file of the host operating system into a FLEX text file.
+class HostTextToFlexConverter
+{
+public:
+    void Convert(const Byte *data, size_t size, std::vector<Byte> &out);
+    void Finish(std::vector<Byte> &out);
+
+    static bool IsHostText(const Byte *data, size_t size);
+
+private:
+    void FlushSpaces(std::vector<Byte> &out);
+
+    Byte spaces{0U}; // Number of spaces not yet written.
+};
+
+#endif // FTXTCONV_INCLUDED
+
@@ -0,0 +1,269 @@
+/*
+    hotcnt.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "misc1.h"
+#include "hotcnt.h"
+#include <sstream>
+#include <cstring>
+#ifdef UNIX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef UNIX
+// Timeout in ms after which the server thread checks for a stop request.
+static constexpr int POLL_TIMEOUT{200};
+#ifdef MSG_NOSIGNAL
+// A client closing the connection early must not raise SIGPIPE.
+static constexpr int SEND_FLAGS{MSG_NOSIGNAL};
+#else
+static constexpr int SEND_FLAGS{0};
+#endif
+#endif
+
+thread_local HotCounterRegistry::Counters *HotCounterRegistry::threadCounters{};
+
+HotCounterRegistry &HotCounterRegistry::Instance()
+{
+    static HotCounterRegistry instance;
+
+    return instance;
+}
+
+bool HotCounterRegistry::IsCompiledIn()
+{
+#ifdef USE_HOTCOUNTERS
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char *HotCounterRegistry::GetName(HotCounterId id)
+{
+    static const std::array<const char *, COUNTER_COUNT> names{
+        "memory.read",
+        "memory.write",
+        "memory.video_write",
+        "io.read",
+        "io.write",
+        "floppy.sector_read",
+        "floppy.sector_write",
+        "cpu.irq",
+        "cpu.firq",
+        "cpu.nmi",
+        "scheduler.suspend",
+        "scheduler.frequency_miss",
+    };
+
+    return names[static_cast<size_t>(id)];
+}
+
+HotCounterRegistry::Counters &HotCounterRegistry::AddThreadCounters()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    allThreadCounters.emplace_back(std::make_unique<Counters>());
+    auto &counters = *allThreadCounters.back();
+    for (auto &counter : counters)
+    {
+        counter.store(0U, std::memory_order_relaxed);
+    }
+
+    return counters;
+}
+
+// Counters of an I/O device are identified by its name. If several
+// devices use the same name they share their counters.
+IoDeviceCounters &HotCounterRegistry::GetIoDeviceCounters(
+        const std::string &name)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    for (auto &counters : ioDeviceCounters)
+    {
+        if (counters.name == name)
+        {
+            return counters;
+        }
+    }
+
+    return ioDeviceCounters.emplace_back(name);
+}
+
+HotCounterRegistry::Values HotCounterRegistry::GetTotals() const
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    Values totals{};
+
+    for (const auto &counters : allThreadCounters)
+    {
+        for (size_t i = 0; i < COUNTER_COUNT; ++i)
+        {
+            totals[i] += (*counters)[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    return totals;
+}
+
+// Write all counters as text, one counter per line:
+// <name> <value>
+void HotCounterRegistry::Dump(std::ostream &os) const
+{
+    if (!IsCompiledIn())
+    {
+        os << "# hot path counters are not compiled in\n";
+    }
+
+    const auto totals = GetTotals();
+
+    for (size_t i = 0; i < COUNTER_COUNT; ++i)
+    {
+        os << GetName(static_cast<HotCounterId>(i)) << ' ' << totals[i] <<
+              '\n';
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+
+    for (const auto &counters : ioDeviceCounters)
+    {
+        os << "io." << counters.name << ".read " <<
+              counters.reads.load(std::memory_order_relaxed) << '\n';
+        os << "io." << counters.name << ".write " <<
+              counters.writes.load(std::memory_order_relaxed) << '\n';
+    }
+}
+
+HotCounterServer::HotCounterServer(std::string p_path)
+    : path(std::move(p_path))
+{
+}
+
+HotCounterServer::~HotCounterServer()
+{
+    Stop();
+}
+
+// Create the socket and start the server thread.
+// Return false if the socket could not be created.
+bool HotCounterServer::Start()
+{
+#ifdef UNIX
+    struct sockaddr_un address{};
+
+    // The path has to fit into sun_path including the terminating NUL.
+    // An existing file is only replaced if it is a socket.
+    if (thread || path.empty() || path.size() >= sizeof(address.sun_path) ||
+        !flx::removeSocketFile(path))
+    {
+        return false;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1U);
+    if (bind(fd, reinterpret_cast<struct sockaddr *>(&address),
+             sizeof(address)) != 0 || listen(fd, 4) != 0)
+    {
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    isStopRequested = false;
+    thread = std::make_unique<std::thread>(&HotCounterServer::Run, this);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void HotCounterServer::Stop()
+{
+#ifdef UNIX
+    if (thread)
+    {
+        isStopRequested = true;
+        thread->join();
+        thread.reset();
+    }
+
+    if (fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+        flx::removeSocketFile(path);
+    }
+#endif
+}
+
+void HotCounterServer::Run()
+{
+#ifdef UNIX
+    while (!isStopRequested)
+    {
+        struct pollfd pfd{};
+
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, POLL_TIMEOUT) <= 0 || (pfd.revents & POLLIN) == 0)
+        {
+            continue;
+        }
+
+        const auto connection = accept(fd, nullptr, nullptr);
+        if (connection < 0)
+        {
+            continue;
+        }
+
+        std::stringstream stream;
+        HotCounterRegistry::Instance().Dump(stream);
+        const auto text = stream.str();
+        size_t offset = 0U;
+
+        while (offset < text.size())
+        {
+            const auto count = send(connection, text.data() + offset,
+                    text.size() - offset, SEND_FLAGS);
+            if (count <= 0)
+            {
+                break;
+            }
+            offset += static_cast<size_t>(count);
+        }
+
+        close(connection);
+    }
+#endif
+}
+
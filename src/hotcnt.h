@@ -0,0 +1,156 @@
+/*
+    hotcnt.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef HOTCNT_INCLUDED
+#define HOTCNT_INCLUDED
+
+#include "typedefs.h"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Counters for hot paths of the emulation, e.g. memory and I/O device
+// accesses, sector transfers, interrupt requests or scheduler suspends.
+// Counting is compiled out by default. It is compiled in by defining
+// USE_HOTCOUNTERS, e.g. with: configure CPPFLAGS=-DUSE_HOTCOUNTERS
+// Each thread increments its own block of counters, so no cache line is
+// shared between threads on a hot path. The counters are relaxed atomics
+// to be readable at any time from any other thread.
+
+#ifdef USE_HOTCOUNTERS
+#define HOT_COUNT(id) HotCounterRegistry::Increment(HotCounterId::id)
+#else
+#define HOT_COUNT(id)
+#endif
+
+enum class HotCounterId : uint8_t
+{
+    MemoryRead,       // Read from RAM or ROM.
+    MemoryWrite,      // Write to RAM or ROM.
+    VideoRamWrite,    // Write to an active video RAM page.
+    IoRead,           // Read from any memory mapped I/O device.
+    IoWrite,          // Write to any memory mapped I/O device.
+    SectorRead,       // Sector read by the floppy disk controller.
+    SectorWrite,      // Sector written by the floppy disk controller.
+    Irq,              // IRQ requested.
+    Firq,             // FIRQ requested.
+    Nmi,              // NMI requested.
+    SchedulerSuspend, // CPU thread suspended until the next timer tick.
+    FrequencyMiss,    // Timer tick elapsed before the required cycles
+                      // have been executed.
+    COUNT,
+};
+
+struct IoDeviceCounters
+{
+    explicit IoDeviceCounters(std::string p_name) : name(std::move(p_name))
+    {
+    }
+
+    const std::string name;
+    std::atomic<QWord> reads{};
+    std::atomic<QWord> writes{};
+};
+
+class HotCounterRegistry
+{
+public:
+    static constexpr size_t COUNTER_COUNT{
+        static_cast<size_t>(HotCounterId::COUNT)};
+    using Counters = std::array<std::atomic<QWord>, COUNTER_COUNT>;
+    using Values = std::array<QWord, COUNTER_COUNT>;
+
+    HotCounterRegistry(const HotCounterRegistry &src) = delete;
+    HotCounterRegistry &operator=(const HotCounterRegistry &src) = delete;
+
+    static HotCounterRegistry &Instance();
+    static bool IsCompiledIn();
+    static const char *GetName(HotCounterId id);
+
+    // Increment a counter of the calling thread. There is only one writer
+    // for each counter, so a relaxed load and store is sufficient.
+    static void Increment(HotCounterId id)
+    {
+        if (threadCounters == nullptr)
+        {
+            threadCounters = &Instance().AddThreadCounters();
+        }
+
+        auto &counter = (*threadCounters)[static_cast<size_t>(id)];
+        counter.store(counter.load(std::memory_order_relaxed) + 1U,
+                std::memory_order_relaxed);
+    }
+
+    // I/O devices may be accessed from different threads.
+    static void Increment(std::atomic<QWord> &counter)
+    {
+        counter.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    IoDeviceCounters &GetIoDeviceCounters(const std::string &name);
+    Values GetTotals() const;
+    void Dump(std::ostream &os) const;
+
+private:
+    HotCounterRegistry() = default;
+    Counters &AddThreadCounters();
+
+    static thread_local Counters *threadCounters;
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Counters> > allThreadCounters;
+    std::deque<IoDeviceCounters> ioDeviceCounters;
+};
+
+// Serve the counters as text on a local (Unix domain) socket.
+// On each connection the current counters are written in the same format
+// as HotCounterRegistry::Dump, then the connection is closed,
+// e.g.: socat - UNIX-CONNECT:<path>
+class HotCounterServer
+{
+public:
+    HotCounterServer() = delete;
+    explicit HotCounterServer(std::string p_path);
+    ~HotCounterServer();
+    HotCounterServer(const HotCounterServer &src) = delete;
+    HotCounterServer &operator=(const HotCounterServer &src) = delete;
+
+    bool Start();
+    void Stop();
+
+private:
+    void Run();
+
+    std::string path;
+    int fd{-1};
+    std::atomic<bool> isStopRequested{};
+    std::unique_ptr<std::thread> thread;
+};
+
+#endif // HOTCNT_INCLUDED
+
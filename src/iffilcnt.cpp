@@ -32,7 +32,6 @@
 FlexDiskIteratorImp::FlexDiskIteratorImp(FlexDisk *p_base)
     : base(p_base), dirIndex(-1), dirTrackSector{0, 0}
 {
-    dirSector.next = first_dir_trk_sec;
 }
 
 bool FlexDiskIteratorImp::operator==(const IFlexDiskByFile *rhs) const
@@ -46,47 +45,37 @@ void FlexDiskIteratorImp::AtEnd()
     base = nullptr;
 }
 
+// On first call all matching directory entries are looked up in the
+// directory cache of the FlexDisk. Each of them is checked again before it
+// is returned because the directory may have been modified in between.
 bool FlexDiskIteratorImp::NextDirEntry(const std::string &wildcard)
 {
     dirEntry.SetEmpty();
 
-    while (dirEntry.IsEmpty())
+    if (dirIndex < 0)
     {
-        dirIndex++;
+        indices = base->FindDirEntryIndices(wildcard);
+        position = 0U;
+    }
 
-        if ((dirIndex % DIRENTRIES) == 0)
+    while (dirEntry.IsEmpty())
+    {
+        if (position >= indices.size())
         {
-            if (!dirSector.next.sec && !dirSector.next.trk)
-            {
-                return false;
-            }
-
-            dirTrackSector = dirSector.next;
-
-            if (!base->ReadSector(reinterpret_cast<Byte *>(&dirSector),
-                                  dirTrackSector.trk, dirTrackSector.sec))
-            {
-                std::stringstream stream;
-
-                stream << dirTrackSector;
-                throw FlexException(FERR_READING_TRKSEC,
-                                    stream.str(),
-                                    base->GetPath());
-            }
+            return false;
         }
 
-        s_dir_entry *pd = &dirSector.dir_entries[dirIndex % DIRENTRIES];
+        dirIndex = static_cast<int>(indices[position++]);
+        const auto *pd = base->GetCachedDirEntry(
+                static_cast<DWord>(dirIndex), dirTrackSector);
 
-        // an empty entry aborts the search
-        if (pd->filename[0] == DE_EMPTY)
+        if (pd == nullptr || pd->filename[0] == DE_EMPTY)
         {
             return false;
         }
 
-        // look for the next used directory entry
         if (pd->filename[0] != DE_DELETED)
         {
-            // ok, found a valid directory entry
             std::string fileName(flx::getstr<>(pd->filename));
             std::string fileExtension(flx::getstr<>(pd->file_ext));
             fileName += '.' + fileExtension;
@@ -160,7 +149,6 @@ bool FlexDiskIteratorImp::DeleteCurrent()
     }
 
     base->SetNextDirectoryPosition(st_t{});
-    base->DeleteFromFilenames(dirEntry.GetTotalFileName());
 
     /* read system info sector (SIS) */
     s_sys_info_sector sis{};
@@ -331,9 +319,6 @@ bool FlexDiskIteratorImp::RenameCurrent(const std::string &newName)
                             stream.str(),
                             base->GetPath());
     }
-    base->DeleteFromFilenames(dirEntry.GetTotalFileName());
-    const auto idx = static_cast<Byte>(dirIndex % DIRENTRIES);
-    base->AddToFilenames(newName, FlexDisk::s_dir_pos{dirTrackSector, idx});
 
     return true;
 }
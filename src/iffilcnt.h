@@ -25,6 +25,7 @@
 #include "ifilcnti.h"
 #include "filecont.h"
 #include "filecnts.h"
+#include <vector>
 
 class FlexDisk;
 
@@ -56,6 +57,8 @@ private:
     st_t dirTrackSector;
     s_dir_sector dirSector{};
     FlexDirEntry dirEntry;
+    std::vector<DWord> indices; // Indices of matching directory entries.
+    size_t position{}; // Position of next directory entry in indices.
 };
 
 #endif // IFFILCNT_INCLUDED
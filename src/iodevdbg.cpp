@@ -104,3 +104,12 @@ Word IoDeviceDebug::sizeOfIo()
     return device.sizeOfIo();
 }
 
+void IoDeviceDebug::saveState(SnapshotWriter &writer)
+{
+    device.saveState(writer);
+}
+
+RestoreStateFct IoDeviceDebug::restoreState(SnapshotReader &reader)
+{
+    return device.restoreState(reader);
+}
@@ -28,7 +28,7 @@
 #include "iodevice.h"
 #include <functional>
 
-class IoDeviceDebug : public IoDevice
+class IoDeviceDebug final : public IoDevice
 {
 public:
 
@@ -48,6 +48,8 @@ public:
     void resetIo() override;
     const char *getName() override;
     Word sizeOfIo() override;
+    void saveState(SnapshotWriter &writer) override;
+    RestoreStateFct restoreState(SnapshotReader &reader) override;
 
 private:
     // Intentionally use a reference.
@@ -26,6 +26,13 @@
 #define IODEVICE_INCLUDED
 
 #include "misc1.h"
+#include <functional>
+
+class SnapshotWriter;
+class SnapshotReader;
+
+// Applies a state which has been read from a machine snapshot.
+using RestoreStateFct = std::function<void()>;
 
 class IoDevice
 {
@@ -36,8 +43,59 @@ public:
     virtual void resetIo() = 0;
     virtual const char *getName() = 0;
     virtual Word sizeOfIo() = 0;
+    // Save or restore the internal state for a machine snapshot.
+    // A device without any internal state does not have to override it.
+    // restoreState() only reads the state. It returns a function to apply
+    // it or an empty function if the state is invalid.
+    virtual void saveState(SnapshotWriter & /*writer*/) { }
+    virtual RestoreStateFct restoreState(SnapshotReader & /*reader*/)
+    {
+        return [](){};
+    }
     virtual ~IoDevice() = default;
 };
 
+// Functions to read from or write to a memory mapped I/O device.
+struct IoDispatch
+{
+    Byte (*readIo)(IoDevice &device, Word offset);
+    void (*writeIo)(IoDevice &device, Word offset, Byte value);
+};
+
+// Create the I/O dispatch functions for a device class known at compile
+// time. They call readIo() and writeIo() without a virtual function call.
+// For a final device class the compiler can also inline all virtual
+// functions called by them, e.g. for polling a status register.
+template <class T>
+IoDispatch MakeIoDispatch()
+{
+    return {
+        [](IoDevice &device, Word offset) -> Byte
+        {
+            return static_cast<T &>(device).T::readIo(offset);
+        },
+        [](IoDevice &device, Word offset, Byte value)
+        {
+            static_cast<T &>(device).T::writeIo(offset, value);
+        }
+    };
+}
+
+// Device class unknown at compile time: Use virtual function calls.
+template <>
+inline IoDispatch MakeIoDispatch<IoDevice>()
+{
+    return {
+        [](IoDevice &device, Word offset) -> Byte
+        {
+            return device.readIo(offset);
+        },
+        [](IoDevice &device, Word offset, Byte value)
+        {
+            device.writeIo(offset, value);
+        }
+    };
+}
+
 #endif // IODEVICE_INCLUDED
 
@@ -0,0 +1,64 @@
+/*
+    irqline.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "misc1.h"
+#include "irqline.h"
+#include "mc6809.h"
+
+
+void InterruptLine::Connect(Mc6809 &p_cpu, tIrqType p_type)
+{
+    cpu = &p_cpu;
+    type = p_type;
+    mask = cpu->connect_interrupt_line(type);
+}
+
+void InterruptLine::Assert()
+{
+    if (cpu != nullptr && cpu->assert_interrupt(type, mask))
+    {
+        ++requestCount;
+    }
+}
+
+void InterruptLine::Deassert()
+{
+    if (cpu != nullptr)
+    {
+        cpu->deassert_interrupt(type, mask);
+    }
+}
+
+void InterruptLine::Pulse()
+{
+    if (cpu != nullptr)
+    {
+        cpu->pulse_interrupt(type);
+        ++requestCount;
+    }
+}
+
+bool InterruptLine::IsAsserted() const
+{
+    return cpu != nullptr && cpu->is_interrupt_asserted(type, mask);
+}
+
@@ -0,0 +1,79 @@
+/*
+    irqline.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef IRQLINE_INCLUDED
+#define IRQLINE_INCLUDED
+
+#include "typedefs.h"
+#include "schedcpu.h"
+#include <atomic>
+
+
+class Mc6809;
+
+// An interrupt line connects an interrupt output of a device with the
+// IRQ, FIRQ or NMI input of the CPU. It replaces a notification through
+// BObserver, so raising an interrupt is only an atomic bit operation.
+//
+// Assert() and Deassert() are level triggered: The CPU input is active
+// as long as at least one connected line is asserted, e.g. until a device
+// interrupt flag is cleared by reading a status register.
+// Pulse() is edge triggered: The interrupt is latched until it has been
+// serviced by the CPU. The NMI input of the MC6809 always is edge
+// triggered, so asserting an NMI line is the same as a pulse.
+// Asserting and pulsing is thread safe (also from a signal handler).
+
+class InterruptLine
+{
+public:
+    InterruptLine() = default;
+    ~InterruptLine() = default;
+    InterruptLine(const InterruptLine &src) = delete;
+    InterruptLine(InterruptLine &&src) = delete;
+    InterruptLine &operator=(const InterruptLine &src) = delete;
+    InterruptLine &operator=(InterruptLine &&src) = delete;
+
+    void Connect(Mc6809 &p_cpu, tIrqType p_type);
+    bool IsConnected() const
+    {
+        return cpu != nullptr;
+    }
+
+    void Assert();
+    void Deassert();
+    void Pulse();
+    bool IsAsserted() const;
+    // Number of interrupt requests, each assert or pulse counts as one.
+    QWord GetRequestCount() const
+    {
+        return requestCount;
+    }
+
+private:
+    Mc6809 *cpu{nullptr};
+    tIrqType type{INT_IRQ};
+    DWord mask{0U};
+    std::atomic<QWord> requestCount{0U};
+};
+
+#endif // IRQLINE_INCLUDED
+
@@ -0,0 +1,57 @@
+/*
+    lblindex.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "lblindex.h"
+#include <algorithm>
+
+
+LabelIndex::LabelIndex()
+    : offsets(0x10000U, 0U)
+    , names(1U, '\0')
+{
+}
+
+void LabelIndex::Clear()
+{
+    std::fill(offsets.begin(), offsets.end(), 0U);
+    names.assign(1U, '\0');
+}
+
+void LabelIndex::Add(const std::map<unsigned, std::string> &labels)
+{
+    for (const auto &[address, label] : labels)
+    {
+        if (address > 0xFFFFU || label.empty())
+        {
+            continue;
+        }
+
+        offsets[address] = static_cast<DWord>(names.size());
+        names.insert(names.end(), label.cbegin(), label.cend());
+        names.push_back('\0');
+    }
+}
+
+bool LabelIndex::IsEmpty() const
+{
+    return names.size() <= 1U;
+}
@@ -0,0 +1,61 @@
+/*
+    lblindex.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef LBLINDEX_INCLUDED
+#define LBLINDEX_INCLUDED
+
+#include "typedefs.h"
+#include <string>
+#include <vector>
+#include <map>
+
+
+// A flat label index covering the whole 64 KByte address space.
+// Each address maps to an offset into a contiguous name pool, so a lookup
+// is a single array access without any tree traversal or allocation.
+// Labels can be merged from several sources (flexlabl.conf, assembler
+// symbol files). A label added later replaces a label already defined
+// for the same address.
+class LabelIndex
+{
+public:
+    LabelIndex();
+
+    void Clear();
+    void Add(const std::map<unsigned, std::string> &labels);
+    bool IsEmpty() const;
+
+    const char *Find(Word address) const
+    {
+        const auto offset = offsets[address];
+
+        return (offset == 0U) ? nullptr : &names[offset];
+    }
+
+private:
+    // Offset 0 in names is reserved as "no label".
+    std::vector<DWord> offsets;
+    std::vector<char> names;
+};
+
+#endif // LBLINDEX_INCLUDED
+
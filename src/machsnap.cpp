@@ -0,0 +1,170 @@
+/*
+    machsnap.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "misc1.h"
+#include "machsnap.h"
+#include "snapshot.h"
+#include "mc6809.h"
+#include "memory.h"
+#include "schedule.h"
+#include "iodevice.h"
+#include <fstream>
+#include <functional>
+#include <iterator>
+
+
+static const char * const CPU_CHUNK = "mc6809";
+static const char * const MEMORY_CHUNK = "memory";
+static const char * const SCHEDULER_CHUNK = "scheduler";
+
+MachineSnapshot::MachineSnapshot(Mc6809 &p_cpu, Memory &p_memory,
+                                 Scheduler &p_scheduler)
+    : cpu(p_cpu)
+    , memory(p_memory)
+    , scheduler(p_scheduler)
+{
+}
+
+void MachineSnapshot::AddIoDevice(IoDevice &device)
+{
+    ioDevices.emplace_back(device);
+}
+
+std::vector<Byte> MachineSnapshot::Save()
+{
+    SnapshotWriter writer;
+
+    writer.BeginChunk(CPU_CHUNK);
+    cpu.save_state(writer);
+    writer.EndChunk();
+    writer.BeginChunk(MEMORY_CHUNK);
+    memory.save_state(writer);
+    writer.EndChunk();
+    writer.BeginChunk(SCHEDULER_CHUNK);
+    scheduler.save_state(writer);
+    writer.EndChunk();
+
+    for (auto &device : ioDevices)
+    {
+        writer.BeginChunk(device.get().getName());
+        device.get().saveState(writer);
+        writer.EndChunk();
+    }
+
+    return writer.GetData();
+}
+
+// The snapshot has to contain a valid chunk for each component, otherwise
+// it has been saved with a different machine configuration.
+// All chunks are read and validated first. Only if this succeeds for all
+// components their state is applied. So a rejected snapshot leaves the
+// machine unchanged.
+bool MachineSnapshot::Restore(std::vector<Byte> data)
+{
+    SnapshotReader reader(std::move(data));
+    std::vector<RestoreStateFct> applyFcts;
+
+    if (!reader.IsValid())
+    {
+        return false;
+    }
+
+    const auto readChunk = [&](const std::string &name,
+                               const std::function<RestoreStateFct()> &fct)
+    {
+        if (!reader.SelectChunk(name))
+        {
+            return false;
+        }
+
+        auto apply = fct();
+        if (!apply)
+        {
+            return false;
+        }
+
+        applyFcts.push_back(std::move(apply));
+        return true;
+    };
+
+    if (!readChunk(MEMORY_CHUNK,
+                   [&](){ return memory.restore_state(reader); }) ||
+        !readChunk(CPU_CHUNK, [&](){ return cpu.restore_state(reader); }) ||
+        !readChunk(SCHEDULER_CHUNK,
+                   [&](){ return scheduler.restore_state(reader); }))
+    {
+        return false;
+    }
+
+    for (auto &device : ioDevices)
+    {
+        if (!readChunk(device.get().getName(),
+                       [&](){ return device.get().restoreState(reader); }))
+        {
+            return false;
+        }
+    }
+
+    for (const auto &apply : applyFcts)
+    {
+        apply();
+    }
+
+    return true;
+}
+
+bool MachineSnapshot::SaveToFile(const std::string &path)
+{
+    const auto data = Save();
+    std::ofstream ofs(path, std::ios::out | std::ios::binary |
+                            std::ios::trunc);
+
+    if (!ofs.is_open())
+    {
+        return false;
+    }
+
+    ofs.write(reinterpret_cast<const char *>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+
+    return ofs.good();
+}
+
+bool MachineSnapshot::RestoreFromFile(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+
+    if (!ifs.is_open())
+    {
+        return false;
+    }
+
+    std::vector<Byte> data((std::istreambuf_iterator<char>(ifs)),
+                           std::istreambuf_iterator<char>());
+    if (ifs.bad())
+    {
+        return false;
+    }
+
+    return Restore(std::move(data));
+}
+
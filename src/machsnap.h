@@ -0,0 +1,69 @@
+/*
+    machsnap.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef MACHSNAP_INCLUDED
+#define MACHSNAP_INCLUDED
+
+#include "typedefs.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+
+class Mc6809;
+class Memory;
+class Scheduler;
+class IoDevice;
+
+// A machine snapshot contains the state of the CPU, memory, scheduler
+// and all added I/O devices (see snapshot.h for the format).
+// Saving or restoring has to be done between two CPU instructions, either
+// before the CPU thread is started or within the CPU thread,
+// e.g. by Scheduler::sync_exec().
+
+class MachineSnapshot
+{
+public:
+    MachineSnapshot() = delete;
+    MachineSnapshot(Mc6809 &p_cpu, Memory &p_memory, Scheduler &p_scheduler);
+    ~MachineSnapshot() = default;
+    MachineSnapshot(const MachineSnapshot &src) = delete;
+    MachineSnapshot(MachineSnapshot &&src) = delete;
+    MachineSnapshot &operator=(const MachineSnapshot &src) = delete;
+    MachineSnapshot &operator=(MachineSnapshot &&src) = delete;
+
+    void AddIoDevice(IoDevice &device);
+
+    std::vector<Byte> Save();
+    bool Restore(std::vector<Byte> data);
+    bool SaveToFile(const std::string &path);
+    bool RestoreFromFile(const std::string &path);
+
+private:
+    Mc6809 &cpu;
+    Memory &memory;
+    Scheduler &scheduler;
+    std::vector<std::reference_wrapper<IoDevice> > ioDevices;
+};
+
+#endif // MACHSNAP_INCLUDED
+
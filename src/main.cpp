@@ -66,10 +66,44 @@ static void flexemu_new_handler()
     std::terminate();
 }
 
+#ifdef UNIX
+// Return true if the fork server is requested in terminal mode
+// (options -K and -t). The command line is not parsed yet, so only
+// separate options are detected.
+static bool IsForkServerRequested(int argc, char *argv[])
+{
+    bool hasForkServer = false;
+    bool hasTermMode = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+
+        if (arg.rfind("-K", 0) == 0)
+        {
+            hasForkServer = true;
+            if (arg.size() == 2U)
+            {
+                ++i; // Skip the socket path.
+            }
+        }
+        else if (arg == "-t")
+        {
+            hasTermMode = true;
+        }
+    }
+
+    return hasForkServer && hasTermMode;
+}
+#endif
+
 int main(int argc, char *argv[])
 {
     int return_code = EXIT_RESTART;
     bool isRestarted = false;
+#ifdef UNIX
+    bool isOffscreen = false;
+#endif
 
 #ifdef _MSC_VER
     set_new_handler(flexemu_new_handler);
@@ -84,6 +118,25 @@ int main(int argc, char *argv[])
     while (return_code == EXIT_RESTART)
     {
         struct sOptions options;
+
+#ifdef UNIX
+        // The fork server needs a single threaded process. The platform
+        // plugin of a windowing system, e.g. xcb, starts threads when
+        // QApplication is constructed. In terminal mode no window is needed.
+        if (!isRestarted && IsForkServerRequested(argc, argv) &&
+            qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+            isOffscreen = true;
+        }
+        else if (isRestarted && isOffscreen)
+        {
+            // After a restart flexemu is never in terminal mode.
+            qunsetenv("QT_QPA_PLATFORM");
+            isOffscreen = false;
+        }
+#endif
+
         QApplication app(argc, argv);
 
         try
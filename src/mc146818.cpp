@@ -22,6 +22,7 @@
 
 #include "misc1.h"
 #include "mc146818.h"
+#include "snapshot.h"
 #include <array>
 #include <fstream>
 #include <ctime>
@@ -111,6 +112,53 @@ void Mc146818::resetIo()
     B &= 0x87U;
     C = 0;
     D = 0x80;
+    firq.Deassert();
+}
+
+void Mc146818::connect_interrupts(Mc6809 &cpu)
+{
+    firq.Connect(cpu, INT_FIRQ);
+}
+
+// The clock registers are part of the snapshot, so a restored machine
+// continues with the time of the snapshot.
+void Mc146818::saveState(SnapshotWriter &writer)
+{
+    for (auto value : { second, minute, hour, al_second, al_minute, al_hour,
+                        weekday, day, month, year, A, B, C, D })
+    {
+        writer.Write(value);
+    }
+    writer.Write(ram.data(), static_cast<DWord>(ram.size()));
+}
+
+RestoreStateFct Mc146818::restoreState(SnapshotReader &reader)
+{
+    std::array<Byte, 14> values{};
+    auto new_ram = ram;
+
+    for (auto &value : values)
+    {
+        reader.Read(value);
+    }
+    reader.Read(new_ram.data(), static_cast<DWord>(new_ram.size()));
+
+    if (!reader.IsValid())
+    {
+        return {};
+    }
+
+    return [this, values, new_ram](){
+        auto iter = values.cbegin();
+
+        for (auto *value : { &second, &minute, &hour, &al_second,
+                             &al_minute, &al_hour, &weekday, &day, &month,
+                             &year, &A, &B, &C, &D })
+        {
+            *value = *(iter++);
+        }
+        ram = new_ram;
+    };
 }
 
 Byte Mc146818::readIo(Word offset)
@@ -158,6 +206,7 @@ Byte Mc146818::readIo(Word offset)
         case 0x0c:
             temp = C;
             C = 0x00;
+            firq.Deassert();
             return temp;
 
         case 0x0d:
@@ -295,7 +344,7 @@ void Mc146818::update_1_second()
         if (BTST<Byte>(B, 4U))
         {
             BSET<Byte>(C, 7U);
-            Notify(NotifyId::SetFirq);
+            firq.Assert();
         }
 
         // now check for an alarm
@@ -308,7 +357,7 @@ void Mc146818::update_1_second()
             if (BTST<Byte>(B, 5U))
             {
                 BSET<Byte>(C, 7U);
-                Notify(NotifyId::SetFirq);
+                firq.Assert();
             }
         }
     }
@@ -27,14 +27,14 @@
 
 #include "misc1.h"
 #include "iodevice.h"
-#include "bobservd.h"
+#include "irqline.h"
 #include <string>
 #include <array>
 
 
 class Mc6809;
 
-class Mc146818 : public IoDevice, public BObserved
+class Mc146818 final : public IoDevice
 {
     // Internal registers:
 
@@ -54,6 +54,7 @@ protected:
     Byte C{0};
     Byte D{0};
     std::array<Byte, 50> ram{}; // 50 bytes of internal RAM
+    InterruptLine firq; // active while bit 7 of register C is set
 
 public:
 
@@ -68,7 +69,10 @@ public:
     {
         return 64;
     };
+    void saveState(SnapshotWriter &writer) override;
+    RestoreStateFct restoreState(SnapshotReader &reader) override;
     virtual void update_1_second();
+    void connect_interrupts(Mc6809 &cpu);
 
 private:
 
@@ -14,6 +14,7 @@
 #include "mc6809.h"
 #include "da6809.h"
 #include "inout.h"
+#include "hotcnt.h"
 #include <cstring>
 
 #ifdef FASTFLEX
@@ -192,19 +193,105 @@ void Mc6809::init_psh_pul_cycles()
 
 void Mc6809::set_nmi()
 {
+    HOT_COUNT(Nmi);
+    interrupt_lines[INT_NMI] |= PULSE_LINE;
     events |= Event::Nmi;
 }
 
 void Mc6809::set_firq()
 {
+    HOT_COUNT(Firq);
+    interrupt_lines[INT_FIRQ] |= PULSE_LINE;
     events |= Event::Firq;
 }
 
 void Mc6809::set_irq()
 {
+    HOT_COUNT(Irq);
+    interrupt_lines[INT_IRQ] |= PULSE_LINE;
     events |= Event::Irq;
 }
 
+static Mc6809::Event GetInterruptEvent(tIrqType type)
+{
+    switch (type)
+    {
+        case INT_NMI:
+            return Mc6809::Event::Nmi;
+
+        case INT_FIRQ:
+            return Mc6809::Event::Firq;
+
+        default:
+            return Mc6809::Event::Irq;
+    }
+}
+
+// Returns the bit mask of a new interrupt line. Lines are connected
+// before the CPU is started.
+DWord Mc6809::connect_interrupt_line(tIrqType type)
+{
+    if (type > INT_NMI || connected_lines[type] >= 31U)
+    {
+        throw FlexException(FERR_WRONG_PARAMETER);
+    }
+
+    return PULSE_LINE << ++connected_lines[type];
+}
+
+// Returns false if the line already was asserted.
+bool Mc6809::assert_interrupt(tIrqType type, DWord mask)
+{
+    if ((interrupt_lines[type].fetch_or(mask) & mask) != 0U)
+    {
+        return false;
+    }
+
+    // The NMI input is edge triggered, it is latched as a pulse.
+    pulse_interrupt(type);
+
+    return true;
+}
+
+void Mc6809::deassert_interrupt(tIrqType type, DWord mask)
+{
+    const auto lines = interrupt_lines[type].fetch_and(~mask);
+
+    // A latched NMI or pulse is only cleared when it has been serviced.
+    if ((lines & mask) == 0U || (lines & ~mask) != 0U || type == INT_NMI)
+    {
+        return;
+    }
+
+    const auto event = GetInterruptEvent(type);
+
+    events &= ~event;
+
+    // if a line has been asserted in another thread check again
+    if (interrupt_lines[type] != 0U)
+    {
+        events |= event;
+    }
+}
+
+void Mc6809::pulse_interrupt(tIrqType type)
+{
+    switch (type)
+    {
+        case INT_NMI:
+            set_nmi();
+            break;
+
+        case INT_FIRQ:
+            set_firq();
+            break;
+
+        default:
+            set_irq();
+            break;
+    }
+}
+
 #ifndef FASTFLEX
 cycles_t Mc6809::psh(Byte what, Word &stack, Word &reg_s_or_u)
 {
@@ -1506,18 +1593,3 @@ void Mc6809::get_interrupt_status(tInterruptStatus &stat)
     std::memcpy(&stat, &interrupt_status, sizeof(tInterruptStatus));
 }
 
-void Mc6809::UpdateFrom(NotifyId id, void * /*param*/)
-{
-    if (id == NotifyId::SetIrq)
-    {
-        set_irq();
-    }
-    else if (id == NotifyId::SetFirq)
-    {
-        set_firq();
-    }
-    else if (id == NotifyId::SetNmi)
-    {
-        set_nmi();
-    }
-}
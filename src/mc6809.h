@@ -23,7 +23,6 @@
 #include "cpustate.h"
 #include "flexemu.h"
 #include "absdisas.h"
-#include "bobserv.h"
 #include "boption.h"
 #include "mc6809lg.h"
 
@@ -138,10 +137,12 @@ union ucc
 };
 
 class Da6809;
+class SnapshotWriter;
+class SnapshotReader;
 struct Mc6809CpuStatus;
 
 
-class Mc6809 : public ScheduledCpu, public BObserver
+class Mc6809 : public ScheduledCpu
 {
 public:
     enum class Event : Word
@@ -159,6 +160,7 @@ public:
         SetStatus = (1U << 9U),
         FrequencyControl = (1U << 10U),
         DoSchedule = (1U << 11U),
+        ScheduleAtCycle = (1U << 12U),
         Cwai = (1U << 13U),
         Sync = (1U << 14U),
         IgnoreBP = (1U << 15U),
@@ -215,6 +217,11 @@ protected:
     Byte nmi_armed{0}; // for handling
     // interrupts
     atomic_event events{Event::NONE}; // event status flags (atomic access)
+    // Asserted interrupt lines for IRQ, FIRQ and NMI (atomic access).
+    // Bit 0 latches a pulse, the other bits are level triggered lines.
+    static constexpr DWord PULSE_LINE{1U};
+    std::array<std::atomic<DWord>, INT_NMI + 1> interrupt_lines{};
+    std::array<DWord, INT_NMI + 1> connected_lines{};
     tInterruptStatus interrupt_status{};
 #ifdef FASTFLEX
     std::atomic<Word> ipcreg{0};
@@ -912,9 +919,14 @@ public:
     CpuStatusPtr create_status_object() override;
     void get_interrupt_status(tInterruptStatus &s) override;
     void set_required_cyclecount(cycles_t p_cycles) override;
+    void set_schedule_cycle(QWord p_cycle, bool p_isAfterInterrupts) override;
 
     // test support
     void set_status(CpuStatus *p_cpu_status);
+
+    // machine snapshot support
+    void save_state(SnapshotWriter &writer);
+    RestoreStateFct restore_state(SnapshotReader &reader);
 protected:
     CpuState runloop();
 
@@ -922,14 +934,30 @@ protected:
 public:
     void reset(); // CPU reset
     inline cycles_t exec_irqs(bool save_state = true);
+protected:
+    inline void acknowledge_interrupt(tIrqType type, Event event);
+public:
     void set_nmi();
     void set_firq();
     void set_irq();
 
+    // Interrupt lines, see irqline.h.
+    // Each connected line gets its own bit within the interrupt input.
+    DWord connect_interrupt_line(tIrqType type);
+    bool assert_interrupt(tIrqType type, DWord mask);
+    void deassert_interrupt(tIrqType type, DWord mask);
+    void pulse_interrupt(tIrqType type);
+    bool is_interrupt_asserted(tIrqType type, DWord mask) const
+    {
+        return (interrupt_lines[type] & mask) != 0U;
+    }
+
 protected:
     std::atomic<QWord> total_cycles{}; // total cycle count with 64 Bit resolution
     cycles_t cycles{}; // cycle cnt for one timer tick
     std::atomic<cycles_t> required_cyclecount{};//cycle count for freq ctrl
+    QWord schedule_cycle{}; // total cycle count to leave the runloop
+    bool is_schedule_after_irqs{}; // leave after executing interrupts
 
     // breakpoint support
 protected:
@@ -949,14 +977,9 @@ public:
         return PC;
     }
 
-public:
-    // BObserver interface
-    void UpdateFrom(NotifyId id, void *param = nullptr) override;
-
 protected:
     unsigned Disassemble(Word address, InstFlg &p_flags,
-                    std::string &code, std::string &mnemonic,
-                    std::string &operands);
+                    DisassemblyText &text);
     Mc6809Logger logger;
     Memory &memory;
 
@@ -16,6 +16,7 @@
 #include "mc6809.h"
 #include "mc6809st.h"
 #include "da6809.h"
+#include "snapshot.h"
 #include <array>
 #include <cstring>
 #include <fmt/format.h>
@@ -32,14 +33,33 @@ static const Mc6809::Event AnyInterrupt =
                  Mc6809::Event::Firq |
                  Mc6809::Event::Nmi;
 
+// Events which are part of a machine snapshot.
+// NOLINTNEXTLINE(cert-err58-cpp)
+static const Mc6809::Event SnapshotEvents =
+                 AnyInterrupt |
+                 Mc6809::Event::Cwai |
+                 Mc6809::Event::Sync;
+
 void Mc6809::reset()
 {
     ++interrupt_status.count[INT_RESET];
     cycles = 0;
     total_cycles = 0;
     nmi_armed = 0;
-    /* no interrupts yet */
+    /* no interrupts yet, except asserted level triggered lines */
     events = events & Event::FrequencyControl;
+    for (auto &lines : interrupt_lines)
+    {
+        lines &= ~PULSE_LINE;
+    }
+    if (interrupt_lines[INT_FIRQ] != 0U)
+    {
+        events |= Event::Firq;
+    }
+    if (interrupt_lines[INT_IRQ] != 0U)
+    {
+        events |= Event::Irq;
+    }
     reset_bp(2); // remove next-breakpoint
 
 #ifdef FASTFLEX
@@ -61,8 +81,7 @@ void Mc6809::reset()
 }
 
 unsigned Mc6809::Disassemble(Word address, InstFlg &p_flags,
-                        std::string &code, std::string &mnemonic,
-                        std::string &operands)
+                        DisassemblyText &text)
 {
     std::array<Byte, 6> buffer{};
     DWord jumpAddress = 0;
@@ -79,7 +98,7 @@ unsigned Mc6809::Disassemble(Word address, InstFlg &p_flags,
     }
 
     p_flags = disassembler->Disassemble(buffer.data(), address, jumpAddress,
-            code, mnemonic, operands);
+            text);
     return disassembler->getByteSize(buffer.data());
 }
 
@@ -110,9 +129,7 @@ QWord Mc6809::get_cycles(bool reset /* = false */)
 void Mc6809::get_status(CpuStatus *cpu_status)
 {
     InstFlg flags = InstFlg::NONE;
-    std::string mnemonic;
-    std::string operands;
-    std::string code;
+    DisassemblyText text;
     Word i;
     auto *stat = dynamic_cast<Mc6809CpuStatus *>(cpu_status);
     assert(stat != nullptr);
@@ -150,7 +167,7 @@ void Mc6809::get_status(CpuStatus *cpu_status)
         stat->memory[i] = memory.read_byte(stack_base + i);
     }
 
-    auto byte_size = Disassemble(stat->pc, flags, code, mnemonic, operands);
+    auto byte_size = Disassemble(stat->pc, flags, text);
     if (byte_size == 0)
     {
         stat->mnemonic[0] = '\0';
@@ -159,12 +176,10 @@ void Mc6809::get_status(CpuStatus *cpu_status)
     }
     else
     {
-        assert(mnemonic.size() < sizeof(stat->mnemonic));
-        std::strncpy(stat->mnemonic, mnemonic.c_str(),
+        std::strncpy(stat->mnemonic, text.mnemonic.data(),
                 sizeof(stat->mnemonic) - 1);
         stat->mnemonic[sizeof(stat->mnemonic) - 1] = '\0';
-        assert(operands.size() < sizeof(stat->operands));
-        std::strncpy(stat->operands, operands.c_str(),
+        std::strncpy(stat->operands, text.operands.data(),
                 sizeof(stat->operands) - 1);
         stat->operands[sizeof(stat->operands) - 1] = '\0';
         stat->insn_size = static_cast<Word>(byte_size);
@@ -201,6 +216,96 @@ void Mc6809::set_status(CpuStatus *cpu_status)
 #endif
 }
 
+// Save processor registers, pending interrupts, wait states (CWAI, SYNC)
+// and cycle counters. It has to be called between two instructions.
+void Mc6809::save_state(SnapshotWriter &writer)
+{
+    using T = std::underlying_type_t<Event>;
+
+#ifdef FASTFLEX
+    for (auto value : { iareg, ibreg, iccreg, idpreg })
+    {
+        writer.Write(value);
+    }
+    for (Word value : { ipcreg.load(), ixreg, iyreg, iureg, isreg })
+    {
+        writer.Write(value);
+    }
+#else
+    for (auto value : { a, b, cc.all, dp })
+    {
+        writer.Write(value);
+    }
+    for (Word value : { pc.load(), x, y, u, s })
+    {
+        writer.Write(value);
+    }
+#endif
+    writer.Write(static_cast<T>(events & SnapshotEvents));
+    for (const auto &lines : interrupt_lines)
+    {
+        writer.Write(lines.load());
+    }
+    writer.Write(nmi_armed);
+    writer.Write(get_cycles());
+    for (auto count : interrupt_status.count)
+    {
+        writer.Write(count);
+    }
+}
+
+RestoreStateFct Mc6809::restore_state(SnapshotReader &reader)
+{
+    using T = std::underlying_type_t<Event>;
+    Mc6809CpuStatus status;
+    T savedEvents;
+    std::array<DWord, INT_NMI + 1> savedLines{};
+    Byte savedNmiArmed;
+    QWord savedCycles;
+    tInterruptStatus savedInterruptStatus{};
+
+    for (auto *value : { &status.a, &status.b, &status.cc, &status.dp })
+    {
+        reader.Read(*value);
+    }
+    for (auto *value : { &status.pc, &status.x, &status.y, &status.u,
+                         &status.s })
+    {
+        reader.Read(*value);
+    }
+    reader.Read(savedEvents);
+    for (auto &lines : savedLines)
+    {
+        reader.Read(lines);
+    }
+    reader.Read(savedNmiArmed);
+    reader.Read(savedCycles);
+    for (auto &count : savedInterruptStatus.count)
+    {
+        reader.Read(count);
+    }
+
+    if (!reader.IsValid())
+    {
+        return {};
+    }
+
+    return [this, status, savedEvents, savedLines, savedNmiArmed,
+            savedCycles, savedInterruptStatus]() mutable {
+        set_status(&status);
+        events &= ~SnapshotEvents;
+        for (size_t i = 0U; i < savedLines.size(); ++i)
+        {
+            interrupt_lines[i] = savedLines[i];
+        }
+        events |= static_cast<Event>(savedEvents) & SnapshotEvents;
+        nmi_armed = savedNmiArmed;
+        interrupt_status = savedInterruptStatus;
+        cycles = 0;
+        total_cycles = savedCycles;
+    };
+}
+
 CpuStatusPtr Mc6809::create_status_object()
 {
     return CpuStatusPtr(new Mc6809CpuStatus);
@@ -217,9 +322,7 @@ CpuState Mc6809::run(RunMode mode)
 
         case RunMode::SingleStepOver:
         {
-            std::string code;
-            std::string mnemonic;
-            std::string operands;
+            DisassemblyText text;
             InstFlg flags = InstFlg::NONE;
 
             // Only if disassembler available and
@@ -228,7 +331,7 @@ CpuState Mc6809::run(RunMode mode)
             if (disassembler != nullptr)
             {
                 const auto byteSize =
-                    Disassemble(PC, flags, code, mnemonic, operands);
+                    Disassemble(PC, flags, text);
                 bp[2] = static_cast<Word>(PC + byteSize);
             }
 
@@ -289,10 +392,18 @@ CpuState Mc6809::runloop()
         {
             if ((events & (Event::BreakPoint | Event::Invalid |
                            Event::SingleStep | Event::SingleStepFinished |
-                           Event::FrequencyControl |
+                           Event::FrequencyControl | Event::ScheduleAtCycle |
                            Event::Cwai | Event::Sync)) != Event::NONE)
             {
                 // All non time critical events
+                if (((events & Event::ScheduleAtCycle) != Event::NONE) &&
+                    !is_schedule_after_irqs && get_cycles() >= schedule_cycle)
+                {
+                    events &= ~Event::ScheduleAtCycle;
+                    new_state = CpuState::Schedule;
+                    break;
+                }
+
                 if ((events & Event::Invalid) != Event::NONE)
                 {
                     // An invalid instr. occured
@@ -394,6 +505,15 @@ CpuState Mc6809::runloop()
                 cycles += exec_irqs();
             }
 
+            if (((events & Event::ScheduleAtCycle) != Event::NONE) &&
+                is_schedule_after_irqs && get_cycles() >= schedule_cycle)
+            {
+                // Also on first_time, the cycle count is only reached once.
+                events &= ~Event::ScheduleAtCycle;
+                new_state = CpuState::Schedule;
+                break;
+            }
+
             if (((events & Event::DoSchedule) != Event::NONE) &&
                 !first_time &&
                 !((events & (Event::SingleStep | Event::SingleStepFinished))
@@ -465,6 +585,28 @@ void Mc6809::set_required_cyclecount(cycles_t p_cycles)
     }
 }
 
+// Has to be called within the CPU thread, e.g. by the scheduler.
+void Mc6809::set_schedule_cycle(QWord p_cycle, bool p_isAfterInterrupts)
+{
+    schedule_cycle = p_cycle;
+    is_schedule_after_irqs = p_isAfterInterrupts;
+    events |= Event::ScheduleAtCycle;
+}
+
+// Clear a serviced interrupt. A level triggered IRQ or FIRQ stays active
+// as long as one of its lines is asserted.
+void Mc6809::acknowledge_interrupt(tIrqType type, Event event)
+{
+    interrupt_lines[type] &= ~PULSE_LINE;
+    events &= ~event;
+
+    // if a line has been asserted in another thread check again
+    if (type != INT_NMI && interrupt_lines[type] != 0U)
+    {
+        events |= event;
+    }
+}
+
 cycles_t Mc6809::exec_irqs(bool save_state)
 {
     if ((events & AnyInterrupt) != Event::NONE)
@@ -473,7 +615,7 @@ cycles_t Mc6809::exec_irqs(bool save_state)
         {
             ++interrupt_status.count[INT_NMI];
             EXEC_NMI(save_state);
-            events &= ~Event::Nmi;
+            acknowledge_interrupt(INT_NMI, Event::Nmi);
             return save_state ? 17 : 5;
         }
 
@@ -481,7 +623,7 @@ cycles_t Mc6809::exec_irqs(bool save_state)
         {
             ++interrupt_status.count[INT_FIRQ];
             EXEC_FIRQ(save_state);
-            events &= ~Event::Firq;
+            acknowledge_interrupt(INT_FIRQ, Event::Firq);
             return save_state ? 8 : 5;
         }
 
@@ -489,7 +631,7 @@ cycles_t Mc6809::exec_irqs(bool save_state)
         {
             ++interrupt_status.count[INT_IRQ];
             EXEC_IRQ(save_state);
-            events &= ~Event::Irq;
+            acknowledge_interrupt(INT_IRQ, Event::Irq);
             return save_state ? 17 : 5;
         }
     }
@@ -61,20 +61,18 @@ void Mc6809Logger::checkForActivatingLoopMode(const Mc6809CpuStatus &state)
 {
     if (!isLoopModeActive)
     {
-        const auto iter = std::find_if(cpuStates.cbegin(), cpuStates.cend(),
-                [&](const Mc6809CpuStatus &cpuState){
-                    return cpuState.pc == state.pc;
-                });
-        if (iter != cpuStates.cend())
+        // The loop starts at the last occurrence of the same PC, if it is
+        // still contained in the history.
+        const auto sequence = lastSequenceForPc[state.pc];
+
+        if (sequence >= historyBegin &&
+            nextSequence - sequence <= history.size())
         {
-            cpuStates.erase(iter + 1, cpuStates.cend());
             isLoopModeActive = true;
             loopRepeatCount = 0U;
-            cpuStatesIter = cpuStates.rbegin();
-
-            for_each(cpuStates.crbegin(), cpuStates.crend(),
-                [&](const Mc6809CpuStatus &/* cpuState */){
-                });
+            loopBegin = sequence;
+            loopLength = nextSequence - sequence;
+            loopIndex = 0U;
         }
     }
 }
@@ -90,23 +88,33 @@ void Mc6809Logger::finishLoopMode()
 
     isLoopModeActive = false;
 
-    if (loopRepeatCount == 1 && cpuStatesIter == cpuStates.rbegin())
+    if (loopRepeatCount == 1 && loopIndex == 0U)
     {
         // If only repeated once and loop has finished at the end
         // do a normal logging.
-        auto iter = cpuStates.rend();
-        logQueuedStatesUpTo(iter);
+        logQueuedStates(loopLength);
     }
 
-    if (cpuStatesIter != cpuStates.rbegin())
+    if (loopIndex != 0U)
     {
         // If loop has been quit in the middle do a normal logging.
-        logQueuedStatesUpTo(cpuStatesIter);
+        logQueuedStates(loopIndex);
     }
 
     loopRepeatCount = 0U;
-    cpuStates.clear();
-    cpuStatesIter = cpuStates.rend();
+    loopIndex = 0U;
+    historyBegin = nextSequence;
+}
+
+void Mc6809Logger::resetLoopHistory()
+{
+    if (history.empty())
+    {
+        history.resize(LOOP_HISTORY_SIZE);
+        lastSequenceForPc.resize(0x10000U, 0U);
+    }
+
+    historyBegin = nextSequence;
 }
 
 void Mc6809Logger::doLoopOptimization(const Mc6809CpuStatus &state)
@@ -115,20 +123,22 @@ void Mc6809Logger::doLoopOptimization(const Mc6809CpuStatus &state)
 
     if (isLoopModeActive)
     {
-        if (cpuStatesIter->pc == state.pc &&
-            cpuStatesIter->insn_size == state.insn_size &&
+        auto &loopState = history[(loopBegin + loopIndex) % history.size()];
+
+        if (loopState.pc == state.pc &&
+            loopState.insn_size == state.insn_size &&
                 std::equal(
-                    std::begin(cpuStatesIter->instruction),
-                    std::begin(cpuStatesIter->instruction) + state.insn_size,
+                    std::begin(loopState.instruction),
+                    std::begin(loopState.instruction) + state.insn_size,
                     std::begin(state.instruction)))
         {
             // Identical PC values and instruction size + bytes, continue loop.
             // The instruction size + bytes have to be checked to
             // detect self modifying code which also has to finish loop mode.
-            *(cpuStatesIter++) = state;
-            if (cpuStatesIter == cpuStates.rend())
+            loopState = state;
+            if (++loopIndex == loopLength)
             {
-                cpuStatesIter = cpuStates.rbegin();
+                loopIndex = 0U;
                 ++loopRepeatCount;
             }
         }
@@ -140,7 +150,8 @@ void Mc6809Logger::doLoopOptimization(const Mc6809CpuStatus &state)
     }
     else
     {
-        cpuStates.emplace_front(state);
+        history[nextSequence % history.size()] = state;
+        lastSequenceForPc[state.pc] = nextSequence++;
     }
 }
 
@@ -168,7 +179,7 @@ void Mc6809Logger::logCpuState(const CpuStatus &state)
 void Mc6809Logger::logLoopContent()
 {
     if (loopRepeatCount == 0 ||
-        (loopRepeatCount == 1 && cpuStatesIter == cpuStates.rbegin()))
+        (loopRepeatCount == 1 && loopIndex == 0U))
     {
         return;
     }
@@ -220,8 +231,7 @@ void Mc6809Logger::logLoopContent()
     fctLogRegisters();
     logOfs << "\n";
 
-    auto iter = cpuStates.rend();
-    logQueuedStatesUpTo(iter);
+    logQueuedStates(loopLength);
 
     fctLogCycleCount();
     logOfs << repeat_str;
@@ -230,13 +240,13 @@ void Mc6809Logger::logLoopContent()
     logOfs.flush();
 }
 
-void Mc6809Logger::logQueuedStatesUpTo(
-        std::deque<Mc6809CpuStatus>::reverse_iterator &iter)
+// Log the first count states of the current loop.
+void Mc6809Logger::logQueuedStates(QWord count)
 {
-    for_each(cpuStates.rbegin(), iter,
-        [&](const Mc6809CpuStatus &cpuState){
-            logCpuStatePrivate(cpuState);
-        });
+    for (QWord index = 0U; index < count; ++index)
+    {
+        logCpuStatePrivate(history[(loopBegin + index) % history.size()]);
+    }
 }
 
 void Mc6809Logger::logCpuStatePrivate(const Mc6809CpuStatus &state)
@@ -433,6 +443,10 @@ bool Mc6809Logger::setLoggerConfig(const Mc6809LoggerConfig &loggerConfig)
     }
 
     config = loggerConfig;
+    if (config.isLoopOptimization)
+    {
+        resetLoopHistory();
+    }
     isLoggingActive = !config.startAddr.has_value();
     if (config.format == Mc6809LoggerConfig::Format::Csv)
     {
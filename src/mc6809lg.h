@@ -30,7 +30,7 @@
 #include <fstream>
 #include <string>
 #include <array>
-#include <deque>
+#include <vector>
 
 
 struct CpuStatus;
@@ -54,6 +54,9 @@ private:
     {
         "CC", "A", "B", "DP", "X", "Y", "U", "S"
     };
+    // Maximum number of instructions within a loop which can be detected
+    // by the loop optimization.
+    static constexpr size_t LOOP_HISTORY_SIZE{1024U};
 
     void checkForActivatingLoopMode(const Mc6809CpuStatus &state);
     void finishLoopMode();
@@ -61,8 +64,8 @@ private:
     void logCpuStatePrivate(const Mc6809CpuStatus &state);
     void logCpuStateToText(const Mc6809CpuStatus &state);
     void logCpuStateToCsv(const Mc6809CpuStatus &state);
-    void logQueuedStatesUpTo(
-            std::deque<Mc6809CpuStatus>::reverse_iterator &iter);
+    void logQueuedStates(QWord count);
+    void resetLoopHistory();
     void doLoopOptimization(const Mc6809CpuStatus &state);
     size_t getLogRegisterCount() const;
     static Byte swapBits(Byte reg);
@@ -71,8 +74,17 @@ private:
     std::ofstream logOfs;
     mutable bool isLoggingActive{};
     bool doPrintCsvHeader{};
-    std::deque<Mc6809CpuStatus> cpuStates;
-    std::deque<Mc6809CpuStatus>::reverse_iterator cpuStatesIter;
+    // Loop detection: history is a ring buffer of the last logged states,
+    // indexed by a sequence number. lastSequenceForPc contains for each PC
+    // the sequence number of its last occurrence, so a loop is detected
+    // with a single table lookup.
+    std::vector<Mc6809CpuStatus> history;
+    std::vector<QWord> lastSequenceForPc;
+    QWord nextSequence{1U};
+    QWord historyBegin{1U};
+    QWord loopBegin{};
+    QWord loopLength{};
+    QWord loopIndex{};
     bool isLoopModeActive{};
     uint64_t loopRepeatCount{};
 };
@@ -23,6 +23,8 @@
 
 #include "misc1.h"
 #include "mc6821.h"
+#include "snapshot.h"
+#include <array>
 
 
 void Mc6821::resetIo()
@@ -35,10 +37,48 @@ void Mc6821::resetIo()
     ddrb = 0; // data direction register B
 
     cls = ControlLine::NONE; // control lines CA1, CA2, CB1, CB2
+    reset_irq_A();
+    reset_irq_B();
+}
+
+void Mc6821::saveState(SnapshotWriter &writer)
+{
+    writer.Write(cra);
+    writer.Write(ora);
+    writer.Write(ddra);
+    writer.Write(crb);
+    writer.Write(orb);
+    writer.Write(ddrb);
+    writer.Write(static_cast<Byte>(cls));
+}
+
+RestoreStateFct Mc6821::restoreState(SnapshotReader &reader)
+{
+    std::array<Byte, 7> values{};
+
+    for (auto &value : values)
+    {
+        reader.Read(value);
+    }
+
+    if (!reader.IsValid())
+    {
+        return {};
+    }
 
+    return [this, values](){
+        cra = values[0];
+        ora = values[1];
+        ddra = values[2];
+        crb = values[3];
+        orb = values[4];
+        ddrb = values[5];
+        cls = static_cast<ControlLine>(values[6]);
+    };
 }
 
-Byte Mc6821::readIo(Word offset)
+// Read output register A or B or data direction register A or B.
+Byte Mc6821::readDataRegister(Word offset)
 {
     switch (offset & 0x03U)
     {
@@ -48,6 +88,7 @@ Byte Mc6821::readIo(Word offset)
                 Byte result = readInputA(); // get data from HW-input
                 cra &= 0xBFU; // clear IRQA2 flag
                 cra &= 0x7FU; // clear IRQA1 flag
+                reset_irq_A();
 
                 if ((cra & 0x38U) == 0x20U)
                 {
@@ -61,26 +102,19 @@ Byte Mc6821::readIo(Word offset)
                 return ddra;
             }
 
-        case 1:
-            requestInputA(); // request for input
-            return cra;
-
         case 2:
             if (crb & 0x04U) // check data direction bit
             {
                 Byte result = readInputB(); // get data from HW-input
                 crb &= 0xBFU; // clear IRQB2 flag
                 crb &= 0x7FU; // clear IRQB1 flag
+                reset_irq_B();
                 return result; // read output register B
             }
             else
             {
                 return ddrb;
             }
-
-        case 3:
-            requestInputB(); // request for input
-            return crb;
     }
 
     return 0;
@@ -129,7 +163,9 @@ void Mc6821::writeIo(Word offset, Byte val)
             break;
 
         case 1:
-            cra = val;
+            // The IRQ flags (bit 6 and 7) are read only.
+            cra = (cra & 0xC0U) | (val & 0x3FU);
+            update_irq_A();
 
             if ((cra & 0x30U) == 0x30U)
             {
@@ -164,7 +200,9 @@ void Mc6821::writeIo(Word offset, Byte val)
             break;
 
         case 3:
-            crb = val;
+            // The IRQ flags (bit 6 and 7) are read only.
+            crb = (crb & 0xC0U) | (val & 0x3FU);
+            update_irq_B();
 
             if ((crb & 0x30U) == 0x30U)
             {
@@ -182,6 +220,39 @@ void Mc6821::writeIo(Word offset, Byte val)
     }
 }
 
+// The IRQ output is active as long as an IRQ flag and its enable bit are
+// set. The IRQ2 flag only causes an interrupt if CA2 or CB2 is an input.
+static bool isIrqActive(Byte cr)
+{
+    return (BTST<Byte>(cr, 7U) && BTST<Byte>(cr, 0U)) ||
+           (BTST<Byte>(cr, 6U) && !BTST<Byte>(cr, 5U) &&
+            BTST<Byte>(cr, 3U));
+}
+
+void Mc6821::update_irq_A()
+{
+    if (isIrqActive(cra))
+    {
+        set_irq_A();
+    }
+    else
+    {
+        reset_irq_A();
+    }
+}
+
+void Mc6821::update_irq_B()
+{
+    if (isIrqActive(crb))
+    {
+        set_irq_B();
+    }
+    else
+    {
+        reset_irq_B();
+    }
+}
+
 // write output to port-Pins (should be overwritten by subclass)
 
 void Mc6821::writeOutputA(Byte /*value*/)
@@ -196,6 +267,14 @@ void Mc6821::set_irq_B()
 {
 }
 
+void Mc6821::reset_irq_A()
+{
+}
+
+void Mc6821::reset_irq_B()
+{
+}
+
 
 void Mc6821::writeOutputB(Byte /*value*/)
 {
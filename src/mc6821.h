@@ -61,7 +61,24 @@ protected:
 public:
 
     // IoDevice interface
-    Byte readIo(Word offset) override;
+    // The control registers are polled most often, so reading them is
+    // inlined (see MakeIoDispatch()).
+    Byte readIo(Word offset) override
+    {
+        switch (offset & 0x03U)
+        {
+            case 1:
+                requestInputA(); // request for input
+                return cra;
+
+            case 3:
+                requestInputB(); // request for input
+                return crb;
+
+            default:
+                return readDataRegister(offset);
+        }
+    }
     void writeIo(Word offset, Byte value) override;
     void resetIo() override;
     const char *getName() override
@@ -72,6 +89,8 @@ public:
     {
         return 4;
     }
+    void saveState(SnapshotWriter &writer) override;
+    RestoreStateFct restoreState(SnapshotReader &reader) override;
 
 
 public:
@@ -85,11 +104,20 @@ public:
 
 protected:
 
+    Byte readDataRegister(Word offset);
+    // Set or reset the IRQ output according to the IRQ flags and
+    // their enable bits.
+    void update_irq_A();
+    void update_irq_B();
+
     // read non strobed data
     virtual Byte readInputA();
     virtual Byte readInputB();
     virtual void set_irq_A();
     virtual void set_irq_B();
+    // the IRQ flags have been cleared
+    virtual void reset_irq_A();
+    virtual void reset_irq_B();
 
     // read strobed data
     virtual void requestInputA();
@@ -25,6 +25,8 @@
 #include "misc1.h"
 #include "iodevice.h"
 #include "mc6850.h"
+#include "snapshot.h"
+#include <array>
 
 
 void Mc6850::resetIo()
@@ -35,24 +37,41 @@ void Mc6850::resetIo()
     rdr = 0; // receive data register
 }
 
-Byte Mc6850::readIo(Word offset)
+void Mc6850::saveState(SnapshotWriter &writer)
 {
-    switch (offset & 0x01U)
+    writer.Write(cr);
+    writer.Write(sr);
+    writer.Write(tdr);
+    writer.Write(rdr);
+}
+
+RestoreStateFct Mc6850::restoreState(SnapshotReader &reader)
+{
+    std::array<Byte, 4> values{};
+
+    for (auto &value : values)
     {
-        case 0:
-            sr &= 0x80U; // only receive data register full
-            BSET<Byte>(sr, 1U);
-            requestInput(); // and interrupt request is set
-            // the other status bits are always 0
-            return sr; // return status register
+        reader.Read(value);
+    }
 
-        case 1:
-            rdr = readInput(); // read character
-            BCLR<Byte>(cr, 7U); // reset interrupt flag
-            return rdr; // return receive data register
+    if (!reader.IsValid())
+    {
+        return {};
     }
 
-    return 0; // should never happen
+    return [this, values](){
+        cr = values[0];
+        sr = values[1];
+        tdr = values[2];
+        rdr = values[3];
+    };
+}
+
+Byte Mc6850::readReceiveData()
+{
+    rdr = readInput(); // read character
+    BCLR<Byte>(cr, 7U); // reset interrupt flag
+    return rdr; // return receive data register
 }
 
 // read data from serial line (should be overwritten by subclass)
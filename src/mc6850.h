@@ -46,7 +46,21 @@ protected:
 
 public:
 
-    Byte readIo(Word offset) override;
+    // The status register is polled most often, so reading it is inlined
+    // (see MakeIoDispatch()).
+    Byte readIo(Word offset) override
+    {
+        if ((offset & 0x01U) == 0U)
+        {
+            sr &= 0x80U; // only receive data register full
+            BSET<Byte>(sr, 1U);
+            requestInput(); // and interrupt request is set
+            // the other status bits are always 0
+            return sr; // return status register
+        }
+
+        return readReceiveData();
+    }
     void writeIo(Word offset, Byte value) override;
     void resetIo() override;
     const char *getName() override
@@ -57,11 +71,14 @@ public:
     {
         return 2;
     }
+    void saveState(SnapshotWriter &writer) override;
+    RestoreStateFct restoreState(SnapshotReader &reader) override;
 
     // actions to be done when a character is ready to be received
     virtual void activeTransition();
 
 protected:
+    Byte readReceiveData();
     // read data from serial line
     virtual Byte readInput();
     // write data to serial line
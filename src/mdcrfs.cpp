@@ -125,6 +125,39 @@ Byte MdcrFileSystem::CalculateChecksum(
     return checksum;
 }
 
+MdcrStatus MdcrFileSystem::ReadHeader(
+              std::string &filename,
+              Word &startAddress,
+              Word &endAddress,
+              MiniDcrTape &mdcr)
+{
+    std::vector<Byte> ibuffer;
+
+    if (!mdcr.ReadRecord(ibuffer) ||
+        ibuffer.size() != 13 || ibuffer[0] != 0x55 || ibuffer[12] != 0)
+    {
+        return MdcrStatus::ReadError;
+    }
+
+    auto iter = ibuffer.cbegin() + 1;
+    if (ibuffer[11] != CalculateChecksum(iter, 10))
+    {
+        return MdcrStatus::WrongChecksum;
+    }
+
+    startAddress = flx::getValueBigEndian<Word>(&ibuffer[7]);
+    endAddress = flx::getValueBigEndian<Word>(&ibuffer[9]);
+    if (startAddress > endAddress)
+    {
+        return MdcrStatus::ReadError;
+    }
+
+    iter = ibuffer.cbegin() + 1;
+    filename = GetFilename(iter);
+
+    return MdcrStatus::Success;
+}
+
 MdcrStatus MdcrFileSystem::ReadFile(
               std::string &filename,
               BMemoryBuffer &memory,
@@ -139,30 +172,16 @@ MdcrStatus MdcrFileSystem::ReadFile(
 
     while (true)
     {
-        // Read the file header
-        if (!mdcr.ReadRecord(ibuffer) ||
-            ibuffer.size() != 13 || ibuffer[0] != 0x55 || ibuffer[12] != 0)
-        {
-            return MdcrStatus::ReadError;
-        }
+        std::string mdcrFilename;
 
-        auto iter = ibuffer.cbegin() + 1;
-        if (ibuffer[11] != CalculateChecksum(iter, 10))
-        {
-            return MdcrStatus::WrongChecksum;
-        }
-
-        startAddress = flx::getValueBigEndian<Word>(&ibuffer[7]);
-        endAddress = flx::getValueBigEndian<Word>(&ibuffer[9]);
-        if (startAddress > endAddress)
+        // Read the file header
+        auto status = ReadHeader(mdcrFilename, startAddress, endAddress, mdcr);
+        if (status != MdcrStatus::Success)
         {
-            return MdcrStatus::ReadError;
+            return status;
         }
         size = endAddress - startAddress + 1;
 
-        iter = ibuffer.cbegin() + 1;
-        auto mdcrFilename = GetFilename(iter);
-
         if (filename.empty() || mdcrFilename == filename)
         {
             hasFoundFile = true;
@@ -176,7 +195,7 @@ MdcrStatus MdcrFileSystem::ReadFile(
                 return MdcrStatus::ReadError;
             }
 
-            iter = ibuffer.cbegin() + 1;
+            auto iter = ibuffer.cbegin() + 1;
             if (ibuffer[ibuffer.size() - 2] !=
                 CalculateChecksum(iter, ibuffer.size() - 3))
             {
@@ -372,3 +391,51 @@ MdcrStatus MdcrFileSystem::ForEachFile(MiniDcrTape &mdcr,
     return MdcrStatus::Success;
 }
 
+// Call the iterateFunction for each file header on MDCR tape.
+// Only the header records are read. The data records are skipped by
+// using the record sizes of the tape record index, so the data checksums
+// are not verified.
+// NOLINTNEXTLINE(readability-convert-member-functions-to-static)
+MdcrStatus MdcrFileSystem::ForEachFileHeader(MiniDcrTape &mdcr,
+                  const std::function<MdcrStatus
+                            (const std::string&, Word startAddress,
+                             Word endAddress)>& iterateFunction)
+{
+    DWord index = 0U;
+
+    while (index < mdcr.GetRecordCount())
+    {
+        std::string filename;
+        Word startAddress = 0;
+        Word endAddress = 0;
+
+        mdcr.GotoRecord(index);
+        auto status = ReadHeader(filename, startAddress, endAddress, mdcr);
+        if (status != MdcrStatus::Success)
+        {
+            return status;
+        }
+
+        const size_t size = endAddress - startAddress + 1U;
+        size_t count = 0U;
+
+        for (++index; count < size; ++index)
+        {
+            const auto recordSize = mdcr.GetRecordSize(index);
+
+            if (index >= mdcr.GetRecordCount() || recordSize < 3U)
+            {
+                return MdcrStatus::ReadError;
+            }
+            count += recordSize - 3U;
+        }
+
+        status = iterateFunction(filename, startAddress, endAddress);
+        if (status != MdcrStatus::Success)
+        {
+            return status;
+        }
+    }
+
+    return MdcrStatus::Success;
+}
@@ -58,6 +58,11 @@ class MdcrFileSystem
         static std::string GetFilename(std::vector<Byte>::const_iterator &iter);
         static Byte CalculateChecksum(std::vector<Byte>::const_iterator &iter,
                                size_t size);
+        static MdcrStatus ReadHeader(
+                      std::string &filename,
+                      Word &startAddress,
+                      Word &endAddress,
+                      MiniDcrTape &mdcr);
 
         static const int MaxRecordSize{1024};
 
@@ -78,6 +83,9 @@ class MdcrFileSystem
         MdcrStatus ForEachFile(MiniDcrTape &mdcr,
                 const std::function<MdcrStatus (const std::string&,
                 BMemoryBuffer &memory)>& iterateFunction);
+        MdcrStatus ForEachFileHeader(MiniDcrTape &mdcr,
+                const std::function<MdcrStatus (const std::string&,
+                Word startAddress, Word endAddress)>& iterateFunction);
 
     public:
         MdcrFileSystem() = default;
@@ -23,17 +23,61 @@
 
 #include "mdcrtape.h"
 #include "flexerr.h"
+#include "crc.h"
 #include "sys/stat.h"
+#include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <algorithm>
 #include <memory>
+#include <cstddef>
 
 
 const std::array<char, 4> MiniDcrTape::magic_bytes { 'M', 'D', 'C', 'R' };
+const std::array<char, 4> MiniDcrTape::index_magic_bytes {
+    'M', 'D', 'C', 'I'
+};
+
+// Format of an index file. All values are stored big endian.
+//
+//   4 Byte   Magic number "MDCI"
+//   DWord    Format version
+//   QWord    Size of the tape file
+//   QWord    Modification time of the tape file in nanoseconds
+//   DWord    Number of records n, including the end-of-tape record
+//   n times:
+//     DWord  Record position within the tape file
+//     Word   Record size
+//     Byte   Record type
+//   DWord    CRC32 of all previous bytes
+static const DWord INDEX_VERSION = 2U;
+static const size_t INDEX_HEADER_SIZE = 28U;
+static const size_t INDEX_ENTRY_SIZE = 7U;
+static const DWord CRC32_POLYNOMIAL = 0x04C11DB7U;
+
+// Get the modification time of a file with the resolution of the file
+// system. Whole seconds are not sufficient to detect a tape file which
+// has been modified within the same second as its index file.
+static bool GetModificationTime(const std::string &path, QWord &time)
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    const auto fileTime = fs::last_write_time(fs::path(path), error);
+
+    if (error)
+    {
+        return false;
+    }
+
+    time = static_cast<QWord>(std::chrono::duration_cast<
+            std::chrono::nanoseconds>(fileTime.time_since_epoch()).count());
+    return true;
+}
 
 MiniDcrTape::MiniDcrTape(const std::string &path, Mode mode) :
-    is_write_protected(false)
+    tape_path(path), is_write_protected(false)
 {
     struct stat sbuf{};
 
@@ -60,9 +104,13 @@ MiniDcrTape::MiniDcrTape(const std::string &path, Mode mode) :
                 is_write_protected = true;
             }
 
-            if (!VerifyTape())
+            if (!ReadIndexFile())
             {
-                throw FlexException(FERR_INVALID_FORMAT, path);
+                if (!VerifyTape())
+                {
+                    throw FlexException(FERR_INVALID_FORMAT, path);
+                }
+                is_index_modified = true;
             }
             break;
 
@@ -86,10 +134,11 @@ MiniDcrTape::MiniDcrTape(const std::string &path, Mode mode) :
             stream.close();
             stream.open(path, std::ios::in | std::ios::out | std::ios::binary);
 
-            if (!IsOpen())
+            if (!IsOpen() || !VerifyTape())
             {
                 throw FlexException(FERR_UNABLE_TO_CREATE, path);
             }
+            is_index_modified = true;
             break;
 
         default:
@@ -120,7 +169,17 @@ MiniDcrTapePtr MiniDcrTape::Open(const std::string &path)
 bool MiniDcrTape::Close()
 {
     stream.close();
+    if (is_index_modified)
+    {
+        // Write the index file after the tape file has been closed,
+        // so it contains the final modification time.
+        WriteIndexFile();
+        is_index_modified = false;
+    }
+    image.clear();
     record_positions.clear();
+    record_sizes.clear();
+    record_types.clear();
     record_index = 0;
     return true;
 }
@@ -163,25 +222,37 @@ DWord MiniDcrTape::GetRecordIndex() const
 
 bool MiniDcrTape::ReadRecord(std::vector<Byte> &buffer)
 {
-    if (IsOpen())
+    if (IsOpen() && record_index < record_sizes.size() &&
+        record_sizes[record_index] != 0U)
     {
-        stream.seekg(record_positions[record_index]);
-        Word size = (stream.get() * 256U) & 0xFF00U;
-        size |= static_cast<Byte>(stream.get());
+        const auto size = record_sizes[record_index];
 
-        if (size == 0)
+        if (image.empty())
         {
-            return false;
+            // The record index has been read from the index file,
+            // the tape image is not loaded. Read only this record.
+            buffer.resize(size);
+            stream.seekg(record_positions[record_index] +
+                         static_cast<std::streamoff>(2));
+            stream.read(reinterpret_cast<char *>(buffer.data()), size);
+            if (!stream.good())
+            {
+                stream.clear();
+                return false;
+            }
+        }
+        else
+        {
+            // Copy the record contents from the tape image. The buffer
+            // capacity is reused.
+            const auto *begin = image.data() +
+                static_cast<std::streamoff>(record_positions[record_index]) +
+                2;
+            buffer.assign(begin, begin + size);
         }
-
-        buffer.clear();
-        buffer.resize(size, 0);
-        auto *pbuffer = reinterpret_cast<char *>(buffer.data());
-        // Read the buffer contents
-        stream.read(pbuffer, static_cast<uint32_t>(buffer.size()));
         record_index++;
 
-        return stream.good();
+        return true;
     }
 
     return false;
@@ -191,7 +262,8 @@ bool MiniDcrTape::WriteRecord(const std::vector<Byte> &buffer)
 {
     if (IsOpen())
     {
-        stream.seekp(record_positions[record_index]);
+        const auto position = record_positions[record_index];
+        stream.seekp(position);
         // Write two bytes containing the buffer size
         // Write most significant byte first
         Word size = static_cast<Word>(buffer.size());
@@ -207,25 +279,39 @@ bool MiniDcrTape::WriteRecord(const std::vector<Byte> &buffer)
 
         if (stream.good())
         {
-            record_index++;
-            if (record_index >= record_positions.size())
-            {
-                record_positions.push_back(record_position);
-            }
-            else
+            // The written record replaces the end-of-tape record and all
+            // records behind it. Update the tape image and the record
+            // index accordingly instead of verifying the whole tape again.
+            if (!image.empty())
             {
-                // An old record has been overwitten.
-                // Shrink number of record positions.
-                record_positions[record_index] = record_position;
-                record_positions.resize(record_index + 1);
+                const auto offset =
+                    static_cast<size_t>(static_cast<std::streamoff>(position));
+                image.resize(offset + 2U + size + 2U);
+                image[offset] = static_cast<Byte>(size >> 8U);
+                image[offset + 1U] = static_cast<Byte>(size & 0xFFU);
+                std::copy(buffer.cbegin(), buffer.cend(),
+                          image.begin() +
+                          static_cast<std::ptrdiff_t>(offset + 2U));
+                image[offset + 2U + size] = 0U;
+                image[offset + 3U + size] = 0U;
             }
-            max_pos = record_position;
-            VerifyTape();
+            record_positions.resize(record_index + 1U);
+            record_sizes.resize(record_index + 1U);
+            record_types.resize(record_index + 1U);
+            record_sizes[record_index] = size;
+            record_index++;
+            record_positions.push_back(record_position);
+            record_sizes.push_back(0U);
+            record_types.push_back(RecordType::NONE);
+            UpdateRecordTypes();
+            max_pos = record_position + static_cast<std::streamoff>(2);
+            is_index_modified = true;
         }
         else
         {
             // Write record failed. Position to previous record.
-            stream.seekp(record_positions[record_index]);
+            stream.clear();
+            stream.seekp(position);
         }
 
         return stream.good();
@@ -238,98 +324,79 @@ bool MiniDcrTape::VerifyTape()
 {
     bool result = false;
 
+    image.clear();
     record_positions.clear();
+    record_sizes.clear();
     record_types.clear();
     max_pos = 0;
 
     if (IsOpen())
     {
-        std::vector<Word> record_sizes;
-        static std::array<char, 4> magic_bytes_read { 0, 0, 0, 0 };
         std::ios::pos_type read_pos = stream.tellg();
-        std::ios::pos_type record_position;
 
+        // Read the whole tape into memory.
+        stream.seekg(0, std::ios::end);
+        const auto file_size = static_cast<std::streamoff>(stream.tellg());
         stream.seekg(0);
+        if (stream.fail() || file_size < 0)
+        {
+            stream.clear();
+            return result;
+        }
+        image.resize(static_cast<size_t>(file_size));
+        stream.read(reinterpret_cast<char *>(image.data()), file_size);
+        const bool is_read_failed = stream.fail();
 
-        stream.read(magic_bytes_read.data(), magic_bytes_read.size());
-        if (stream.fail() ||
-            static_cast<size_t>(stream.tellg()) != magic_bytes_read.size() ||
-            magic_bytes_read != MiniDcrTape::magic_bytes)
+        // Restore previous read position.
+        stream.clear();
+        stream.seekg(read_pos);
+
+        if (is_read_failed || image.size() < magic_bytes.size() ||
+            !std::equal(magic_bytes.cbegin(), magic_bytes.cend(),
+                        image.cbegin()))
         {
             // Wrong or incomplete magic number
+            image.clear();
             return result;
         }
 
-        Word size = 0xFFFF;
+        // Build the record index. Each record starts with its size, most
+        // significant byte first. A record of size 0 marks the end of tape.
+        size_t position = magic_bytes.size();
 
-        while (size != 0)
+        while (position + 2U <= image.size())
         {
-            record_position = stream.tellg();
-            size = (static_cast<Byte>(stream.get()) << 8U);
-            size |= (static_cast<Byte>(stream.get()) & 0xFFU);
-            if (stream.eof() || stream.fail())
+            const Word size = static_cast<Word>((image[position] << 8U) |
+                                                image[position + 1U]);
+
+            if (position + 2U + size > image.size())
             {
-                size = 0xFFFF;
                 break;
             }
 
-            stream.seekg(size, std::ios::cur);
+            record_positions.emplace_back(
+                    static_cast<std::streamoff>(position));
+            record_sizes.push_back(size);
+            position += 2U + size;
 
-            if (stream.eof() || stream.fail())
+            if (size == 0)
             {
-                size = 0xFFFF;
+                max_pos = static_cast<std::streamoff>(position);
+                result = true;
                 break;
             }
-
-            record_sizes.push_back(size);
-            record_positions.push_back(record_position);
         }
 
-        if (size == 0)
-        {
-            max_pos = stream.tellg();
-            result = true;
-        }
-
-        // Restore previous read position.
-        stream.seekg(read_pos);
-
         RecordType previous_record_type = RecordType::NONE;
         for (auto sizeIter = record_sizes.crbegin();
              sizeIter < record_sizes.crend();
              ++sizeIter)
         {
-            auto record_type = RecordType::NONE;
-
-            if (*sizeIter == 1027)
-            {
-                record_type = RecordType::Data;
-            }
-            else if (previous_record_type == RecordType::Data ||
-                       previous_record_type == RecordType::LastData)
-            {
-
-                record_type = *sizeIter == 13 ?
-                    RecordType::Header :
-                    RecordType::Data;
-            }
-            else if (previous_record_type == RecordType::NONE ||
-                     previous_record_type == RecordType::Header)
-            {
-                record_type = RecordType::LastData;
-            }
+            const auto record_type =
+                DeriveRecordType(*sizeIter, previous_record_type);
 
             record_types.push_back(record_type);
             previous_record_type = record_type;
-            /*
-            switch(record_type)
-            {
-                case RecordType::NONE: std::cerr << "type=NONE\n"; break;
-                case RecordType::Data: std::cerr << "type=Data\n"; break;
-                case RecordType::LastData: std::cerr << "type=LastData\n"; break;
-                case RecordType::Header: std::cerr << "type=Header\n"; break;
-            }
-            */
         }
         std::reverse(record_types.begin(), record_types.end());
     }
@@ -337,6 +404,44 @@ bool MiniDcrTape::VerifyTape()
     return result;
 }
 
+// The type of a record depends on its size and on the type of the
+// following record.
+RecordType MiniDcrTape::DeriveRecordType(Word size, RecordType next_type)
+{
+    if (size == 1027)
+    {
+        return RecordType::Data;
+    }
+
+    if (next_type == RecordType::Data || next_type == RecordType::LastData)
+    {
+        return size == 13 ? RecordType::Header : RecordType::Data;
+    }
+
+    return RecordType::LastData;
+}
+
+// Update the record types from the end-of-tape record backwards. As soon
+// as a record type does not change all previous ones are also unchanged.
+void MiniDcrTape::UpdateRecordTypes()
+{
+    auto next_type = RecordType::NONE;
+
+    for (auto index = record_types.size(); index > 0U; --index)
+    {
+        const auto record_type =
+            DeriveRecordType(record_sizes[index - 1U], next_type);
+
+        if (index < record_types.size() - 1U &&
+            record_types[index - 1U] == record_type)
+        {
+            break;
+        }
+        record_types[index - 1U] = record_type;
+        next_type = record_type;
+    }
+}
+
 bool MiniDcrTape::GotoPreviousRecord()
 {
     if (!IsOpen() || !record_index)
@@ -350,3 +455,168 @@ bool MiniDcrTape::GotoPreviousRecord()
     return true;
 }
 
+bool MiniDcrTape::GotoRecord(DWord index)
+{
+    if (!IsOpen() || index >= record_positions.size())
+    {
+        return false;
+    }
+
+    record_index = index;
+
+    return true;
+}
+
+// Number of records without the end-of-tape record.
+DWord MiniDcrTape::GetRecordCount() const
+{
+    return record_positions.empty() ?
+        0U : static_cast<DWord>(record_positions.size() - 1U);
+}
+
+Word MiniDcrTape::GetRecordSize(DWord index) const
+{
+    return index < record_sizes.size() ? record_sizes[index] : 0U;
+}
+
+std::string MiniDcrTape::GetIndexFilePath(const std::string &path)
+{
+    return path + ".idx";
+}
+
+// The record index of a tape is cached in an index file. It is only used
+// if the size and exact modification time of the tape file and the checksum
+// match and the tape file contains the end-of-tape record at the indexed
+// position. Then opening a tape does not need to read the tape file.
+bool MiniDcrTape::ReadIndexFile()
+{
+    struct stat sbuf{};
+    QWord mtime{};
+    std::ifstream istream(GetIndexFilePath(tape_path),
+                          std::ios::in | std::ios::binary);
+
+    if (!istream.is_open() || stat(tape_path.c_str(), &sbuf) != 0 ||
+        !GetModificationTime(tape_path, mtime))
+    {
+        return false;
+    }
+
+    const std::vector<Byte> data((std::istreambuf_iterator<char>(istream)),
+                                 std::istreambuf_iterator<char>());
+    const auto *p = data.data();
+
+    if (data.size() < INDEX_HEADER_SIZE + INDEX_ENTRY_SIZE + 4U ||
+        !std::equal(index_magic_bytes.cbegin(), index_magic_bytes.cend(),
+                    data.cbegin()) ||
+        flx::getValueBigEndian<DWord>(&p[4]) != INDEX_VERSION ||
+        flx::getValueBigEndian<QWord>(&p[8]) !=
+            static_cast<QWord>(sbuf.st_size) ||
+        flx::getValueBigEndian<QWord>(&p[16]) != mtime)
+    {
+        return false;
+    }
+
+    const auto count = flx::getValueBigEndian<DWord>(&p[24]);
+    const auto crc_offset = data.size() - 4U;
+    Crc<DWord> crc(CRC32_POLYNOMIAL);
+
+    if (INDEX_HEADER_SIZE + count * INDEX_ENTRY_SIZE != crc_offset ||
+        crc.GetResult(p, p + crc_offset) !=
+            flx::getValueBigEndian<DWord>(&p[crc_offset]))
+    {
+        return false;
+    }
+
+    // Records have to be contiguous, the last one is the end-of-tape record.
+    size_t position = magic_bytes.size();
+    const auto *entry = &p[INDEX_HEADER_SIZE];
+
+    for (DWord index = 0U; index < count; ++index)
+    {
+        const auto record_position = flx::getValueBigEndian<DWord>(entry);
+        const auto size = flx::getValueBigEndian<Word>(&entry[4]);
+        const auto type = entry[6];
+
+        if (record_position != position ||
+            (size == 0U) != (index == count - 1U) ||
+            type > static_cast<Byte>(RecordType::LastData))
+        {
+            record_positions.clear();
+            record_sizes.clear();
+            record_types.clear();
+            return false;
+        }
+        record_positions.emplace_back(
+                static_cast<std::streamoff>(record_position));
+        record_sizes.push_back(size);
+        record_types.push_back(static_cast<RecordType>(type));
+        position += 2U + size;
+        entry += INDEX_ENTRY_SIZE;
+    }
+
+    std::array<char, 2> end_of_tape{ 1, 1 };
+
+    stream.seekg(record_positions.back());
+    stream.read(end_of_tape.data(), end_of_tape.size());
+    if (!stream.good() || position > static_cast<size_t>(sbuf.st_size) ||
+        end_of_tape[0] != '\0' || end_of_tape[1] != '\0')
+    {
+        stream.clear();
+        record_positions.clear();
+        record_sizes.clear();
+        record_types.clear();
+        return false;
+    }
+    stream.seekg(0);
+    max_pos = static_cast<std::streamoff>(position);
+
+    return true;
+}
+
+// Writing the index file is optional. If it fails, e.g. because the
+// directory is write protected, the tape file is verified on each open.
+void MiniDcrTape::WriteIndexFile() const
+{
+    struct stat sbuf{};
+    QWord mtime{};
+
+    if (record_positions.empty() || stat(tape_path.c_str(), &sbuf) != 0 ||
+        !GetModificationTime(tape_path, mtime))
+    {
+        return;
+    }
+
+    std::vector<Byte> data(INDEX_HEADER_SIZE +
+                           record_positions.size() * INDEX_ENTRY_SIZE + 4U);
+    auto *p = data.data();
+
+    std::copy(index_magic_bytes.cbegin(), index_magic_bytes.cend(), p);
+    flx::setValueBigEndian<DWord>(&p[4], INDEX_VERSION);
+    flx::setValueBigEndian<QWord>(&p[8], static_cast<QWord>(sbuf.st_size));
+    flx::setValueBigEndian<QWord>(&p[16], mtime);
+    flx::setValueBigEndian<DWord>(&p[24],
+            static_cast<DWord>(record_positions.size()));
+
+    auto *entry = &p[INDEX_HEADER_SIZE];
+    for (size_t index = 0U; index < record_positions.size(); ++index)
+    {
+        flx::setValueBigEndian<DWord>(entry,
+                static_cast<DWord>(record_positions[index]));
+        flx::setValueBigEndian<Word>(&entry[4], record_sizes[index]);
+        entry[6] = static_cast<Byte>(record_types[index]);
+        entry += INDEX_ENTRY_SIZE;
+    }
+
+    const auto crc_offset = data.size() - 4U;
+    Crc<DWord> crc(CRC32_POLYNOMIAL);
+    flx::setValueBigEndian<DWord>(&p[crc_offset],
+                                  crc.GetResult(p, p + crc_offset));
+
+    std::ofstream ostream(GetIndexFilePath(tape_path),
+                          std::ios::out | std::ios::binary | std::ios::trunc);
+    if (ostream.is_open())
+    {
+        ostream.write(reinterpret_cast<const char *>(data.data()),
+                      static_cast<std::streamsize>(data.size()));
+    }
+}
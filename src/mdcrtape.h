@@ -28,6 +28,7 @@
 #include <array>
 #include <vector>
 #include <fstream>
+#include <string>
 
 
 const int TYPE_MDCR_CONTAINER = 0x100; /* file container with MDCR format */
@@ -57,9 +58,16 @@ private:
 // on Linux gcc 5.4.0
 //    std::basic_fstream<Byte> stream
     std::fstream stream;
+    std::string tape_path;
     bool is_write_protected;
+    bool is_index_modified{false};
     std::ios::pos_type max_pos;
+    // The tape contents is kept in memory. Together with the record index
+    // (position, size and type of each record) reading a record needs
+    // no file access.
+    std::vector<Byte> image;
     std::vector<std::ios::pos_type> record_positions;
+    std::vector<Word> record_sizes;
     std::vector<RecordType> record_types;
     DWord record_index;
 
@@ -83,12 +91,22 @@ public:
     bool ReadRecord(std::vector<Byte> &buffer);
     bool WriteRecord(const std::vector<Byte> &buffer);
     bool GotoPreviousRecord();
+    bool GotoRecord(DWord index);
+    DWord GetRecordCount() const;
+    Word GetRecordSize(DWord index) const;
     bool IsWriteProtected() const;
 
+    static std::string GetIndexFilePath(const std::string &path);
+
     static const std::array<char, 4> magic_bytes;
+    static const std::array<char, 4> index_magic_bytes;
 
 private:
     bool VerifyTape();
+    void UpdateRecordTypes();
+    static RecordType DeriveRecordType(Word size, RecordType next_type);
+    bool ReadIndexFile();
+    void WriteIndexFile() const;
 
 }; // class MiniDcrTape
 
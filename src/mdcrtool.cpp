@@ -62,7 +62,10 @@ static void syntax()
               << "   -u: Convert file names to uppercase.\n"
               << "       Default: Keep file name as is.\n"
               << "   -d <directory>: Directory where to extract files.\n"
-              << "       Default: Current working directory.\n";
+              << "       Default: Current working directory.\n"
+              << "\n"
+              << "   The record index of a MDCR file is cached in "
+                 "<mdcr_file>.idx.\n";
 
 }
 
@@ -101,13 +104,14 @@ static int WriteAppendToMdcrFile(const std::vector<const char *> &ifiles,
     for (const char *ifile : ifiles)
     {
         DWord startAddress = 0;
+        sHexFilePosition position;
 
         memory.Reset();
-        auto result = load_hexfile(ifile, memory, startAddress);
+        auto result = load_hexfile(ifile, memory, startAddress, &position);
         if (result < 0)
         {
             std::cerr << "*** Error in \"" << ifile << "\":\n    ";
-            print_hexfile_error(std::cerr, result);
+            print_hexfile_error(std::cerr, result, position);
             std::cerr << " Ignored.\n";
             continue; // ignore reading input file. Continue with next one.
         }
@@ -244,20 +248,13 @@ static int ListContentOfMdcrFile(const char *ifile)
 
     MdcrFileSystem mdcrfs;
 
-    auto status = mdcrfs.ForEachFile(*mdcr.get(),
+    // Only the file headers are read, the data records are skipped.
+    auto status = mdcrfs.ForEachFileHeader(*mdcr.get(),
                        [](const std::string &filename,
-                          BMemoryBuffer &memory)
+                          Word startAddress, Word endAddress)
     {
-        if (memory.GetAddressRanges().size() != 1)
-        {
-            std::cout << filename << " unknown address range\n";
-        }
-        else
-        {
-            const auto addrRange = memory.GetAddressRanges()[0];
-            std::cout << fmt::format("{} {:04X} {:04X}\n", filename,
-                addrRange.lower(), addrRange.upper());
-        }
+        std::cout << fmt::format("{} {:04X} {:04X}\n", filename,
+            startAddress, endAddress);
         return MdcrStatus::Success;
     });
 
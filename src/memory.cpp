@@ -25,7 +25,10 @@
 #include "memory.h"
 #include "fcnffile.h"
 #include "soptions.h"
+#include "snapshot.h"
+#include "hotcnt.h"
 #include <cstring>
+#include <algorithm>
 #include <iostream>
 #include <fmt/format.h>
 
@@ -208,12 +211,16 @@ void Memory::init_blocks_to_update()
 // base_address The base address of the device
 // size         The I/O address size. Default value: -1.
 //              If -1 the size of the I/O device is used (method sizeOfIo() )
+// dispatch     The functions to read from or write to the device.
+//              Default: Virtual function calls. Use MakeIoDispatch<T>()
+//              for a device class T known at compile time.
 //
 // return false if not successful
 bool Memory::add_io_device(
         IoDevice &device,
         Word base_address,
-        int size /* = -1 */)
+        int size /* = -1 */,
+        IoDispatch dispatch /* = MakeIoDispatch<IoDevice>() */)
 {
     Word sizeOfIo = device.sizeOfIo();
 
@@ -233,7 +240,11 @@ bool Memory::add_io_device(
     {
         return false; // No more I/O devices allowed.
     }
-    ioDevices.push_back(std::ref(device));
+    ioDevices.push_back({ std::ref(device), dispatch });
+#ifdef USE_HOTCOUNTERS
+    ioDeviceCounters.push_back(
+        &HotCounterRegistry::Instance().GetIoDeviceCounters(device.getName()));
+#endif
 
     // To access a device store the device index and it's byte offset
     // in a vector. The vector index is the address - GENIO_BASE.
@@ -252,9 +263,9 @@ bool Memory::add_io_device(
 
 void Memory::reset_io()
 {
-    for (auto deviceRef : ioDevices)
+    for (auto &entry : ioDevices)
     {
-        deviceRef.get().resetIo();
+        entry.device.get().resetIo();
     }
 }
 
@@ -297,6 +308,88 @@ void Memory::switch_mmu(Word offset, Byte val)
     ppage[offset] = vram_ptrs[ppage_index];
 }
 
+// Save RAM, ROM, video RAM and the MMU mapping.
+// A ppage pointer is stored as offset into memory, or as offset into
+// video_ram + memory_size.
+void Memory::save_state(SnapshotWriter &writer) const
+{
+    writer.Write(memory_size);
+    writer.Write(video_ram_size);
+    writer.Write(memory.data(), memory_size);
+    writer.Write(video_ram.data(), video_ram_size);
+    for (const auto *page : ppage)
+    {
+        if (page >= memory.data() && page < memory.data() + memory_size)
+        {
+            writer.Write(static_cast<DWord>(page - memory.data()));
+        }
+        else
+        {
+            writer.Write(static_cast<DWord>(page - video_ram.data()) +
+                         memory_size);
+        }
+    }
+    writer.Write(video_ram_active_bits);
+    writer.Write(ramBank);
+}
+
+// The snapshot can only be restored with the same memory configuration
+// (RAM extension and high memory) which has been used to save it.
+RestoreStateFct Memory::restore_state(SnapshotReader &reader)
+{
+    DWord size;
+    DWord vram_size;
+    std::array<DWord, 16> offsets{};
+    Byte new_video_ram_active_bits;
+    Byte new_ramBank;
+
+    reader.Read(size);
+    reader.Read(vram_size);
+    if (!reader.IsValid() || size != memory_size ||
+        vram_size != video_ram_size)
+    {
+        return {};
+    }
+
+    // The memory contents is read into a temporary buffer, it is only
+    // copied when applying the state.
+    auto new_memory = std::make_shared<std::vector<Byte> >(
+            memory_size + video_ram_size);
+    reader.Read(new_memory->data(), memory_size + video_ram_size);
+    for (auto &offset : offsets)
+    {
+        reader.Read(offset);
+        if (offset + VIDEORAM_SIZE > memory_size + video_ram_size)
+        {
+            return {};
+        }
+    }
+    reader.Read(new_video_ram_active_bits);
+    reader.Read(new_ramBank);
+
+    if (!reader.IsValid())
+    {
+        return {};
+    }
+
+    return [this, new_memory, offsets, new_video_ram_active_bits,
+            new_ramBank](){
+        std::copy_n(new_memory->cbegin(), memory_size, memory.begin());
+        std::copy_n(new_memory->cbegin() + memory_size, video_ram_size,
+                    video_ram.begin());
+        video_ram_active_bits = new_video_ram_active_bits;
+        ramBank = new_ramBank;
+
+        for (size_t i = 0U; i < ppage.size(); ++i)
+        {
+            ppage[i] = (offsets[i] < memory_size) ?
+                memory.data() + offsets[i] :
+                video_ram.data() + (offsets[i] - memory_size);
+        }
+        init_blocks_to_update();
+    };
+}
+
 void Memory::dump_ram_rom(std::ostream &os, Word min, Word max)
 {
     Word address = min;
@@ -357,3 +450,31 @@ void Memory::CopyFrom(const Byte *source, DWord address, DWord size)
     std::memcpy(memory.data() + address, source, secureSize);
 }
 
+#ifdef USE_HOTCOUNTERS
+void Memory::CountIoRead(Byte deviceIndex) const
+{
+    HOT_COUNT(IoRead);
+    HotCounterRegistry::Increment(ioDeviceCounters[deviceIndex]->reads);
+}
+
+void Memory::CountIoWrite(Byte deviceIndex) const
+{
+    HOT_COUNT(IoWrite);
+    HotCounterRegistry::Increment(ioDeviceCounters[deviceIndex]->writes);
+}
+
+void Memory::CountMemoryRead()
+{
+    HOT_COUNT(MemoryRead);
+}
+
+void Memory::CountMemoryWrite()
+{
+    HOT_COUNT(MemoryWrite);
+}
+
+void Memory::CountVideoRamWrite()
+{
+    HOT_COUNT(VideoRamWrite);
+}
+#endif
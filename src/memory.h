@@ -38,6 +38,8 @@
 #include <array>
 #include <iostream>
 
+struct IoDeviceCounters;
+
 // Maximum number of video RAM pointers supported.
 // Each video RAM page has as size of 16KByte.
 
@@ -46,6 +48,8 @@ MAX_VRAM = (4 * 16),
 };
 
 struct sOptions;
+class SnapshotWriter;
+class SnapshotReader;
 
 struct ioDeviceAccess
 {
@@ -53,6 +57,12 @@ struct ioDeviceAccess
     Byte addressOffset{0};
 };
 
+struct ioDeviceEntry
+{
+    std::reference_wrapper<IoDevice> device;
+    IoDispatch dispatch;
+};
+
 class Memory : public MemoryTarget<DWord>, public BObserver
 {
 public:
@@ -73,9 +83,20 @@ private:
     std::vector<Byte> video_ram;
 
     // I/O device access
-    std::vector<std::reference_wrapper<IoDevice> > ioDevices;
+    std::vector<ioDeviceEntry> ioDevices;
     std::vector<ioDeviceAccess> deviceAccess;
     static const Byte NO_DEVICE = 0xFF;
+#ifdef USE_HOTCOUNTERS
+    // The hot path counters are incremented in memory.cpp, so hotcnt.h
+    // is not needed in this header.
+    std::vector<IoDeviceCounters *> ioDeviceCounters;
+
+    void CountIoRead(Byte deviceIndex) const;
+    void CountIoWrite(Byte deviceIndex) const;
+    static void CountMemoryRead();
+    static void CountMemoryWrite();
+    static void CountVideoRamWrite();
+#endif
 
     // interface to video display
     std::array<Byte *, MAX_VRAM> vram_ptrs{};
@@ -91,13 +112,16 @@ private:
 
 public:
 
-    bool add_io_device(IoDevice &device, Word base_address, int size = -1);
+    bool add_io_device(IoDevice &device, Word base_address, int size = -1,
+                       IoDispatch dispatch = MakeIoDispatch<IoDevice>());
 
     // memory interface
 public:
     void reset_io();
     void switch_mmu(Word offset, Byte val);
     void init_blocks_to_update();
+    void save_state(SnapshotWriter &writer) const;
+    RestoreStateFct restore_state(SnapshotReader &reader);
 
     // BObserver interface
 public:
@@ -124,8 +148,12 @@ public:
             {
                 auto offset = access.addressOffset;
 
+#ifdef USE_HOTCOUNTERS
+                CountIoWrite(access.deviceIndex);
+#endif
                 // Write one Byte to memory mapped I/O device.
-                ioDevices[access.deviceIndex].get().writeIo(offset, value);
+                const auto &entry = ioDevices[access.deviceIndex];
+                entry.dispatch.writeIo(entry.device.get(), offset, value);
                 return;
             }
         }
@@ -133,11 +161,17 @@ public:
         if (video_ram_active_bits &
                 (1U << (static_cast<unsigned>(address) >> 12U)))
         {
+#ifdef USE_HOTCOUNTERS
+            CountVideoRamWrite();
+#endif
             changed[(address & 0x3FFFU) / YBLOCK_SIZE] = true;
             *(ppage[address >> 12U] + (address & 0x3FFFU)) = value;
         }
         else
         {
+#ifdef USE_HOTCOUNTERS
+            CountMemoryWrite();
+#endif
             if (address < ROM_BASE)
             {
                 // Use paged memory access to be able to mirror
@@ -162,11 +196,18 @@ public:
             {
                 auto offset = access.addressOffset;
 
+#ifdef USE_HOTCOUNTERS
+                CountIoRead(access.deviceIndex);
+#endif
                 // Read one Byte from memory mapped I/O device.
-                return ioDevices[access.deviceIndex].get().readIo(offset);
+                const auto &entry = ioDevices[access.deviceIndex];
+                return entry.dispatch.readIo(entry.device.get(), offset);
             }
         }
 
+#ifdef USE_HOTCOUNTERS
+        CountMemoryRead();
+#endif
         return *(ppage[address >> 12U] + (address & 0x3FFFU));
     }
 
@@ -24,6 +24,7 @@
 #include "misc1.h"
 #include "cistring.h"
 #include <cctype>
+#include <cerrno>
 #include <iostream>
 #include <sstream>
 #include <functional>
@@ -43,6 +44,7 @@
 #include <algorithm>
 #include <utility>
 #include <regex>
+#include <thread>
 #include <fmt/format.h>
 
 
@@ -993,3 +995,45 @@ std::string flx::updateFilename(std::string path,
     return path;
 }
 
+
+// Convert the number of parallel jobs, e.g. of a command line option.
+// Only a decimal number in the range of 0 up to MAX_JOBS is valid.
+// 0 is converted into the number of CPU cores.
+bool flx::getJobCount(const std::string &str, unsigned &jobs)
+{
+    std::stringstream stream(str);
+    long value{};
+
+    stream.imbue(std::locale("C"));
+    if (!(stream >> value) || !(stream >> std::ws).eof() ||
+        value < 0L || value > static_cast<long>(MAX_JOBS))
+    {
+        return false;
+    }
+
+    jobs = static_cast<unsigned>(value);
+    if (jobs == 0U)
+    {
+        jobs = std::min(std::max(1U, std::thread::hardware_concurrency()),
+                        MAX_JOBS);
+    }
+
+    return true;
+}
+
+#ifdef UNIX
+// Remove a Unix domain socket file, e.g. left over by a previous process.
+// Any other type of file is kept.
+// Return true if the path does not exist (anymore).
+bool flx::removeSocketFile(const std::string &path)
+{
+    struct stat sbuf{};
+
+    if (lstat(path.c_str(), &sbuf) != 0)
+    {
+        return errno == ENOENT;
+    }
+
+    return S_ISSOCK(sbuf.st_mode) && unlink(path.c_str()) == 0;
+}
+#endif
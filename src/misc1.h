@@ -317,6 +317,9 @@ extern bool endsWithPathSeparator(const std::string &path);
 extern bool isAbsolutePath(const std::string &path);
 extern bool isPathsEqual(const std::string &path1, const std::string &path2);
 extern bool isFlexFilename(const std::string &filename);
+#ifdef UNIX
+extern bool removeSocketFile(const std::string &path);
+#endif
 
 extern const char * const white_space;
 
@@ -449,6 +452,10 @@ extern bool askForInput(const std::string &question,
                         const std::string &answers,
                         char default_answer);
 
+// Maximum number of jobs which can be run in parallel.
+constexpr unsigned MAX_JOBS{256U};
+extern bool getJobCount(const std::string &str, unsigned &jobs);
+
 // Locale independent conversion from numeric value to string.
 // Use "C" locale to avoid any locale specific conversions.
 template<typename T>
@@ -32,7 +32,7 @@
 class Memory;
 
 
-class Mmu : public IoDevice
+class Mmu final : public IoDevice
 {
 
     // Internal registers
@@ -98,12 +98,28 @@ Byte Pia1::readInputA()
 
 void Pia1::set_irq_A()
 {
-    Notify(NotifyId::SetIrq);
+    irqA.Assert();
 }
 
 
 void Pia1::set_irq_B()
 {
-    Notify(NotifyId::SetIrq);
+    irqB.Assert();
+}
+
+void Pia1::reset_irq_A()
+{
+    irqA.Deassert();
+}
+
+void Pia1::reset_irq_B()
+{
+    irqB.Deassert();
+}
+
+void Pia1::connect_interrupts(Mc6809 &cpu)
+{
+    irqA.Connect(cpu, INT_IRQ);
+    irqB.Connect(cpu, INT_IRQ);
 }
 
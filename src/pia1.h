@@ -27,14 +27,16 @@
 #include "misc1.h"
 #include "mc6821.h"
 #include "bobservd.h"
+#include "irqline.h"
 #include "soptions.h"
 
 
 class KeyboardIO;
 class Scheduler;
 class BObserver;
+class Mc6809;
 
-class Pia1 : public Mc6821, public BObserved
+class Pia1 final : public Mc6821, public BObserved
 {
 
     // Terminal connected to port A of pia1
@@ -45,6 +47,9 @@ protected:
     KeyboardIO &keyboardIO;
     const struct sOptions &options;
     bool request_a_updated{false};
+    // Level triggered, active while an IRQ flag is set.
+    InterruptLine irqA;
+    InterruptLine irqB;
 
 protected:
 
@@ -52,6 +57,8 @@ protected:
     Byte readInputA() override;
     void set_irq_A() override;
     void set_irq_B() override;
+    void reset_irq_A() override;
+    void reset_irq_B() override;
 
 public:
     Pia1() = delete;
@@ -64,6 +71,7 @@ public:
     Pia1 &operator=(Pia1 &&src) = delete;
 
     void resetIo() override;
+    void connect_interrupts(Mc6809 &cpu);
     const char *getName() override
     {
         return "pia1";
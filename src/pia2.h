@@ -35,7 +35,7 @@ class Mc6809;
 class JoystickIO;
 class KeyboardIO;
 
-class Pia2 : public Mc6821
+class Pia2 final : public Mc6821
 {
 
     // Terminal bell and Joystick connected to Port B
@@ -100,7 +100,7 @@ void Pia2V5::writeOutputA(Byte value)
                 direction = TapeDirection::Rewind;
                 cycles_BET = cpu.get_cycles();
                 cycles_RDC = cpu.get_cycles();
-                delay_RDC = static_cast<QWord>(166.F / ORIGINAL_PERIOD);
+                delay_RDC = ToCycles(166.F);
                 // Prepare for write
                 write_buffer.clear();
                 write_bit_mask = 0x80;
@@ -167,7 +167,7 @@ void Pia2V5::writeOutputA(Byte value)
 
         case 0xc8: // Start read data
             if (direction == TapeDirection::Forward &&
-                cpu.get_cycles() - cycles_BET > delay_BET &&
+                cpu.get_cycles() - cycles_BET > ToCycles(time_BET) &&
                 drive[drive_idx]->GetRecordType() != RecordType::NONE &&
                 read_mode != ReadMode::Init)
             {
@@ -222,18 +222,18 @@ Byte Pia2V5::readInputA()
 
         if (drive[drive_idx]->GetRecordIndex() > 0)
         {
-            delay_RDC = static_cast<QWord>(600000.F / ORIGINAL_PERIOD);
+            delay_RDC = ToCycles(600000.F);
         }
         else
         {
-            delay_RDC = static_cast<QWord>(166.F / ORIGINAL_PERIOD);
+            delay_RDC = ToCycles(166.F);
         }
     }
     else if (cpu.get_cycles() - cycles_RDC > delay_RDC &&
              (read_mode == ReadMode::Read && BTST<Byte>(cra, 7U)))
     {
         cycles_RDC = cpu.get_cycles();
-        delay_RDC = static_cast<QWord>(166.F / ORIGINAL_PERIOD);
+        delay_RDC = ToCycles(166.F);
 
         // Only read a bit if Read Clock (RDC) has been signaled.
         if (read_buffer.empty())
@@ -344,7 +344,7 @@ Byte Pia2V5::readInputB()
 
 void Pia2V5::requestInputA()
 {
-    if (cpu.get_cycles() - cycles_BET > delay_BET)
+    if (cpu.get_cycles() - cycles_BET > ToCycles(time_BET))
     {
         if (direction == TapeDirection::Rewind && drive_idx >= 0)
         {
@@ -399,11 +399,11 @@ void Pia2V5::SetReadModeToInit()
     {
         // When reading the header of the next file
         // there is an extra long delay
-        delay_RDC = static_cast<QWord>(900000.F / ORIGINAL_PERIOD);
+        delay_RDC = ToCycles(900000.F);
     }
     else
     {
-        delay_RDC = static_cast<QWord>(120000.F / ORIGINAL_PERIOD);
+        delay_RDC = ToCycles(120000.F);
     }
 }
 
@@ -471,6 +471,17 @@ bool Pia2V5::mount_drive(const char *path, Word drive_nr)
     return false;
 }
 
+void Pia2V5::set_fast_load(bool p_is_fast_load)
+{
+    is_fast_load = p_is_fast_load;
+}
+
+QWord Pia2V5::ToCycles(float microseconds) const
+{
+    return is_fast_load ? 0U : static_cast<QWord>(microseconds /
+                                                  ORIGINAL_PERIOD);
+}
+
 void Pia2V5::set_debug(const std::string &debugLevel,
                        std::string logFilePath)
 {
@@ -37,7 +37,7 @@
 
 class Mc6809;
 
-class Pia2V5 : public Mc6821
+class Pia2V5 final : public Mc6821
 {
 
     // Philips MDCR digital cassette recorder connected to Port A and B
@@ -73,10 +73,13 @@ private:
     Word debug{0};
     std::string disk_dir;
     std::fstream cdbg;
-    // following delay/cycle variables/constants are multiples of cpu cycles
+    // If true all tape delays are skipped. The monitor gets the next bit
+    // as soon as it polls for it.
+    bool is_fast_load{false};
+    // following delay/cycle variables are multiples of cpu cycles
     QWord delay_RDC{0}; // Delay until a read clock is present
-    // Delay until a begin/end of tape is detected
-    static const QWord delay_BET = static_cast<QWord>(2000.F / ORIGINAL_PERIOD);
+    // Delay until a begin/end of tape is detected in microseconds
+    static constexpr float time_BET{2000.F};
     QWord cycles_RDC{0};
     QWord cycles_BET{0};
     QWord cycles_cdbg{0};
@@ -90,6 +93,7 @@ protected:
 
 public:
     void set_debug(const std::string &debugLevel, std::string logFilePath);
+    void set_fast_load(bool p_is_fast_load);
     void disk_directory(const char *p_disk_dir);
     void mount_all_drives(const std::array<std::string, 2> &paths);
     bool mount_drive(const char *path, Word drive_nr);
@@ -107,6 +111,7 @@ public:
 private:
     void log_buffer(const std::vector<Byte> &buffer);
     void SetReadModeToInit();
+    QWord ToCycles(float microseconds) const;
 };
 
 #endif // PIA2V5_INCLUDED
@@ -0,0 +1,309 @@
+/*
+    replay.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "replay.h"
+#include "schedcpu.h"
+#include <array>
+#include <algorithm>
+#include <iterator>
+
+
+static const std::array<Byte, 8> magic{
+    'F', 'L', 'X', 'R', 'P', 'L', 'Y', 0x1A
+};
+
+static constexpr Byte AFTER_INTERRUPTS{0x80U};
+
+static void WriteLittleEndian(std::ostream &ostream, QWord value,
+                              unsigned byteCount)
+{
+    for (unsigned i = 0U; i < byteCount; ++i)
+    {
+        ostream.put(static_cast<char>(value & 0xFFU));
+        value >>= 8U;
+    }
+}
+
+ReplayLog::ReplayLog(ScheduledCpu &p_cpu)
+    : cpu(p_cpu)
+{
+}
+
+ReplayLog::~ReplayLog()
+{
+    Stop();
+}
+
+bool ReplayLog::StartRecording(const std::string &path,
+                               const std::vector<Byte> &p_snapshotData,
+                               const std::string &p_startupCommand)
+{
+    ofs.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open())
+    {
+        return false;
+    }
+
+    previousCycle = cpu.get_cycles();
+    ofs.write(reinterpret_cast<const char *>(magic.data()), magic.size());
+    WriteLittleEndian(ofs, FORMAT_VERSION, 4U);
+    WriteLittleEndian(ofs, p_startupCommand.size(), 4U);
+    ofs.write(p_startupCommand.data(),
+              static_cast<std::streamsize>(p_startupCommand.size()));
+    WriteLittleEndian(ofs, p_snapshotData.size(), 4U);
+    ofs.write(reinterpret_cast<const char *>(p_snapshotData.data()),
+              static_cast<std::streamsize>(p_snapshotData.size()));
+    WriteLittleEndian(ofs, previousCycle, 8U);
+    ofs.flush();
+    isRecording = ofs.good();
+
+    return isRecording;
+}
+
+void ReplayLog::Stop()
+{
+    if (isRecording)
+    {
+        Record(Input::End);
+        ofs.close();
+        isRecording = false;
+    }
+}
+
+void ReplayLog::WriteCycles(QWord cycles)
+{
+    do
+    {
+        auto value = static_cast<Byte>(cycles & 0x7FU);
+
+        cycles >>= 7U;
+        if (cycles != 0U)
+        {
+            value |= 0x80U;
+        }
+        ofs.put(static_cast<char>(value));
+    } while (cycles != 0U);
+}
+
+void ReplayLog::Record(Input input, Byte value, bool isAfterInterrupts)
+{
+    if (!isRecording)
+    {
+        return;
+    }
+
+    const auto cycle = cpu.get_cycles();
+
+    ofs.put(static_cast<char>(static_cast<Byte>(input) |
+                              (isAfterInterrupts ? AFTER_INTERRUPTS : 0U)));
+    WriteCycles(cycle - previousCycle);
+    previousCycle = cycle;
+    if (input == Input::SerialKey)
+    {
+        ofs.put(static_cast<char>(value));
+    }
+    else
+    {
+        // Inputs other than keys are rare. Flushing them keeps the log
+        // usable even if the emulator crashes.
+        ofs.flush();
+    }
+}
+
+bool ReplayLog::StartReplay(const std::string &path)
+{
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+
+    if (!ifs.is_open())
+    {
+        return false;
+    }
+
+    data.assign(std::istreambuf_iterator<char>(ifs),
+                std::istreambuf_iterator<char>());
+    if (ifs.bad() || data.size() < magic.size() + 4U ||
+        !std::equal(magic.cbegin(), magic.cend(), data.cbegin()))
+    {
+        return false;
+    }
+
+    size_t position = magic.size();
+    const auto readLittleEndian = [&](unsigned byteCount, QWord &value)
+    {
+        value = 0U;
+        if (position + byteCount > data.size())
+        {
+            return false;
+        }
+        for (unsigned i = 0U; i < byteCount; ++i)
+        {
+            value |= static_cast<QWord>(data[position++]) << (8U * i);
+        }
+        return true;
+    };
+    const auto readBytes = [&](size_t size, auto &target)
+    {
+        if (position + size > data.size())
+        {
+            return false;
+        }
+        const auto iter = data.cbegin() + static_cast<std::ptrdiff_t>(position);
+        target.assign(iter, iter + static_cast<std::ptrdiff_t>(size));
+        position += size;
+        return true;
+    };
+    QWord version{};
+    QWord size{};
+    QWord startCycle{};
+
+    if (!readLittleEndian(4U, version) || version != FORMAT_VERSION ||
+        !readLittleEndian(4U, size) || !readBytes(size, startupCommand) ||
+        !readLittleEndian(4U, size) || !readBytes(size, snapshotData) ||
+        !readLittleEndian(8U, startCycle))
+    {
+        return false;
+    }
+
+    serialStream = { position, startCycle, {}, false };
+    FindNextRecord(serialStream, true);
+    schedulerStream = { position, startCycle, {}, false };
+    FindNextRecord(schedulerStream, false);
+    isReplaying = true;
+
+    return true;
+}
+
+// A truncated or invalid record ends the replay.
+bool ReplayLog::ReadRecord(sStream &stream, sRecord &record) const
+{
+    if (stream.position >= data.size())
+    {
+        return false;
+    }
+
+    const auto header = data[stream.position++];
+    record.input = static_cast<Input>(header & ~AFTER_INTERRUPTS);
+    record.isAfterInterrupts = (header & AFTER_INTERRUPTS) != 0U;
+    if (record.input == Input::NONE || record.input > Input::End)
+    {
+        return false;
+    }
+
+    QWord cycles = 0U;
+    Byte value;
+    unsigned shift = 0U;
+    do
+    {
+        if (stream.position >= data.size() || shift >= 64U)
+        {
+            return false;
+        }
+        value = data[stream.position++];
+        cycles |= static_cast<QWord>(value & 0x7FU) << shift;
+        shift += 7U;
+    } while ((value & 0x80U) != 0U);
+
+    record.value = 0U;
+    if (record.input == Input::SerialKey)
+    {
+        if (stream.position >= data.size())
+        {
+            return false;
+        }
+        record.value = data[stream.position++];
+    }
+
+    stream.cycle += cycles;
+    record.cycle = stream.cycle;
+
+    return true;
+}
+
+void ReplayLog::FindNextRecord(sStream &stream, bool isSerial) const
+{
+    sRecord record{};
+
+    while (ReadRecord(stream, record))
+    {
+        const bool isSerialInput = record.input == Input::SerialKey ||
+                                   record.input == Input::SerialEof;
+
+        if (isSerialInput == isSerial)
+        {
+            stream.record = record;
+            stream.isValid = true;
+            return;
+        }
+    }
+
+    stream.position = data.size();
+    stream.isValid = false;
+}
+
+bool ReplayLog::GetSerialInput(Input &input, Byte &value)
+{
+    if (!serialStream.isValid ||
+        serialStream.record.cycle > cpu.get_cycles())
+    {
+        return false;
+    }
+
+    input = serialStream.record.input;
+    value = serialStream.record.value;
+    FindNextRecord(serialStream, true);
+
+    return true;
+}
+
+bool ReplayLog::GetSchedulerInput(Input &input)
+{
+    if (!IsSchedulerInputDue())
+    {
+        return false;
+    }
+
+    input = schedulerStream.record.input;
+    FindNextRecord(schedulerStream, false);
+
+    return true;
+}
+
+bool ReplayLog::IsSchedulerInputDue() const
+{
+    return schedulerStream.isValid &&
+           schedulerStream.record.cycle <= cpu.get_cycles();
+}
+
+bool ReplayLog::GetNextSchedulerCycle(QWord &cycle,
+                                      bool &isAfterInterrupts) const
+{
+    if (!schedulerStream.isValid)
+    {
+        return false;
+    }
+
+    cycle = schedulerStream.record.cycle;
+    isAfterInterrupts = schedulerStream.record.isAfterInterrupts;
+
+    return true;
+}
+
@@ -0,0 +1,152 @@
+/*
+    replay.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef REPLAY_INCLUDED
+#define REPLAY_INCLUDED
+
+#include "typedefs.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+class ScheduledCpu;
+
+// A replay log records all non-deterministic inputs of the emulation
+// tagged with the total CPU cycle count when they have been received.
+// Replaying it restores the machine snapshot taken at the start of the
+// recording and passes each input at exactly the same instruction to
+// the emulation again, independent of the host time.
+//
+// Binary format of a replay log. All values are stored little endian.
+//
+//   8 Byte   Magic number "FLXRPLY\x1A"
+//   DWord    Format version
+//   DWord    Length n of startup command
+//   n Byte   Startup command
+//   DWord    Length m of machine snapshot
+//   m Byte   Machine snapshot (see snapshot.h)
+//   QWord    Total cycle count at start of recording
+//   Records until end of file, each record:
+//     Byte   Bit 0..6: Input, bit 7: CPU stopped after executing
+//            pending interrupts (only used for scheduler inputs)
+//     1..10  Byte, cycle count since previous record, 7 bit per byte,
+//            least significant first, bit 7 set if more bytes follow
+//     Byte   Value (only for Input::SerialKey)
+//
+// The records are only appended, so even the log of a crashed emulator
+// can be replayed up to the last flushed record.
+// Recording and replaying has to be done within the CPU thread or
+// before it is started.
+
+class ReplayLog
+{
+public:
+    static constexpr DWord FORMAT_VERSION{1U};
+
+    enum class Input : Byte
+    {
+        NONE = 0U,
+        SerialKey = 1U, // Terminal: A key has been received
+        SerialEof = 2U, // Terminal: End of input
+        Second = 3U,    // One second update, e.g. of the real time clock
+        End = 4U,       // End of recording
+    };
+
+    ReplayLog() = delete;
+    explicit ReplayLog(ScheduledCpu &p_cpu);
+    ~ReplayLog();
+    ReplayLog(const ReplayLog &src) = delete;
+    ReplayLog(ReplayLog &&src) = delete;
+    ReplayLog &operator=(const ReplayLog &src) = delete;
+    ReplayLog &operator=(ReplayLog &&src) = delete;
+
+    bool StartRecording(const std::string &path,
+                        const std::vector<Byte> &snapshotData,
+                        const std::string &startupCommand);
+    bool StartReplay(const std::string &path);
+    // Recording: Append an end record and close the file.
+    void Stop();
+
+    bool IsRecording() const
+    {
+        return isRecording;
+    }
+    bool IsReplaying() const
+    {
+        return isReplaying;
+    }
+    const std::vector<Byte> &GetSnapshot() const
+    {
+        return snapshotData;
+    }
+    const std::string &GetStartupCommand() const
+    {
+        return startupCommand;
+    }
+
+    void Record(Input input, Byte value = 0U, bool isAfterInterrupts = false);
+
+    // Replay: Get the next terminal or scheduler input if it is due at the
+    // current cycle count.
+    bool GetSerialInput(Input &input, Byte &value);
+    bool GetSchedulerInput(Input &input);
+    bool IsSchedulerInputDue() const;
+    bool GetNextSchedulerCycle(QWord &cycle, bool &isAfterInterrupts) const;
+
+private:
+    struct sRecord
+    {
+        Input input;
+        Byte value;
+        bool isAfterInterrupts;
+        QWord cycle;
+    };
+
+    // Position and cycle count within the replayed records and the next
+    // record of the terminal or the scheduler inputs.
+    struct sStream
+    {
+        size_t position;
+        QWord cycle;
+        sRecord record;
+        bool isValid;
+    };
+
+    void WriteCycles(QWord cycles);
+    bool ReadRecord(sStream &stream, sRecord &record) const;
+    void FindNextRecord(sStream &stream, bool isSerial) const;
+
+    ScheduledCpu &cpu;
+    std::ofstream ofs;
+    std::vector<Byte> data;
+    std::vector<Byte> snapshotData;
+    std::string startupCommand;
+    sStream serialStream{};
+    sStream schedulerStream{};
+    QWord previousCycle{};
+    bool isRecording{};
+    bool isReplaying{};
+};
+
+#endif // REPLAY_INCLUDED
+
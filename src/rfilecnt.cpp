@@ -22,7 +22,9 @@
 
 #include "rfilecnt.h"
 #include "flexerr.h"
+#include <algorithm>
 #include <cstring>
+#include <sstream>
 
 
 FlexRamDisk::FlexRamDisk(const std::string &p_path, std::ios::openmode mode,
@@ -55,6 +57,54 @@ FlexRamDisk::FlexRamDisk(const std::string &p_path, std::ios::openmode mode,
     {
         throw FlexException(FERR_READING_FROM, path);
     }
+    dirty_sectors.resize(sectors);
+}
+
+FlexRamDisk::FlexRamDisk(const std::string &p_name,
+                         const FileTimeAccess &p_fileTimeAccess,
+                         int tracks, int sectors, int fmt)
+    : FlexDisk(p_name, p_fileTimeAccess)
+    , is_scratch(true)
+{
+    std::stringstream stream;
+
+    if (fmt != TYPE_DSK_DISKFILE && fmt != TYPE_FLX_DISKFILE)
+    {
+        throw FlexException(FERR_INVALID_FORMAT, fmt);
+    }
+
+    if (!Format_disk(stream, p_name, tracks, sectors, fmt))
+    {
+        throw FlexException(FERR_UNABLE_TO_FORMAT, path);
+    }
+
+    const auto image = stream.str();
+
+    if (fmt == TYPE_FLX_DISKFILE)
+    {
+        std::memcpy(&flx_header, image.data(), sizeof(flx_header));
+        Initialize_for_flx_format(flx_header);
+        file_size = static_cast<DWord>(image.size());
+    }
+    else
+    {
+        s_formats format{};
+
+        format.size = static_cast<SDWord>(image.size());
+        format.tracks = static_cast<Word>(tracks);
+        format.sectors = static_cast<Word>(sectors);
+        Initialize_for_dsk_format(format);
+        // On a newly formatted disk the directory sectors on track 0
+        // are already evaluated by Initialize_for_dsk_format().
+        if (!onTrack0OnlyDirSectors)
+        {
+            param.max_sector0 = param.max_sector;
+        }
+    }
+
+    is_flex_format = true;
+    param.type |= TYPE_RAM_DISKFILE;
+    file_buffer.assign(image.cbegin() + param.offset, image.cend());
 }
 
 FlexRamDisk::~FlexRamDisk()
@@ -77,32 +127,13 @@ bool FlexRamDisk::close()
 
     if (fstream.is_open())
     {
-        // Only if the buffer contents has been changed it
-        // will be written to file.
-        if (is_dirty && !file_buffer.empty())
-        {
-            unsigned int sectors;
-
-            sectors = (file_size - param.offset) / param.byte_p_sector;
-
-            fstream.seekg(param.offset);
-            if (fstream.fail())
-            {
-                throwException = true;
-            }
-
-            fstream.write(reinterpret_cast<const char *>(file_buffer.data()),
-                          param.byte_p_sector * sectors);
-            if (fstream.fail())
-            {
-                throwException = true;
-            }
-        }
-
+        // Only sectors which have been changed are written to file.
+        throwException = !WriteDirtySectors();
         fstream.close();
     }
 
     file_buffer.clear();
+    dirty_sectors.clear();
 
     if (throwException)
     {
@@ -112,6 +143,80 @@ bool FlexRamDisk::close()
     return true;
 }
 
+bool FlexRamDisk::Flush()
+{
+    if (!fstream.is_open())
+    {
+        // A scratch disk has nothing to be written.
+        return is_scratch;
+    }
+
+    if (!WriteDirtySectors())
+    {
+        return false;
+    }
+
+    fstream.flush();
+
+    return !fstream.fail();
+}
+
+bool FlexRamDisk::IsScratch() const
+{
+    return is_scratch;
+}
+
+void FlexRamDisk::Detach()
+{
+    fstream.close();
+    std::fill(dirty_sectors.begin(), dirty_sectors.end(), false);
+}
+
+// Write all changed sectors to file. Each run of consecutive changed
+// sectors is written at once. On success the sectors are marked as
+// unchanged.
+bool FlexRamDisk::WriteDirtySectors()
+{
+    const auto count = dirty_sectors.size();
+    size_t index = 0U;
+
+    while (index < count)
+    {
+        if (!dirty_sectors[index])
+        {
+            ++index;
+            continue;
+        }
+
+        auto end = index + 1U;
+        while (end < count && dirty_sectors[end])
+        {
+            ++end;
+        }
+
+        const auto offset = index * param.byte_p_sector;
+
+        fstream.seekg(param.offset + offset);
+        if (fstream.fail())
+        {
+            return false;
+        }
+
+        fstream.write(reinterpret_cast<const char *>(&file_buffer[offset]),
+                      (end - index) * param.byte_p_sector);
+        if (fstream.fail())
+        {
+            return false;
+        }
+
+        std::fill(dirty_sectors.begin() + index, dirty_sectors.begin() + end,
+                  false);
+        index = end;
+    }
+
+    return true;
+}
+
 bool FlexRamDisk::ReadSector(Byte *pbuffer, int trk, int sec,
                              int side /* = -1 */) const
 {
@@ -161,8 +266,12 @@ bool FlexRamDisk::WriteSector(const Byte *pbuffer, int trk, int sec,
         return false;
     }
 
-    is_dirty = true;
+    if (!is_scratch)
+    {
+        dirty_sectors[pos / param.byte_p_sector] = true;
+    }
     std::memcpy(&file_buffer[pos], pbuffer, param.byte_p_sector);
+    UpdateDirectoryCache(pbuffer, trk, sec);
 
     return true;
 }
@@ -28,15 +28,18 @@
 #include <vector>
 
 // class FlexRamDisk is a specialization of FlexDisk where the whole disk
-// image is stored in RAM for improved performance. The disk image is only
-// written back to disk if there are changes (see is_dirty flag).
+// image is stored in RAM for improved performance. Only changed sectors
+// are written back to disk (see dirty_sectors).
+// A scratch disk has no backing file. It is formatted in memory and
+// its contents is lost when it is destroyed.
 class FlexRamDisk : public FlexDisk
 {
 
 private:
 
     std::vector<Byte> file_buffer;
-    bool is_dirty{};
+    std::vector<bool> dirty_sectors; // One flag for each sector.
+    bool is_scratch{};
 
 public:
 
@@ -45,6 +48,10 @@ public:
     FlexRamDisk(FlexRamDisk &&src) = delete;
     FlexRamDisk(const std::string &p_path, std::ios::openmode mode,
                 const FileTimeAccess &fileTimeAccess);
+    // Create a formatted scratch disk. p_name is used as path and disk name.
+    FlexRamDisk(const std::string &p_name,
+                const FileTimeAccess &fileTimeAccess,
+                int tracks, int sectors, int fmt = TYPE_DSK_DISKFILE);
     ~FlexRamDisk() override;
 
     FlexRamDisk &operator= (const FlexRamDisk &src) = delete;
@@ -55,8 +62,16 @@ public:
     bool WriteSector(const Byte *buffer, int trk, int sec,
                      int side = -1) override;
 
+    // Write all changed sectors back to the disk image file.
+    bool Flush();
+    bool IsScratch() const;
+    // Close the disk image file. Afterwards changes are only kept in
+    // memory, they are lost when the disk is destroyed.
+    void Detach();
+
 private:
     bool close();
+    bool WriteDirtySectors();
 };
 
 #endif // RFILECNT_INCLUDED
@@ -0,0 +1,287 @@
+/*
+    rgxlist.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "misc1.h"
+#include "rgxlist.h"
+#include <algorithm>
+#include <utility>
+
+
+void RegexList::Add(const std::string &pattern, bool isCaseSensitive)
+{
+    auto flags = std::regex_constants::extended;
+    if (!isCaseSensitive)
+    {
+        flags |= std::regex_constants::icase;
+    }
+
+    regexs.emplace_back(pattern, flags);
+
+    const auto index = regexs.size() - 1U;
+    const auto caseIndex = isCaseSensitive ? 1U : 0U;
+    auto prefix = GetLiteralPrefix(pattern);
+    auto suffix = GetLiteralSuffix(pattern);
+
+    if (!isCaseSensitive)
+    {
+        prefix = flx::tolower(prefix);
+        suffix = flx::tolower(suffix);
+    }
+
+    if (prefix.empty() && suffix.empty())
+    {
+        unindexed.push_back(index);
+    }
+    else if (prefix.size() >= suffix.size())
+    {
+        prefixes[caseIndex][prefix].push_back(index);
+    }
+    else
+    {
+        suffixes[caseIndex][suffix].push_back(index);
+    }
+}
+
+size_t RegexList::FindFirst(const std::string &text) const
+{
+    std::vector<size_t> candidates(unindexed);
+    const std::array<std::string, 2> keys{ flx::tolower(text), text };
+
+    for (size_t caseIndex = 0U; caseIndex < keys.size(); ++caseIndex)
+    {
+        const auto &key = keys[caseIndex];
+
+        for (size_t length = 1U; length <= key.size(); ++length)
+        {
+            AddCandidates(candidates, prefixes[caseIndex],
+                          key.substr(0U, length));
+            AddCandidates(candidates, suffixes[caseIndex],
+                          key.substr(key.size() - length));
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    for (auto index : candidates)
+    {
+        if (std::regex_search(text, regexs[index]))
+        {
+            return index;
+        }
+    }
+
+    return npos;
+}
+
+std::vector<std::string> RegexList::Select(
+        const std::vector<std::string> &texts) const
+{
+    // First: Index of regular expression, second: Index of text.
+    std::vector<std::pair<size_t, size_t> > matches;
+    std::vector<std::string> result;
+
+    for (size_t textIndex = 0U; textIndex < texts.size(); ++textIndex)
+    {
+        const auto index = FindFirst(texts[textIndex]);
+
+        if (index != npos)
+        {
+            matches.emplace_back(index, textIndex);
+        }
+    }
+
+    std::sort(matches.begin(), matches.end());
+    result.reserve(matches.size());
+    for (const auto &match : matches)
+    {
+        result.push_back(texts[match.second]);
+    }
+
+    return result;
+}
+
+// Return the literal which has to be at the beginning of each text in
+// which pattern is found, e.g. "TEST" for "^TEST[0-9]*\.TXT".
+std::string RegexList::GetLiteralPrefix(const std::string &pattern)
+{
+    std::vector<sToken> tokens;
+    std::string prefix;
+
+    if (!Tokenize(pattern, tokens) || tokens.empty() ||
+        tokens[0].isLiteral || tokens[0].ch != '^')
+    {
+        return prefix;
+    }
+
+    size_t index = 1U;
+    for (; index < tokens.size() && tokens[index].isLiteral; ++index)
+    {
+        prefix.push_back(tokens[index].ch);
+    }
+
+    // A quantifier applies to the last literal character.
+    if (!prefix.empty() && index < tokens.size() &&
+        std::string("*+?{").find(tokens[index].ch) != std::string::npos)
+    {
+        prefix.pop_back();
+    }
+
+    return prefix;
+}
+
+// Return the literal which has to be at the end of each text in
+// which pattern is found, e.g. ".CMD" for "[A-Z]+\.CMD$".
+std::string RegexList::GetLiteralSuffix(const std::string &pattern)
+{
+    std::vector<sToken> tokens;
+    std::string suffix;
+
+    if (!Tokenize(pattern, tokens) || tokens.size() < 2U ||
+        tokens.back().isLiteral || tokens.back().ch != '$')
+    {
+        return suffix;
+    }
+
+    auto index = tokens.size() - 1U;
+    while (index > 0U && tokens[index - 1U].isLiteral)
+    {
+        --index;
+    }
+
+    for (; index < tokens.size() - 1U; ++index)
+    {
+        suffix.push_back(tokens[index].ch);
+    }
+
+    return suffix;
+}
+
+// Split pattern into literal characters and other tokens. A bracket
+// expression or an interval is one token. Returns false if the pattern
+// contains an alternative or can not be split.
+bool RegexList::Tokenize(const std::string &pattern,
+                         std::vector<sToken> &tokens)
+{
+    static const std::string escapedLiterals(".[]()*+?{}|^$\\");
+    static const std::string specialChars(".()*+?}]^$");
+    const auto size = pattern.size();
+
+    tokens.clear();
+    for (size_t index = 0U; index < size; ++index)
+    {
+        const char ch = pattern[index];
+
+        switch (ch)
+        {
+            case '|':
+                return false;
+
+            case '\\':
+                ++index;
+                if (index < size &&
+                    escapedLiterals.find(pattern[index]) != std::string::npos)
+                {
+                    tokens.push_back({ pattern[index], true });
+                }
+                else
+                {
+                    // Any other escape sequence, e.g. a back reference.
+                    tokens.push_back({ ch, false });
+                }
+                break;
+
+            case '[':
+                {
+                    auto pos = index + 1U;
+
+                    if (pos < size && pattern[pos] == '^')
+                    {
+                        ++pos;
+                    }
+                    if (pos < size && pattern[pos] == ']')
+                    {
+                        ++pos;
+                    }
+                    while (pos < size && pattern[pos] != ']')
+                    {
+                        // Skip a character class, collating symbol or
+                        // equivalence class, e.g. "[:alpha:]".
+                        if (pattern[pos] == '[' && pos + 1U < size &&
+                            std::string(":.=").find(pattern[pos + 1U]) !=
+                                std::string::npos)
+                        {
+                            const char end[] = { pattern[pos + 1U], ']', '\0' };
+
+                            pos = pattern.find(end, pos + 2U);
+                            if (pos == std::string::npos)
+                            {
+                                return false;
+                            }
+                            ++pos;
+                        }
+                        ++pos;
+                    }
+                    if (pos >= size)
+                    {
+                        return false;
+                    }
+                    index = pos;
+                    tokens.push_back({ ch, false });
+                }
+                break;
+
+            case '{':
+                index = pattern.find('}', index);
+                if (index == std::string::npos)
+                {
+                    return false;
+                }
+                tokens.push_back({ ch, false });
+                break;
+
+            default:
+                tokens.push_back(
+                        { ch, specialChars.find(ch) == std::string::npos });
+                break;
+        }
+    }
+
+    return true;
+}
+
+void RegexList::AddCandidates(std::vector<size_t> &candidates,
+                              const KeyMap &keyMap, const std::string &key)
+{
+    if (keyMap.empty())
+    {
+        return;
+    }
+
+    const auto iter = keyMap.find(key);
+
+    if (iter != keyMap.end())
+    {
+        candidates.insert(candidates.end(), iter->second.cbegin(),
+                          iter->second.cend());
+    }
+}
+
@@ -0,0 +1,97 @@
+/*
+    rgxlist.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef RGXLIST_INCLUDED
+#define RGXLIST_INCLUDED
+
+#include <array>
+#include <limits>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// A list of regular expressions in POSIX extended syntax used to select
+// file names.
+// To avoid searching each regular expression in each text, a regular
+// expression starting with a literal ("^TEST") or ending with a literal
+// ("\.CMD$") is indexed by this literal. Only regular expressions indexed
+// by a prefix or suffix of the text and the ones without such a literal
+// are searched in the text.
+class RegexList
+{
+public:
+    static constexpr size_t npos{std::numeric_limits<size_t>::max()};
+
+    RegexList() = default;
+    ~RegexList() = default;
+    RegexList(const RegexList &src) = delete;
+    RegexList(RegexList &&src) = default;
+    RegexList &operator=(const RegexList &src) = delete;
+    RegexList &operator=(RegexList &&src) = default;
+
+    // Throws std::regex_error if pattern is no valid regular expression.
+    void Add(const std::string &pattern, bool isCaseSensitive);
+    bool IsEmpty() const
+    {
+        return regexs.empty();
+    }
+    size_t GetCount() const
+    {
+        return regexs.size();
+    }
+    // Return the index of the first regular expression found in text
+    // or npos if there is none.
+    size_t FindFirst(const std::string &text) const;
+    // Return all texts in which any regular expression is found.
+    // The result is ordered by the index of the first regular expression
+    // found and then by the order of texts.
+    std::vector<std::string> Select(const std::vector<std::string> &texts)
+        const;
+
+    static std::string GetLiteralPrefix(const std::string &pattern);
+    static std::string GetLiteralSuffix(const std::string &pattern);
+
+private:
+    struct sToken
+    {
+        char ch; // The literal character or the first character of a token.
+        bool isLiteral;
+    };
+
+    using KeyMap = std::unordered_map<std::string, std::vector<size_t> >;
+
+    static bool Tokenize(const std::string &pattern,
+                         std::vector<sToken> &tokens);
+    static void AddCandidates(std::vector<size_t> &candidates,
+                              const KeyMap &keyMap, const std::string &key);
+
+    std::vector<std::regex> regexs;
+    // Index 0: Case insensitive, keys are lower case. 1: Case sensitive.
+    std::array<KeyMap, 2> prefixes;
+    std::array<KeyMap, 2> suffixes;
+    std::vector<size_t> unindexed;
+};
+
+#endif // RGXLIST_INCLUDED
+
@@ -68,6 +68,10 @@ public:
     virtual CpuStatusPtr create_status_object() = 0;
     virtual void get_interrupt_status(tInterruptStatus &s) = 0;
     virtual void set_required_cyclecount(cycles_t required_cyclecount) = 0;
+    // Leave the runloop with CpuState::Schedule as soon as the total
+    // cycle count is reached, either before or after executing pending
+    // interrupts. Used to replay inputs at exactly the same instruction.
+    virtual void set_schedule_cycle(QWord cycle, bool isAfterInterrupts) = 0;
 };
 
 #endif // SCHEDCPU_INCLUDED
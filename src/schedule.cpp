@@ -33,6 +33,9 @@
 #include "mc6809.h"
 #include "inout.h"
 #include "breltime.h"
+#include "hotcnt.h"
+#include "snapshot.h"
+#include "replay.h"
 #ifdef DEBUG_FILE
 #include <fstream>
 #include <fmt/format.h>
@@ -44,7 +47,7 @@ Scheduler::Scheduler(ScheduledCpu &p_cpu, Inout &p_inout) :
     cpu(p_cpu), inout(p_inout),
     state(CpuState::Run), events(Event::NONE), user_state(CpuState::NONE),
     total_cycles(0), time0sec(0),
-    is_status_valid(false), is_resume(false),
+    is_status_valid(false), is_resume(false), is_suspended(true),
     target_frequency(ORIGINAL_FREQUENCY), frequency(0.0), time0(0), cycles0(0)
 {
     std::memset(&interrupt_status, 0, sizeof(tInterruptStatus));
@@ -72,6 +75,11 @@ bool Scheduler::is_finished()
 
 void Scheduler::process_events()
 {
+    if (is_replaying())
+    {
+        replay_inputs();
+    }
+
     if (events != Event::NONE)
     {
         if ((events & Event::Timer) != Event::NONE)
@@ -84,6 +92,13 @@ void Scheduler::process_events()
 
             if (target_frequency > 0.0)
             {
+                if (!is_suspended)
+                {
+                    // The CPU has not executed the required cycles
+                    // within the last timer tick.
+                    HOT_COUNT(FrequencyMiss);
+                }
+                is_suspended = false;
                 frequency_control(time1sec);
             }
 
@@ -93,7 +108,17 @@ void Scheduler::process_events()
                 update_frequency();
                 events |= Event::SetStatus;
 
-                inout.update_1_second();
+                // When replaying the one second updates are replayed
+                // at their recorded cycle count.
+                if (!is_replaying())
+                {
+                    inout.update_1_second();
+                }
+                if (replayLog != nullptr)
+                {
+                    replayLog->Record(ReplayLog::Input::Second, 0U,
+                                      is_after_interrupts);
+                }
 
                 time0sec += 1000000;
             }
@@ -151,11 +176,16 @@ CpuState Scheduler::runloop(RunMode mode)
     while (new_state == CpuState::Schedule)
     {
         new_state = cpu.run(mode);
+        is_after_interrupts = (new_state == CpuState::Schedule);
 
         if (new_state == CpuState::Suspend)
         {
-            // suspend thread until next timer tick
-            suspend();
+            // suspend thread until next timer tick, except when replaying
+            // an input at the current cycle count.
+            if (!is_replaying() || !replayLog->IsSchedulerInputDue())
+            {
+                suspend();
+            }
             new_state = CpuState::Schedule;
         }
 
@@ -248,6 +278,30 @@ void Scheduler::timer_elapsed()
     cpu.exit_run();
 }
 
+void Scheduler::save_state(SnapshotWriter &writer)
+{
+    writer.Write(cpu.get_cycles());
+}
+
+// Has to be called after restoring the CPU state.
+// The frequency control restarts with the next timer tick.
+RestoreStateFct Scheduler::restore_state(SnapshotReader &reader)
+{
+    QWord cycles;
+
+    reader.Read(cycles);
+    if (!reader.IsValid())
+    {
+        return {};
+    }
+
+    return [this, cycles](){
+        total_cycles = cycles;
+        cycles0 = cycles;
+        time0 = 0;
+    };
+}
+
 void Scheduler::do_reset()
 {
     cpu.do_reset();
@@ -266,7 +320,58 @@ void Scheduler::run()
 #endif
 
     time0sec = BRelativeTime::GetTimeUsll();
+    if (is_replaying())
+    {
+        replay_inputs();
+    }
     statemachine(CpuState::Run);
+    if (replayLog != nullptr)
+    {
+        replayLog->Stop();
+    }
+}
+
+void Scheduler::set_replay_log(ReplayLog *p_replayLog)
+{
+    replayLog = p_replayLog;
+}
+
+bool Scheduler::is_replaying() const
+{
+    return replayLog != nullptr && replayLog->IsReplaying();
+}
+
+// Pass all scheduler inputs due at the current cycle count to the
+// emulation and let the CPU leave its runloop at the next one.
+void Scheduler::replay_inputs()
+{
+    ReplayLog::Input input{};
+    QWord cycle{};
+    bool isAfterInterrupts{};
+
+    while (replayLog->GetSchedulerInput(input))
+    {
+        switch (input)
+        {
+            case ReplayLog::Input::Second:
+                inout.update_1_second();
+                break;
+
+            case ReplayLog::Input::End:
+                request_new_state(CpuState::Exit);
+                break;
+
+            case ReplayLog::Input::NONE:
+            case ReplayLog::Input::SerialKey:
+            case ReplayLog::Input::SerialEof:
+                break;
+        }
+    }
+
+    if (replayLog->GetNextSchedulerCycle(cycle, isAfterInterrupts))
+    {
+        cpu.set_schedule_cycle(cycle, isAfterInterrupts);
+    }
 }
 
 void Scheduler::sync_exec(BCommandPtr new_command)
@@ -382,6 +487,8 @@ void Scheduler::set_frequency(float p_target_frequency)
 
 void Scheduler::suspend()
 {
+    HOT_COUNT(SchedulerSuspend);
+    is_suspended = true;
     std::unique_lock<std::mutex> lock(condition_mutex);
     is_resume = false;
     condition.wait(lock, [&](){ return is_resume; });
@@ -33,10 +33,14 @@
 #include "cpustate.h"
 #include "schedcpu.h"
 #include "bcommand.h"
+#include "iodevice.h"
 
 
 
 class Inout;
+class SnapshotWriter;
+class SnapshotReader;
+class ReplayLog;
 
 class Scheduler
 {
@@ -84,6 +88,20 @@ public:
         return total_cycles;
     }
     void timer_elapsed();
+
+    // Machine snapshot support:
+public:
+    void save_state(SnapshotWriter &writer);
+    RestoreStateFct restore_state(SnapshotReader &reader);
+
+    // Record and replay of inputs (see replay.h):
+public:
+    void set_replay_log(ReplayLog *p_replayLog);
+protected:
+    void replay_inputs();
+    bool is_replaying() const;
+    ReplayLog *replayLog{};
+    bool is_after_interrupts{}; // CPU has left runloop after executing irqs
 protected:
 //    static void timer_elapsed(void *p);
 //    void set_timer();
@@ -121,6 +139,7 @@ public:
 protected:
     void update_frequency();
     void frequency_control(QWord time1);
+    bool is_suspended; // CPU thread suspended since last timer tick
     float target_frequency;
     float frequency; // current frequency
     QWord time0; // time for freq control
@@ -0,0 +1,239 @@
+/*
+    snapshot.cpp
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "snapshot.h"
+#include <array>
+#include <algorithm>
+#include <cstring>
+
+
+static const std::array<Byte, 8> magic{
+    'F', 'L', 'X', 'S', 'N', 'A', 'P', 0x1A
+};
+
+SnapshotWriter::SnapshotWriter()
+{
+    data.reserve(0x10000);
+    data.insert(data.end(), magic.cbegin(), magic.cend());
+    Write(FORMAT_VERSION);
+}
+
+void SnapshotWriter::BeginChunk(const std::string &name)
+{
+    Write(static_cast<Byte>(std::min(name.size(), size_t(255U))));
+    data.insert(data.end(), name.cbegin(),
+            name.cbegin() + std::min(name.size(), size_t(255U)));
+    chunkSizeIndex = data.size();
+    // Placeholder for the chunk size, set in EndChunk().
+    Write(static_cast<DWord>(0U));
+}
+
+void SnapshotWriter::EndChunk()
+{
+    auto size = static_cast<DWord>(data.size() - chunkSizeIndex - 4U);
+
+    for (size_t i = 0U; i < 4U; ++i)
+    {
+        data[chunkSizeIndex + i] = static_cast<Byte>(size & 0xFFU);
+        size >>= 8U;
+    }
+}
+
+void SnapshotWriter::Write(bool value)
+{
+    data.push_back(value ? 1U : 0U);
+}
+
+void SnapshotWriter::Write(Byte value)
+{
+    data.push_back(value);
+}
+
+void SnapshotWriter::Write(Word value)
+{
+    data.push_back(static_cast<Byte>(value & 0xFFU));
+    data.push_back(static_cast<Byte>(value >> 8U));
+}
+
+void SnapshotWriter::Write(DWord value)
+{
+    Write(static_cast<Word>(value & 0xFFFFU));
+    Write(static_cast<Word>(value >> 16U));
+}
+
+void SnapshotWriter::Write(QWord value)
+{
+    Write(static_cast<DWord>(value & 0xFFFFFFFFU));
+    Write(static_cast<DWord>(value >> 32U));
+}
+
+void SnapshotWriter::Write(const Byte *p_data, DWord size)
+{
+    data.insert(data.end(), p_data, p_data + size);
+}
+
+void SnapshotWriter::Write(const std::string &value)
+{
+    Write(static_cast<DWord>(value.size()));
+    data.insert(data.end(), value.cbegin(), value.cend());
+}
+
+SnapshotReader::SnapshotReader(std::vector<Byte> p_data)
+    : data(std::move(p_data))
+{
+    if (data.size() < magic.size() + 4U ||
+        !std::equal(magic.cbegin(), magic.cend(), data.cbegin()))
+    {
+        return;
+    }
+
+    position = magic.size();
+    endPosition = data.size();
+    isValid = true;
+    if (static_cast<DWord>(ReadLittleEndian(4U)) !=
+            SnapshotWriter::FORMAT_VERSION)
+    {
+        isValid = false;
+        return;
+    }
+
+    while (isValid && position < data.size())
+    {
+        std::string name(static_cast<size_t>(ReadLittleEndian(1U)), '\0');
+
+        if (position + name.size() > data.size())
+        {
+            isValid = false;
+            break;
+        }
+        std::copy_n(data.cbegin() + static_cast<std::ptrdiff_t>(position),
+                    name.size(), name.begin());
+        position += name.size();
+        const auto size = static_cast<DWord>(ReadLittleEndian(4U));
+        if (!isValid || position + size > data.size())
+        {
+            isValid = false;
+            break;
+        }
+        chunks[name] = { position, size };
+        position += size;
+    }
+
+    // No chunk is selected yet.
+    position = endPosition = 0U;
+}
+
+bool SnapshotReader::HasChunk(const std::string &name) const
+{
+    return chunks.find(name) != chunks.end();
+}
+
+bool SnapshotReader::SelectChunk(const std::string &name)
+{
+    const auto iter = chunks.find(name);
+
+    if (iter == chunks.end())
+    {
+        position = endPosition = 0U;
+        return false;
+    }
+
+    position = iter->second.first;
+    endPosition = position + iter->second.second;
+    return true;
+}
+
+QWord SnapshotReader::ReadLittleEndian(unsigned byteCount)
+{
+    QWord value = 0U;
+
+    if (position + byteCount > endPosition)
+    {
+        position = endPosition;
+        isValid = false;
+        return value;
+    }
+
+    for (unsigned i = 0U; i < byteCount; ++i)
+    {
+        value |= static_cast<QWord>(data[position++]) << (8U * i);
+    }
+
+    return value;
+}
+
+void SnapshotReader::Read(bool &value)
+{
+    value = ReadLittleEndian(1U) != 0U;
+}
+
+void SnapshotReader::Read(Byte &value)
+{
+    value = static_cast<Byte>(ReadLittleEndian(1U));
+}
+
+void SnapshotReader::Read(Word &value)
+{
+    value = static_cast<Word>(ReadLittleEndian(2U));
+}
+
+void SnapshotReader::Read(DWord &value)
+{
+    value = static_cast<DWord>(ReadLittleEndian(4U));
+}
+
+void SnapshotReader::Read(QWord &value)
+{
+    value = ReadLittleEndian(8U);
+}
+
+void SnapshotReader::Read(Byte *p_data, DWord size)
+{
+    if (position + size > endPosition)
+    {
+        position = endPosition;
+        isValid = false;
+        std::memset(p_data, 0, size);
+        return;
+    }
+
+    std::memcpy(p_data, data.data() + position, size);
+    position += size;
+}
+
+void SnapshotReader::Read(std::string &value)
+{
+    const auto size = static_cast<DWord>(ReadLittleEndian(4U));
+
+    value.clear();
+    if (position + size > endPosition)
+    {
+        position = endPosition;
+        isValid = false;
+        return;
+    }
+
+    value.assign(reinterpret_cast<const char *>(data.data() + position),
+                 size);
+    position += size;
+}
+
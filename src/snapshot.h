@@ -0,0 +1,120 @@
+/*
+    snapshot.h
+
+
+    flexemu, an MC6809 emulator running FLEX
+    Copyright (C) 2024  W. Schwotzer
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef SNAPSHOT_INCLUDED
+#define SNAPSHOT_INCLUDED
+
+#include "typedefs.h"
+#include <map>
+#include <string>
+#include <vector>
+
+
+// Binary format of a snapshot. All values are stored little endian.
+//
+//   8 Byte   Magic number "FLXSNAP\x1A"
+//   DWord    Format version
+//   Chunks until end of data, each chunk:
+//     Byte   Length n of chunk name
+//     n Byte Chunk name, e.g. "mc6809", "memory" or the name of an I/O device
+//     DWord  Length m of chunk data
+//     m Byte Chunk data
+//
+// Each emulated component writes its state into its own chunk.
+// A chunk is read back by the component which has written it, so the
+// chunk data is only a sequence of values without any type information.
+
+class SnapshotWriter
+{
+public:
+    static constexpr DWord FORMAT_VERSION{2U};
+
+    SnapshotWriter();
+    ~SnapshotWriter() = default;
+    SnapshotWriter(const SnapshotWriter &src) = delete;
+    SnapshotWriter(SnapshotWriter &&src) = delete;
+    SnapshotWriter &operator=(const SnapshotWriter &src) = delete;
+    SnapshotWriter &operator=(SnapshotWriter &&src) = delete;
+
+    void BeginChunk(const std::string &name);
+    void EndChunk();
+
+    void Write(bool value);
+    void Write(Byte value);
+    void Write(Word value);
+    void Write(DWord value);
+    void Write(QWord value);
+    void Write(const Byte *data, DWord size);
+    void Write(const std::string &value);
+
+    const std::vector<Byte> &GetData() const
+    {
+        return data;
+    }
+
+private:
+    std::vector<Byte> data;
+    size_t chunkSizeIndex{};
+};
+
+class SnapshotReader
+{
+public:
+    SnapshotReader() = delete;
+    explicit SnapshotReader(std::vector<Byte> p_data);
+    ~SnapshotReader() = default;
+    SnapshotReader(const SnapshotReader &src) = delete;
+    SnapshotReader(SnapshotReader &&src) = delete;
+    SnapshotReader &operator=(const SnapshotReader &src) = delete;
+    SnapshotReader &operator=(SnapshotReader &&src) = delete;
+
+    // true if the snapshot header and all chunk headers are valid and
+    // no value has been read beyond the end of the selected chunk.
+    bool IsValid() const
+    {
+        return isValid;
+    }
+    bool HasChunk(const std::string &name) const;
+    bool SelectChunk(const std::string &name);
+
+    // On error a value is set to zero and IsValid() returns false.
+    void Read(bool &value);
+    void Read(Byte &value);
+    void Read(Word &value);
+    void Read(DWord &value);
+    void Read(QWord &value);
+    void Read(Byte *p_data, DWord size);
+    void Read(std::string &value);
+
+private:
+    QWord ReadLittleEndian(unsigned byteCount);
+
+    std::vector<Byte> data;
+    // Key: chunk name. Value: Offset of chunk data and chunk data size.
+    std::map<std::string, std::pair<size_t, DWord> > chunks;
+    size_t position{};
+    size_t endPosition{};
+    bool isValid{};
+};
+
+#endif // SNAPSHOT_INCLUDED
+
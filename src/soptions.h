@@ -128,6 +128,16 @@ struct sOptions
     int directoryDiskSectors{}; // Default number of sectors for a directory disk
     bool isDirectoryDiskActive{}; // true if directory disk is active.
     std::string cpuLogPath; // Path used for CPU instruction logging
+    std::vector<std::string> symbolFiles; // Assembler symbol files used
+                                          // as disassembler labels
+    std::string counterSocketPath; // Unix domain socket serving hot path
+                                   // counters
+    bool isPrintCounters{}; // Print hot path counters on exit
+    std::string snapshotPath; // Machine snapshot restored on startup
+    std::string forkServerPath; // Unix domain socket of the fork server
+    bool isMdcrFastLoad{}; // Eurocom II/V5: Read MDCR tapes without delays
+    std::string replayRecordPath; // Record non-deterministic inputs
+    std::string replayPath; // Replay recorded inputs
 
     FlexemuOptionIds_t readOnlyOptionIds;// List of option ids which are
                                          // read-only.
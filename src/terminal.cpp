@@ -25,8 +25,12 @@
 #include "terminal.h"
 #include "mc6809.h"
 #include "schedule.h"
+#include "replay.h"
 #include <cstring>
 #include <iostream>
+#ifdef HAVE_TERMIOS_H
+#include <poll.h>
+#endif
 
 // pointer to this instance for signal handling
 TerminalIO *TerminalIO::instance = nullptr;
@@ -234,6 +238,37 @@ void TerminalIO::put_char_serial(Byte key)
 #endif // #ifdef HAVE_TERMIOS_H
 
     key_buffer_serial.push_back(key);
+    if (replayLog != nullptr)
+    {
+        replayLog->Record(ReplayLog::Input::SerialKey, key);
+    }
+}
+
+void TerminalIO::set_replay_log(ReplayLog *p_replayLog)
+{
+    replayLog = p_replayLog;
+}
+
+// Replay a recorded key instead of reading it from the terminal.
+// It is polled at the same rate, so it is received by exactly the same
+// instruction as when it was recorded.
+void TerminalIO::replay_serial_input()
+{
+    ReplayLog::Input input{};
+    Byte key{};
+
+    if (replayLog->GetSerialInput(input, key))
+    {
+        if (input == ReplayLog::Input::SerialKey)
+        {
+            std::lock_guard<std::mutex> guard(serial_mutex);
+            key_buffer_serial.push_back(key);
+        }
+        else
+        {
+            scheduler.request_new_state(CpuState::Exit);
+        }
+    }
 }
 
 // poll serial port for input character.
@@ -258,7 +293,38 @@ bool TerminalIO::has_key_serial()
         count = 0;
         fflush(stdout);
 
-        if (read(fileno(stdin), &buffer, 1) > 0)
+        if (replayLog != nullptr && replayLog->IsReplaying())
+        {
+            replay_serial_input();
+        }
+        else if (is_redirected)
+        {
+            // A socket or pipe has no non-blocking terminal settings,
+            // so check for available input before reading.
+            struct pollfd pfd{};
+
+            pfd.fd = fileno(stdin);
+            pfd.events = POLLIN;
+            if (poll(&pfd, 1, 0) > 0)
+            {
+                const auto count = read(fileno(stdin), &buffer, 1);
+
+                if (count > 0)
+                {
+                    put_char_serial(buffer);
+                }
+                else if (count == 0)
+                {
+                    // End of input: The peer has closed the connection.
+                    if (replayLog != nullptr)
+                    {
+                        replayLog->Record(ReplayLog::Input::SerialEof);
+                    }
+                    scheduler.request_new_state(CpuState::Exit);
+                }
+            }
+        }
+        else if (read(fileno(stdin), &buffer, 1) > 0)
         {
             put_char_serial(buffer);
         }
@@ -351,6 +417,30 @@ void TerminalIO::write_char_serial(Byte /* [[maybe_unused]] Byte value */)
 }
 #endif // #ifdef HAVE_TERMIOS_H
 
+// Redirect serial input and output to a file descriptor, e.g. a connected
+// socket. End of input exits the emulation.
+// Return false if redirection is not supported or failed.
+bool TerminalIO::redirect_serial_io(int fd)
+{
+#ifdef HAVE_TERMIOS_H
+    fflush(stdout);
+    if (dup2(fd, fileno(stdin)) < 0 || dup2(fd, fileno(stdout)) < 0)
+    {
+        return false;
+    }
+
+    // The terminal settings of the original stdin are not restored
+    // any more.
+    is_termios_saved = false;
+    is_redirected = true;
+
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
 // Implementation may change in future.
 // NOLINTNEXTLINE(readability-convert-member-functions-to-static)
 bool TerminalIO::is_terminal_supported()
@@ -380,23 +470,30 @@ void TerminalIO::s_exec_signal(int sig_no, siginfo_t * /*unused*/, void * /*unus
 }
 #endif
 
+void TerminalIO::connect_interrupts(Mc6809 &cpu)
+{
+    irq.Connect(cpu, INT_IRQ);
+    firq.Connect(cpu, INT_FIRQ);
+    nmi.Connect(cpu, INT_NMI);
+}
+
 void TerminalIO::exec_signal(int sig_no)
 {
     switch (sig_no)
     {
         case SIGINT:
-            Notify(NotifyId::SetNmi);
+            nmi.Pulse();
             break;
 
 #if defined(SIGUSR1)
         case SIGUSR1:
-            Notify(NotifyId::SetIrq);
+            irq.Pulse();
             break;
 #endif
 
 #if defined(SIGUSR2)
         case SIGUSR2:
-            Notify(NotifyId::SetFirq);
+            firq.Pulse();
             break;
 #endif
 
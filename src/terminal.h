@@ -32,7 +32,7 @@
 #include <csignal>
 #include "flexemu.h"
 #include "flexerr.h"
-#include "bobservd.h"
+#include "irqline.h"
 #include "soptions.h"
 #include "asciictl.h"
 #include <deque>
@@ -40,8 +40,10 @@
 
 
 class Scheduler;
+class Mc6809;
+class ReplayLog;
 
-class TerminalIO : public BObserved
+class TerminalIO
 {
 private:
     std::deque<Byte> key_buffer_serial;
@@ -52,8 +54,14 @@ private:
     static bool used_serial_io;
     static struct termios save_termios;
     static bool is_termios_saved;
+    bool is_redirected{};
 #endif
     Word init_delay;
+    // Interrupts requested by signals SIGUSR1, SIGUSR2 and SIGINT.
+    InterruptLine irq;
+    InterruptLine firq;
+    InterruptLine nmi;
+    ReplayLog *replayLog{};
 
 public:
     static TerminalIO *instance;
@@ -74,6 +82,9 @@ public:
     bool is_terminal_supported();
     void signal_reset(int sig_no);
     void set_startup_command(const char *p_startup_command);
+    bool redirect_serial_io(int fd);
+    void connect_interrupts(Mc6809 &cpu);
+    void set_replay_log(ReplayLog *p_replayLog);
 
 private:
     static void reset_terminal_io();
@@ -81,11 +92,12 @@ private:
     void put_char_serial(Byte key);
     void exec_signal(int sig_no);
     void write_char_serial_safe(Byte val);
+    void replay_serial_input();
 
 public:
     TerminalIO() = delete;
     TerminalIO(Scheduler &p_scheduler, const struct sOptions &p_options);
-    ~TerminalIO() override = default;
+    ~TerminalIO() = default;
 };
 
 #endif // TERMINAL_INCLUDED
@@ -51,7 +51,7 @@
 //     1   |   0   | none (white screen)
 //     1   |   1   | none (white screen)
 
-class VideoControl1 : public ByteRegister, public BObserved
+class VideoControl1 final : public ByteRegister, public BObserved
 {
 private:
 
@@ -74,6 +74,8 @@ public:
     {
         return value;
     }
+    void saveState(SnapshotWriter &writer) override;
+    RestoreStateFct restoreState(SnapshotReader &reader) override;
 };
 
 #endif
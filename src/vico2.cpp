@@ -23,6 +23,7 @@
 
 #include "misc1.h"
 #include "vico2.h"
+#include "snapshot.h"
 
 
 void VideoControl2::requestWriteValue(Byte new_value)
@@ -38,3 +39,24 @@ void VideoControl2::requestWriteValue(Byte new_value)
     }
 }
 
+void VideoControl2::saveState(SnapshotWriter &writer)
+{
+    writer.Write(value);
+}
+
+// Write the restored value to notify all observers.
+RestoreStateFct VideoControl2::restoreState(SnapshotReader &reader)
+{
+    Byte new_value;
+
+    reader.Read(new_value);
+    if (!reader.IsValid())
+    {
+        return {};
+    }
+
+    return [this, new_value](){
+        isFirstWrite = true;
+        requestWriteValue(new_value);
+    };
+}
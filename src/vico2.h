@@ -34,7 +34,7 @@
 // first on the video display. All 8 bits are used for 256
 // raster lines.
 
-class VideoControl2 : public ByteRegister, public BObserved
+class VideoControl2 final : public ByteRegister, public BObserved
 {
 private:
 
@@ -57,6 +57,8 @@ public:
     {
         return value;
     }
+    void saveState(SnapshotWriter &writer) override;
+    RestoreStateFct restoreState(SnapshotReader &reader) override;
 };
 
 #endif
@@ -24,6 +24,8 @@
 #include "misc1.h"
 
 #include "wd1793.h"
+#include "snapshot.h"
+#include <array>
 
 
 void Wd1793::resetIo()
@@ -40,83 +42,95 @@ void Wd1793::resetIo()
     command(0); //execute RESTORE after a reset
 }
 
-Byte Wd1793::readIo(Word offset)
+void Wd1793::saveState(SnapshotWriter &writer)
 {
-    switch (offset & 0x03U)
+    for (auto value : { dr, tr, sr, cr, str, stepOffset, indexPulse })
     {
-        case 0:
-            resetIrq();
-
-            if (((cr & 0xE0U) == CMD_READSECTOR) && (++strRead == 32))
-            {
-                isDataRequest = false;
-                str &= ~(STR_DATAREQUEST | STR_BUSY); // read finished
-            }
-
-            // set index pulse every 16 reads.
-            indexPulse = (indexPulse + 1) % 16;
-            if (!indexPulse)
-            {
-                // After max. 16x read from STR drive gets ready
-                str &= ~STR_NOTREADY;
-            }
-
-            if (str & STR_NOTREADY)
-            {
-                return str;
-            }
+        writer.Write(value);
+    }
+    writer.Write(isDataRequest);
+    writer.Write(isInterrupt);
+    writer.Write(side);
+    writer.Write(byteCount);
+    writer.Write(strRead);
+}
 
-            if (!indexPulse && !(cr & 0x80U))
-            {
-                return str | STR_DATAREQUEST;
-            }
+RestoreStateFct Wd1793::restoreState(SnapshotReader &reader)
+{
+    std::array<Byte, 7> values{};
+    std::array<bool, 3> flags{};
+    std::array<Word, 2> counts{};
 
-            return str;
+    for (auto &value : values)
+    {
+        reader.Read(value);
+    }
+    for (auto &flag : flags)
+    {
+        reader.Read(flag);
+    }
+    for (auto &count : counts)
+    {
+        reader.Read(count);
+    }
 
-        case 1:
-            return tr;
+    if (!reader.IsValid())
+    {
+        return {};
+    }
 
-        case 2:
-            return sr;
+    return [this, values, flags, counts](){
+        auto iter = values.cbegin();
 
-        case 3:
-            strRead = 0;
+        for (auto *value : { &dr, &tr, &sr, &cr, &str, &stepOffset,
+                             &indexPulse })
+        {
+            *value = *(iter++);
+        }
+        isDataRequest = flags[0];
+        isInterrupt = flags[1];
+        side = flags[2];
+        byteCount = counts[0];
+        strRead = counts[1];
+    };
+}
 
-            if (byteCount)
-            {
-                dr = readByte(byteCount, cr & 0xF0U);
-                if (byteCount != 0)
-                {
-                    byteCount--;
-                }
-            }
+Byte Wd1793::readDataRegister()
+{
+    strRead = 0;
 
-            if (!byteCount && (cr & 0xF0U) == CMD_READSECTOR_MULT)
-            {
-                // When reading multiple sectors read next sector,
-                // until record not found.
-                ++sr;
-                if (isRecordNotFound())
-                {
-                    str |= STR_RECORDNOTFOUND;
-                }
-                else
-                {
-                    byteCount = getBytesPerSector();
-                }
-            }
+    if (byteCount)
+    {
+        dr = readByte(byteCount, cr & 0xF0U);
+        if (byteCount != 0)
+        {
+            byteCount--;
+        }
+    }
 
-            if (isDataRequest && !byteCount)
-            {
-                isDataRequest = false;
-                str &= ~(STR_DATAREQUEST | STR_BUSY); // read finished
-                setIrq();
-            }
+    if (!byteCount && (cr & 0xF0U) == CMD_READSECTOR_MULT)
+    {
+        // When reading multiple sectors read next sector,
+        // until record not found.
+        ++sr;
+        if (isRecordNotFound())
+        {
+            str |= STR_RECORDNOTFOUND;
+        }
+        else
+        {
+            byteCount = getBytesPerSector();
+        }
+    }
 
-            return dr;
+    if (isDataRequest && !byteCount)
+    {
+        isDataRequest = false;
+        str &= ~(STR_DATAREQUEST | STR_BUSY); // read finished
+        setIrq();
     }
 
-    return 0; // default, should never be used!
+    return dr;
 }
 
 
@@ -182,6 +182,38 @@ protected:
         sr = newSector;
     }
 
+    Byte readStatusRegister()
+    {
+        resetIrq();
+
+        if (((cr & 0xE0U) == CMD_READSECTOR) && (++strRead == 32))
+        {
+            isDataRequest = false;
+            str &= ~(STR_DATAREQUEST | STR_BUSY); // read finished
+        }
+
+        // set index pulse every 16 reads.
+        indexPulse = (indexPulse + 1) % 16;
+        if (!indexPulse)
+        {
+            // After max. 16x read from STR drive gets ready
+            str &= ~STR_NOTREADY;
+        }
+
+        if (str & STR_NOTREADY)
+        {
+            return str;
+        }
+
+        if (!indexPulse && !(cr & 0x80U))
+        {
+            return str | STR_DATAREQUEST;
+        }
+
+        return str;
+    }
+
+    Byte readDataRegister();
     void command(Byte command);
     void setStatusReadError();
     void setStatusWriteError();
@@ -199,7 +231,25 @@ protected:
 public:
 
     void resetIo() override;
-    Byte readIo(Word offset) override;
+    // The status register is polled most often, so reading it is inlined
+    // (see MakeIoDispatch()).
+    Byte readIo(Word offset) override
+    {
+        switch (offset & 0x03U)
+        {
+            case 0:
+                return readStatusRegister();
+
+            case 1:
+                return tr;
+
+            case 2:
+                return sr;
+
+            default:
+                return readDataRegister();
+        }
+    }
     void writeIo(Word offset, Byte value) override;
     const char *getName() override
     {
@@ -209,6 +259,8 @@ public:
     {
        return 4;
     };
+    void saveState(SnapshotWriter &writer) override;
+    RestoreStateFct restoreState(SnapshotReader &reader) override;
 
 public:
 
@@ -0,0 +1,291 @@
+#include "gtest/gtest.h"
+#include "bench.h"
+#include "misc1.h"
+#include "mc6809.h"
+#include "mc6809st.h"
+#include "memory.h"
+#include "soptions.h"
+#include "foptman.h"
+#include "ffilecnt.h"
+#include "e2floppy.h"
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+
+// All MC6809 programs are loaded at this address. The program has to be an
+// endless loop which jumps back to this address.
+static constexpr Word PROGRAM_ADDRESS{0x0100};
+// Number of executed MC6809 instructions for scale factor 1.0.
+static constexpr double CPU_INSTRUCTIONS{50e6};
+// Number of transferred sectors for scale factor 1.0.
+static constexpr double DISK_SECTORS{200e3};
+// Track 0 has a different number of sectors, it is not used.
+static constexpr int DISK_TRACKS{80};
+static constexpr int DISK_SECTORS_PER_TRACK{36};
+
+static QWord GetTimeNs()
+{
+    return static_cast<QWord>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static void InitBenchOptions(struct sOptions &options)
+{
+    FlexemuOptions::InitOptions(options);
+    // Avoid reading flexemu.conf. Without RAM extension video RAM is
+    // located at $0000 - $3FFF.
+    options.isRamExtension = false;
+    options.isHiMem = false;
+}
+
+// Execute an endless loop MC6809 program located at PROGRAM_ADDRESS.
+// The number of instructions and cycles of one loop is determined by
+// single stepping it once. Then the program is executed for the
+// required number of cycles with the cycle count of the CPU as the only
+// exit condition. Optionally memory mapped I/O devices can be added.
+static void RunCpuBenchmark(const char *name, const std::vector<Byte> &program,
+        const std::function<void(Memory &)> &addIoDevices = nullptr)
+{
+    struct sOptions options;
+    InitBenchOptions(options);
+    Memory memory(options);
+    Mc6809 cpu(memory);
+    Mc6809CpuStatus status;
+    QWord loopInstructions = 0U;
+
+    if (addIoDevices)
+    {
+        addIoDevices(memory);
+    }
+
+    Word address = PROGRAM_ADDRESS;
+    for (auto byte : program)
+    {
+        memory.write_ram_rom(address++, byte);
+    }
+    memory.write_ram_rom(0xFFFE, PROGRAM_ADDRESS >> 8U);
+    memory.write_ram_rom(0xFFFF, PROGRAM_ADDRESS & 0xFFU);
+
+    cpu.set_required_cyclecount(std::numeric_limits<cycles_t>::max());
+    cpu.reset();
+    cpu.get_status(&status);
+    status.s = 0x0800;
+    status.x = 0x1000;
+    status.y = 0x0000;
+    cpu.set_status(&status);
+
+    auto cycles = cpu.get_cycles(true);
+    do
+    {
+        cpu.run(RunMode::SingleStepInto);
+        cpu.get_status(&status);
+        ++loopInstructions;
+    } while (status.pc != PROGRAM_ADDRESS && loopInstructions < 1000000U);
+    ASSERT_EQ(status.pc, PROGRAM_ADDRESS) << "Program is not an endless loop";
+    const auto loopCycles = cpu.get_cycles(true) - cycles;
+    ASSERT_NE(loopCycles, 0U);
+
+    const auto loops = static_cast<QWord>(CPU_INSTRUCTIONS * benchScale) /
+                       loopInstructions + 1U;
+    const auto allocations = allocationCount.load();
+    const auto startNs = GetTimeNs();
+
+    cycles = cpu.get_cycles(true);
+    cpu.set_required_cyclecount(static_cast<cycles_t>(loops * loopCycles));
+    const auto state = cpu.run(RunMode::RunningStart);
+
+    BenchResult result;
+    result.hostNs = GetTimeNs() - startNs;
+    result.allocations = allocationCount.load() - allocations;
+    result.emulatedCycles = cpu.get_cycles(true) - cycles;
+    result.operations =
+        result.emulatedCycles * loopInstructions / loopCycles;
+    result.name = name;
+    EXPECT_EQ(state, CpuState::Suspend);
+    AddBenchResult(result);
+}
+
+TEST(flexemu_bench, cpu_instruction_mix)
+{
+    const std::vector<Byte> program{
+        0x8E, 0x10, 0x00, // 0100 LDX   #$1000
+        0x86, 0x55,       // 0103 LDA   #$55
+        0x8B, 0x11,       // 0105 ADDA  #$11
+        0xA7, 0x84,       // 0107 STA   ,X
+        0xE6, 0x01,       // 0109 LDB   1,X
+        0xC4, 0x0F,       // 010B ANDB  #$0F
+        0x34, 0x06,       // 010D PSHS  B,A
+        0x35, 0x06,       // 010F PULS  A,B
+        0x31, 0x21,       // 0111 LEAY  1,Y
+        0x8C, 0x20, 0x00, // 0113 CMPX  #$2000
+        0xBD, 0x01, 0x1E, // 0116 JSR   $011E
+        0x26, 0xE5,       // 0119 BNE   $0100
+        0x7E, 0x01, 0x00, // 011B JMP   $0100
+        0x39,             // 011E RTS
+    };
+
+    RunCpuBenchmark("cpu_instruction_mix", program);
+}
+
+TEST(flexemu_bench, cpu_mul_daa)
+{
+    const std::vector<Byte> program{
+        0x86, 0x12,       // 0100 LDA   #$12
+        0xC6, 0x34,       // 0102 LDB   #$34
+        0x3D,             // 0104 MUL
+        0x8B, 0x19,       // 0105 ADDA  #$19
+        0x19,             // 0107 DAA
+        0xCB, 0x27,       // 0108 ADDB  #$27
+        0x3D,             // 010A MUL
+        0x19,             // 010B DAA
+        0x20, 0xF2,       // 010C BRA   $0100
+    };
+
+    RunCpuBenchmark("cpu_mul_daa", program);
+}
+
+TEST(flexemu_bench, cpu_video_write)
+{
+    // Fill the video RAM ($0000 - $3FFF) with 16-bit writes.
+    // The program itself is located within video RAM.
+    const std::vector<Byte> program{
+        0x8E, 0x02, 0x00, // 0100 LDX   #$0200
+        0xCC, 0xAA, 0x55, // 0103 LDD   #$AA55
+        0xED, 0x81,       // 0106 STD   ,X++
+        0x8C, 0x40, 0x00, // 0108 CMPX  #$4000
+        0x26, 0xF9,       // 010B BNE   $0106
+        0x20, 0xF1,       // 010D BRA   $0100
+    };
+
+    RunCpuBenchmark("cpu_video_write", program);
+}
+
+TEST(flexemu_bench, cpu_fdc_status_poll)
+{
+    // Poll the status register of the floppy disk controller as done by
+    // the FLEX disk driver while waiting for the end of a command.
+    struct sOptions options;
+    InitBenchOptions(options);
+    E2floppy fdc(options);
+    const std::vector<Byte> program{
+        0xB6, 0xFD, 0x30, // 0100 LDA   $FD30
+        0x85, 0x01,       // 0103 BITA  #$01
+        0x26, 0xF9,       // 0105 BNE   $0100
+        0x20, 0xF7,       // 0107 BRA   $0100
+    };
+
+    RunCpuBenchmark("cpu_fdc_status_poll", program, [&](Memory &memory){
+        ASSERT_TRUE(memory.add_io_device(fdc, 0xFD30, 4,
+                    MakeIoDispatch<E2floppy>()));
+    });
+}
+
+class flexemu_bench_disk : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        path = (fs::temp_directory_path() / "flexemu_bench.dsk").string();
+        std::unique_ptr<FlexDisk> disk(FlexDisk::Create(path,
+                    FileTimeAccess::NONE, DISK_TRACKS,
+                    DISK_SECTORS_PER_TRACK));
+        ASSERT_NE(disk.get(), nullptr);
+        passes = static_cast<int>(DISK_SECTORS * benchScale /
+                (DISK_TRACKS * DISK_SECTORS_PER_TRACK)) + 1;
+    }
+
+    void TearDown() override
+    {
+        fs::remove(path);
+    }
+
+    std::string path;
+    int passes{};
+};
+
+TEST_F(flexemu_bench_disk, disk_sector_read_write)
+{
+    const auto mode = std::ios::in | std::ios::out | std::ios::binary;
+    FlexDisk disk(path, mode, FileTimeAccess::NONE);
+    std::vector<Byte> buffer(disk.GetBytesPerSector());
+
+    for (bool isWrite : { false, true })
+    {
+        QWord errors = 0U;
+        const auto allocations = allocationCount.load();
+        const auto startNs = GetTimeNs();
+
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            for (int track = 1; track < DISK_TRACKS; ++track)
+            {
+                for (int sector = 1; sector <= DISK_SECTORS_PER_TRACK;
+                     ++sector)
+                {
+                    const auto success = isWrite ?
+                        disk.WriteSector(buffer.data(), track, sector) :
+                        disk.ReadSector(buffer.data(), track, sector);
+                    errors += success ? 0U : 1U;
+                }
+            }
+        }
+
+        BenchResult result;
+        result.hostNs = GetTimeNs() - startNs;
+        result.allocations = allocationCount.load() - allocations;
+        result.operations = static_cast<QWord>(passes) * (DISK_TRACKS - 1) *
+                            DISK_SECTORS_PER_TRACK;
+        result.name = isWrite ? "disk_sector_write" : "disk_sector_read";
+        EXPECT_EQ(errors, 0U);
+        AddBenchResult(result);
+    }
+}
+
+TEST_F(flexemu_bench_disk, floppy_sector_read)
+{
+    // Read sectors through the WD1793 registers of the floppy controller
+    // as done by the FLEX disk driver, without the MC6809 CPU.
+    struct sOptions options;
+    InitBenchOptions(options);
+    E2floppy fdc(options);
+    ASSERT_TRUE(fdc.mount_drive(path, 0));
+    fdc.select_drive(0);
+
+    QWord errors = 0U;
+    const auto allocations = allocationCount.load();
+    const auto startNs = GetTimeNs();
+
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (int track = 1; track < DISK_TRACKS; ++track)
+        {
+            for (int sector = 1; sector <= DISK_SECTORS_PER_TRACK; ++sector)
+            {
+                fdc.writeIo(1, static_cast<Byte>(track));
+                fdc.writeIo(2, static_cast<Byte>(sector));
+                fdc.writeIo(0, Wd1793::CMD_READSECTOR);
+                for (unsigned i = 0; i < SECTOR_SIZE; ++i)
+                {
+                    fdc.readIo(3);
+                }
+                errors += (fdc.readIo(0) & 0x1CU) ? 1U : 0U;
+            }
+        }
+    }
+
+    BenchResult result;
+    result.hostNs = GetTimeNs() - startNs;
+    result.allocations = allocationCount.load() - allocations;
+    result.operations = static_cast<QWord>(passes) * (DISK_TRACKS - 1) *
+                        DISK_SECTORS_PER_TRACK;
+    result.name = "floppy_sector_read";
+    EXPECT_EQ(errors, 0U);
+    AddBenchResult(result);
+}
@@ -0,0 +1,30 @@
+#ifndef BENCH_INCLUDED
+#define BENCH_INCLUDED
+
+#include "typedefs.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+
+// Result of one benchmark. Members which do not apply to a benchmark are 0,
+// e.g. emulated cycles for a disk benchmark.
+struct BenchResult
+{
+    std::string name;
+    QWord operations{}; // Executed instructions or transferred sectors.
+    QWord emulatedCycles{};
+    QWord hostNs{};
+    QWord allocations{};
+};
+
+// Number of heap allocations since program start.
+// Counted by the replaced global operator new.
+extern std::atomic<QWord> allocationCount;
+
+// Scale factor for the benchmark size, set by command line option.
+extern double benchScale;
+
+void AddBenchResult(const BenchResult &result);
+
+#endif // BENCH_INCLUDED
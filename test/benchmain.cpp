@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "bench.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+#include <fmt/format.h>
+
+
+// Command line options in addition to the googletest options:
+//   --json=<file>  Write the benchmark results as JSON into <file>.
+//   --scale=<n>    Scale the benchmark size by factor <n> (default: 1.0).
+
+std::atomic<QWord> allocationCount{};
+double benchScale{1.0};
+static std::vector<BenchResult> results;
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1U, std::memory_order_relaxed);
+    if (auto *ptr = std::malloc(size == 0U ? 1U : size))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t /* size */) noexcept
+{
+    std::free(ptr);
+}
+
+void AddBenchResult(const BenchResult &result)
+{
+    const auto ns = static_cast<double>(result.hostNs);
+    std::string line = fmt::format("{:<24} {:>12} ops {:>10.2f} ns/op",
+            result.name, result.operations,
+            result.operations ? ns / static_cast<double>(result.operations) :
+                                0.0);
+
+    if (result.emulatedCycles != 0U && result.hostNs != 0U)
+    {
+        line += fmt::format(" {:>9.2f} MHz",
+            static_cast<double>(result.emulatedCycles) * 1000.0 / ns);
+    }
+    line += fmt::format(" {:>8} allocations", result.allocations);
+    std::cout << line << '\n';
+
+    results.push_back(result);
+}
+
+static bool WriteJson(const std::string &path)
+{
+    std::ofstream ofs(path, std::ios::out | std::ios::trunc);
+
+    if (!ofs.is_open())
+    {
+        return false;
+    }
+
+    ofs << "{\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto &result = results[i];
+        const auto ns = static_cast<double>(result.hostNs);
+        const auto nsPerOp = result.operations ?
+            ns / static_cast<double>(result.operations) : 0.0;
+        const auto mhz = (result.emulatedCycles && result.hostNs) ?
+            static_cast<double>(result.emulatedCycles) * 1000.0 / ns : 0.0;
+
+        ofs << (i == 0U ? "\n" : ",\n");
+        ofs << fmt::format(
+            "    {{ \"name\": \"{}\", \"operations\": {}, "
+            "\"emulated_cycles\": {}, \"host_ns\": {}, "
+            "\"ns_per_operation\": {:.3f}, \"emulated_mhz\": {:.3f}, "
+            "\"allocations\": {} }}",
+            result.name, result.operations, result.emulatedCycles,
+            result.hostNs, nsPerOp, mhz, result.allocations);
+    }
+    ofs << "\n  ]\n}\n";
+
+    return ofs.good();
+}
+
+int main(int argc, char **argv)
+{
+    std::string jsonPath;
+
+    ::testing::InitGoogleTest(&argc, argv);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strncmp(argv[i], "--json=", 7) == 0)
+        {
+            jsonPath = &argv[i][7];
+        }
+        else if (strncmp(argv[i], "--scale=", 8) == 0)
+        {
+            benchScale = std::strtod(&argv[i][8], nullptr);
+            if (benchScale <= 0.0)
+            {
+                std::cerr << "*** Error: Invalid scale " << &argv[i][8] <<
+                             "\n";
+                return 1;
+            }
+        }
+    }
+
+    const auto result = RUN_ALL_TESTS();
+
+    if (!jsonPath.empty() && !WriteJson(jsonPath))
+    {
+        std::cerr << "*** Error: Could not write " << jsonPath << "\n";
+        return 1;
+    }
+
+    return result;
+}
@@ -79,6 +79,21 @@ TEST(test_bmembuf, member_CopyFrom)
             testing::Throws<std::out_of_range>());
 }
 
+TEST(test_bmembuf, member_Reset)
+{
+    BMemoryBuffer buffer(0x4000U);
+    std::vector<Byte> buffer_src{ 1, 2, 3, 4 };
+    std::array<Byte, 4> buffer_tgt{ 0xFF, 0xFF, 0xFF, 0xFF };
+    buffer.CopyFrom(buffer_src.data(), 0x2000U, buffer_src.size());
+    // Copying zero bytes adds no address range.
+    buffer.CopyFrom(buffer_src.data(), 0x3000U, 0U);
+    EXPECT_EQ(buffer.GetAddressRanges().size(), 1U);
+    buffer.Reset();
+    EXPECT_EQ(buffer.GetAddressRanges().size(), 0U);
+    buffer.CopyTo(buffer_tgt.data(), 0x2000U, buffer_tgt.size());
+    EXPECT_EQ(buffer_tgt, (std::array<Byte, 4>{ 0, 0, 0, 0 }));
+}
+
 TEST(test_bmembuf, member_CopyTo)
 {
     BMemoryBuffer buffer(0x4000U);
@@ -101,3 +116,31 @@ TEST(test_bmembuf, member_CopyTo)
             testing::Throws<std::out_of_range>());
 }
 
+TEST(test_bmembuf, member_AddressRanges)
+{
+    BMemoryBuffer buffer(0x10000U);
+    std::vector<Byte> buffer_src(0x300U, 0x55U);
+    buffer.CopyFrom(buffer_src.data(), 0x8000U, 0x10U);
+    buffer.CopyFrom(buffer_src.data(), 0x1000U, 0x300U);
+    buffer.CopyFrom(buffer_src.data(), 0x4000U, 0x10U);
+    buffer.CopyFrom(buffer_src.data(), 0x4010U, 0x10U);
+    buffer.CopyFrom(buffer_src.data(), 0x0FF0U, 0x20U);
+    const auto &ranges = buffer.GetAddressRanges();
+    ASSERT_EQ(ranges.size(), 3U);
+    EXPECT_EQ(ranges.at(0U).lower(), 0x0FF0U);
+    EXPECT_EQ(ranges.at(0U).upper(), 0x12FFU);
+    EXPECT_EQ(ranges.at(1U).lower(), 0x4000U);
+    EXPECT_EQ(ranges.at(1U).upper(), 0x401FU);
+    EXPECT_EQ(ranges.at(2U).lower(), 0x8000U);
+    EXPECT_EQ(ranges.at(2U).upper(), 0x800FU);
+
+    // A copy contains the same contents. Unwritten memory reads as 0.
+    BMemoryBuffer buffer_copy(buffer);
+    std::vector<Byte> buffer_tgt;
+    buffer_copy.CopyTo(buffer_tgt, BInterval<DWord>(0x0FFEU, 0x1301U));
+    ASSERT_EQ(buffer_tgt.size(), 0x304U);
+    EXPECT_EQ(buffer_tgt.front(), 0x55U);
+    EXPECT_EQ(buffer_tgt.at(0x301U), 0x55U);
+    EXPECT_EQ(buffer_tgt.at(0x302U), 0x00U);
+    EXPECT_EQ(buffer_tgt.back(), 0x00U);
+}
@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+#include "bwrkpool.h"
+#include "flexerr.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+TEST(test_bwrkpool, fct_SameKeyInOrder)
+{
+    std::mutex mutex;
+    std::vector<int> sequence;
+    std::atomic<int> running{};
+    std::atomic<bool> isOverlapping{};
+
+    {
+        BWorkerPool pool(4U);
+
+        EXPECT_EQ(pool.GetThreadCount(), 4U);
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.Post("disk.dsk", [&, i](){
+                if (++running > 1)
+                {
+                    isOverlapping = true;
+                }
+                {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    sequence.push_back(i);
+                }
+                --running;
+            });
+        }
+        // The destructor executes all posted tasks.
+    }
+
+    EXPECT_FALSE(isOverlapping);
+    ASSERT_EQ(sequence.size(), 100U);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(sequence[static_cast<size_t>(i)], i);
+    }
+}
+
+TEST(test_bwrkpool, fct_DifferentKeysInParallel)
+{
+    BWorkerPool pool(2U);
+    std::promise<void> started;
+    auto startedFuture = started.get_future().share();
+
+    // The first task can only finish if the second one is executed
+    // in parallel.
+    auto first = pool.PostWithResult<bool>("a.dsk", [startedFuture](){
+        return startedFuture.wait_for(std::chrono::seconds(10)) ==
+               std::future_status::ready;
+    });
+    auto second = pool.PostWithResult<int>("b.dsk", [&started](){
+        started.set_value();
+        return 42;
+    });
+
+    EXPECT_TRUE(first.get());
+    EXPECT_EQ(second.get(), 42);
+}
+
+TEST(test_bwrkpool, fct_PostWithResult_exception)
+{
+    BWorkerPool pool(1U);
+
+    auto future = pool.PostWithResult<int>("", []() -> int {
+        throw FlexException(FERR_UNABLE_TO_OPEN, std::string("test.txt"));
+    });
+    EXPECT_THROW(future.get(), FlexException);
+
+    // The worker thread continues after an exception.
+    auto other = pool.PostWithResult<std::string>("", [](){
+        return std::string("ok");
+    });
+    EXPECT_EQ(other.get(), "ok");
+}
@@ -2,10 +2,17 @@
 #include "misc1.h"
 #include "da6809.h"
 #include <string>
+#include <array>
+#include <vector>
+#include <thread>
 #include <iomanip>
 #include <sstream>
+#include <fstream>
+#include <filesystem>
 #include "fmt/format.h"
 
+namespace fs = std::filesystem;
+
 
 TEST(test_da6809, dis_illegal)
 {
@@ -1015,6 +1022,111 @@ TEST(test_da6809, dis_flex_labels)
     }
 }
 
+TEST(test_da6809, dis_flex_labels_threads)
+{
+    // The label index is built by the first thread which needs it.
+    Da6809::SetFlexLabelFile("../src/flexlabl.conf");
+    static const std::array<Byte, 3> memory{ 0x7E, 0xCD, 0x03 };
+    std::vector<std::thread> threads;
+    std::array<std::string, 8> results;
+
+    for (auto &result : results)
+    {
+        threads.emplace_back([&result](){
+            Da6809 da;
+            DWord jumpaddr = 4711U;
+            std::string code;
+            std::string mnemonic;
+
+            da.Disassemble(memory.data(), 0U, jumpaddr, code, mnemonic,
+                           result);
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto &result : results)
+    {
+        EXPECT_EQ(result, "WARMS");
+    }
+}
+
+TEST(test_da6809, dis_symbol_file_labels)
+{
+    Da6809 da;
+    Da6809::SetFlexLabelFile("../src/flexlabl.conf");
+    const std::string path{"/tmp/da6809_symbols.lst"};
+    std::ofstream ofs(path);
+    ofs << "START EQU $0100 ; program start\n"
+           "LOOP = $0105\n"
+           "DATA1: $0200\n"
+           "WARMS EQU $CD03\n"
+           "       LDA $12\n"
+           "NODEC EQU 100\n";
+    ofs.close();
+    Da6809::AddSymbolFile(path);
+    DWord pc = 0x0000;
+    DWord jumpaddr = 4711U;
+    std::string code;
+    std::string mnemonic;
+    std::string operands;
+    static const std::vector<Byte> memory{
+        0x7E, 0x01, 0x00, 0x7E, 0x01, 0x05,
+        0xB6, 0x02, 0x00, 0x7E, 0xCD, 0x03,
+        0x7E, 0x00, 0x64, 0x8E, 0xCD, 0x06,
+    };
+    static const std::vector<const char *> expected_operands{
+        "START", "LOOP",
+        "DATA1", "WARMS",
+        "$0064", "#RENTER",
+    };
+    auto iexpected_operand = expected_operands.cbegin();
+    Word size = 3U;
+
+    while (pc < static_cast<Word>(memory.size()))
+    {
+        da.Disassemble(&memory[pc], pc, jumpaddr, code, mnemonic, operands);
+
+        EXPECT_EQ(operands, *(iexpected_operand++));
+        pc += size;
+    }
+    Da6809::ClearSymbolFiles();
+    fs::remove(path);
+}
+
+TEST(test_da6809, dis_fixed_buffer)
+{
+    Da6809 da;
+    DWord pc = 0x0000;
+    DWord jumpaddr = 4711U;
+    DWord jumpaddr2 = 4711U;
+    std::string code;
+    std::string mnemonic;
+    std::string operands;
+    DisassemblyText text;
+    static const std::vector<Byte> memory{
+        0x12, 0x86, 0x55, 0x10, 0xAE, 0x99, 0x12, 0x34,
+        0x34, 0x7F, 0x16, 0x12, 0x34, 0x1F, 0x89, 0x10,
+        0x2E, 0xFF, 0xF0, 0x01, 0x00,
+    };
+
+    while (pc < static_cast<Word>(memory.size()))
+    {
+        const auto flags = da.Disassemble(&memory[pc], pc, jumpaddr, code,
+                mnemonic, operands);
+        const auto flags2 = da.Disassemble(&memory[pc], pc, jumpaddr2, text);
+
+        EXPECT_EQ(flags, flags2);
+        EXPECT_EQ(jumpaddr, jumpaddr2);
+        EXPECT_EQ(code, text.code.data());
+        EXPECT_EQ(mnemonic, text.mnemonic.data());
+        EXPECT_EQ(operands, text.operands.data());
+        pc += da.getByteSize(&memory[pc]);
+    }
+}
+
 TEST(test_da6809, fct_getByteSize_page1)
 {
     Da6809 da;
@@ -0,0 +1,249 @@
+#include "gtest/gtest.h"
+#include "fdedupst.h"
+#include "fdedupdk.h"
+#include "ffilecnt.h"
+#include "ffilebuf.h"
+#include "filfschk.h"
+#include "filecntb.h"
+#include "flexerr.h"
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace fs = std::filesystem;
+
+class test_fdedupst : public ::testing::Test
+{
+protected:
+    const fs::path tempDir{fs::temp_directory_path() / "test_fdedupst"};
+    const fs::path storeDir{tempDir / "store"};
+    const std::string subdir{"data/"};
+    std::array<std::string, 2> diskPaths;
+
+    void SetUp() override
+    {
+        fs::remove_all(tempDir);
+        fs::create_directory(tempDir);
+        diskPaths[0] = (tempDir / "disk1.dsk").u8string();
+        diskPaths[1] = (tempDir / "disk2.flx").u8string();
+
+        // Two disks with identical contents but different file formats.
+        FlexFileBuffer buffer;
+        ASSERT_TRUE(buffer.ReadFromFile(subdir + "cat.cmd",
+                    FileTimeAccess::NONE));
+        for (const auto &path : diskPaths)
+        {
+            const auto fmt = (&path == &diskPaths[0]) ?
+                TYPE_DSK_DISKFILE : TYPE_FLX_DISKFILE;
+            std::unique_ptr<FlexDisk> disk(FlexDisk::Create(path,
+                        FileTimeAccess::NONE, 35, 10, fmt));
+            ASSERT_NE(disk.get(), nullptr);
+            ASSERT_TRUE(disk->WriteFromBuffer(buffer));
+        }
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(tempDir);
+    }
+
+    static std::vector<char> ReadFile(const std::string &path)
+    {
+        std::ifstream ifs(path, std::ios::in | std::ios::binary);
+
+        return std::vector<char>(std::istreambuf_iterator<char>(ifs),
+                                 std::istreambuf_iterator<char>());
+    }
+};
+
+TEST_F(test_fdedupst, fct_ImportExport)
+{
+    const auto exportPath = (tempDir / "export").u8string();
+    DWord count1;
+    DWord count2;
+
+    {
+        FlexDedupStore store(storeDir.u8string());
+
+        EXPECT_EQ(store.GetSectorCount(), 0U);
+        count1 = store.Import(diskPaths[0], "disk1.dsk");
+        EXPECT_GT(count1, 0U);
+        EXPECT_LE(count1, 35U * 10U);
+        count2 = store.Import(diskPaths[1], "disk2.flx");
+        // Both disks only differ in the sector containing the disk name.
+        EXPECT_LE(count2, 2U);
+        EXPECT_EQ(store.GetSectorCount(), count1 + count2);
+        EXPECT_EQ(store.Import(diskPaths[0], "disk1.dsk"), 0U);
+        EXPECT_TRUE(store.HasImage("disk1.dsk"));
+        EXPECT_FALSE(store.HasImage("disk3.dsk"));
+        const auto manifest = store.ReadManifest("disk2.flx");
+        EXPECT_EQ(manifest.header.size(), sizeof(s_flex_header));
+        EXPECT_EQ(manifest.indices.size(), 35U * 10U);
+    }
+
+    // Reopen the store from the file system.
+    EXPECT_TRUE(FlexDedupStore::IsStore(storeDir.u8string()));
+    EXPECT_FALSE(FlexDedupStore::IsStore(tempDir.u8string()));
+    const FlexDedupStore store(storeDir.u8string());
+    EXPECT_EQ(store.GetSectorCount(), count1 + count2);
+    EXPECT_EQ(store.GetImageNames(),
+              std::vector<std::string>({ "disk1.dsk", "disk2.flx" }));
+    for (const auto &path : diskPaths)
+    {
+        store.Export(fs::path(path).filename().u8string(), exportPath);
+        EXPECT_EQ(ReadFile(exportPath), ReadFile(path)) << path;
+    }
+    EXPECT_THROW(store.Export("disk3.dsk", exportPath), FlexException);
+
+    // Not a FLEX disk image.
+    FlexDedupStore otherStore(storeDir.u8string());
+    EXPECT_THROW(otherStore.Import(subdir + "cat.cmd", "cat.cmd"),
+                 FlexException);
+}
+
+TEST_F(test_fdedupst, fct_PartialSector)
+{
+    const auto exportPath = (tempDir / "export").u8string();
+    const auto sectorsPath = storeDir / "sectors.dat";
+    DWord count1;
+
+    {
+        FlexDedupStore store(storeDir.u8string());
+
+        count1 = store.Import(diskPaths[0], "disk1.dsk");
+    }
+
+    // Simulate a failed append of a new sector.
+    {
+        std::ofstream ofs(sectorsPath, std::ios::out | std::ios::binary |
+                                       std::ios::app);
+        const std::string partialSector(100U, '\x55');
+
+        ofs << partialSector;
+    }
+
+    FlexDedupStore store(storeDir.u8string());
+    EXPECT_EQ(store.GetSectorCount(), count1);
+    const auto count2 = store.Import(diskPaths[1], "disk2.flx");
+    EXPECT_GT(count2, 0U);
+    EXPECT_EQ(fs::file_size(sectorsPath), (count1 + count2) * SECTOR_SIZE);
+    store.Export("disk2.flx", exportPath);
+    EXPECT_EQ(ReadFile(exportPath), ReadFile(diskPaths[1]));
+}
+
+TEST_F(test_fdedupst, fct_FlexDedupDisk)
+{
+    auto store = std::make_shared<FlexDedupStore>(storeDir.u8string());
+    std::array<Byte, SECTOR_SIZE> sector{};
+    std::array<Byte, SECTOR_SIZE> otherSector{};
+
+    for (const auto &path : diskPaths)
+    {
+        const auto name = fs::path(path).filename().u8string();
+        store->Import(path, name);
+
+        const FlexDisk disk(path, std::ios::in | std::ios::binary,
+                            FileTimeAccess::NONE);
+        FlexDedupDisk dedupDisk(store, name);
+
+        EXPECT_TRUE(dedupDisk.IsFlexFormat());
+        EXPECT_TRUE(dedupDisk.IsWriteProtected());
+        EXPECT_NE(dedupDisk.GetFlexDiskType() & TYPE_DEDUP_DISKFILE, 0U);
+        for (int trk = 0; trk <= 35; ++trk)
+        {
+            EXPECT_EQ(dedupDisk.IsTrackValid(trk), disk.IsTrackValid(trk));
+            for (int sec = 0; sec <= 11; ++sec)
+            {
+                const auto isValid = disk.IsSectorValid(trk, sec);
+
+                ASSERT_EQ(dedupDisk.IsSectorValid(trk, sec), isValid) <<
+                    name << " trk=" << trk << " sec=" << sec;
+                if (isValid)
+                {
+                    ASSERT_TRUE(disk.ReadSector(sector.data(), trk, sec));
+                    ASSERT_TRUE(dedupDisk.ReadSector(otherSector.data(),
+                                                     trk, sec));
+                    EXPECT_EQ(sector, otherSector) <<
+                        name << " trk=" << trk << " sec=" << sec;
+                }
+            }
+        }
+        EXPECT_FALSE(dedupDisk.WriteSector(sector.data(), 1, 1));
+
+        FlexDiskAttributes attributes;
+        FlexDiskAttributes dedupAttributes;
+        ASSERT_TRUE(disk.GetDiskAttributes(attributes));
+        ASSERT_TRUE(dedupDisk.GetDiskAttributes(dedupAttributes));
+        EXPECT_EQ(dedupAttributes.GetName(), attributes.GetName());
+        EXPECT_EQ(dedupAttributes.GetFree(), attributes.GetFree());
+        EXPECT_EQ(dedupAttributes.GetTotalSize(), attributes.GetTotalSize());
+
+        auto checker = FlexDiskCheck(dedupDisk, FileTimeAccess::NONE);
+        EXPECT_TRUE(checker.CheckFileSystem());
+        EXPECT_TRUE(checker.GetResult().empty());
+    }
+}
+
+TEST_F(test_fdedupst, fct_IndexFile)
+{
+    const auto indexPath = storeDir / "sectors.idx";
+    DWord count;
+
+    {
+        FlexDedupStore store(storeDir.u8string());
+
+        count = store.Import(diskPaths[0], "disk1.dsk");
+    }
+    ASSERT_TRUE(fs::exists(indexPath));
+    EXPECT_EQ(fs::file_size(indexPath), (count + 1U) * sizeof(DWord));
+
+    // Another store object, e.g. of another process, appends sectors.
+    // They are used when importing into the first store object.
+    FlexDedupStore store(storeDir.u8string());
+    {
+        FlexDedupStore otherStore(storeDir.u8string());
+
+        EXPECT_EQ(otherStore.GetSectorCount(), count);
+        EXPECT_LE(otherStore.Import(diskPaths[1], "disk2.flx"), 2U);
+    }
+    EXPECT_EQ(store.Import(diskPaths[1], "disk3.flx"), 0U);
+    count = store.GetSectorCount();
+    EXPECT_EQ(fs::file_size(indexPath), (count + 1U) * sizeof(DWord));
+
+    // A missing or invalid index file is rebuilt.
+    const auto index = ReadFile(indexPath.u8string());
+    fs::remove(indexPath);
+    EXPECT_EQ(FlexDedupStore(storeDir.u8string()).GetSectorCount(), count);
+    EXPECT_EQ(ReadFile(indexPath.u8string()), index);
+    {
+        std::fstream ofs(indexPath, std::ios::in | std::ios::out |
+                                    std::ios::binary);
+        ofs.put('X');
+    }
+    const FlexDedupStore otherStore(storeDir.u8string());
+    EXPECT_EQ(otherStore.GetSectorCount(), count);
+    EXPECT_EQ(ReadFile(indexPath.u8string()), index);
+
+    const auto exportPath = (tempDir / "export").u8string();
+    otherStore.Export("disk3.flx", exportPath);
+    EXPECT_EQ(ReadFile(exportPath), ReadFile(diskPaths[1]));
+}
+
+TEST_F(test_fdedupst, fct_LockFile)
+{
+    const auto lockPath = storeDir / "sectors.lck";
+    FlexDedupStore store(storeDir.u8string());
+
+    std::ofstream(lockPath).close();
+    EXPECT_THROW(store.Import(diskPaths[0], "disk1.dsk"), FlexException);
+    EXPECT_EQ(store.GetSectorCount(), 0U);
+    EXPECT_FALSE(store.HasImage("disk1.dsk"));
+    fs::remove(lockPath);
+    EXPECT_GT(store.Import(diskPaths[0], "disk1.dsk"), 0U);
+    EXPECT_FALSE(fs::exists(lockPath));
+}
@@ -7,10 +7,13 @@
 #include "rfilecnt.h"
 #include "ndircont.h"
 #include "filfschk.h"
+#include "flexerr.h"
 #include "fixt_filecont.h"
 #include <array>
 #include <fstream>
 #include <filesystem>
+#include <memory>
+#include <vector>
 
 
 using ::testing::StartsWith;
@@ -560,3 +563,152 @@ TEST_F(test_IFlexDiskBySector, exec_FlexDiskCheck)
         }
     }
 }
+
+TEST_F(test_IFlexDiskBySector, fct_RamDiskFlush)
+{
+    std::array<Byte, SECTOR_SIZE> buffer{};
+    std::array<Byte, SECTOR_SIZE> fileBuffer{};
+
+    for (int tidx = DSK; tidx <= FLX; ++tidx)
+    {
+        auto *disk = dynamic_cast<FlexRamDisk *>(disks[RAM][tidx].get());
+        ASSERT_NE(disk, nullptr);
+        const auto offset = (tidx == FLX) ? sizeof(s_flex_header) : 0U;
+        const auto path = disk->GetPath();
+        // Byte offset of a sector on a 35-10 disk image file.
+        auto byteOffset = [&](int track, int sector){
+            return static_cast<std::streamoff>(offset +
+                (track * sectors + sector - 1) * SECTOR_SIZE);
+        };
+
+        buffer.fill(0x55);
+        ASSERT_TRUE(disk->WriteSector(buffer.data(), 3, 2));
+        ASSERT_TRUE(disk->WriteSector(buffer.data(), 3, 3));
+        ASSERT_TRUE(disk->WriteSector(buffer.data(), 5, 10));
+
+        // Change an unchanged sector on file. It is not overwritten by
+        // Flush() because only changed sectors are written back.
+        {
+            std::fstream ofs(path, std::ios::in | std::ios::out |
+                                   std::ios::binary);
+            fileBuffer.fill(0xAA);
+            ofs.seekp(byteOffset(10, 1));
+            ofs.write(reinterpret_cast<const char *>(fileBuffer.data()),
+                      SECTOR_SIZE);
+            ASSERT_FALSE(ofs.fail());
+        }
+        EXPECT_TRUE(disk->Flush());
+        EXPECT_FALSE(disk->IsScratch());
+
+        std::ifstream ifs(path, std::ios::in | std::ios::binary);
+        for (const auto &ts : std::vector<st_t>{ {3, 2}, {3, 3}, {5, 10} })
+        {
+            ifs.seekg(byteOffset(ts.trk, ts.sec));
+            ifs.read(reinterpret_cast<char *>(fileBuffer.data()),
+                     SECTOR_SIZE);
+            EXPECT_EQ(fileBuffer, buffer) << "path=" << path << " " << ts;
+        }
+        ifs.seekg(byteOffset(10, 1));
+        ifs.read(reinterpret_cast<char *>(fileBuffer.data()), SECTOR_SIZE);
+        EXPECT_EQ(fileBuffer[0], 0xAA) << "path=" << path;
+    }
+}
+
+TEST_F(test_IFlexDiskBySector, fct_RamDiskDetach)
+{
+    std::array<Byte, SECTOR_SIZE> buffer{};
+    std::array<Byte, SECTOR_SIZE> otherBuffer{};
+    std::array<Byte, SECTOR_SIZE> fileBuffer{};
+
+    for (int tidx = DSK; tidx <= FLX; ++tidx)
+    {
+        auto &ramDisk = disks[RAM][tidx];
+        auto *disk = dynamic_cast<FlexRamDisk *>(ramDisk.get());
+        ASSERT_NE(disk, nullptr);
+        const auto path = disk->GetPath();
+
+        ASSERT_TRUE(disk->ReadSector(fileBuffer.data(), 3, 2));
+        buffer.fill(0x55);
+        ASSERT_TRUE(disk->WriteSector(buffer.data(), 3, 2));
+        disk->Detach();
+
+        // After detaching changes are only kept in memory.
+        buffer.fill(0x66);
+        ASSERT_TRUE(disk->WriteSector(buffer.data(), 3, 3));
+        ASSERT_TRUE(disk->ReadSector(otherBuffer.data(), 3, 3));
+        EXPECT_EQ(otherBuffer, buffer);
+        ramDisk.reset();
+
+        FlexDisk fileDisk(path, std::ios::in | std::ios::binary,
+                          FileTimeAccess::NONE);
+        ASSERT_TRUE(fileDisk.ReadSector(otherBuffer.data(), 3, 2));
+        EXPECT_EQ(otherBuffer, fileBuffer) << "path=" << path;
+    }
+}
+
+TEST_F(test_IFlexDiskBySector, fct_ScratchDisk)
+{
+    std::array<Byte, SECTOR_SIZE> buffer{};
+    std::array<Byte, SECTOR_SIZE> otherBuffer{};
+
+    for (int tidx = DSK; tidx <= FLX; ++tidx)
+    {
+        const auto fmt = (tidx == DSK) ? TYPE_DSK_DISKFILE : TYPE_FLX_DISKFILE;
+        const auto path = (fs::temp_directory_path() /
+                           (tidx == DSK ? "scratch.dsk" : "scratch.flx"))
+                          .u8string();
+        FlexRamDisk scratch("scratch", no_ft, tracks, sectors, fmt);
+        std::unique_ptr<FlexDisk> disk(FlexDisk::Create(path, no_ft,
+                    tracks, sectors, fmt));
+        ASSERT_NE(disk.get(), nullptr);
+
+        EXPECT_TRUE(scratch.IsFlexFormat());
+        EXPECT_TRUE(scratch.IsScratch());
+        EXPECT_FALSE(scratch.IsWriteProtected());
+        EXPECT_EQ(scratch.GetPath(), "scratch");
+        EXPECT_EQ(scratch.GetFlexDiskType(),
+                  disk->GetFlexDiskType() | TYPE_RAM_DISKFILE);
+
+        // Same geometry and contents as a formatted disk image file,
+        // except for the disk name.
+        for (int track = 0; track <= tracks; ++track)
+        {
+            EXPECT_EQ(scratch.IsTrackValid(track), disk->IsTrackValid(track));
+            for (int sector = 0; sector <= sectors + 1; ++sector)
+            {
+                const auto isValid = disk->IsSectorValid(track, sector);
+
+                ASSERT_EQ(scratch.IsSectorValid(track, sector), isValid)
+                    << "track=" << track << " sector=" << sector;
+                if (isValid && !(track == 0 && sector == 3))
+                {
+                    ASSERT_TRUE(scratch.ReadSector(buffer.data(), track,
+                                                   sector));
+                    ASSERT_TRUE(disk->ReadSector(otherBuffer.data(), track,
+                                                 sector));
+                    EXPECT_EQ(buffer, otherBuffer)
+                        << "track=" << track << " sector=" << sector;
+                }
+            }
+        }
+
+        FlexDiskAttributes attributes;
+        ASSERT_TRUE(scratch.GetDiskAttributes(attributes));
+        EXPECT_EQ(attributes.GetName(), "SCRATCH");
+
+        FlexDiskCheck checker(scratch, no_ft);
+        EXPECT_TRUE(checker.CheckFileSystem());
+
+        buffer.fill(0x55);
+        EXPECT_TRUE(scratch.WriteSector(buffer.data(), 4, 5));
+        EXPECT_TRUE(scratch.ReadSector(otherBuffer.data(), 4, 5));
+        EXPECT_EQ(buffer, otherBuffer);
+        EXPECT_TRUE(scratch.Flush());
+        disk.reset();
+        fs::remove(path);
+    }
+
+    EXPECT_THROW(FlexRamDisk("scratch", no_ft, 1, sectors), FlexException);
+    EXPECT_THROW(FlexRamDisk("scratch", no_ft, tracks, sectors,
+                             TYPE_DIRECTORY_BY_SECTOR), FlexException);
+}
@@ -10,12 +10,16 @@
 #include "flexerr.h"
 #include "fcopyman.h"
 #include "ffilebuf.h"
+#include "filfschk.h"
 #include "fixt_filecont.h"
 #include <array>
 #include <memory>
 #include <fstream>
 #include <filesystem>
 #include <numeric>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
 #include <fmt/format.h>
 
 
@@ -444,6 +448,161 @@ TEST_F(test_IFlexDiskByFile, fct_WriteFromBuffer)
     fs::remove(path);
 }
 
+TEST_F(test_IFlexDiskByFile, fct_WriteFromBuffers)
+{
+    // Both disks have the same disk name.
+    const auto diskDir = fs::temp_directory_path() / "test_filecont";
+    const auto otherDir = diskDir / "other";
+    fs::create_directories(otherDir);
+    std::unique_ptr<FlexDisk> disk(FlexDisk::Create(
+                (diskDir / "disk.dsk").u8string(), no_ft, 35, 10));
+    ASSERT_NE(disk.get(), nullptr);
+    std::unique_ptr<FlexDisk> otherDisk(FlexDisk::Create(
+                (otherDir / "disk.dsk").u8string(), no_ft, 35, 10));
+    ASSERT_NE(otherDisk.get(), nullptr);
+    std::vector<FlexFileBuffer> buffers;
+
+    // More files than fit into one directory sector, one of them random.
+    for (int i = 0; i < 12; ++i)
+    {
+        FlexFileBuffer buffer;
+        std::vector<Byte> data(static_cast<size_t>(i + 1) *
+                               (SECTOR_SIZE - 4U));
+
+        for (size_t j = 0U; j < data.size(); ++j)
+        {
+            data[j] = static_cast<Byte>(j + static_cast<size_t>(i));
+        }
+        buffer.Realloc(static_cast<DWord>(data.size()));
+        ASSERT_TRUE(buffer.CopyFrom(data.data(),
+                    static_cast<DWord>(data.size())));
+        buffer.SetFilename("file" + std::to_string(i) + ".bin");
+        buffer.SetDateTime(BDate(1, 2, 1985), BTime());
+        buffer.SetSectorMap(i == 5 ? IS_RANDOM_FILE : 0);
+        buffers.push_back(buffer);
+    }
+
+    // Writing all files at once results in the same disk image as writing
+    // them one by one.
+    FlexFileBuffer catBuffer;
+    ASSERT_TRUE(catBuffer.ReadFromFile("data/cat.cmd", no_ft));
+    ASSERT_TRUE(disk->WriteFromBuffer(catBuffer));
+    ASSERT_TRUE(otherDisk->WriteFromBuffer(catBuffer));
+    ASSERT_TRUE(otherDisk->WriteFromBuffers(buffers));
+    for (const auto &buffer : buffers)
+    {
+        ASSERT_TRUE(disk->WriteFromBuffer(buffer));
+    }
+
+    std::array<Byte, SECTOR_SIZE> sector{};
+    std::array<Byte, SECTOR_SIZE> otherSector{};
+    for (int trk = 0; trk < 35; ++trk)
+    {
+        for (int sec = 1; sec <= 10; ++sec)
+        {
+            ASSERT_TRUE(disk->ReadSector(sector.data(), trk, sec));
+            ASSERT_TRUE(otherDisk->ReadSector(otherSector.data(), trk, sec));
+            EXPECT_EQ(sector, otherSector) << "trk=" << trk << " sec=" << sec;
+        }
+    }
+
+    auto readBuffer = otherDisk->ReadToBuffer("file11.bin");
+    EXPECT_EQ(readBuffer.GetFileSize(), 12U * (SECTOR_SIZE - 4U));
+    EXPECT_EQ(*readBuffer.GetBuffer(3000U), static_cast<Byte>(3011U));
+
+    // Nothing is written if the files do not fit on the disk.
+    s_sys_info_sector sis{};
+    ASSERT_TRUE(otherDisk->ReadSector(reinterpret_cast<Byte *>(&sis), 0, 3));
+    std::vector<FlexFileBuffer> tooLarge(1);
+    tooLarge[0].Realloc(350U * (SECTOR_SIZE - 4U));
+    tooLarge[0].SetFilename("large.bin");
+    buffers.resize(1);
+    buffers[0].SetFilename("small.bin");
+    tooLarge.insert(tooLarge.begin(), buffers[0]);
+    EXPECT_THAT([&](){ otherDisk->WriteFromBuffers(tooLarge); },
+            testing::Throws<FlexException>());
+    FlexDirEntry entry;
+    EXPECT_FALSE(otherDisk->FindFile("small.bin", entry));
+    s_sys_info_sector sisAfter{};
+    ASSERT_TRUE(otherDisk->ReadSector(reinterpret_cast<Byte *>(&sisAfter),
+                0, 3));
+    EXPECT_EQ(std::memcmp(&sis, &sisAfter, sizeof(sis)), 0);
+
+    // A file name may only be used once.
+    buffers.push_back(buffers[0]);
+    EXPECT_THAT([&](){ otherDisk->WriteFromBuffers(buffers); },
+            testing::Throws<FlexException>());
+    EXPECT_FALSE(otherDisk->FindFile("small.bin", entry));
+
+    disk.reset();
+    otherDisk.reset();
+    fs::remove_all(diskDir);
+    fs::remove(fs::current_path() / "data" / ".random");
+}
+
+TEST_F(test_IFlexDiskByFile, fct_WriteRandomFromBuffer)
+{
+    const auto diskPath =
+        (fs::temp_directory_path() / "random.dsk").u8string();
+    std::unique_ptr<FlexDisk> disk(FlexDisk::Create(diskPath, no_ft, 35, 10));
+    ASSERT_NE(disk.get(), nullptr);
+    // The buffer of a random file also contains the two sector map sectors.
+    const DWord dataSize = 12U * (SECTOR_SIZE - 4U);
+    const DWord mapSize = 2U * (SECTOR_SIZE - 4U);
+    std::vector<Byte> data(dataSize, 0xFFU);
+    FlexFileBuffer buffer;
+
+    for (DWord i = mapSize; i < dataSize; ++i)
+    {
+        data[i] = static_cast<Byte>(i);
+    }
+    buffer.Realloc(dataSize);
+    ASSERT_TRUE(buffer.CopyFrom(data.data(), dataSize));
+    buffer.SetFilename("random.dat");
+    buffer.SetDateTime(BDate(1, 2, 1985), BTime());
+    buffer.SetSectorMap(IS_RANDOM_FILE);
+    ASSERT_TRUE(disk->WriteFromBuffer(buffer));
+
+    FlexDirEntry entry;
+    ASSERT_TRUE(disk->FindFile("random.dat", entry));
+    EXPECT_TRUE(entry.IsRandom());
+    EXPECT_EQ(entry.GetFileSize(), 12U * SECTOR_SIZE);
+
+    auto readBuffer = disk->ReadToBuffer("random.dat");
+    ASSERT_EQ(readBuffer.GetFileSize(), dataSize);
+    std::vector<Byte> readData(dataSize);
+    ASSERT_TRUE(readBuffer.CopyTo(readData.data(), dataSize));
+    EXPECT_TRUE(std::equal(data.cbegin() + mapSize, data.cend(),
+                           readData.cbegin() + mapSize));
+
+    // The sector map is newly created. It refers to the 10 data sectors
+    // which follow the two sector map sectors.
+    int trk;
+    int sec;
+    entry.GetStartTrkSec(trk, sec);
+    std::array<Byte, SECTOR_SIZE> mapSector{};
+    ASSERT_TRUE(disk->ReadSector(mapSector.data(), trk, sec));
+    ASSERT_TRUE(disk->ReadSector(mapSector.data(), mapSector[0],
+                mapSector[1]));
+    EXPECT_EQ(readData[0], mapSector[0]);
+    EXPECT_EQ(readData[1], mapSector[1]);
+    unsigned count = 0U;
+    for (DWord index = 0U; index + 2U < SECTOR_SIZE - 4U; index += 3U)
+    {
+        count += readData[index + 2U];
+    }
+    EXPECT_EQ(count, 10U);
+    EXPECT_EQ(std::count(readData.cbegin() + SECTOR_SIZE - 4U,
+                         readData.cbegin() + mapSize, 0), mapSize / 2U);
+
+    auto checker = FlexDiskCheck(*disk, no_ft);
+    EXPECT_TRUE(checker.CheckFileSystem());
+    EXPECT_TRUE(checker.GetResult().empty());
+
+    disk.reset();
+    fs::remove(diskPath);
+}
+
 TEST_F(test_IFlexDiskByFile, fct_FileCopy)
 {
     FlexCopyManager::autoTextConversion = true;
@@ -507,6 +666,54 @@ TEST_F(test_IFlexDiskByFile, fct_FileCopy)
     }
 }
 
+TEST_F(test_IFlexDiskByFile, fct_FileCopyRandom)
+{
+    const DWord dataSize = (SECTOR_SIZE - 4) * 12;
+    std::vector<Byte> data(dataSize);
+    FlexFileBuffer buffer;
+
+    // A random file buffer also contains the two sector map sectors.
+    std::iota(data.begin(), data.end(), Byte{0});
+    buffer.Realloc(dataSize);
+    ASSERT_TRUE(buffer.CopyFrom(data.data(), dataSize));
+    buffer.SetFilename("RANDOM.DAT");
+    buffer.SetSectorMap(IS_RANDOM_FILE);
+    buffer.SetDateTime(BDate(11, 8, 2024), BTime());
+
+    auto &src = disks[RW][DSK];
+    ASSERT_TRUE(src->WriteFromBuffer(buffer));
+
+    for (auto &tgt : disks[TGT])
+    {
+        FlexDirEntry entry;
+
+        tgt->DeleteFile("RANDOM.DAT");
+        EXPECT_FALSE(src->FileCopy("RANDOM.DAT", "RANDOM.DAT", *tgt.get()));
+        ASSERT_TRUE(tgt->FindFile("RANDOM.DAT", entry));
+        EXPECT_TRUE(entry.IsRandom());
+        EXPECT_EQ(entry.GetFileSize(), SECTOR_SIZE * 12);
+        EXPECT_EQ(entry.GetDate(), BDate(11, 8, 2024));
+
+        const auto result = tgt->ReadToBuffer("RANDOM.DAT");
+        ASSERT_EQ(result.GetFileSize(), dataSize);
+        std::vector<Byte> resultData(dataSize);
+        ASSERT_TRUE(result.CopyTo(resultData.data(), dataSize));
+        const auto mapSize = 2U * (SECTOR_SIZE - 4);
+        EXPECT_TRUE(std::equal(data.cbegin() + mapSize, data.cend(),
+                               resultData.cbegin() + mapSize));
+        if ((tgt->GetFlexDiskType() & TYPE_DISKFILE) != 0U)
+        {
+            // The sector map contains the 10 data sectors of the new file.
+            unsigned count = 0U;
+            for (DWord index = 0U; index + 2U < mapSize; index += 3U)
+            {
+                count += resultData[index + 2U];
+            }
+            EXPECT_EQ(count, 10U);
+        }
+    }
+}
+
 TEST_F(test_IFlexDiskByFile, fct_GetSupportedAttributes)
 {
     for (auto &disk : disks[RW])
@@ -572,6 +779,77 @@ TEST_F(test_IFlexDiskByFile, fcts_begin_end)
     }
 }
 
+TEST_F(test_IFlexDiskByFile, fcts_wildcards)
+{
+    const std::vector<std::string> wildcards{
+        "test05.txt", "TEST0*", "*.bin", "*.b*", "T?ST1*.TXT", "*5.*",
+        "*.tx", "test*.txtt", "test0[1]*", "*01.bin;test1*;*.bin",
+        "*0.*;x*", "*", "",
+    };
+    const std::vector<int> indices{RO, RW};
+    for (int idx : indices)
+    {
+        for (auto &disk : disks[idx])
+        {
+            if (!disk)
+            {
+                continue;
+            }
+
+            std::vector<std::string> allFilenames;
+            FlexDiskIterator iter("*");
+            for (iter = disk->begin(); iter != disk->end(); ++iter)
+            {
+                allFilenames.push_back(iter->GetTotalFileName());
+            }
+            ASSERT_EQ(allFilenames.size(), 20U);
+
+            for (const auto &wildcard : wildcards)
+            {
+                std::vector<std::string> expected;
+                std::copy_if(allFilenames.cbegin(), allFilenames.cend(),
+                        std::back_inserter(expected),
+                        [&](const std::string &filename){
+                            return flx::multimatches(filename, wildcard, ';',
+                                                     true);
+                        });
+                std::vector<std::string> filenames;
+                FlexDiskIterator iter1(wildcard);
+                for (iter1 = disk->begin(); iter1 != disk->end(); ++iter1)
+                {
+                    filenames.push_back(iter1->GetTotalFileName());
+                }
+                EXPECT_EQ(filenames, expected) << "wildcard=" << wildcard;
+            }
+        }
+    }
+
+    // A directory sector written by sector is visible on file level.
+    for (int tidx = DSK; tidx <= FLX; ++tidx)
+    {
+        auto *disk = dynamic_cast<FlexDisk *>(disks[RW][tidx].get());
+        ASSERT_NE(disk, nullptr);
+        FlexDirEntry entry;
+        EXPECT_TRUE(disk->FindFile("TEST01.TXT", entry));
+        EXPECT_TRUE(disk->FindFile("*.TXT", entry));
+
+        s_dir_sector dirSector{};
+        const auto st = first_dir_trk_sec;
+        ASSERT_TRUE(disk->ReadSector(reinterpret_cast<Byte *>(&dirSector),
+                                     st.trk, st.sec));
+        auto &dirEntry = dirSector.dir_entries[0];
+        const auto name = flx::getstr<>(dirEntry.filename) + '.' +
+                          flx::getstr<>(dirEntry.file_ext);
+        std::memcpy(dirEntry.file_ext, "XYZ", FLEX_FILEEXT_LENGTH);
+        ASSERT_TRUE(disk->WriteSector(reinterpret_cast<Byte *>(&dirSector),
+                                      st.trk, st.sec));
+        EXPECT_FALSE(disk->FindFile(name, entry));
+        EXPECT_TRUE(disk->FindFile("*.XYZ", entry));
+        EXPECT_EQ(entry.GetTotalFileName(),
+                  flx::getstr<>(dirEntry.filename) + ".XYZ");
+    }
+}
+
 TEST_F(test_IFlexDiskByFile, fcts_ReadOnly)
 {
     const std::vector<int> indices{RO, ROM};
@@ -31,6 +31,7 @@ struct TestMemory : public MemoryTarget<DWord>, public MemorySource<DWord>
             secureSize -= address + size - buffer.size();
         }
         memcpy(buffer.data() + address, source, secureSize);
+        ++copyFromCount;
 
         if (secureSize > 0U)
         {
@@ -61,6 +62,7 @@ struct TestMemory : public MemoryTarget<DWord>, public MemorySource<DWord>
     }
     AddressRanges addressRanges;
     std::array<Byte, 65536> buffer{};
+    int copyFromCount{};
 };
 
 TEST(test_fileread, fct_load_hexfile)
@@ -200,6 +202,73 @@ TEST(test_fileread, fct_load_hexfile__motorola)
     }
 }
 
+TEST(test_fileread, fct_load_hexfile__error_position)
+{
+    std::array<std::string, 5> file_contents{
+       ":0401000001020304F1\n:04010400Z5060708E1\n:00000001FF\n",
+       ":0401000001020304F1\r\n:0401040005060708E2\r\n",
+       "S107010001020304ED\nS3070100010203040B\n",
+       "S107010001020304ED\nS9030100FB\nX",
+       ":0401000001020304F1\n:0401040005060708DD\n:00000001FF",
+    };
+    std::array<int, 5> expected_results{ -3, -4, -3, 0, 0 };
+    std::array<sHexFilePosition, 5> expected_positions{{
+        { 2U, 10U }, { 2U, 18U }, { 2U, 2U }, { 0U, 0U }, { 0U, 0U },
+    }};
+
+    const auto path = fs::temp_directory_path() / "test_error_position.hex";
+    for (size_t index = 0U; index < file_contents.size(); ++index)
+    {
+        std::fstream ofs(path, std::ios::out | std::ios::trunc |
+                               std::ios::binary);
+        ASSERT_TRUE(ofs.is_open());
+        ofs << file_contents[index];
+        ofs.close();
+        TestMemory memory{};
+        DWord start_addr = 0U;
+        sHexFilePosition position;
+        auto result = load_hexfile(path, memory, start_addr, &position);
+        EXPECT_EQ(result, expected_results[index]) << "index=" << index;
+        EXPECT_EQ(position.line, expected_positions[index].line) <<
+            "index=" << index;
+        EXPECT_EQ(position.column, expected_positions[index].column) <<
+            "index=" << index;
+        fs::remove(path);
+    }
+
+    std::stringstream stream;
+    print_hexfile_error(stream, -4, sHexFilePosition{ 2U, 18U });
+    EXPECT_EQ(stream.str(), "Wrong checksum. Line 2, column 18.");
+}
+
+TEST(test_fileread, fct_load_hexfile__contiguous_records)
+{
+    // Contiguous data records are copied to the memory target at once.
+    const std::string file_content{
+        ":0401000001020304F1\n"
+        ":0401040005060708DD\n"
+        ":02020000AA55FD\n"
+        ":00000001FF\n"
+    };
+    const auto path = fs::temp_directory_path() / "test_contiguous.hex";
+    std::fstream ofs(path, std::ios::out | std::ios::trunc);
+    ASSERT_TRUE(ofs.is_open());
+    ofs << file_content;
+    ofs.close();
+    TestMemory memory{};
+    DWord start_addr = 0U;
+    auto result = load_hexfile(path, memory, start_addr);
+    ASSERT_EQ(result, 0);
+    EXPECT_EQ(memory.copyFromCount, 2);
+    EXPECT_EQ(memory.buffer[0x0100], 0x01);
+    EXPECT_EQ(memory.buffer[0x0107], 0x08);
+    EXPECT_EQ(memory.buffer[0x0200], 0xAA);
+    EXPECT_EQ(memory.buffer[0x0201], 0x55);
+    const auto &ranges = memory.GetAddressRanges();
+    ASSERT_EQ(ranges.size(), 2U);
+    fs::remove(path);
+}
+
 TEST(test_fileread, fct_load_hexfile__flex_binary)
 {
     std::array<std::array<char, 20>, 6> file_contents{{
@@ -7,6 +7,10 @@
 #include <array>
 #include <memory>
 #include <filesystem>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 
 using ::testing::StartsWith;
@@ -454,3 +458,100 @@ TEST_F(test_filfschk, check_BadFileTime)
     EXPECT_EQ(item->name, fileNameOnDisk);
 }
 
+TEST_F(test_filfschk, check_DebugDumpLinks)
+{
+    ModifySector(0x22, 9, [](std::array<Byte, SECTOR_SIZE> &sectorBuffer){
+        // Manipulate sector 22-09 by creating a bad link to 30-01, which
+        // is outside of the disk geometry.
+        sectorBuffer[0] = 48;
+        sectorBuffer[1] = 1;
+    });
+    auto checker = FlexDiskCheck(*disk, FileTimeAccess::NONE);
+    EXPECT_FALSE(checker.CheckFileSystem());
+    std::stringstream stream;
+    checker.DebugDump(stream);
+
+    // All links are dumped in ascending track-sector order, the link
+    // outside of the disk geometry is the last one.
+    std::string line;
+    std::vector<std::string> trk_secs;
+    while (std::getline(stream, line) && line.find("L I N K S") ==
+           std::string::npos)
+    {
+    }
+    ASSERT_TRUE(std::getline(stream, line));
+    EXPECT_EQ(line, "count=351");
+    while (std::getline(stream, line) && line.find("*****") ==
+           std::string::npos)
+    {
+        trk_secs.push_back(line.substr(1U, 5U));
+    }
+    ASSERT_EQ(trk_secs.size(), 351U);
+    EXPECT_EQ(trk_secs.front(), "00-01");
+    EXPECT_EQ(trk_secs[349], "22-0A");
+    EXPECT_EQ(trk_secs.back(), "30-01");
+    EXPECT_TRUE(std::is_sorted(trk_secs.cbegin(), trk_secs.cend()));
+}
+
+TEST_F(test_filfschk, check_Parallel)
+{
+    const std::array<std::string, 4> paths{
+        "/tmp/disk0.dsk", "/tmp/disk1.dsk", "/tmp/disk2.dsk", "/tmp/disk3.dsk"
+    };
+    std::array<std::string, 4> dumps;
+    std::array<std::string, 4> parallelDumps;
+
+    const auto check = [](const std::string &path){
+        const FlexDisk flexDisk(path, std::ios::in | std::ios::binary,
+                                FileTimeAccess::NONE);
+        auto checker = FlexDiskCheck(flexDisk, FileTimeAccess::NONE);
+        std::stringstream stream;
+
+        checker.CheckFileSystem();
+        stream << checker.GetStatisticsString() << '\n';
+        for (const auto &item : checker.GetResult())
+        {
+            stream << item << '\n';
+        }
+        checker.DebugDump(stream);
+
+        return stream.str();
+    };
+
+    // Each disk image has a different defect.
+    for (size_t index = 0U; index < paths.size(); ++index)
+    {
+        std::array<Byte, SECTOR_SIZE> buffer{};
+
+        ASSERT_TRUE(disk->ReadSector(buffer.data(), 1, 2));
+        buffer[0] = 1;
+        buffer[1] = static_cast<Byte>(index + 1U);
+        ASSERT_TRUE(disk->WriteSector(buffer.data(), 1, 2));
+        disk.reset();
+        fs::copy_file(diskPath, paths[index],
+                      fs::copy_options::overwrite_existing);
+        disk = std::make_unique<FlexDisk>(diskPath,
+                std::ios::in | std::ios::out | std::ios::binary,
+                FileTimeAccess::NONE);
+        dumps[index] = check(paths[index]);
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t index = 0U; index < paths.size(); ++index)
+    {
+        threads.emplace_back([&, index](){
+            parallelDumps[index] = check(paths[index]);
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t index = 0U; index < paths.size(); ++index)
+    {
+        EXPECT_EQ(parallelDumps[index], dumps[index]) << paths[index];
+        fs::remove(paths[index]);
+    }
+    EXPECT_NE(dumps[0], dumps[1]);
+}
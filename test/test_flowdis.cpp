@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+#include "misc1.h"
+#include "da6809.h"
+#include "flowdis.h"
+#include "bmembuf.h"
+#include <vector>
+#include <sstream>
+
+using ByteType = FlowDisassembler::ByteType;
+using RefType = FlowDisassembler::RefType;
+
+
+static void LoadTestProgram(BMemoryBuffer &memory)
+{
+    const std::vector<Byte> program{
+        0x8E, 0x20, 0x00,       // 1000: LDX  #$2000
+        0xBD, 0x10, 0x10,       // 1003: JSR  $1010
+        0x27, 0x04,             // 1006: BEQ  $100C
+        0xB6, 0x20, 0x00,       // 1008: LDA  $2000
+        0x39,                   // 100B: RTS
+        0x7E, 0x10, 0x00,       // 100C: JMP  $1000
+        0x01,                   // 100F: data
+        0x86, 0x01,             // 1010: LDA  #$01
+        0x35, 0x80,             // 1012: PULS PC
+        0x41, 0x42, 0x43, 0x44, // 1014: data
+    };
+    const std::vector<Byte> resetVector{ 0x10, 0x00 };
+
+    memory.CopyFrom(program.data(), 0x1000U,
+            static_cast<DWord>(program.size()));
+    memory.CopyFrom(resetVector.data(), 0xFFFEU,
+            static_cast<DWord>(resetVector.size()));
+}
+
+TEST(test_flowdis, byte_types)
+{
+    Da6809 da;
+    BMemoryBuffer memory(0x10000U);
+    FlowDisassembler flow(da);
+
+    LoadTestProgram(memory);
+    flow.SetMemory(memory);
+    flow.AddVectorEntryPoints();
+    flow.Analyze();
+
+    EXPECT_EQ(flow.GetByteType(0x0FFFU), ByteType::NotLoaded);
+    EXPECT_EQ(flow.GetByteType(0x1000U), ByteType::Code);
+    EXPECT_EQ(flow.GetByteType(0x1001U), ByteType::Operand);
+    EXPECT_EQ(flow.GetByteType(0x1002U), ByteType::Operand);
+    EXPECT_EQ(flow.GetByteType(0x1003U), ByteType::Code);
+    EXPECT_EQ(flow.GetByteType(0x100BU), ByteType::Code);
+    EXPECT_EQ(flow.GetByteType(0x100CU), ByteType::Code);
+    EXPECT_EQ(flow.GetByteType(0x100FU), ByteType::Data);
+    EXPECT_EQ(flow.GetByteType(0x1010U), ByteType::Code);
+    EXPECT_EQ(flow.GetByteType(0x1012U), ByteType::Code);
+    EXPECT_EQ(flow.GetByteType(0x1013U), ByteType::Operand);
+    EXPECT_EQ(flow.GetByteType(0x1014U), ByteType::Data);
+    EXPECT_EQ(flow.GetByteType(0x1017U), ByteType::Data);
+    EXPECT_EQ(flow.GetByteType(0x1018U), ByteType::NotLoaded);
+    EXPECT_EQ(flow.GetByteType(0xFFFEU), ByteType::Data);
+}
+
+TEST(test_flowdis, flex_entry_points)
+{
+    Da6809 da;
+    BMemoryBuffer memory(0x10000U);
+    FlowDisassembler flow(da);
+    const std::vector<Byte> rts(0x50U, 0x39U); // $CD00 - $CD4F: RTS
+
+    memory.CopyFrom(rts.data(), 0xCD00U, static_cast<DWord>(rts.size()));
+    flow.SetMemory(memory);
+    flow.Analyze();
+    EXPECT_EQ(flow.GetByteType(0xCD00U), ByteType::Data);
+
+    flow.AddFlexEntryPoints();
+    flow.Analyze();
+    EXPECT_EQ(flow.GetByteType(0xCD00U), ByteType::Code);
+    EXPECT_EQ(flow.GetByteType(0xCD01U), ByteType::Data);
+    EXPECT_EQ(flow.GetByteType(0xCD45U), ByteType::Code); // PCRLF
+    EXPECT_EQ(flow.GetByteType(0xCD48U), ByteType::Code); // INDEC
+    EXPECT_EQ(flow.GetByteType(0xCD4BU), ByteType::Code); // OUTDEC
+    EXPECT_EQ(flow.GetByteType(0xCD4EU), ByteType::Code); // STAT
+    EXPECT_EQ(flow.GetByteType(0xCD4FU), ByteType::Data);
+    EXPECT_EQ(flow.GetByteType(0xD400U), ByteType::NotLoaded);
+}
+
+TEST(test_flowdis, references)
+{
+    Da6809 da;
+    BMemoryBuffer memory(0x10000U);
+    FlowDisassembler flow(da);
+
+    LoadTestProgram(memory);
+    flow.SetMemory(memory);
+    flow.AddEntryPoint(0x1000U);
+    flow.Analyze();
+
+    EXPECT_EQ(flow.GetReferences().size(), 4U);
+    auto references = flow.GetReferencesTo(0x1000U);
+    ASSERT_EQ(references.size(), 1U);
+    EXPECT_EQ(references[0].source, 0x100CU);
+    EXPECT_EQ(references[0].type, RefType::Jump);
+    references = flow.GetReferencesTo(0x1010U);
+    ASSERT_EQ(references.size(), 1U);
+    EXPECT_EQ(references[0].source, 0x1003U);
+    EXPECT_EQ(references[0].type, RefType::Call);
+    references = flow.GetReferencesTo(0x2000U);
+    ASSERT_EQ(references.size(), 1U);
+    EXPECT_EQ(references[0].source, 0x1008U);
+    EXPECT_EQ(references[0].type, RefType::Data);
+    EXPECT_TRUE(flow.GetReferencesTo(0x1003U).empty());
+
+    EXPECT_TRUE(flow.HasLabel(0x1000U));
+    EXPECT_TRUE(flow.HasLabel(0x100CU));
+    EXPECT_TRUE(flow.HasLabel(0x1010U));
+    EXPECT_FALSE(flow.HasLabel(0x1003U));
+    // Not contained in memory image.
+    EXPECT_FALSE(flow.HasLabel(0x2000U));
+}
+
+TEST(test_flowdis, listing)
+{
+    Da6809 da;
+    BMemoryBuffer memory(0x10000U);
+    FlowDisassembler flow(da);
+    std::stringstream stream;
+
+    LoadTestProgram(memory);
+    flow.SetMemory(memory);
+    flow.AddVectorEntryPoints();
+    flow.Analyze();
+    flow.WriteListing(stream);
+
+    const auto listing = stream.str();
+    EXPECT_NE(listing.find("; Entry points: 1000"), std::string::npos);
+    EXPECT_NE(listing.find("ORG   $1000"), std::string::npos);
+    EXPECT_NE(listing.find("ORG   $FFFE"), std::string::npos);
+    EXPECT_NE(listing.find("; XREF: 1003C"), std::string::npos);
+    EXPECT_NE(listing.find("; XREF: 100CJ"), std::string::npos);
+    EXPECT_NE(listing.find("L1010   LDA"), std::string::npos);
+    EXPECT_NE(listing.find("FCB   $41,$42,$43,$44"), std::string::npos);
+    EXPECT_NE(listing.find("FCB   $01"), std::string::npos);
+    EXPECT_NE(listing.find("; 19 code bytes, 7 data bytes, 4 references"),
+            std::string::npos);
+}
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+#include "ftxtconv.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+
+using namespace std::string_literals;
+
+static std::vector<Byte> ToFlex(const std::vector<Byte> &input,
+                                size_t chunkSize)
+{
+    HostTextToFlexConverter converter;
+    std::vector<Byte> result;
+
+    for (size_t index = 0U; index < input.size(); index += chunkSize)
+    {
+        const auto size = std::min(chunkSize, input.size() - index);
+        converter.Convert(input.data() + index, size, result);
+    }
+    converter.Finish(result);
+
+    return result;
+}
+
+static std::vector<Byte> ToHost(const std::vector<Byte> &input,
+                                size_t chunkSize)
+{
+    FlexTextToHostConverter converter;
+    std::vector<Byte> result;
+
+    for (size_t index = 0U; index < input.size(); index += chunkSize)
+    {
+        const auto size = std::min(chunkSize, input.size() - index);
+        converter.Convert(input.data() + index, size, result);
+    }
+    converter.Finish(result);
+
+    return result;
+}
+
+static std::vector<Byte> ToBytes(const std::string &text)
+{
+    return std::vector<Byte>(text.cbegin(), text.cend());
+}
+
+TEST(test_ftxtconv, fct_HostTextToFlex)
+{
+    const auto input =
+        ToBytes("ABC DEF  GHI" + std::string(130U, ' ') + "\tJ\r\nK  ");
+    const auto expected = ToBytes(
+            "ABC DEF\t\x02GHI\t\x7F\t\x03\t\x08J\rK\t\x02");
+
+    for (size_t chunkSize = 1U; chunkSize <= input.size(); ++chunkSize)
+    {
+        EXPECT_EQ(ToFlex(input, chunkSize), expected) <<
+            "chunkSize=" << chunkSize;
+    }
+    EXPECT_TRUE(HostTextToFlexConverter::IsHostText(input.data(),
+                                                    input.size()));
+    const auto binary = ToBytes(std::string("ABCDEFGHIJ\x01"));
+    EXPECT_FALSE(HostTextToFlexConverter::IsHostText(binary.data(),
+                                                     binary.size()));
+    EXPECT_FALSE(HostTextToFlexConverter::IsHostText(binary.data() + 2U,
+                                                     binary.size() - 2U));
+    EXPECT_TRUE(HostTextToFlexConverter::IsHostText(binary.data(),
+                                                    binary.size() - 1U));
+}
+
+TEST(test_ftxtconv, fct_FlexTextToHost)
+{
+    auto input = ToBytes("ABC\t\x03" "DEF\r\x18\x00GHI\r\t"s);
+#ifdef _WIN32
+    const auto eol = std::string("\r\n");
+#else
+    const auto eol = std::string("\n");
+#endif
+    auto expected = ToBytes("ABC   DEF" + eol + "GHI" + eol + " ");
+
+    for (size_t chunkSize = 1U; chunkSize <= input.size(); ++chunkSize)
+    {
+        EXPECT_EQ(ToHost(input, chunkSize), expected) <<
+            "chunkSize=" << chunkSize;
+    }
+
+    // ASCII SUB is the end of file marker.
+    input.insert(input.end() - 1, 0x1A);
+    input.push_back('X');
+    expected.pop_back();
+    for (size_t chunkSize = 1U; chunkSize <= input.size(); ++chunkSize)
+    {
+        EXPECT_EQ(ToHost(input, chunkSize), expected) <<
+            "chunkSize=" << chunkSize;
+    }
+
+    EXPECT_TRUE(FlexTextToHostConverter::IsFlexText(input.data(),
+                                                    input.size()));
+    const auto binary = ToBytes(std::string("ABCDEFGH\t\x01\x02"));
+    EXPECT_FALSE(FlexTextToHostConverter::IsFlexText(binary.data(),
+                                                     binary.size()));
+    // The count byte after ASCII TAB may have any value.
+    EXPECT_TRUE(FlexTextToHostConverter::IsFlexText(binary.data(),
+                                                    binary.size() - 1U));
+}
+
+TEST(test_ftxtconv, fct_RoundTrip)
+{
+    std::mt19937 generator(4711U);
+    std::uniform_int_distribution<int> distribution(0, 9);
+    std::vector<Byte> input;
+
+    for (int index = 0; index < 5000; ++index)
+    {
+        const auto value = distribution(generator);
+        input.push_back(value < 3 ? ' ' : (value == 3 ? '\n' :
+                        static_cast<Byte>('A' + value)));
+    }
+    input.insert(input.begin() + 100, 300U, ' ');
+    input.push_back('\n');
+
+    const auto flexText = ToFlex(input, input.size());
+    EXPECT_LT(flexText.size(), input.size());
+    EXPECT_TRUE(FlexTextToHostConverter::IsFlexText(flexText.data(),
+                                                    flexText.size()));
+    EXPECT_EQ(ToFlex(input, 7U), flexText);
+    EXPECT_EQ(ToHost(flexText, 5U), ToHost(flexText, flexText.size()));
+#ifndef _WIN32
+    EXPECT_EQ(ToHost(flexText, 3U), input);
+#endif
+}
+
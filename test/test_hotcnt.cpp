@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include "misc1.h"
+#include "hotcnt.h"
+#include <sstream>
+#include <string>
+#include <thread>
+#include <filesystem>
+#ifdef UNIX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include <array>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+
+TEST(test_hotcnt, fct_Increment)
+{
+    auto &registry = HotCounterRegistry::Instance();
+    const auto index = static_cast<size_t>(HotCounterId::SectorRead);
+    const auto before = registry.GetTotals()[index];
+
+    HotCounterRegistry::Increment(HotCounterId::SectorRead);
+    std::thread thread([](){
+        for (int i = 0; i < 1000; ++i)
+        {
+            HotCounterRegistry::Increment(HotCounterId::SectorRead);
+        }
+    });
+    thread.join();
+
+    EXPECT_EQ(registry.GetTotals()[index], before + 1001U);
+}
+
+TEST(test_hotcnt, fct_IoDeviceCounters)
+{
+    auto &registry = HotCounterRegistry::Instance();
+    auto &counters = registry.GetIoDeviceCounters("test_device");
+
+    EXPECT_EQ(&counters, &registry.GetIoDeviceCounters("test_device"));
+    EXPECT_NE(&counters, &registry.GetIoDeviceCounters("other_device"));
+    const auto reads = counters.reads.load();
+    HotCounterRegistry::Increment(counters.reads);
+    HotCounterRegistry::Increment(counters.reads);
+    EXPECT_EQ(counters.reads.load(), reads + 2U);
+
+    std::stringstream stream;
+    registry.Dump(stream);
+    const auto text = stream.str();
+    EXPECT_NE(text.find("floppy.sector_read "), std::string::npos);
+    EXPECT_NE(text.find("scheduler.frequency_miss "), std::string::npos);
+    EXPECT_NE(text.find(std::string("io.test_device.read ") +
+                std::to_string(reads + 2U) + "\n"), std::string::npos);
+    EXPECT_NE(text.find("io.test_device.write "), std::string::npos);
+}
+
+#ifdef UNIX
+TEST(test_hotcnt, fct_HotCounterServer)
+{
+    const auto path = (fs::temp_directory_path() / "test_hotcnt.socket").
+        string();
+    HotCounterServer server(path);
+
+    ASSERT_TRUE(server.Start());
+    EXPECT_FALSE(server.Start());
+
+    auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    ASSERT_EQ(connect(fd, reinterpret_cast<struct sockaddr *>(&address),
+                sizeof(address)), 0);
+
+    std::string text;
+    std::array<char, 256> buffer{};
+    ssize_t count;
+    while ((count = read(fd, buffer.data(), buffer.size())) > 0)
+    {
+        text.append(buffer.data(), static_cast<size_t>(count));
+    }
+    close(fd);
+    server.Stop();
+
+    EXPECT_NE(text.find("memory.read "), std::string::npos);
+    EXPECT_NE(text.find("cpu.irq "), std::string::npos);
+    EXPECT_FALSE(fs::exists(path));
+}
+#endif
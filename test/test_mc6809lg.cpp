@@ -324,6 +324,70 @@ TEST(test_mc6809logger, fct_logCpuState_selfModifyCode)
     fs::remove(config.logFileName);
 }
 
+TEST(test_mc6809logger, fct_logCpuState_longRunning)
+{
+    Mc6809LoggerConfig config;
+    config.logFileName = "test6.log";
+    config.isEnabled = true;
+    config.isLoopOptimization = true;
+    {
+        // Testcase:
+        // 0000 NOP
+        // ...       32768 times NOP
+        // 8000 DECA
+        // 8001 BNE $8000
+        // 8003 JMP $CD03
+        // Expectation: one DO - REPEAT, loop repeated 99999 times.
+        // Each logged state has to be processed in constant time.
+        Mc6809Logger logger;
+        logger.setLoggerConfig(config);
+        for (Word pc = 0x0000; pc < 0x8000; ++pc)
+        {
+            logger.logCpuState(setState({0x12}, pc, "NOP"));
+        }
+        for (int i = 0; i < 100000; ++i)
+        {
+            logger.logCpuState(setState({0x4A}, 0x8000, "DECA"));
+            logger.logCpuState(setState({0x26, 0xFD}, 0x8001, "BNE", "$8000"));
+        }
+        logger.logCpuState(setState({0x7E, 0xCD, 0x03}, 0x8003, "JMP", "$CD03"));
+    }
+    auto result = parseFile(config.logFileName);
+    ASSERT_TRUE(result.isValid);
+    EXPECT_EQ(result.doCount, 1);
+    EXPECT_EQ(result.repeatCount, 1);
+    EXPECT_EQ(result.lineCount, 0x8000 + 7);
+    ASSERT_EQ(result.repeatValues.size(), 1U);
+    EXPECT_EQ(result.repeatValues[0], 99999);
+    EXPECT_EQ(result.countForMnemonic["NOP"], 0x8000);
+    EXPECT_EQ(result.countForMnemonic["DECA"], 2);
+    EXPECT_EQ(result.countForMnemonic["BNE"], 2);
+    EXPECT_EQ(result.countForMnemonic["JMP"], 1);
+    fs::remove(config.logFileName);
+
+    {
+        config.logFileName = "test7.log";
+        // Testcase:
+        // Loop containing 2048 NOPs which exceeds the loop history size.
+        // Expectation: no DO - REPEAT, all instructions are logged.
+        Mc6809Logger logger;
+        logger.setLoggerConfig(config);
+        for (int i = 0; i < 3; ++i)
+        {
+            for (Word pc = 0x1000; pc < 0x1800; ++pc)
+            {
+                logger.logCpuState(setState({0x12}, pc, "NOP"));
+            }
+        }
+    }
+    result = parseFile(config.logFileName);
+    ASSERT_TRUE(result.isValid);
+    EXPECT_EQ(result.doCount, 0);
+    EXPECT_EQ(result.repeatCount, 0);
+    EXPECT_EQ(result.countForMnemonic["NOP"], 3 * 0x800);
+    fs::remove(config.logFileName);
+}
+
 TEST(test_mc6809logger, fct_asCCString)
 {
     EXPECT_EQ(Mc6809Logger::asCCString(0x01), "-------C");
@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+#include "misc1.h"
+#include "mc6821.h"
+
+
+class TestMc6821 final : public Mc6821
+{
+public:
+    bool isIrqA{};
+    bool isIrqB{};
+
+protected:
+    void set_irq_A() override
+    {
+        isIrqA = true;
+    }
+    void set_irq_B() override
+    {
+        isIrqB = true;
+    }
+    void reset_irq_A() override
+    {
+        isIrqA = false;
+    }
+    void reset_irq_B() override
+    {
+        isIrqB = false;
+    }
+};
+
+TEST(test_mc6821, fct_ControlRegisterIrq)
+{
+    TestMc6821 pia;
+
+    pia.resetIo();
+    // Enable IRQA1 and IRQB1 interrupts, access output registers.
+    pia.writeIo(1U, 0x05U);
+    pia.writeIo(3U, 0x05U);
+    pia.activeTransition(Mc6821::ControlLine::CA1);
+    pia.activeTransition(Mc6821::ControlLine::CB1);
+    EXPECT_TRUE(pia.isIrqA);
+    EXPECT_TRUE(pia.isIrqB);
+
+    // The IRQ flags are read only, disabling the interrupt deasserts
+    // the IRQ output.
+    pia.writeIo(1U, 0x04U);
+    EXPECT_EQ(pia.readIo(1U), 0x84U);
+    EXPECT_FALSE(pia.isIrqA);
+    EXPECT_TRUE(pia.isIrqB);
+    pia.writeIo(3U, 0x04U);
+    EXPECT_EQ(pia.readIo(3U), 0x84U);
+    EXPECT_FALSE(pia.isIrqB);
+
+    // Enabling the interrupt while the flag is set asserts the IRQ output.
+    pia.writeIo(1U, 0x05U);
+    EXPECT_TRUE(pia.isIrqA);
+
+    // Reading the data register clears the flags.
+    pia.readIo(0U);
+    EXPECT_EQ(pia.readIo(1U), 0x05U);
+    EXPECT_FALSE(pia.isIrqA);
+
+    // Writing the IRQ flags does not set them.
+    pia.writeIo(1U, 0xC5U);
+    EXPECT_EQ(pia.readIo(1U), 0x05U);
+    EXPECT_FALSE(pia.isIrqA);
+
+    // IRQA2 only causes an interrupt if CA2 is an input.
+    pia.writeIo(1U, 0x0CU);
+    pia.activeTransition(Mc6821::ControlLine::CA2);
+    EXPECT_TRUE(pia.isIrqA);
+    pia.writeIo(1U, 0x2CU);
+    EXPECT_FALSE(pia.isIrqA);
+}
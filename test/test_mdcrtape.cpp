@@ -0,0 +1,223 @@
+#include "gtest/gtest.h"
+#include "misc1.h"
+#include "mdcrtape.h"
+#include "flexerr.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+
+namespace fs = std::filesystem;
+
+TEST(test_mdcrtape, fct_WriteRead)
+{
+    const auto path = fs::temp_directory_path() / "test_mdcrtape.mdcr";
+    const std::vector<Byte> header(13, 0x48U);
+    const std::vector<Byte> data(1027, 0xD5U);
+    const std::vector<Byte> lastData{ 0x01U, 0x02U, 0x03U };
+    std::vector<Byte> buffer;
+
+    fs::remove(path);
+    {
+        auto tape = MiniDcrTape::Create(path.u8string());
+        ASSERT_TRUE(tape->IsOpen());
+        EXPECT_FALSE(tape->HasRecord());
+        EXPECT_TRUE(tape->WriteRecord(header));
+        EXPECT_TRUE(tape->WriteRecord(data));
+        EXPECT_TRUE(tape->WriteRecord(lastData));
+    }
+    EXPECT_THROW(MiniDcrTape::Create(path.u8string()), FlexException);
+
+    auto tape = MiniDcrTape::Open(path.u8string());
+    ASSERT_TRUE(tape->IsOpen());
+    EXPECT_EQ(tape->GetRecordType(), RecordType::Header);
+    EXPECT_TRUE(tape->ReadRecord(buffer));
+    EXPECT_EQ(buffer, header);
+    EXPECT_EQ(tape->GetRecordType(), RecordType::Data);
+    EXPECT_TRUE(tape->ReadRecord(buffer));
+    EXPECT_EQ(buffer, data);
+    EXPECT_TRUE(tape->ReadRecord(buffer));
+    EXPECT_EQ(buffer, lastData);
+    EXPECT_EQ(tape->GetRecordIndex(), 3U);
+    EXPECT_FALSE(tape->HasRecord());
+    EXPECT_FALSE(tape->ReadRecord(buffer));
+
+    // Rewind and read the last record again.
+    EXPECT_TRUE(tape->GotoPreviousRecord());
+    EXPECT_TRUE(tape->ReadRecord(buffer));
+    EXPECT_EQ(buffer, lastData);
+    tape->Close();
+    fs::remove(path);
+    fs::remove(MiniDcrTape::GetIndexFilePath(path.u8string()));
+}
+
+TEST(test_mdcrtape, fct_InvalidTape)
+{
+    const auto path = fs::temp_directory_path() / "test_mdcrtape.mdcr";
+    std::ofstream ofs(path, std::ios::out | std::ios::binary |
+                            std::ios::trunc);
+
+    // Magic bytes followed by a truncated record.
+    ofs << "MDCR" << '\0' << '\x10' << "ABC";
+    ofs.close();
+    EXPECT_THROW(MiniDcrTape::Open(path.u8string()), FlexException);
+    fs::remove(path);
+}
+
+TEST(test_mdcrtape, fct_IndexFile)
+{
+    const auto path = fs::temp_directory_path() / "test_mdcrtape.mdcr";
+    const auto indexPath = MiniDcrTape::GetIndexFilePath(path.u8string());
+    const std::vector<Byte> record1(13, 0x11U);
+    const std::vector<Byte> record2(100, 0x22U);
+    std::vector<Byte> buffer;
+
+    fs::remove(path);
+    fs::remove(indexPath);
+    {
+        auto tape = MiniDcrTape::Create(path.u8string());
+        EXPECT_TRUE(tape->WriteRecord(record1));
+        EXPECT_TRUE(tape->WriteRecord(record2));
+    }
+    // The index file is written when the tape is closed.
+    ASSERT_TRUE(fs::exists(indexPath));
+
+    // Open a tape using the index file, random record access.
+    {
+        auto tape = MiniDcrTape::Open(path.u8string());
+        EXPECT_EQ(tape->GetRecordCount(), 2U);
+        EXPECT_EQ(tape->GetRecordSize(0U), 13U);
+        EXPECT_EQ(tape->GetRecordSize(1U), 100U);
+        EXPECT_TRUE(tape->GotoRecord(1U));
+        EXPECT_TRUE(tape->ReadRecord(buffer));
+        EXPECT_EQ(buffer, record2);
+        EXPECT_TRUE(tape->GotoRecord(0U));
+        EXPECT_TRUE(tape->ReadRecord(buffer));
+        EXPECT_EQ(buffer, record1);
+        EXPECT_FALSE(tape->GotoRecord(3U));
+        // Append a record, the index file is updated.
+        EXPECT_TRUE(tape->GotoRecord(2U));
+        EXPECT_TRUE(tape->WriteRecord(record1));
+    }
+
+    // An invalid index file is ignored.
+    {
+        std::fstream ofs(indexPath, std::ios::in | std::ios::out |
+                                    std::ios::binary);
+        ofs.seekp(30);
+        ofs.put('\xFF');
+    }
+    {
+        auto tape = MiniDcrTape::Open(path.u8string());
+        EXPECT_EQ(tape->GetRecordCount(), 3U);
+        EXPECT_TRUE(tape->GotoRecord(2U));
+        EXPECT_TRUE(tape->ReadRecord(buffer));
+        EXPECT_EQ(buffer, record1);
+    }
+    fs::remove(path);
+    fs::remove(indexPath);
+}
+
+TEST(test_mdcrtape, fct_IndexFileModificationTime)
+{
+    const auto path = fs::temp_directory_path() / "test_mdcrtape.mdcr";
+    const auto indexPath = MiniDcrTape::GetIndexFilePath(path.u8string());
+    const auto otherPath = fs::temp_directory_path() / "test_mdcrtape2.mdcr";
+    std::vector<Byte> buffer;
+
+    fs::remove(path);
+    fs::remove(indexPath);
+    {
+        auto tape = MiniDcrTape::Create(path.u8string());
+        EXPECT_TRUE(tape->WriteRecord(std::vector<Byte>(13, 0x11U)));
+        EXPECT_TRUE(tape->WriteRecord(std::vector<Byte>(100, 0x22U)));
+    }
+    ASSERT_TRUE(fs::exists(indexPath));
+    const auto time = fs::last_write_time(path);
+
+    // Overwrite the tape with records of different sizes, the tape file
+    // size is unchanged. The modification time only differs in the
+    // fraction of a second.
+    {
+        auto tape = MiniDcrTape::Create(otherPath.u8string());
+        EXPECT_TRUE(tape->WriteRecord(std::vector<Byte>(50, 0x33U)));
+        EXPECT_TRUE(tape->WriteRecord(std::vector<Byte>(63, 0x44U)));
+    }
+    fs::rename(otherPath, path);
+    fs::remove(MiniDcrTape::GetIndexFilePath(otherPath.u8string()));
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            time.time_since_epoch());
+    auto otherTime = fs::file_time_type(seconds);
+    if (otherTime == time)
+    {
+        otherTime += std::chrono::milliseconds(500);
+    }
+    fs::last_write_time(path, otherTime);
+
+    {
+        auto tape = MiniDcrTape::Open(path.u8string());
+        EXPECT_EQ(tape->GetRecordCount(), 2U);
+        EXPECT_EQ(tape->GetRecordSize(0U), 50U);
+        EXPECT_EQ(tape->GetRecordSize(1U), 63U);
+        EXPECT_TRUE(tape->ReadRecord(buffer));
+        EXPECT_EQ(buffer, std::vector<Byte>(50, 0x33U));
+    }
+    fs::remove(path);
+    fs::remove(indexPath);
+}
+
+TEST(test_mdcrtape, fct_OverwriteRecord)
+{
+    const auto path = fs::temp_directory_path() / "test_mdcrtape.mdcr";
+    const auto indexPath = MiniDcrTape::GetIndexFilePath(path.u8string());
+    const std::vector<Byte> header(13, 0x48U);
+    const std::vector<Byte> data(1027, 0xD5U);
+    const std::vector<Byte> lastData{ 0x01U, 0x02U, 0x03U };
+    std::vector<Byte> buffer;
+    std::vector<RecordType> types;
+    std::vector<Word> sizes;
+
+    fs::remove(path);
+    fs::remove(indexPath);
+    {
+        auto tape = MiniDcrTape::Create(path.u8string());
+        EXPECT_TRUE(tape->WriteRecord(header));
+        EXPECT_TRUE(tape->WriteRecord(data));
+        EXPECT_TRUE(tape->WriteRecord(data));
+        EXPECT_TRUE(tape->WriteRecord(lastData));
+        // Overwrite the third record, all following records are dropped.
+        EXPECT_TRUE(tape->GotoRecord(2U));
+        EXPECT_TRUE(tape->WriteRecord(lastData));
+        EXPECT_TRUE(tape->WriteRecord(header));
+        EXPECT_EQ(tape->GetRecordCount(), 4U);
+        EXPECT_FALSE(tape->HasRecord());
+        EXPECT_TRUE(tape->GotoRecord(3U));
+        EXPECT_TRUE(tape->ReadRecord(buffer));
+        EXPECT_EQ(buffer, header);
+        for (DWord index = 0U; index <= tape->GetRecordCount(); ++index)
+        {
+            EXPECT_TRUE(tape->GotoRecord(index));
+            types.push_back(tape->GetRecordType());
+            sizes.push_back(tape->GetRecordSize(index));
+        }
+    }
+
+    // The record index has to match the one of a verified tape.
+    fs::remove(indexPath);
+    auto tape = MiniDcrTape::Open(path.u8string());
+    EXPECT_EQ(tape->GetRecordCount(), 4U);
+    for (DWord index = 0U; index <= tape->GetRecordCount(); ++index)
+    {
+        EXPECT_TRUE(tape->GotoRecord(index));
+        EXPECT_EQ(tape->GetRecordType(), types[index]) << "index=" << index;
+        EXPECT_EQ(tape->GetRecordSize(index), sizes[index]) <<
+            "index=" << index;
+    }
+    EXPECT_TRUE(tape->GotoRecord(2U));
+    EXPECT_TRUE(tape->ReadRecord(buffer));
+    EXPECT_EQ(buffer, lastData);
+    tape->Close();
+    fs::remove(path);
+    fs::remove(indexPath);
+}
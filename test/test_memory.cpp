@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+#include "misc1.h"
+#include "memory.h"
+#include "iodevice.h"
+#include "soptions.h"
+#include <array>
+
+
+class TestIoDevice final : public IoDevice
+{
+public:
+    Byte readIo(Word offset) override
+    {
+        ++reads;
+        return registers[offset];
+    }
+    void writeIo(Word offset, Byte value) override
+    {
+        registers[offset] = value;
+    }
+    void resetIo() override
+    {
+        registers.fill(0U);
+    }
+    const char *getName() override
+    {
+        return "testio";
+    }
+    Word sizeOfIo() override
+    {
+        return static_cast<Word>(registers.size());
+    }
+
+    std::array<Byte, 4> registers{};
+    unsigned reads{};
+};
+
+static void InitOptions(struct sOptions &options)
+{
+    // Without RAM extension flexemu.conf is not needed.
+    options.isRamExtension = false;
+    options.isHiMem = false;
+    options.isFlexibleMmu = false;
+    options.isEurocom2V5 = false;
+}
+
+TEST(test_memory, fct_add_io_device)
+{
+    struct sOptions options;
+    InitOptions(options);
+    Memory memory(options);
+    TestIoDevice device1;
+    TestIoDevice device2;
+
+    // Virtual dispatch and dispatch for a device class known at compile
+    // time have to behave the same.
+    ASSERT_TRUE(memory.add_io_device(device1, 0xFD00U));
+    ASSERT_TRUE(memory.add_io_device(device2, 0xFD10U, 8,
+                MakeIoDispatch<TestIoDevice>()));
+    EXPECT_FALSE(memory.add_io_device(device1, 0xF000U));
+
+    memory.write_byte(0xFD01U, 0x11U);
+    memory.write_byte(0xFD12U, 0x22U);
+    // Address range of 8 bytes mirrors the 4 device registers.
+    memory.write_byte(0xFD17U, 0x33U);
+    EXPECT_EQ(device1.registers[1], 0x11U);
+    EXPECT_EQ(device2.registers[2], 0x22U);
+    EXPECT_EQ(device2.registers[3], 0x33U);
+    EXPECT_EQ(memory.read_byte(0xFD01U), 0x11U);
+    EXPECT_EQ(memory.read_byte(0xFD16U), 0x22U);
+    EXPECT_EQ(device1.reads, 1U);
+    EXPECT_EQ(device2.reads, 1U);
+
+    memory.reset_io();
+    EXPECT_EQ(memory.read_byte(0xFD01U), 0U);
+    EXPECT_EQ(memory.read_byte(0xFD12U), 0U);
+}
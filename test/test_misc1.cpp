@@ -2,6 +2,8 @@
 #include "gmock/gmock.h"
 #include "misc1.h"
 #include <sys/stat.h>
+#include <algorithm>
+#include <thread>
 
 
 using ::testing::EndsWith;
@@ -776,6 +778,28 @@ TEST(test_misc1, fct_updateFilename)
     EXPECT_EQ(result, "/tmp/stem.tar.xz");
 }
 
+TEST(test_misc1, fct_getJobCount)
+{
+    unsigned jobs = 7U;
+
+    // 0 is the number of CPU cores.
+    EXPECT_TRUE(flx::getJobCount("0", jobs));
+    EXPECT_EQ(jobs, std::min(std::max(1U,
+              std::thread::hardware_concurrency()), flx::MAX_JOBS));
+    EXPECT_TRUE(flx::getJobCount("1", jobs));
+    EXPECT_EQ(jobs, 1U);
+    EXPECT_TRUE(flx::getJobCount("16", jobs));
+    EXPECT_EQ(jobs, 16U);
+    EXPECT_TRUE(flx::getJobCount(std::to_string(flx::MAX_JOBS), jobs));
+    EXPECT_EQ(jobs, flx::MAX_JOBS);
+    EXPECT_FALSE(flx::getJobCount("-1", jobs));
+    EXPECT_FALSE(flx::getJobCount(std::to_string(flx::MAX_JOBS + 1U), jobs));
+    EXPECT_FALSE(flx::getJobCount("4294967295", jobs));
+    EXPECT_FALSE(flx::getJobCount("4x", jobs));
+    EXPECT_FALSE(flx::getJobCount("", jobs));
+    EXPECT_EQ(jobs, flx::MAX_JOBS);
+}
+
 TEST(test_misc1, fct_BTST)
 {
     const Byte val8 = 0x55U;
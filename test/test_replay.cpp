@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+#include "misc1.h"
+#include "replay.h"
+#include "schedcpu.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+namespace fs = std::filesystem;
+
+// A CPU which only provides a settable total cycle count.
+class TestCpu : public ScheduledCpu
+{
+public:
+    void do_reset() override
+    {
+    }
+    CpuState run(RunMode /*mode*/) override
+    {
+        return CpuState::Exit;
+    }
+    void exit_run() override
+    {
+    }
+    QWord get_cycles(bool /*reset*/ = false) override
+    {
+        return cycles;
+    }
+    void get_status(CpuStatus * /*cpu_status*/) override
+    {
+    }
+    CpuStatusPtr create_status_object() override
+    {
+        return nullptr;
+    }
+    void get_interrupt_status(tInterruptStatus & /*s*/) override
+    {
+    }
+    void set_required_cyclecount(cycles_t /*required_cyclecount*/) override
+    {
+    }
+    void set_schedule_cycle(QWord /*cycle*/,
+                            bool /*isAfterInterrupts*/) override
+    {
+    }
+
+    QWord cycles{};
+};
+
+using Input = ReplayLog::Input;
+
+TEST(test_replay, fct_RecordReplay)
+{
+    const auto path = fs::temp_directory_path() / "test_replay.rpl";
+    const std::vector<Byte> snapshot{ 'F', 'L', 'X', 0x00U, 0xFFU };
+    TestCpu cpu;
+
+    cpu.cycles = 1000U;
+    {
+        ReplayLog log(cpu);
+        ASSERT_TRUE(log.StartRecording(path.u8string(), snapshot, "DIR\r"));
+        EXPECT_TRUE(log.IsRecording());
+        EXPECT_FALSE(log.IsReplaying());
+        cpu.cycles = 1010U;
+        log.Record(Input::SerialKey, 'A');
+        log.Record(Input::SerialKey, 'B');
+        cpu.cycles = 1500000U;
+        log.Record(Input::Second, 0U, true);
+        cpu.cycles = 1500200U;
+        log.Record(Input::SerialKey, '\r');
+        cpu.cycles = 0x123456789ULL;
+        log.Record(Input::SerialEof);
+        log.Stop();
+        EXPECT_FALSE(log.IsRecording());
+    }
+
+    cpu.cycles = 0U;
+    ReplayLog log(cpu);
+    ASSERT_TRUE(log.StartReplay(path.u8string()));
+    EXPECT_TRUE(log.IsReplaying());
+    EXPECT_EQ(log.GetSnapshot(), snapshot);
+    EXPECT_EQ(log.GetStartupCommand(), "DIR\r");
+
+    // Recording is a no-op while replaying.
+    log.Record(Input::SerialKey, 'X');
+
+    Input input{};
+    Byte value{};
+    QWord cycle{};
+    bool isAfterInterrupts{};
+
+    // Terminal and scheduler inputs are read independently.
+    ASSERT_TRUE(log.GetNextSchedulerCycle(cycle, isAfterInterrupts));
+    EXPECT_EQ(cycle, 1500000U);
+    EXPECT_TRUE(isAfterInterrupts);
+
+    cpu.cycles = 1009U;
+    EXPECT_FALSE(log.GetSerialInput(input, value));
+    EXPECT_FALSE(log.IsSchedulerInputDue());
+    cpu.cycles = 1010U;
+    ASSERT_TRUE(log.GetSerialInput(input, value));
+    EXPECT_EQ(input, Input::SerialKey);
+    EXPECT_EQ(value, 'A');
+    ASSERT_TRUE(log.GetSerialInput(input, value));
+    EXPECT_EQ(value, 'B');
+    EXPECT_FALSE(log.GetSerialInput(input, value));
+    EXPECT_FALSE(log.GetSchedulerInput(input));
+
+    cpu.cycles = 1500300U;
+    ASSERT_TRUE(log.GetSerialInput(input, value));
+    EXPECT_EQ(input, Input::SerialKey);
+    EXPECT_EQ(value, '\r');
+    EXPECT_TRUE(log.IsSchedulerInputDue());
+    ASSERT_TRUE(log.GetSchedulerInput(input));
+    EXPECT_EQ(input, Input::Second);
+
+    ASSERT_TRUE(log.GetNextSchedulerCycle(cycle, isAfterInterrupts));
+    EXPECT_EQ(cycle, 0x123456789ULL);
+    EXPECT_FALSE(isAfterInterrupts);
+    cpu.cycles = 0x123456789ULL;
+    ASSERT_TRUE(log.GetSerialInput(input, value));
+    EXPECT_EQ(input, Input::SerialEof);
+    EXPECT_FALSE(log.GetSerialInput(input, value));
+    ASSERT_TRUE(log.GetSchedulerInput(input));
+    EXPECT_EQ(input, Input::End);
+    EXPECT_FALSE(log.GetSchedulerInput(input));
+    EXPECT_FALSE(log.GetNextSchedulerCycle(cycle, isAfterInterrupts));
+
+    fs::remove(path);
+}
+
+TEST(test_replay, fct_InvalidFile)
+{
+    const auto path = fs::temp_directory_path() / "test_replay.rpl";
+    TestCpu cpu;
+    ReplayLog log(cpu);
+
+    fs::remove(path);
+    EXPECT_FALSE(log.StartReplay(path.u8string()));
+    {
+        std::ofstream ofs(path, std::ios::out | std::ios::binary);
+        ofs << "FLXSNAP\x1A";
+    }
+    EXPECT_FALSE(log.StartReplay(path.u8string()));
+    EXPECT_FALSE(log.IsReplaying());
+
+    // A truncated log ends at the last complete record.
+    {
+        ReplayLog recordLog(cpu);
+        ASSERT_TRUE(recordLog.StartRecording(path.u8string(), {}, ""));
+        cpu.cycles = 10U;
+        recordLog.Record(Input::SerialKey, 'A');
+        recordLog.Record(Input::SerialKey, 'B');
+    }
+    const auto size = fs::file_size(path);
+    // Cut the end record and the value of the second key.
+    fs::resize_file(path, size - 3U);
+    ASSERT_TRUE(log.StartReplay(path.u8string()));
+    Input input{};
+    Byte value{};
+    ASSERT_TRUE(log.GetSerialInput(input, value));
+    EXPECT_EQ(value, 'A');
+    EXPECT_FALSE(log.GetSerialInput(input, value));
+
+    fs::remove(path);
+}
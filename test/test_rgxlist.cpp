@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include "rgxlist.h"
+#include <regex>
+#include <string>
+#include <vector>
+
+
+TEST(test_rgxlist, fct_GetLiteralPrefixSuffix)
+{
+    EXPECT_EQ(RegexList::GetLiteralPrefix("^TEST[0-9]*\\.TXT"), "TEST");
+    EXPECT_EQ(RegexList::GetLiteralPrefix("^TEST\\.TXT$"), "TEST.TXT");
+    EXPECT_EQ(RegexList::GetLiteralPrefix("^TESTS*"), "TEST");
+    EXPECT_EQ(RegexList::GetLiteralPrefix("^TESTS{2}"), "TEST");
+    EXPECT_EQ(RegexList::GetLiteralPrefix("TEST"), "");
+    EXPECT_EQ(RegexList::GetLiteralPrefix("^(TEST)"), "");
+    EXPECT_EQ(RegexList::GetLiteralPrefix("^TEST|^ABC"), "");
+    EXPECT_EQ(RegexList::GetLiteralPrefix("^A[|]B"), "A");
+    EXPECT_EQ(RegexList::GetLiteralPrefix("^\\^A\\$"), "^A$");
+    EXPECT_EQ(RegexList::GetLiteralSuffix("[A-Z]+\\.CMD$"), ".CMD");
+    EXPECT_EQ(RegexList::GetLiteralSuffix("[[:alpha:]]X$"), "X");
+    EXPECT_EQ(RegexList::GetLiteralSuffix("CMD"), "");
+    EXPECT_EQ(RegexList::GetLiteralSuffix("CMD\\$"), "");
+    EXPECT_EQ(RegexList::GetLiteralSuffix("(CMD)$"), "");
+    EXPECT_EQ(RegexList::GetLiteralSuffix("A{1,2}$"), "");
+}
+
+TEST(test_rgxlist, fct_FindFirst)
+{
+    RegexList regexs;
+
+    EXPECT_TRUE(regexs.IsEmpty());
+    regexs.Add("^TEST0", true);
+    regexs.Add("\\.cmd$", false);
+    regexs.Add("^TEST", true);
+    regexs.Add("X", false);
+    EXPECT_THROW(regexs.Add("(", true), std::regex_error);
+    EXPECT_FALSE(regexs.IsEmpty());
+    EXPECT_EQ(regexs.GetCount(), 4U);
+
+    EXPECT_EQ(regexs.FindFirst("TEST01.CMD"), 0U);
+    EXPECT_EQ(regexs.FindFirst("TEST11.CMD"), 1U);
+    EXPECT_EQ(regexs.FindFirst("test11.cmd"), 1U);
+    EXPECT_EQ(regexs.FindFirst("TEST11.TXT"), 2U);
+    EXPECT_EQ(regexs.FindFirst("test11.dat"), RegexList::npos);
+    EXPECT_EQ(regexs.FindFirst("test11.txx"), 3U);
+    EXPECT_EQ(regexs.FindFirst(""), RegexList::npos);
+}
+
+TEST(test_rgxlist, fct_Select)
+{
+    const std::vector<std::string> patterns{
+        "^TEST0", "\\.BIN$", "^B", "1", "^TEST09\\.TXT$", "^(A|B)", "Z$",
+        "^[A-C]+\\.", "^TEST0*\\.", "^ATE?ST\\.",
+    };
+    const std::vector<std::string> texts{
+        "TEST01.TXT", "BTEST.BIN", "ABC.TXT", "TEST09.TXT", "ATEST.Z",
+        "TEST.BIN", "ATST.TXT", "AB.CMD", "TEST10.TXT", "C.C",
+    };
+    RegexList regexs;
+    std::vector<std::regex> allRegexs;
+
+    for (const auto &pattern : patterns)
+    {
+        regexs.Add(pattern, pattern.size() % 2 == 0U);
+        auto flags = std::regex_constants::extended;
+        if (pattern.size() % 2 != 0U)
+        {
+            flags |= std::regex_constants::icase;
+        }
+        allRegexs.emplace_back(pattern, flags);
+    }
+
+    // Same result as searching each regular expression in each text.
+    std::vector<std::string> expected;
+    std::vector<bool> isSelected(texts.size());
+    for (const auto &regex : allRegexs)
+    {
+        for (size_t index = 0U; index < texts.size(); ++index)
+        {
+            if (!isSelected[index] && std::regex_search(texts[index], regex))
+            {
+                expected.push_back(texts[index]);
+                isSelected[index] = true;
+            }
+        }
+    }
+
+    EXPECT_EQ(regexs.Select(texts), expected);
+    EXPECT_EQ(expected.size(), texts.size());
+}
+
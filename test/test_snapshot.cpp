@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+#include "misc1.h"
+#include "snapshot.h"
+#include "memory.h"
+#include "soptions.h"
+#include <array>
+#include <string>
+#include <vector>
+
+
+TEST(test_snapshot, fct_WriteRead)
+{
+    SnapshotWriter writer;
+    const std::array<Byte, 5> block{ 1, 2, 3, 4, 5 };
+
+    writer.BeginChunk("first");
+    writer.Write(true);
+    writer.Write(static_cast<Byte>(0xA5U));
+    writer.Write(static_cast<Word>(0x1234U));
+    writer.Write(static_cast<DWord>(0x89ABCDEFU));
+    writer.Write(static_cast<QWord>(0x0123456789ABCDEFU));
+    writer.EndChunk();
+    writer.BeginChunk("second");
+    writer.Write(block.data(), static_cast<DWord>(block.size()));
+    writer.Write(std::string("path/to/disk.dsk"));
+    writer.EndChunk();
+
+    SnapshotReader reader(writer.GetData());
+    ASSERT_TRUE(reader.IsValid());
+    EXPECT_TRUE(reader.HasChunk("first"));
+    EXPECT_TRUE(reader.HasChunk("second"));
+    EXPECT_FALSE(reader.HasChunk("third"));
+    EXPECT_FALSE(reader.SelectChunk("third"));
+
+    std::array<Byte, 5> blockRead{};
+    std::string path;
+    ASSERT_TRUE(reader.SelectChunk("second"));
+    reader.Read(blockRead.data(), static_cast<DWord>(blockRead.size()));
+    reader.Read(path);
+    EXPECT_EQ(blockRead, block);
+    EXPECT_EQ(path, "path/to/disk.dsk");
+
+    bool flag{};
+    Byte byteValue{};
+    Word wordValue{};
+    DWord dwordValue{};
+    QWord qwordValue{};
+    ASSERT_TRUE(reader.SelectChunk("first"));
+    reader.Read(flag);
+    reader.Read(byteValue);
+    reader.Read(wordValue);
+    reader.Read(dwordValue);
+    reader.Read(qwordValue);
+    EXPECT_TRUE(reader.IsValid());
+    EXPECT_TRUE(flag);
+    EXPECT_EQ(byteValue, 0xA5U);
+    EXPECT_EQ(wordValue, 0x1234U);
+    EXPECT_EQ(dwordValue, 0x89ABCDEFU);
+    EXPECT_EQ(qwordValue, 0x0123456789ABCDEFU);
+
+    // Reading beyond the end of a chunk is an error.
+    reader.Read(byteValue);
+    EXPECT_FALSE(reader.IsValid());
+    EXPECT_EQ(byteValue, 0U);
+}
+
+TEST(test_snapshot, fct_InvalidData)
+{
+    SnapshotReader reader1(std::vector<Byte>{ 'F', 'L', 'X' });
+    EXPECT_FALSE(reader1.IsValid());
+
+    SnapshotWriter writer;
+    writer.BeginChunk("chunk");
+    writer.Write(static_cast<DWord>(0U));
+    writer.EndChunk();
+    auto data = writer.GetData();
+    // Truncated chunk data.
+    data.pop_back();
+    SnapshotReader reader2(data);
+    EXPECT_FALSE(reader2.IsValid());
+
+    data = writer.GetData();
+    // Unsupported format version.
+    data[8] = 0xFFU;
+    SnapshotReader reader3(data);
+    EXPECT_FALSE(reader3.IsValid());
+}
+
+TEST(test_snapshot, fct_Memory)
+{
+    struct sOptions options;
+    // Without RAM extension flexemu.conf is not needed.
+    options.isRamExtension = false;
+    options.isHiMem = false;
+    options.isFlexibleMmu = false;
+    options.isEurocom2V5 = false;
+    Memory memory(options);
+    SnapshotWriter writer;
+
+    memory.write_byte(0x1000U, 0x55U);
+    memory.write_byte(0x8000U, 0xAAU);
+    memory.write_ram_rom(0xFFFEU, 0xF0U);
+    writer.BeginChunk("memory");
+    memory.save_state(writer);
+    writer.EndChunk();
+
+    Memory restored(options);
+    SnapshotReader reader(writer.GetData());
+    restored.write_byte(0x1000U, 0x11U);
+    ASSERT_TRUE(reader.SelectChunk("memory"));
+    const auto apply = restored.restore_state(reader);
+    ASSERT_TRUE(apply);
+    // Reading the state does not change the memory.
+    EXPECT_EQ(restored.read_byte(0x1000U), 0x11U);
+    apply();
+    EXPECT_EQ(restored.read_byte(0x1000U), 0x55U);
+    EXPECT_EQ(restored.read_byte(0x8000U), 0xAAU);
+    EXPECT_EQ(restored.read_ram_rom(0xFFFEU), 0xF0U);
+    for (int block = 0; block < YBLOCKS; ++block)
+    {
+        EXPECT_TRUE(restored.has_changed(block));
+    }
+
+    // A snapshot with a different memory size is rejected.
+    SnapshotWriter otherWriter;
+    otherWriter.BeginChunk("memory");
+    otherWriter.Write(static_cast<DWord>(0x8000U));
+    otherWriter.Write(static_cast<DWord>(0U));
+    otherWriter.EndChunk();
+    SnapshotReader otherReader(otherWriter.GetData());
+    ASSERT_TRUE(otherReader.SelectChunk("memory"));
+    EXPECT_FALSE(restored.restore_state(otherReader));
+    EXPECT_EQ(restored.read_byte(0x1000U), 0x55U);
+
+    // A snapshot with truncated memory contents is rejected without
+    // changing the memory.
+    DWord size;
+    DWord vramSize;
+    ASSERT_TRUE(reader.SelectChunk("memory"));
+    reader.Read(size);
+    reader.Read(vramSize);
+    SnapshotWriter truncatedWriter;
+    const std::vector<Byte> contents(0x2000U, 0xEEU);
+    truncatedWriter.BeginChunk("memory");
+    truncatedWriter.Write(size);
+    truncatedWriter.Write(vramSize);
+    truncatedWriter.Write(contents.data(),
+                          static_cast<DWord>(contents.size()));
+    truncatedWriter.EndChunk();
+    SnapshotReader truncatedReader(truncatedWriter.GetData());
+    ASSERT_TRUE(truncatedReader.SelectChunk("memory"));
+    EXPECT_FALSE(restored.restore_state(truncatedReader));
+    EXPECT_EQ(restored.read_byte(0x1000U), 0x55U);
+}